@@ -0,0 +1,86 @@
+.include "macros.inc"
+.file "fold.c"
+
+.section .text, "ax"
+
+.fn fold_mix_a, global
+/* 8000C000 00009000  54 60 18 38 */	slwi r0, r3, 0x3
+/* 8000C004 00009004  7C 00 1A 14 */	add r0, r0, r3
+/* 8000C008 00009008  7C 00 22 78 */	xor r0, r0, r4
+/* 8000C00C 0000900C  38 84 00 11 */	addi r4, r4, 0x11
+/* 8000C010 00009010  7C 60 21 D6 */	mullw r3, r0, r4
+/* 8000C014 00009014  54 60 C9 FE */	srwi r0, r3, 0x7
+/* 8000C018 00009018  7C 63 02 78 */	xor r3, r3, r0
+/* 8000C01C 0000901C  70 63 FF FF */	andi. r3, r3, 0xffff
+/* 8000C020 00009020  38 63 00 01 */	addi r3, r3, 0x1
+/* 8000C024 00009024  4E 80 00 20 */	blr
+.endfn fold_mix_a
+
+.fn fold_mix_b, global
+/* 8000C028 00009028  54 60 18 38 */	slwi r0, r3, 0x3
+/* 8000C02C 0000902C  7C 00 1A 14 */	add r0, r0, r3
+/* 8000C030 00009030  7C 00 22 78 */	xor r0, r0, r4
+/* 8000C034 00009034  38 84 00 11 */	addi r4, r4, 0x11
+/* 8000C038 00009038  7C 60 21 D6 */	mullw r3, r0, r4
+/* 8000C03C 0000903C  54 60 C9 FE */	srwi r0, r3, 0x7
+/* 8000C040 00009040  7C 63 02 78 */	xor r3, r3, r0
+/* 8000C044 00009044  70 63 FF FF */	andi. r3, r3, 0xffff
+/* 8000C048 00009048  38 63 00 01 */	addi r3, r3, 0x1
+/* 8000C04C 0000904C  4E 80 00 20 */	blr
+.endfn fold_mix_b
+
+.fn fold_mix_c, global
+/* 8000C050 00009050  54 60 18 38 */	slwi r0, r3, 0x3
+/* 8000C054 00009054  7C 00 1A 14 */	add r0, r0, r3
+/* 8000C058 00009058  7C 00 22 78 */	xor r0, r0, r4
+/* 8000C05C 0000905C  38 84 00 11 */	addi r4, r4, 0x11
+/* 8000C060 00009060  7C 60 21 D6 */	mullw r3, r0, r4
+/* 8000C064 00009064  54 60 C9 FE */	srwi r0, r3, 0x7
+/* 8000C068 00009068  7C 63 02 78 */	xor r3, r3, r0
+/* 8000C06C 0000906C  70 63 FF FF */	andi. r3, r3, 0xffff
+/* 8000C070 00009070  38 63 00 01 */	addi r3, r3, 0x1
+/* 8000C074 00009074  4E 80 00 20 */	blr
+.endfn fold_mix_c
+
+.fn bench_fold_sum, global
+/* 8000C078 00009078  94 21 FF E0 */	stwu r1, -0x20(r1)
+/* 8000C07C 0000907C  7C 08 02 A6 */	mflr r0
+/* 8000C080 00009080  90 01 00 24 */	stw r0, 0x24(r1)
+/* 8000C084 00009084  93 E1 00 1C */	stw r31, 0x1c(r1)
+/* 8000C088 00009088  93 C1 00 18 */	stw r30, 0x18(r1)
+/* 8000C08C 0000908C  93 A1 00 14 */	stw r29, 0x14(r1)
+/* 8000C090 00009090  93 81 00 10 */	stw r28, 0x10(r1)
+/* 8000C094 00009094  7C 7D 1B 78 */	mr r29, r3
+/* 8000C098 00009098  7C 9E 23 78 */	mr r30, r4
+/* 8000C09C 0000909C  3B E0 00 00 */	li r31, 0x0
+/* 8000C0A0 000090A0  3B 80 00 00 */	li r28, 0x0
+/* 8000C0A4 000090A4  2C 1E 00 00 */	cmpwi r30, 0x0
+/* 8000C0A8 000090A8  41 82 00 44 */	beq .L_8000C0EC
+.L_8000C0AC:
+/* 8000C0AC 000090AC  80 7D 00 00 */	lwz r3, 0x0(r29)
+/* 8000C0B0 000090B0  7F 84 E3 78 */	mr r4, r28
+/* 8000C0B4 000090B4  4B FF FF 4D */	bl fold_mix_a
+/* 8000C0B8 000090B8  7F FF 1A 14 */	add r31, r31, r3
+/* 8000C0BC 000090BC  80 7D 00 00 */	lwz r3, 0x0(r29)
+/* 8000C0C0 000090C0  38 9C 01 00 */	addi r4, r28, 0x100
+/* 8000C0C4 000090C4  4B FF FF 65 */	bl fold_mix_b
+/* 8000C0C8 000090C8  7F FF 1A 14 */	add r31, r31, r3
+/* 8000C0CC 000090CC  80 7D 00 00 */	lwz r3, 0x0(r29)
+/* 8000C0D0 000090D0  38 9C 02 00 */	addi r4, r28, 0x200
+/* 8000C0D4 000090D4  4B FF FF 7D */	bl fold_mix_c
+/* 8000C0D8 000090D8  7F FF 1A 14 */	add r31, r31, r3
+/* 8000C0DC 000090DC  3B BD 00 04 */	addi r29, r29, 0x4
+/* 8000C0E0 000090E0  3B 9C 00 01 */	addi r28, r28, 0x1
+/* 8000C0E4 000090E4  7C 1C F0 00 */	cmpw r28, r30
+/* 8000C0E8 000090E8  41 80 FF C4 */	blt .L_8000C0AC
+.L_8000C0EC:
+/* 8000C0EC 000090EC  7F E3 FB 78 */	mr r3, r31
+/* 8000C0F0 000090F0  80 01 00 24 */	lwz r0, 0x24(r1)
+/* 8000C0F4 000090F4  83 E1 00 1C */	lwz r31, 0x1c(r1)
+/* 8000C0F8 000090F8  83 C1 00 18 */	lwz r30, 0x18(r1)
+/* 8000C0FC 000090FC  83 A1 00 14 */	lwz r29, 0x14(r1)
+/* 8000C100 00009100  83 81 00 10 */	lwz r28, 0x10(r1)
+/* 8000C104 00009104  7C 08 03 A6 */	mtlr r0
+/* 8000C108 00009108  38 21 00 20 */	addi r1, r1, 0x20
+/* 8000C10C 0000910C  4E 80 00 20 */	blr
+.endfn bench_fold_sum
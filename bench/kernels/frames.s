@@ -0,0 +1,51 @@
+.include "macros.inc"
+.file "frames.c"
+
+.section .text, "ax"
+
+.fn frame_mix, global
+/* 8000B000 00008000  94 21 FF F0 */	stwu r1, -0x10(r1)
+/* 8000B004 00008004  93 E1 00 0C */	stw r31, 0xc(r1)
+/* 8000B008 00008008  7C 7F 1B 78 */	mr r31, r3
+/* 8000B00C 0000800C  7C 7F F9 D6 */	mullw r3, r31, r31
+/* 8000B010 00008010  38 63 00 07 */	addi r3, r3, 0x7
+/* 8000B014 00008014  3B E0 00 00 */	li r31, 0x0
+/* 8000B018 00008018  38 00 FF FF */	li r0, -0x1
+/* 8000B01C 0000801C  83 E1 00 0C */	lwz r31, 0xc(r1)
+/* 8000B020 00008020  38 21 00 10 */	addi r1, r1, 0x10
+/* 8000B024 00008024  4E 80 00 20 */	blr
+.endfn frame_mix
+
+.fn bench_frame_sum, global
+/* 8000B028 00008028  94 21 FF E0 */	stwu r1, -0x20(r1)
+/* 8000B02C 0000802C  7C 08 02 A6 */	mflr r0
+/* 8000B030 00008030  90 01 00 24 */	stw r0, 0x24(r1)
+/* 8000B034 00008034  93 E1 00 1C */	stw r31, 0x1c(r1)
+/* 8000B038 00008038  93 A1 00 14 */	stw r29, 0x14(r1)
+/* 8000B03C 0000803C  93 81 00 10 */	stw r28, 0x10(r1)
+/* 8000B040 00008040  7C 7C 1B 78 */	mr r28, r3
+/* 8000B044 00008044  7C 9D 23 78 */	mr r29, r4
+/* 8000B048 00008048  3B E0 00 00 */	li r31, 0x0
+/* 8000B04C 0000804C  2C 1D 00 00 */	cmpwi r29, 0x0
+/* 8000B050 00008050  41 82 00 2C */	beq .L_8000B07C
+.L_8000B054:
+/* 8000B054 00008054  80 7C 00 00 */	lwz r3, 0x0(r28)
+/* 8000B058 00008058  93 A1 00 08 */	stw r29, 0x8(r1)
+/* 8000B05C 0000805C  3B A0 00 00 */	li r29, 0x0
+/* 8000B060 00008060  4B FF FF A1 */	bl frame_mix
+/* 8000B064 00008064  83 A1 00 08 */	lwz r29, 0x8(r1)
+/* 8000B068 00008068  7F FF 1A 14 */	add r31, r31, r3
+/* 8000B06C 0000806C  3B 9C 00 04 */	addi r28, r28, 0x4
+/* 8000B070 00008070  3B BD FF FF */	addi r29, r29, -0x1
+/* 8000B074 00008074  2C 1D 00 00 */	cmpwi r29, 0x0
+/* 8000B078 00008078  40 82 FF DC */	bne .L_8000B054
+.L_8000B07C:
+/* 8000B07C 0000807C  7F E3 FB 78 */	mr r3, r31
+/* 8000B080 00008080  80 01 00 24 */	lwz r0, 0x24(r1)
+/* 8000B084 00008084  83 E1 00 1C */	lwz r31, 0x1c(r1)
+/* 8000B088 00008088  83 A1 00 14 */	lwz r29, 0x14(r1)
+/* 8000B08C 0000808C  83 81 00 10 */	lwz r28, 0x10(r1)
+/* 8000B090 00008090  7C 08 03 A6 */	mtlr r0
+/* 8000B094 00008094  38 21 00 20 */	addi r1, r1, 0x20
+/* 8000B098 00008098  4E 80 00 20 */	blr
+.endfn bench_frame_sum
@@ -0,0 +1,62 @@
+.include "macros.inc"
+.file "inline.c"
+
+.section .text, "ax"
+
+.fn inline_madd, global
+/* 8000D000 0000A000  7C 03 21 D6 */	mullw r0, r3, r4
+/* 8000D004 0000A004  7C 60 1A 14 */	add r3, r0, r3
+/* 8000D008 0000A008  38 63 00 05 */	addi r3, r3, 0x5
+/* 8000D00C 0000A00C  4E 80 00 20 */	blr
+.endfn inline_madd
+
+.fn inline_combine, global
+/* 8000D010 0000A010  7C 63 22 78 */	xor r3, r3, r4
+/* 8000D014 0000A014  38 63 00 03 */	addi r3, r3, 0x3
+/* 8000D018 0000A018  4E 80 00 20 */	blr
+.endfn inline_combine
+
+.fn inline_low_byte, global
+/* 8000D01C 0000A01C  54 63 06 3E */	clrlwi r3, r3, 24
+/* 8000D020 0000A020  4E 80 00 20 */	blr
+.endfn inline_low_byte
+
+.fn bench_inline_sum, global
+/* 8000D024 0000A024  94 21 FF E0 */	stwu r1, -0x20(r1)
+/* 8000D028 0000A028  7C 08 02 A6 */	mflr r0
+/* 8000D02C 0000A02C  90 01 00 24 */	stw r0, 0x24(r1)
+/* 8000D030 0000A030  93 E1 00 1C */	stw r31, 0x1c(r1)
+/* 8000D034 0000A034  93 C1 00 18 */	stw r30, 0x18(r1)
+/* 8000D038 0000A038  93 A1 00 14 */	stw r29, 0x14(r1)
+/* 8000D03C 0000A03C  93 81 00 10 */	stw r28, 0x10(r1)
+/* 8000D040 0000A040  7C 7D 1B 78 */	mr r29, r3
+/* 8000D044 0000A044  7C 9E 23 78 */	mr r30, r4
+/* 8000D048 0000A048  3B E0 00 00 */	li r31, 0x0
+/* 8000D04C 0000A04C  2C 1E 00 00 */	cmpwi r30, 0x0
+/* 8000D050 0000A050  41 82 00 3C */	beq .L_8000D08C
+.L_8000D054:
+/* 8000D054 0000A054  83 9D 00 00 */	lwz r28, 0x0(r29)
+/* 8000D058 0000A058  7F 83 E3 78 */	mr r3, r28
+/* 8000D05C 0000A05C  80 9D 00 04 */	lwz r4, 0x4(r29)
+/* 8000D060 0000A060  4B FF FF A1 */	bl inline_madd
+/* 8000D064 0000A064  7F FF 1A 14 */	add r31, r31, r3
+/* 8000D068 0000A068  7F E3 FB 78 */	mr r3, r31
+/* 8000D06C 0000A06C  7F 84 E3 78 */	mr r4, r28
+/* 8000D070 0000A070  4B FF FF A1 */	bl inline_combine
+/* 8000D074 0000A074  4B FF FF A9 */	bl inline_low_byte
+/* 8000D078 0000A078  90 7D 00 08 */	stw r3, 0x8(r29)
+/* 8000D07C 0000A07C  3B BD 00 0C */	addi r29, r29, 0xc
+/* 8000D080 0000A080  3B DE FF FF */	addi r30, r30, -0x1
+/* 8000D084 0000A084  2C 1E 00 00 */	cmpwi r30, 0x0
+/* 8000D088 0000A088  40 82 FF CC */	bne .L_8000D054
+.L_8000D08C:
+/* 8000D08C 0000A08C  7F E3 FB 78 */	mr r3, r31
+/* 8000D090 0000A090  80 01 00 24 */	lwz r0, 0x24(r1)
+/* 8000D094 0000A094  83 E1 00 1C */	lwz r31, 0x1c(r1)
+/* 8000D098 0000A098  83 C1 00 18 */	lwz r30, 0x18(r1)
+/* 8000D09C 0000A09C  83 A1 00 14 */	lwz r29, 0x14(r1)
+/* 8000D0A0 0000A0A0  83 81 00 10 */	lwz r28, 0x10(r1)
+/* 8000D0A4 0000A0A4  7C 08 03 A6 */	mtlr r0
+/* 8000D0A8 0000A0A8  38 21 00 20 */	addi r1, r1, 0x20
+/* 8000D0AC 0000A0AC  4E 80 00 20 */	blr
+.endfn bench_inline_sum
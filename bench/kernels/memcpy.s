@@ -0,0 +1,19 @@
+.include "macros.inc"
+.file "memcpy.c"
+
+.section .text, "ax"
+
+.fn bench_memcpy, global
+/* 80004000 00001000  2C 05 00 00 */	cmpwi r5, 0x0
+/* 80004004 00001004  41 82 00 1C */	beq .L_80004020
+/* 80004008 00001008  7C A9 03 A6 */	mtctr r5
+/* 8000400C 0000100C  38 84 FF FC */	addi r4, r4, -0x4
+/* 80004010 00001010  38 63 FF FC */	addi r3, r3, -0x4
+.L_80004014:
+/* 80004014 00001014  84 04 00 04 */	lwzu r0, 0x4(r4)
+/* 80004018 00001018  94 03 00 04 */	stwu r0, 0x4(r3)
+/* 8000401C 0000101C  42 00 FF F8 */	bdnz .L_80004014
+.L_80004020:
+/* 80004020 00001020  4E 80 00 20 */	blr
+.endfn bench_memcpy
+
@@ -0,0 +1,55 @@
+.include "macros.inc"
+.file "mtx_fpu.c"
+
+.section .text, "ax"
+
+.fn bench_mtx44_mul, global
+/* 80006000 00003000  38 C0 00 04 */	li r6, 0x4
+/* 80006004 00003004  7C C9 03 A6 */	mtctr r6
+.L_80006008:
+/* 80006008 00003008  C0 03 00 00 */	lfs f0, 0x0(r3)
+/* 8000600C 0000300C  C0 23 00 04 */	lfs f1, 0x4(r3)
+/* 80006010 00003010  C0 43 00 08 */	lfs f2, 0x8(r3)
+/* 80006014 00003014  C0 63 00 0C */	lfs f3, 0xc(r3)
+/* 80006018 00003018  C0 84 00 00 */	lfs f4, 0x0(r4)
+/* 8000601C 0000301C  EC A0 01 32 */	fmuls f5, f0, f4
+/* 80006020 00003020  C0 84 00 10 */	lfs f4, 0x10(r4)
+/* 80006024 00003024  EC A1 29 3A */	fmadds f5, f1, f4, f5
+/* 80006028 00003028  C0 84 00 20 */	lfs f4, 0x20(r4)
+/* 8000602C 0000302C  EC A2 29 3A */	fmadds f5, f2, f4, f5
+/* 80006030 00003030  C0 84 00 30 */	lfs f4, 0x30(r4)
+/* 80006034 00003034  EC A3 29 3A */	fmadds f5, f3, f4, f5
+/* 80006038 00003038  D0 A5 00 00 */	stfs f5, 0x0(r5)
+/* 8000603C 0000303C  C0 84 00 04 */	lfs f4, 0x4(r4)
+/* 80006040 00003040  EC A0 01 32 */	fmuls f5, f0, f4
+/* 80006044 00003044  C0 84 00 14 */	lfs f4, 0x14(r4)
+/* 80006048 00003048  EC A1 29 3A */	fmadds f5, f1, f4, f5
+/* 8000604C 0000304C  C0 84 00 24 */	lfs f4, 0x24(r4)
+/* 80006050 00003050  EC A2 29 3A */	fmadds f5, f2, f4, f5
+/* 80006054 00003054  C0 84 00 34 */	lfs f4, 0x34(r4)
+/* 80006058 00003058  EC A3 29 3A */	fmadds f5, f3, f4, f5
+/* 8000605C 0000305C  D0 A5 00 04 */	stfs f5, 0x4(r5)
+/* 80006060 00003060  C0 84 00 08 */	lfs f4, 0x8(r4)
+/* 80006064 00003064  EC A0 01 32 */	fmuls f5, f0, f4
+/* 80006068 00003068  C0 84 00 18 */	lfs f4, 0x18(r4)
+/* 8000606C 0000306C  EC A1 29 3A */	fmadds f5, f1, f4, f5
+/* 80006070 00003070  C0 84 00 28 */	lfs f4, 0x28(r4)
+/* 80006074 00003074  EC A2 29 3A */	fmadds f5, f2, f4, f5
+/* 80006078 00003078  C0 84 00 38 */	lfs f4, 0x38(r4)
+/* 8000607C 0000307C  EC A3 29 3A */	fmadds f5, f3, f4, f5
+/* 80006080 00003080  D0 A5 00 08 */	stfs f5, 0x8(r5)
+/* 80006084 00003084  C0 84 00 0C */	lfs f4, 0xc(r4)
+/* 80006088 00003088  EC A0 01 32 */	fmuls f5, f0, f4
+/* 8000608C 0000308C  C0 84 00 1C */	lfs f4, 0x1c(r4)
+/* 80006090 00003090  EC A1 29 3A */	fmadds f5, f1, f4, f5
+/* 80006094 00003094  C0 84 00 2C */	lfs f4, 0x2c(r4)
+/* 80006098 00003098  EC A2 29 3A */	fmadds f5, f2, f4, f5
+/* 8000609C 0000309C  C0 84 00 3C */	lfs f4, 0x3c(r4)
+/* 800060A0 000030A0  EC A3 29 3A */	fmadds f5, f3, f4, f5
+/* 800060A4 000030A4  D0 A5 00 0C */	stfs f5, 0xc(r5)
+/* 800060A8 000030A8  38 63 00 10 */	addi r3, r3, 0x10
+/* 800060AC 000030AC  38 A5 00 10 */	addi r5, r5, 0x10
+/* 800060B0 000030B0  42 00 FF 58 */	bdnz .L_80006008
+/* 800060B4 000030B4  4E 80 00 20 */	blr
+.endfn bench_mtx44_mul
+
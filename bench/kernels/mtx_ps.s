@@ -0,0 +1,35 @@
+.include "macros.inc"
+.file "mtx_ps.c"
+
+.section .text, "ax"
+
+.fn bench_mtx44_mul_ps, global
+/* 80007000 00004000  38 C0 00 04 */	li r6, 0x4
+/* 80007004 00004004  7C C9 03 A6 */	mtctr r6
+.L_80007008:
+/* 80007008 00004008  E0 03 00 00 */	psq_l f0, 0x0(r3), 0, qr0
+/* 8000700C 0000400C  E0 23 00 08 */	psq_l f1, 0x8(r3), 0, qr0
+/* 80007010 00004010  E0 44 00 00 */	psq_l f2, 0x0(r4), 0, qr0
+/* 80007014 00004014  E0 64 00 10 */	psq_l f3, 0x10(r4), 0, qr0
+/* 80007018 00004018  E0 84 00 20 */	psq_l f4, 0x20(r4), 0, qr0
+/* 8000701C 0000401C  E0 A4 00 30 */	psq_l f5, 0x30(r4), 0, qr0
+/* 80007020 00004020  10 C2 00 18 */	ps_muls0 f6, f2, f0
+/* 80007024 00004024  10 C3 30 1E */	ps_madds1 f6, f3, f0, f6
+/* 80007028 00004028  10 C4 30 5C */	ps_madds0 f6, f4, f1, f6
+/* 8000702C 0000402C  10 C5 30 5E */	ps_madds1 f6, f5, f1, f6
+/* 80007030 00004030  F0 C5 00 00 */	psq_st f6, 0x0(r5), 0, qr0
+/* 80007034 00004034  E0 44 00 08 */	psq_l f2, 0x8(r4), 0, qr0
+/* 80007038 00004038  E0 64 00 18 */	psq_l f3, 0x18(r4), 0, qr0
+/* 8000703C 0000403C  E0 84 00 28 */	psq_l f4, 0x28(r4), 0, qr0
+/* 80007040 00004040  E0 A4 00 38 */	psq_l f5, 0x38(r4), 0, qr0
+/* 80007044 00004044  10 C2 00 18 */	ps_muls0 f6, f2, f0
+/* 80007048 00004048  10 C3 30 1E */	ps_madds1 f6, f3, f0, f6
+/* 8000704C 0000404C  10 C4 30 5C */	ps_madds0 f6, f4, f1, f6
+/* 80007050 00004050  10 C5 30 5E */	ps_madds1 f6, f5, f1, f6
+/* 80007054 00004054  F0 C5 00 08 */	psq_st f6, 0x8(r5), 0, qr0
+/* 80007058 00004058  38 63 00 10 */	addi r3, r3, 0x10
+/* 8000705C 0000405C  38 A5 00 10 */	addi r5, r5, 0x10
+/* 80007060 00004060  42 00 FF A8 */	bdnz .L_80007008
+/* 80007064 00004064  4E 80 00 20 */	blr
+.endfn bench_mtx44_mul_ps
+
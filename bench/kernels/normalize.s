@@ -0,0 +1,35 @@
+.include "macros.inc"
+.file "normalize.c"
+
+.section .text, "ax"
+
+.fn bench_vec_normalize, global
+/* 80008000 00005000  2C 04 00 00 */	cmpwi r4, 0x0
+/* 80008004 00005004  41 82 00 5C */	beq .L_80008060
+/* 80008008 00005008  7C 89 03 A6 */	mtctr r4
+/* 8000800C 0000500C  C0 C5 00 00 */	lfs f6, 0x0(r5)
+/* 80008010 00005010  C0 E5 00 04 */	lfs f7, 0x4(r5)
+.L_80008014:
+/* 80008014 00005014  C0 03 00 00 */	lfs f0, 0x0(r3)
+/* 80008018 00005018  C0 23 00 04 */	lfs f1, 0x4(r3)
+/* 8000801C 0000501C  C0 43 00 08 */	lfs f2, 0x8(r3)
+/* 80008020 00005020  EC 60 00 32 */	fmuls f3, f0, f0
+/* 80008024 00005024  EC 61 18 7A */	fmadds f3, f1, f1, f3
+/* 80008028 00005028  EC 62 18 BA */	fmadds f3, f2, f2, f3
+/* 8000802C 0000502C  FC 80 18 34 */	frsqrte f4, f3
+/* 80008030 00005030  ED 04 01 32 */	fmuls f8, f4, f4
+/* 80008034 00005034  ED 03 3A 3C */	fnmsubs f8, f3, f8, f7
+/* 80008038 00005038  EC 84 01 B2 */	fmuls f4, f4, f6
+/* 8000803C 0000503C  EC 84 02 32 */	fmuls f4, f4, f8
+/* 80008040 00005040  EC 00 01 32 */	fmuls f0, f0, f4
+/* 80008044 00005044  EC 21 01 32 */	fmuls f1, f1, f4
+/* 80008048 00005048  EC 42 01 32 */	fmuls f2, f2, f4
+/* 8000804C 0000504C  D0 03 00 00 */	stfs f0, 0x0(r3)
+/* 80008050 00005050  D0 23 00 04 */	stfs f1, 0x4(r3)
+/* 80008054 00005054  D0 43 00 08 */	stfs f2, 0x8(r3)
+/* 80008058 00005058  38 63 00 0C */	addi r3, r3, 0xc
+/* 8000805C 0000505C  42 00 FF B8 */	bdnz .L_80008014
+.L_80008060:
+/* 80008060 00005060  4E 80 00 20 */	blr
+.endfn bench_vec_normalize
+
@@ -0,0 +1,15 @@
+.include "macros.inc"
+.file "strlen.c"
+
+.section .text, "ax"
+
+.fn bench_strlen, global
+/* 80005000 00002000  38 83 FF FF */	addi r4, r3, -0x1
+.L_80005004:
+/* 80005004 00002004  8C 04 00 01 */	lbzu r0, 0x1(r4)
+/* 80005008 00002008  2C 00 00 00 */	cmpwi r0, 0x0
+/* 8000500C 0000200C  40 82 FF F8 */	bne .L_80005004
+/* 80005010 00002010  7C 63 20 50 */	subf r3, r3, r4
+/* 80005014 00002014  4E 80 00 20 */	blr
+.endfn bench_strlen
+
@@ -0,0 +1,56 @@
+.include "macros.inc"
+.file "/tmp/kern/tokens.c"
+
+.section .text, "ax"
+
+.fn bench_count_tokens, global
+/* 80009000 00006000  38 A0 00 00 */	li r5, 0x0
+/* 80009004 00006004  38 C0 00 00 */	li r6, 0x0
+/* 80009008 00006008  2C 04 00 00 */	cmpwi r4, 0x0
+/* 8000900C 0000600C  41 82 00 8C */	beq .L_80009098
+/* 80009010 00006010  7C 89 03 A6 */	mtctr r4
+.L_80009014:
+/* 80009014 00006014  89 23 00 00 */	lbz r9, 0x0(r3)
+/* 80009018 00006018  38 63 00 01 */	addi r3, r3, 0x1
+/* 8000901C 0000601C  38 E0 00 01 */	li r7, 0x1
+/* 80009020 00006020  28 09 00 20 */	cmplwi r9, 0x20
+/* 80009024 00006024  41 81 00 0C */	bgt .L_80009030
+/* 80009028 00006028  38 E0 00 00 */	li r7, 0x0
+/* 8000902C 0000602C  48 00 00 14 */	b .L_80009040
+.L_80009030:
+/* 80009030 00006030  39 09 FF D0 */	addi r8, r9, -0x30
+/* 80009034 00006034  28 08 00 09 */	cmplwi r8, 0x9
+/* 80009038 00006038  41 81 00 08 */	bgt .L_80009040
+/* 8000903C 0000603C  38 E0 00 02 */	li r7, 0x2
+.L_80009040:
+/* 80009040 00006040  2C 05 00 01 */	cmpwi r5, 0x1
+/* 80009044 00006044  41 82 00 20 */	beq .L_80009064
+/* 80009048 00006048  2C 05 00 02 */	cmpwi r5, 0x2
+/* 8000904C 0000604C  41 82 00 28 */	beq .L_80009074
+/* 80009050 00006050  2C 07 00 00 */	cmpwi r7, 0x0
+/* 80009054 00006054  41 82 00 40 */	beq .L_80009094
+/* 80009058 00006058  38 C6 00 01 */	addi r6, r6, 0x1
+/* 8000905C 0000605C  7C E5 3B 78 */	mr r5, r7
+/* 80009060 00006060  48 00 00 34 */	b .L_80009094
+.L_80009064:
+/* 80009064 00006064  2C 07 00 00 */	cmpwi r7, 0x0
+/* 80009068 00006068  40 82 00 2C */	bne .L_80009094
+/* 8000906C 0000606C  38 A0 00 00 */	li r5, 0x0
+/* 80009070 00006070  48 00 00 24 */	b .L_80009094
+.L_80009074:
+/* 80009074 00006074  2C 07 00 02 */	cmpwi r7, 0x2
+/* 80009078 00006078  41 82 00 1C */	beq .L_80009094
+/* 8000907C 0000607C  2C 07 00 00 */	cmpwi r7, 0x0
+/* 80009080 00006080  41 82 00 10 */	beq .L_80009090
+/* 80009084 00006084  38 C6 00 01 */	addi r6, r6, 0x1
+/* 80009088 00006088  38 A0 00 01 */	li r5, 0x1
+/* 8000908C 0000608C  48 00 00 08 */	b .L_80009094
+.L_80009090:
+/* 80009090 00006090  38 A0 00 00 */	li r5, 0x0
+.L_80009094:
+/* 80009094 00006094  42 00 FF 80 */	bdnz .L_80009014
+.L_80009098:
+/* 80009098 00006098  7C C3 33 78 */	mr r3, r6
+/* 8000909C 0000609C  4E 80 00 20 */	blr
+.endfn bench_count_tokens
+
@@ -0,0 +1,60 @@
+.include "macros.inc"
+.file "vtable.c"
+
+.section .text, "ax"
+
+.fn Square_area, global
+/* 8000A000 00007000  80 63 00 04 */	lwz r3, 0x4(r3)
+/* 8000A004 00007004  7C 63 19 D6 */	mullw r3, r3, r3
+/* 8000A008 00007008  4E 80 00 20 */	blr
+.endfn Square_area
+
+.fn Circle_area, global
+/* 8000A00C 0000700C  80 63 00 04 */	lwz r3, 0x4(r3)
+/* 8000A010 00007010  7C 63 19 D6 */	mullw r3, r3, r3
+/* 8000A014 00007014  1C 63 00 03 */	mulli r3, r3, 0x3
+/* 8000A018 00007018  4E 80 00 20 */	blr
+.endfn Circle_area
+
+.fn Triangle_area, global
+/* 8000A01C 0000701C  80 83 00 04 */	lwz r4, 0x4(r3)
+/* 8000A020 00007020  80 63 00 08 */	lwz r3, 0x8(r3)
+/* 8000A024 00007024  7C 63 21 D6 */	mullw r3, r3, r4
+/* 8000A028 00007028  7C 63 0E 70 */	srawi r3, r3, 1
+/* 8000A02C 0000702C  4E 80 00 20 */	blr
+.endfn Triangle_area
+
+.fn bench_sum_areas, global
+/* 8000A030 00007030  94 21 FF E0 */	stwu r1, -0x20(r1)
+/* 8000A034 00007034  7C 08 02 A6 */	mflr r0
+/* 8000A038 00007038  90 01 00 24 */	stw r0, 0x24(r1)
+/* 8000A03C 0000703C  93 E1 00 1C */	stw r31, 0x1c(r1)
+/* 8000A040 00007040  93 C1 00 18 */	stw r30, 0x18(r1)
+/* 8000A044 00007044  93 A1 00 14 */	stw r29, 0x14(r1)
+/* 8000A048 00007048  7C 7F 1B 78 */	mr r31, r3
+/* 8000A04C 0000704C  7C 9E 23 78 */	mr r30, r4
+/* 8000A050 00007050  3B A0 00 00 */	li r29, 0x0
+/* 8000A054 00007054  2C 1E 00 00 */	cmpwi r30, 0x0
+/* 8000A058 00007058  41 82 00 2C */	beq .L_8000A084
+.L_8000A05C:
+/* 8000A05C 0000705C  80 7F 00 00 */	lwz r3, 0x0(r31)
+/* 8000A060 00007060  81 83 00 00 */	lwz r12, 0x0(r3)
+/* 8000A064 00007064  81 8C 00 08 */	lwz r12, 0x8(r12)
+/* 8000A068 00007068  7D 89 03 A6 */	mtctr r12
+/* 8000A06C 0000706C  4E 80 04 21 */	bctrl
+/* 8000A070 00007070  7F BD 1A 14 */	add r29, r29, r3
+/* 8000A074 00007074  3B FF 00 04 */	addi r31, r31, 0x4
+/* 8000A078 00007078  3B DE FF FF */	addi r30, r30, -0x1
+/* 8000A07C 0000707C  2C 1E 00 00 */	cmpwi r30, 0x0
+/* 8000A080 00007080  40 82 FF DC */	bne .L_8000A05C
+.L_8000A084:
+/* 8000A084 00007084  7F A3 EB 78 */	mr r3, r29
+/* 8000A088 00007088  80 01 00 24 */	lwz r0, 0x24(r1)
+/* 8000A08C 0000708C  83 E1 00 1C */	lwz r31, 0x1c(r1)
+/* 8000A090 00007090  83 C1 00 18 */	lwz r30, 0x18(r1)
+/* 8000A094 00007094  83 A1 00 14 */	lwz r29, 0x14(r1)
+/* 8000A098 00007098  7C 08 03 A6 */	mtlr r0
+/* 8000A09C 0000709C  38 21 00 20 */	addi r1, r1, 0x20
+/* 8000A0A0 000070A0  4E 80 00 20 */	blr
+.endfn bench_sum_areas
+
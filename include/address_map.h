@@ -0,0 +1,164 @@
+/**
+ * @file address_map.h
+ * @brief Single source of truth for the GameCube/Wii guest address space
+ *
+ * Every guest-to-host and virtual-to-physical translation goes through the
+ * tables below: the transpiler's constant folding, the convert_gc_address()
+ * table emitted into generated projects, and gecko_translate_address().
+ * All of them are expanded from the one window list, GC_REGION_LIST.
+ *
+ * Lookups go through a 256-entry table indexed by the top address byte, so a
+ * translation is one load, one compare and a select.
+ */
+
+#ifndef ADDRESS_MAP_H
+#define ADDRESS_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// HOST BUFFER LAYOUT (offsets into the generated project's 256 MB `mem`)
+//==============================================================================
+#define GC_HOST_MEM1            0x00000000  // MEM1 + headroom (64 MB)
+#define GC_HOST_MEM2            0x04000000  // MEM2 (64 MB, Wii)
+#define GC_HOST_HWIO            0x08000000  // Hardware I/O shadow (64 KB)
+#define GC_HOST_LOCKED_CACHE    0x08010000  // Locked L1 cache (64 KB)
+
+#define GC_ADDRESS_SLOT_SHIFT   24
+#define GC_ADDRESS_SLOT_COUNT   256
+#define GC_ADDRESS_SLOT_SIZE    (1u << GC_ADDRESS_SLOT_SHIFT)
+#define GC_ADDRESS_SLOT_MASK    (GC_ADDRESS_SLOT_SIZE - 1)
+
+//==============================================================================
+// REGION LIST
+//==============================================================================
+
+/**
+ * @brief Every mapped window, X(i, gc_base, size, phys_base, host_offset, name)
+ * The only place the map is written down: gc_regions and both slot tables are
+ * expanded from it. Windows start on a 16 MB slot boundary; one smaller than a
+ * slot maps the start of its slot. `i` is the slot being expanded (unused by
+ * gc_regions).
+ */
+#define GC_REGION_LIST(X, i) \
+    X(i, 0x80000000, 0x04000000, 0x00000000, GC_HOST_MEM1,         "MEM1 cached") \
+    X(i, 0xC0000000, 0x02000000, 0x00000000, GC_HOST_MEM1,         "MEM1 uncached") \
+    X(i, 0x90000000, 0x04000000, 0x10000000, GC_HOST_MEM2,         "MEM2 cached") \
+    X(i, 0xD0000000, 0x04000000, 0x10000000, GC_HOST_MEM2,         "MEM2 uncached") \
+    X(i, 0xCC000000, 0x00010000, 0x0C000000, GC_HOST_HWIO,         "Hardware I/O") \
+    X(i, 0xE0000000, 0x00010000, 0xE0000000, GC_HOST_LOCKED_CACHE, "Locked cache")
+
+typedef struct {
+    uint32_t gc_base;       // First guest (effective) address
+    uint32_t size;          // Size of the window in bytes
+    uint32_t phys_base;     // Physical address of gc_base
+    uint32_t host_offset;   // Offset of gc_base in the host buffer
+    const char *name;
+} GC_Region;
+
+#define GC_REGION_ENTRY(i, gc_base, size, phys_base, host_offset, name) \
+    { gc_base, size, phys_base, host_offset, name },
+
+static const GC_Region gc_regions[] = {
+    GC_REGION_LIST(GC_REGION_ENTRY, 0)
+};
+
+#define GC_REGION_COUNT ((int)(sizeof(gc_regions) / sizeof(gc_regions[0])))
+
+/**
+ * @brief Find the region containing a guest address
+ * @return Region descriptor, or NULL if the address is unmapped
+ */
+static inline const GC_Region* gc_address_region(uint32_t addr) {
+    for (int r = 0; r < GC_REGION_COUNT; r++) {
+        if (addr - gc_regions[r].gc_base < gc_regions[r].size) return &gc_regions[r];
+    }
+    return NULL;
+}
+
+//==============================================================================
+// BYTE-INDEXED LOOKUP TABLE
+//==============================================================================
+
+/**
+ * @brief One 16 MB slot of the address space
+ * Addresses whose low 24 bits are below `limit` translate to `base + low`;
+ * everything else (limit 0 for unmapped slots) is passed through unchanged.
+ */
+typedef struct {
+    uint32_t base;
+    uint32_t limit;
+} GC_AddressSlot;
+
+// Slot i against one window: offset of the slot into the window, and whether it is mapped
+#define GC_SLOT_START(i)                ((uint32_t)(i) << GC_ADDRESS_SLOT_SHIFT)
+#define GC_SLOT_OFFSET(i, gc_base)      (GC_SLOT_START(i) - (uint32_t)(gc_base))
+#define GC_SLOT_IN(i, gc_base, size)    (GC_SLOT_OFFSET(i, gc_base) < (uint32_t)(size))
+
+// Per-window terms, summed over GC_REGION_LIST (windows do not overlap, so at most one is non-zero)
+#define GC_SLOT_HOST_TERM(i, gc_base, size, phys_base, host_offset, name) \
+    (GC_SLOT_IN(i, gc_base, size) ? (uint32_t)(host_offset) + GC_SLOT_OFFSET(i, gc_base) : 0u) +
+#define GC_SLOT_PHYS_TERM(i, gc_base, size, phys_base, host_offset, name) \
+    (GC_SLOT_IN(i, gc_base, size) ? (uint32_t)(phys_base) + GC_SLOT_OFFSET(i, gc_base) : 0u) +
+#define GC_SLOT_LIMIT_TERM(i, gc_base, size, phys_base, host_offset, name) \
+    (!GC_SLOT_IN(i, gc_base, size) ? 0u : \
+     (uint32_t)(size) - GC_SLOT_OFFSET(i, gc_base) < GC_ADDRESS_SLOT_SIZE ? \
+     (uint32_t)(size) - GC_SLOT_OFFSET(i, gc_base) : GC_ADDRESS_SLOT_SIZE) +
+
+#define GC_HOST_SLOT(i) { GC_REGION_LIST(GC_SLOT_HOST_TERM, i) 0u, GC_REGION_LIST(GC_SLOT_LIMIT_TERM, i) 0u },
+#define GC_PHYS_SLOT(i) { GC_REGION_LIST(GC_SLOT_PHYS_TERM, i) 0u, GC_REGION_LIST(GC_SLOT_LIMIT_TERM, i) 0u },
+
+#define GC_SLOTS_16(S, hi) \
+    S((hi) * 16 + 0)  S((hi) * 16 + 1)  S((hi) * 16 + 2)  S((hi) * 16 + 3)  \
+    S((hi) * 16 + 4)  S((hi) * 16 + 5)  S((hi) * 16 + 6)  S((hi) * 16 + 7)  \
+    S((hi) * 16 + 8)  S((hi) * 16 + 9)  S((hi) * 16 + 10) S((hi) * 16 + 11) \
+    S((hi) * 16 + 12) S((hi) * 16 + 13) S((hi) * 16 + 14) S((hi) * 16 + 15)
+#define GC_SLOTS_256(S) \
+    GC_SLOTS_16(S, 0)  GC_SLOTS_16(S, 1)  GC_SLOTS_16(S, 2)  GC_SLOTS_16(S, 3)  \
+    GC_SLOTS_16(S, 4)  GC_SLOTS_16(S, 5)  GC_SLOTS_16(S, 6)  GC_SLOTS_16(S, 7)  \
+    GC_SLOTS_16(S, 8)  GC_SLOTS_16(S, 9)  GC_SLOTS_16(S, 10) GC_SLOTS_16(S, 11) \
+    GC_SLOTS_16(S, 12) GC_SLOTS_16(S, 13) GC_SLOTS_16(S, 14) GC_SLOTS_16(S, 15)
+
+/**
+ * @brief Guest address -> offset in the host buffer, per top address byte
+ * Expanded from GC_REGION_LIST; statically initialized so lookups need no
+ * setup and are safe from any thread.
+ */
+static const GC_AddressSlot gc_host_slots[GC_ADDRESS_SLOT_COUNT] = {
+    GC_SLOTS_256(GC_HOST_SLOT)
+};
+
+/**
+ * @brief Guest (effective) address -> physical address, per top address byte
+ */
+static const GC_AddressSlot gc_phys_slots[GC_ADDRESS_SLOT_COUNT] = {
+    GC_SLOTS_256(GC_PHYS_SLOT)
+};
+
+/**
+ * @brief Translate an address through a slot table
+ * @param slots gc_host_slots or gc_phys_slots
+ * @param addr Guest address
+ * @param out Receives the translated address (may be NULL)
+ * @return true if the address falls inside a known region
+ */
+static inline bool gc_address_map_lookup(const GC_AddressSlot *slots, uint32_t addr, uint32_t *out) {
+    const GC_AddressSlot *slot = &slots[addr >> GC_ADDRESS_SLOT_SHIFT];
+    uint32_t low = addr & GC_ADDRESS_SLOT_MASK;
+    bool hit = low < slot->limit;
+
+    if (out) *out = hit ? slot->base + low : addr;
+    return hit;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADDRESS_MAP_H
@@ -0,0 +1,395 @@
+/**
+ * @file binary_loader.h
+ * @brief DOL/ELF executable loader for direct instruction decoding
+ *
+ * Maps a GameCube/Wii executable into memory and exposes its section table so
+ * instruction words can be fed straight into transpile_instruction() without a
+ * disassembly round trip. Function names come from the ELF symbol table and/or
+ * a symbol map (symbol_map.h); anything left unnamed is called fn_XXXXXXXX.
+ *
+ * Supported inputs:
+ *   - .dol  (7 text + 11 data sections, 0x100 byte big-endian header)
+ *   - ELF32 big-endian PowerPC (section headers + .symtab)
+ */
+
+#ifndef BINARY_LOADER_H
+#define BINARY_LOADER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+
+#define BINARY_MAX_SECTIONS     64
+#define BINARY_MAX_SYMBOL_NAME  128
+
+#define DOL_HEADER_SIZE         0x100
+#define DOL_TEXT_SECTIONS       7
+#define DOL_DATA_SECTIONS       11
+
+//==============================================================================
+// STRUCTURES
+//==============================================================================
+
+/**
+ * @brief One loadable section of the executable
+ */
+typedef struct {
+    char name[32];              // ".text0" / ".data3" for DOL, section name for ELF
+    uint32_t address;           // Load address
+    uint32_t size;              // Size in bytes
+    uint32_t file_offset;       // Offset of the contents in the file (unused for bss)
+    bool is_code;               // Executable section
+} Binary_Section;
+
+/**
+ * @brief Named address (function entry point)
+ */
+typedef struct {
+    char name[BINARY_MAX_SYMBOL_NAME];
+    uint32_t address;
+    uint32_t size;              // 0 if unknown
+} Binary_Symbol;
+
+/**
+ * @brief Mapped executable with its section table and symbols
+ */
+typedef struct {
+    const uint8_t *data;        // File contents (mapped or read)
+    size_t size;
+    bool mapped;                // data came from mmap() rather than malloc()
+    bool is_elf;
+
+    Binary_Section sections[BINARY_MAX_SECTIONS];
+    int section_count;
+    uint32_t entry_point;
+
+    Binary_Symbol *symbols;     // Sorted by address after binary_sort_symbols()
+    int symbol_count;
+    int symbol_capacity;
+} Binary_Image;
+
+//==============================================================================
+// BYTE ACCESS
+//==============================================================================
+
+static inline uint32_t binary_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint16_t binary_be16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Check that [offset, offset + size) lies inside the file
+ */
+static inline bool binary_in_file(const Binary_Image *img, uint32_t offset, uint32_t size) {
+    return offset <= img->size && size <= img->size - offset;
+}
+
+/**
+ * @brief Read the instruction word at a guest address inside a section
+ */
+static inline uint32_t binary_section_word(const Binary_Image *img, const Binary_Section *sec, uint32_t addr) {
+    return binary_be32(img->data + sec->file_offset + (addr - sec->address));
+}
+
+/**
+ * @brief Branch target of a b/bl (opcode 18) or bc (opcode 16) word
+ * @return true if the word is a direct branch
+ */
+static inline bool binary_branch_target(uint32_t word, uint32_t address, uint32_t *target) {
+    uint32_t opcode = word >> 26;
+    bool absolute = (word & 0x2) != 0;
+    int32_t displacement;
+
+    if (opcode == 18) {
+        displacement = (int32_t)((word & 0x03FFFFFC) << 6) >> 6;
+    } else if (opcode == 16) {
+        displacement = (int16_t)(word & 0xFFFC);
+    } else {
+        return false;
+    }
+
+    *target = absolute ? (uint32_t)displacement : address + (uint32_t)displacement;
+    return true;
+}
+
+//==============================================================================
+// SYMBOLS
+//==============================================================================
+
+/**
+ * @brief Add a symbol (duplicate addresses are resolved by binary_sort_symbols)
+ */
+static inline bool binary_add_symbol(Binary_Image *img, const char *name, uint32_t address, uint32_t size) {
+    if (img->symbol_count >= img->symbol_capacity) {
+        int new_capacity = img->symbol_capacity ? img->symbol_capacity * 2 : 1024;
+        Binary_Symbol *grown = (Binary_Symbol*)realloc(img->symbols, sizeof(Binary_Symbol) * new_capacity);
+        if (!grown) return false;
+        img->symbols = grown;
+        img->symbol_capacity = new_capacity;
+    }
+
+    Binary_Symbol *sym = &img->symbols[img->symbol_count++];
+    strncpy(sym->name, name, BINARY_MAX_SYMBOL_NAME - 1);
+    sym->name[BINARY_MAX_SYMBOL_NAME - 1] = '\0';
+    sym->address = address;
+    sym->size = size;
+    return true;
+}
+
+static inline int binary_symbol_compare(const void *a, const void *b) {
+    uint32_t x = ((const Binary_Symbol*)a)->address;
+    uint32_t y = ((const Binary_Symbol*)b)->address;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sort symbols by address and drop duplicates (real names beat fn_ placeholders)
+ */
+static inline void binary_sort_symbols(Binary_Image *img) {
+    if (img->symbol_count < 2) return;
+    qsort(img->symbols, img->symbol_count, sizeof(Binary_Symbol), binary_symbol_compare);
+
+    int out = 0;
+    for (int i = 0; i < img->symbol_count; i++) {
+        if (out > 0 && img->symbols[out - 1].address == img->symbols[i].address) {
+            // Keep the named entry over an auto-generated fn_ placeholder
+            if (strncmp(img->symbols[out - 1].name, "fn_", 3) == 0 &&
+                strncmp(img->symbols[i].name, "fn_", 3) != 0) {
+                img->symbols[out - 1] = img->symbols[i];
+            }
+            continue;
+        }
+        img->symbols[out++] = img->symbols[i];
+    }
+    img->symbol_count = out;
+}
+
+/**
+ * @brief Find the symbol starting exactly at an address (symbols must be sorted)
+ */
+static inline const Binary_Symbol* binary_find_symbol(const Binary_Image *img, uint32_t address) {
+    int lo = 0, hi = img->symbol_count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        uint32_t a = img->symbols[mid].address;
+        if (a == address) return &img->symbols[mid];
+        if (a < address) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief True if a name can be used verbatim as a C identifier
+ */
+static inline bool binary_is_c_identifier(const char *name) {
+    if (!name[0] || isdigit((unsigned char)name[0])) return false;
+    for (const char *p = name; *p; p++) {
+        if (!isalnum((unsigned char)*p) && *p != '_') return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// FORMAT PARSERS
+//==============================================================================
+
+static inline void binary_add_section(Binary_Image *img, const char *name, uint32_t address,
+                                      uint32_t size, uint32_t file_offset, bool is_code) {
+    if (img->section_count >= BINARY_MAX_SECTIONS || size == 0) return;
+    Binary_Section *sec = &img->sections[img->section_count++];
+    snprintf(sec->name, sizeof(sec->name), "%s", name);
+    sec->address = address;
+    sec->size = size;
+    sec->file_offset = file_offset;
+    sec->is_code = is_code;
+}
+
+/**
+ * @brief Parse a DOL header: 7 text and 11 data (offset, address, size) triples
+ */
+static inline bool binary_parse_dol(Binary_Image *img) {
+    if (img->size < DOL_HEADER_SIZE) return false;
+    const uint8_t *h = img->data;
+
+    for (int i = 0; i < DOL_TEXT_SECTIONS + DOL_DATA_SECTIONS; i++) {
+        uint32_t offset = binary_be32(h + 0x00 + i * 4);
+        uint32_t address = binary_be32(h + 0x48 + i * 4);
+        uint32_t size = binary_be32(h + 0x90 + i * 4);
+        if (size == 0) continue;
+        if (!binary_in_file(img, offset, size)) return false;
+
+        bool is_code = i < DOL_TEXT_SECTIONS;
+        char name[32];
+        snprintf(name, sizeof(name), is_code ? ".text%d" : ".data%d",
+                 is_code ? i : i - DOL_TEXT_SECTIONS);
+        binary_add_section(img, name, address, size, offset, is_code);
+    }
+
+    img->entry_point = binary_be32(h + 0xE0);
+    return img->section_count > 0;
+}
+
+/**
+ * @brief Parse an ELF32 big-endian PowerPC executable and its STT_FUNC symbols
+ */
+static inline bool binary_parse_elf(Binary_Image *img) {
+    const uint8_t *e = img->data;
+    if (img->size < 52 || e[4] != 1 || e[5] != 2) return false;  // ELFCLASS32, ELFDATA2MSB
+    if (binary_be16(e + 18) != 20) return false;                    // EM_PPC
+
+    uint32_t shoff = binary_be32(e + 32);
+    uint16_t shentsize = binary_be16(e + 46);
+    uint16_t shnum = binary_be16(e + 48);
+    uint16_t shstrndx = binary_be16(e + 50);
+    if (shentsize < 40 || shstrndx >= shnum) return false;
+    if (!binary_in_file(img, shoff, (uint32_t)shentsize * shnum)) return false;
+
+    img->entry_point = binary_be32(e + 24);
+
+    #define ELF_SH(i) (e + shoff + (uint32_t)(i) * shentsize)
+    uint32_t strtab_off = binary_be32(ELF_SH(shstrndx) + 16);
+    uint32_t strtab_size = binary_be32(ELF_SH(shstrndx) + 20);
+    if (!binary_in_file(img, strtab_off, strtab_size)) return false;
+
+    for (uint16_t i = 0; i < shnum; i++) {
+        const uint8_t *sh = ELF_SH(i);
+        uint32_t name_off = binary_be32(sh + 0);
+        uint32_t type = binary_be32(sh + 4);
+        uint32_t flags = binary_be32(sh + 8);
+        uint32_t addr = binary_be32(sh + 12);
+        uint32_t offset = binary_be32(sh + 16);
+        uint32_t size = binary_be32(sh + 20);
+
+        // SHT_PROGBITS with SHF_ALLOC, loaded at a non-zero address
+        if (type == 1 && (flags & 0x2) && addr != 0 && binary_in_file(img, offset, size)) {
+            const char *name = name_off < strtab_size ? (const char*)e + strtab_off + name_off : "";
+            binary_add_section(img, name, addr, size, offset, (flags & 0x4) != 0);  // SHF_EXECINSTR
+        }
+
+        // SHT_SYMTAB: collect STT_FUNC symbols, names from the linked string table
+        if (type == 2 && binary_in_file(img, offset, size)) {
+            uint32_t link = binary_be32(sh + 24);
+            if (link >= shnum) continue;
+            uint32_t names_off = binary_be32(ELF_SH(link) + 16);
+            uint32_t names_size = binary_be32(ELF_SH(link) + 20);
+            if (!binary_in_file(img, names_off, names_size)) continue;
+
+            for (uint32_t s = 0; s + 16 <= size; s += 16) {
+                const uint8_t *sym = e + offset + s;
+                uint32_t sym_name = binary_be32(sym + 0);
+                uint32_t value = binary_be32(sym + 4);
+                uint32_t sym_size = binary_be32(sym + 8);
+                if ((sym[12] & 0xF) != 2 || sym_name >= names_size || value == 0) continue;  // STT_FUNC
+                binary_add_symbol(img, (const char*)e + names_off + sym_name, value, sym_size);
+            }
+        }
+    }
+    #undef ELF_SH
+
+    return img->section_count > 0;
+}
+
+//==============================================================================
+// OPEN / CLOSE
+//==============================================================================
+
+/**
+ * @brief Unmap the executable and free the symbol table
+ */
+static inline void binary_image_close(Binary_Image *img) {
+    if (img->data) {
+#ifndef _WIN32
+        if (img->mapped) munmap((void*)img->data, img->size);
+        else free((void*)img->data);
+#else
+        free((void*)img->data);
+#endif
+    }
+    free(img->symbols);
+    memset(img, 0, sizeof(*img));
+}
+
+/**
+ * @brief Map an executable and parse its section table
+ * @return 0 on success, -1 if the file cannot be read or is not a DOL/ELF
+ */
+static inline int binary_image_open(Binary_Image *img, const char *path) {
+    memset(img, 0, sizeof(*img));
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+    void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return -1;
+    img->data = (const uint8_t*)mapped;
+    img->size = (size_t)st.st_size;
+    img->mapped = true;
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buffer = length > 0 ? (uint8_t*)malloc((size_t)length) : NULL;
+    if (!buffer || fread(buffer, 1, (size_t)length, f) != (size_t)length) {
+        free(buffer);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    img->data = buffer;
+    img->size = (size_t)length;
+#endif
+
+    img->is_elf = img->size >= 4 && memcmp(img->data, "\x7F" "ELF", 4) == 0;
+    bool ok = img->is_elf ? binary_parse_elf(img) : binary_parse_dol(img);
+    if (!ok) {
+        binary_image_close(img);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief True if a path names a supported executable (.dol or .elf)
+ */
+static inline bool binary_is_executable_path(const char *path) {
+    const char *ext = strrchr(path, '.');
+    if (!ext) return false;
+    char lower[8] = {0};
+    for (int i = 0; i < 7 && ext[i]; i++) lower[i] = (char)tolower((unsigned char)ext[i]);
+    return strcmp(lower, ".dol") == 0 || strcmp(lower, ".elf") == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BINARY_LOADER_H
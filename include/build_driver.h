@@ -0,0 +1,522 @@
+/**
+ * @file build_driver.h
+ * @brief `porpoise_tool build`: parallel compile of a generated project with an object cache
+ *
+ * The transpiler writes porpoise_build.txt next to CMakeLists.txt: the project
+ * name, compiler and linker flags, and every translation unit. The driver
+ * preprocesses each unit, hashes the preprocessed text together with the
+ * compiler identity and flags, and only compiles units whose hash has no object
+ * in the cache yet. A touched but unchanged file, or a file regenerated with the
+ * same contents, costs a preprocess and no compile.
+ *
+ * Units run on a pool of worker threads, largest first, so a long file starts
+ * early instead of finishing alone at the end of the build.
+ *
+ * The cache is <project>/.porpoise_cache, or $PORPOISE_CACHE_DIR to share one
+ * between projects. $CC (default cc), $CFLAGS and $LDFLAGS are honoured and are
+ * part of the cache key. The compiler must accept gcc-style options (gcc, clang).
+ */
+
+#ifndef BUILD_DRIVER_H
+#define BUILD_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include "project_generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUILD_MANIFEST_NAME     "porpoise_build.txt"
+#define BUILD_OUTPUT_DIR        "porpoise_build"
+#define BUILD_CACHE_DIR         ".porpoise_cache"
+#define BUILD_CACHE_ENV         "PORPOISE_CACHE_DIR"
+#define BUILD_MAX_JOBS          256
+#define BUILD_COMMAND_SIZE      4096
+#define BUILD_PATH_SIZE         1024
+
+//==============================================================================
+// MANIFEST
+//==============================================================================
+
+typedef struct {
+    char name[256];
+    char cflags[1024];
+    char ldflags[1024];
+    char transpiled_cflags[1024];   // Preprocessing transpiled units only (CMake's PCH force-includes)
+    char **sources;             // Translation units, relative to the project
+    bool *transpiled;           // Per source: transpiled file or unity shard
+    int source_count;
+    int source_capacity;
+} Build_Manifest;
+
+static inline void build_manifest_free(Build_Manifest *manifest) {
+    for (int i = 0; i < manifest->source_count; i++) free(manifest->sources[i]);
+    free(manifest->sources);
+    free(manifest->transpiled);
+    manifest->sources = NULL;
+    manifest->transpiled = NULL;
+    manifest->source_count = 0;
+    manifest->source_capacity = 0;
+}
+
+static inline bool build_manifest_add(Build_Manifest *manifest, const char *path, bool transpiled) {
+    if (manifest->source_count == manifest->source_capacity) {
+        int grown = manifest->source_capacity ? manifest->source_capacity * 2 : 256;
+        char **resized = (char**)realloc(manifest->sources, sizeof(char*) * grown);
+        if (resized) manifest->sources = resized;
+        bool *resized_flags = (bool*)realloc(manifest->transpiled, sizeof(bool) * grown);
+        if (resized_flags) manifest->transpiled = resized_flags;
+        if (!resized || !resized_flags) return false;
+        manifest->source_capacity = grown;
+    }
+    manifest->transpiled[manifest->source_count] = transpiled;
+    manifest->sources[manifest->source_count] = strdup(path);
+    return manifest->sources[manifest->source_count++] != NULL;
+}
+
+/**
+ * @brief Read porpoise_build.txt (paths relative to the current directory)
+ * Unity shards, when listed, replace the transpiled sources they include.
+ */
+static inline bool build_manifest_load(Build_Manifest *manifest) {
+    memset(manifest, 0, sizeof(*manifest));
+    FILE *f = fopen(BUILD_MANIFEST_NAME, "r");
+    if (!f) return false;
+
+    bool unity = false;
+    char line[BUILD_PATH_SIZE + 64];
+    while (fgets(line, sizeof(line), f)) {
+        unity |= strncmp(line, "unity ", 6) == 0;
+    }
+    rewind(f);
+
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *value = strchr(line, ' ');
+        if (line[0] == '#' || !value) continue;
+        *value++ = '\0';
+        if (strcmp(line, "name") == 0) {
+            snprintf(manifest->name, sizeof(manifest->name), "%s", value);
+        } else if (strcmp(line, "cflags") == 0) {
+            snprintf(manifest->cflags, sizeof(manifest->cflags), "%s", value);
+        } else if (strcmp(line, "ldflags") == 0) {
+            snprintf(manifest->ldflags, sizeof(manifest->ldflags), "%s", value);
+        } else if (strcmp(line, "transpiled_cflags") == 0) {
+            snprintf(manifest->transpiled_cflags, sizeof(manifest->transpiled_cflags), "%s", value);
+        } else if (strcmp(line, "source") == 0) {
+            ok = build_manifest_add(manifest, value, false);
+        } else if (strcmp(line, unity ? "unity" : "transpiled") == 0) {
+            ok = build_manifest_add(manifest, value, true);
+        }
+    }
+    fclose(f);
+    return ok && manifest->name[0];
+}
+
+/**
+ * @brief Add every .c under dir (SDK sources supplied after generation)
+ */
+static inline void build_manifest_scan(Build_Manifest *manifest, const char *dir) {
+    DIR *d = opendir(dir);
+    if (!d) return;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        char path[BUILD_PATH_SIZE];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+        size_t length = strlen(entry->d_name);
+        if (S_ISDIR(st.st_mode)) {
+            build_manifest_scan(manifest, path);
+        } else if (length > 2 && strcmp(entry->d_name + length - 2, ".c") == 0) {
+            build_manifest_add(manifest, path, false);
+        }
+    }
+    closedir(d);
+}
+
+//==============================================================================
+// HASHING
+//==============================================================================
+
+#define BUILD_HASH_SEED         0xCBF29CE484222325ULL  // FNV-1a 64
+#define BUILD_HASH_PRIME        0x100000001B3ULL
+
+static inline uint64_t build_hash(uint64_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= BUILD_HASH_PRIME;
+    }
+    return hash;
+}
+
+static inline uint64_t build_hash_string(uint64_t hash, const char *s) {
+    return build_hash(hash, s, strlen(s) + 1);  // Terminator separates adjacent strings
+}
+
+/**
+ * @brief Hash a file's contents into hash
+ * @return false if the file cannot be read
+ */
+static inline bool build_hash_file(const char *path, uint64_t *hash, uint64_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    char chunk[65536];
+    size_t n;
+    *size = 0;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        *hash = build_hash(*hash, chunk, n);
+        *size += n;
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Hash of `<cc> --version`: a compiler upgrade invalidates the cache
+ */
+static inline uint64_t build_compiler_identity(const char *cc) {
+    uint64_t hash = build_hash_string(BUILD_HASH_SEED, cc);
+    char command[BUILD_PATH_SIZE];
+    snprintf(command, sizeof(command), "%s --version 2>&1", cc);
+#ifdef _WIN32
+    FILE *p = _popen(command, "r");
+#else
+    FILE *p = popen(command, "r");
+#endif
+    if (!p) return hash;
+    char line[512];
+    while (fgets(line, sizeof(line), p)) hash = build_hash_string(hash, line);
+#ifdef _WIN32
+    _pclose(p);
+#else
+    pclose(p);
+#endif
+    return hash;
+}
+
+//==============================================================================
+// JOB POOL
+//==============================================================================
+
+typedef struct {
+    char command[BUILD_COMMAND_SIZE];
+    const char *label;          // Printed when the job starts (NULL: quiet)
+    int status;                 // system() result
+} Build_Job;
+
+typedef struct {
+    Build_Job *jobs;
+    int count;
+    int next;
+    int started;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+} Build_Pool;
+
+static inline void build_run_job(Build_Pool *pool, int index) {
+    Build_Job *job = &pool->jobs[index];
+    if (job->label) {
+        printf("  [%d/%d] %s\n", ++pool->started, pool->count, job->label);
+        fflush(stdout);
+    }
+    job->status = system(job->command);
+}
+
+#ifndef _WIN32
+static inline void* build_worker(void *arg) {
+    Build_Pool *pool = (Build_Pool*)arg;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        int index = pool->next < pool->count ? pool->next++ : -1;
+        if (index >= 0 && pool->jobs[index].label) {
+            printf("  [%d/%d] %s\n", ++pool->started, pool->count, pool->jobs[index].label);
+            fflush(stdout);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (index < 0) return NULL;
+        pool->jobs[index].status = system(pool->jobs[index].command);
+    }
+}
+#endif
+
+/**
+ * @brief Run the jobs in order on up to job_count threads
+ * @return Number of failed jobs
+ */
+static inline int build_run_jobs(Build_Job *jobs, int count, int job_count) {
+    Build_Pool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.jobs = jobs;
+    pool.count = count;
+    int thread_count = 0;
+#ifndef _WIN32
+    pthread_t threads[BUILD_MAX_JOBS];
+    if (job_count > 1 && count > 1 && pthread_mutex_init(&pool.lock, NULL) == 0) {
+        if (job_count > count) job_count = count;
+        for (; thread_count < job_count; thread_count++) {
+            if (pthread_create(&threads[thread_count], NULL, build_worker, &pool) != 0) break;
+        }
+        for (int t = 0; t < thread_count; t++) pthread_join(threads[t], NULL);
+        pthread_mutex_destroy(&pool.lock);
+    }
+#else
+    (void)job_count;
+#endif
+    if (thread_count == 0) {
+        for (int i = 0; i < count; i++) build_run_job(&pool, i);
+    }
+
+    int failed = 0;
+    for (int i = 0; i < count; i++) failed += jobs[i].status != 0;
+    return failed;
+}
+
+static inline int build_default_jobs(void) {
+#ifdef _WIN32
+    return 1;
+#else
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus < 1 ? 1 : cpus > BUILD_MAX_JOBS ? BUILD_MAX_JOBS : (int)cpus;
+#endif
+}
+
+//==============================================================================
+// BUILD
+//==============================================================================
+
+typedef struct {
+    const char *source;
+    char preprocessed[BUILD_PATH_SIZE];
+    char object[BUILD_PATH_SIZE];
+    uint64_t size;              // Scheduling weight: source, then preprocessed size
+    uint64_t key;               // Preprocessed text + compiler + flags
+    bool cached;
+} Build_Unit;
+
+static const Build_Unit *build_sort_units;
+
+// Largest first, then manifest order
+static inline int build_compare_size(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    const Build_Unit *ux = &build_sort_units[x], *uy = &build_sort_units[y];
+    if (ux->size != uy->size) return ux->size > uy->size ? -1 : 1;
+    return (x > y) - (x < y);
+}
+
+static inline void build_order_by_size(const Build_Unit *units, int *order, int count) {
+    build_sort_units = units;
+    qsort(order, count, sizeof(int), build_compare_size);
+}
+
+static inline const char* build_env(const char *name, const char *fallback) {
+    const char *value = getenv(name);
+    return value && value[0] ? value : fallback;
+}
+
+/**
+ * @brief Compile and link the project in the current directory
+ * @param job_count Parallel jobs (<= 0: one per CPU)
+ * @return 0 on success
+ */
+static inline int build_project(int job_count) {
+    Build_Manifest manifest;
+    if (!build_manifest_load(&manifest)) {
+        fprintf(stderr, "Error: No %s here (re-run the transpiler to generate it)\n", BUILD_MANIFEST_NAME);
+        build_manifest_free(&manifest);
+        return 1;
+    }
+    build_manifest_scan(&manifest, "sdk/src");
+    if (job_count <= 0) job_count = build_default_jobs();
+    if (job_count > BUILD_MAX_JOBS) job_count = BUILD_MAX_JOBS;
+
+    const char *cc = build_env("CC", "cc");
+    const char *extra_cflags = build_env("CFLAGS", "");
+    const char *extra_ldflags = build_env("LDFLAGS", "");
+    const char *cache_dir = build_env(BUILD_CACHE_ENV, BUILD_CACHE_DIR);
+    char include_flags[256] = "-Iinclude";
+    struct stat st;
+    if (stat("sdk/include", &st) == 0) strcat(include_flags, " -Isdk/include");
+    if (stat("src/sdk/include", &st) == 0) strcat(include_flags, " -Isrc/sdk/include");
+
+    // Room left in Build_Unit.object for "/<16 hex digits>.o"
+    char objects_dir[BUILD_PATH_SIZE - 20];
+    int length = snprintf(objects_dir, sizeof(objects_dir), "%s/objects", cache_dir);
+    if (length < 0 || (size_t)length >= sizeof(objects_dir)) {
+        fprintf(stderr, "Error: Cache directory path is too long: %s\n", cache_dir);
+        build_manifest_free(&manifest);
+        return 1;
+    }
+    create_directory(cache_dir);
+    create_directory(objects_dir);
+    create_directory(BUILD_OUTPUT_DIR);
+    create_directory(BUILD_OUTPUT_DIR "/pp");
+
+    int count = manifest.source_count;
+    Build_Unit *units = (Build_Unit*)calloc(count + 1, sizeof(Build_Unit));
+    Build_Job *jobs = (Build_Job*)calloc(count + 1, sizeof(Build_Job));
+    int *order = (int*)malloc(sizeof(int) * (count + 1));
+    if (!units || !jobs || !order) {
+        free(units); free(jobs); free(order);
+        build_manifest_free(&manifest);
+        return 1;
+    }
+
+    // Preprocess everything: the cache key is the text the compiler would see
+    printf("Build %s: %d units, %d jobs, cache %s\n", manifest.name, count, job_count, cache_dir);
+    int too_long = 0;
+    for (int i = 0; i < count; i++) {
+        units[i].source = manifest.sources[i];
+        snprintf(units[i].preprocessed, BUILD_PATH_SIZE, "%s/pp/%d.i", BUILD_OUTPUT_DIR, i);
+        units[i].size = stat(units[i].source, &st) == 0 ? (uint64_t)st.st_size : 0;
+        order[i] = i;
+    }
+    build_order_by_size(units, order, count);
+    for (int i = 0; i < count; i++) {
+        const Build_Unit *unit = &units[order[i]];
+        length = snprintf(jobs[i].command, BUILD_COMMAND_SIZE, "%s %s %s %s %s -E \"%s\" -o \"%s\"",
+                          cc, manifest.cflags, extra_cflags, include_flags,
+                          manifest.transpiled[order[i]] ? manifest.transpiled_cflags : "", unit->source, unit->preprocessed);
+        if (length < 0 || length >= BUILD_COMMAND_SIZE) {
+            fprintf(stderr, "Error: Preprocess command for %s is too long\n", unit->source);
+            too_long++;
+        }
+    }
+    int failed = too_long ? too_long : build_run_jobs(jobs, count, job_count);
+
+    // Key every unit; objects already in the cache are done
+    uint64_t identity = build_compiler_identity(cc);
+    identity = build_hash_string(identity, manifest.cflags);
+    identity = build_hash_string(identity, extra_cflags);
+    int misses = 0;
+    for (int i = 0; i < count && failed == 0; i++) {
+        Build_Unit *unit = &units[i];
+        unit->key = identity;
+        if (!build_hash_file(unit->preprocessed, &unit->key, &unit->size)) {
+            fprintf(stderr, "Error: Cannot read %s\n", unit->preprocessed);
+            failed++;
+            break;
+        }
+        snprintf(unit->object, BUILD_PATH_SIZE, "%s/%016llx.o", objects_dir, (unsigned long long)unit->key);
+        unit->cached = stat(unit->object, &st) == 0;
+        if (!unit->cached) order[misses++] = i;
+    }
+
+    // Compile the misses, largest preprocessed unit first
+    if (failed == 0 && misses > 0) {
+        build_order_by_size(units, order, misses);
+        for (int i = 0; i < misses; i++) {
+            const Build_Unit *unit = &units[order[i]];
+            length = snprintf(jobs[i].command, BUILD_COMMAND_SIZE, "%s %s %s -c \"%s\" -o \"%s.tmp\"",
+                              cc, manifest.cflags, extra_cflags, unit->preprocessed, unit->object);
+            if (length < 0 || length >= BUILD_COMMAND_SIZE) {
+                fprintf(stderr, "Error: Compile command for %s is too long\n", unit->source);
+                too_long++;
+            }
+            jobs[i].label = unit->source;
+        }
+        if (too_long) {
+            failed = too_long;
+            for (int i = 0; i < misses; i++) jobs[i].status = 1;
+        } else {
+            failed = build_run_jobs(jobs, misses, job_count);
+        }
+        for (int i = 0; i < misses; i++) {
+            const Build_Unit *unit = &units[order[i]];
+            char temporary[BUILD_PATH_SIZE + 8];
+            snprintf(temporary, sizeof(temporary), "%s.tmp", unit->object);
+            // Complete objects only: a concurrent build sharing the cache never sees a partial one
+            if (jobs[i].status == 0) {
+                remove(unit->object);  // rename() does not replace on Windows
+                rename(temporary, unit->object);
+            } else {
+                remove(temporary);
+                fprintf(stderr, "Error: Failed to compile %s\n", unit->source);
+            }
+        }
+    }
+    for (int i = 0; i < count; i++) remove(units[i].preprocessed);
+
+    // Link, unless the same objects were already linked with the same flags
+    int result = 1;
+    if (failed == 0) {
+        char executable[BUILD_PATH_SIZE], response[BUILD_PATH_SIZE], key_path[BUILD_PATH_SIZE];
+#ifdef _WIN32
+        snprintf(executable, sizeof(executable), "%s/%s.exe", BUILD_OUTPUT_DIR, manifest.name);
+#else
+        snprintf(executable, sizeof(executable), "%s/%s", BUILD_OUTPUT_DIR, manifest.name);
+#endif
+        snprintf(response, sizeof(response), "%s/objects.rsp", BUILD_OUTPUT_DIR);
+        snprintf(key_path, sizeof(key_path), "%s/link.key", BUILD_OUTPUT_DIR);
+
+        uint64_t link_key = build_hash_string(identity, manifest.ldflags);
+        link_key = build_hash_string(link_key, extra_ldflags);
+        FILE *rsp = fopen(response, "w");
+        for (int i = 0; rsp && i < count; i++) {
+            fprintf(rsp, "\"%s\"\n", units[i].object);
+            link_key = build_hash_string(link_key, units[i].object);
+        }
+        if (rsp) fclose(rsp);
+
+        unsigned long long previous = 0;
+        FILE *key_file = fopen(key_path, "r");
+        if (key_file) {
+            if (fscanf(key_file, "%llx", &previous) != 1) previous = 0;
+            fclose(key_file);
+        }
+
+        if (previous == link_key && stat(executable, &st) == 0) {
+            result = 0;
+        } else if (rsp) {
+            char command[BUILD_COMMAND_SIZE];
+            length = snprintf(command, sizeof(command), "%s %s @\"%s\" -o \"%s\" %s %s",
+                              cc, manifest.cflags, response, executable, manifest.ldflags, extra_ldflags);
+            if (length < 0 || (size_t)length >= sizeof(command)) {
+                fprintf(stderr, "Error: Link command for %s is too long\n", executable);
+                result = 1;
+            } else {
+                printf("  Linking %s\n", executable);
+                result = system(command) == 0 ? 0 : 1;
+            }
+            key_file = result == 0 ? fopen(key_path, "w") : NULL;
+            if (key_file) {
+                fprintf(key_file, "%016llx\n", (unsigned long long)link_key);
+                fclose(key_file);
+            }
+        }
+        if (result == 0) {
+            printf("Build %s: %d compiled, %d from cache -> %s\n", manifest.name, misses, count - misses, executable);
+        }
+    } else {
+        fprintf(stderr, "Build %s: %d units failed\n", manifest.name, failed);
+    }
+
+    free(units);
+    free(jobs);
+    free(order);
+    build_manifest_free(&manifest);
+    return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUILD_DRIVER_H
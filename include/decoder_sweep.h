@@ -0,0 +1,366 @@
+/**
+ * @file decoder_sweep.h
+ * @brief Exhaustive decoder sweep (`porpoise_tool sweep`)
+ *
+ * Feeds every 32-bit word (or every Nth word of a range) through
+ * transpile_instruction() on all cores and times it. Each word is then tried
+ * against every decoder in opcode_table.h. transpile_instruction() stops at
+ * the first decoder that matches, so two decoders accepting the same word
+ * never show up in normal runs. The sweep reports:
+ * - words no decoder accepts (by primary / extended opcode)
+ * - words more than one decoder accepts (by decoder pair)
+ * - words a decoder accepts that transpile_instruction() still rejects
+ */
+
+#ifndef DECODER_SWEEP_H
+#define DECODER_SWEEP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "opcode_table.h"
+#include "porpoise_stats.h"
+#include "build_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SWEEP_CHUNK             65536       // Words per work unit
+#define SWEEP_ADDRESS           0x80003100  // Address passed with every word (branch targets)
+#define SWEEP_GROUPS            (64 * 1024) // Primary opcode x 10-bit extended opcode
+#define SWEEP_OUTPUT_SIZE       512
+
+typedef bool (*Sweep_Transpile)(uint32_t instruction, uint32_t address, char *output, size_t output_size,
+                                char *comment, size_t comment_size);
+
+typedef struct {
+    uint32_t first;             // First word
+    uint32_t last;              // Last word (inclusive)
+    uint32_t step;              // 1 = every word
+    int jobs;                   // 0 = one per CPU
+    bool verbose;               // List every unhandled extended opcode
+} Sweep_Options;
+
+typedef struct {
+    uint64_t words;
+    uint64_t handled;                           // transpile_instruction() returned true
+    uint64_t unmatched;                         // No decoder in the table accepts the word
+    uint64_t outside_table;                     // Handled, but by no decoder in the table
+    uint64_t undispatched[OPCODE_TABLE_COUNT];  // Decoder accepts, transpile_instruction() rejects
+    uint32_t undispatched_example[OPCODE_TABLE_COUNT];
+    uint64_t *pairs;                            // [a * OPCODE_TABLE_COUNT + b], a < b
+    uint32_t *pair_example;
+    uint64_t *group_words;                      // By sweep_group()
+    uint64_t *group_unhandled;
+    bool *chunk_handled;
+    double transpile_seconds;                   // Inside transpile_instruction() only
+} Sweep_Counts;
+
+typedef struct {
+    const Sweep_Options *options;
+    Sweep_Transpile transpile;
+    uint64_t samples;
+    uint64_t chunks;
+    uint64_t next;
+    int progress;               // Last reported tenth
+#ifndef _WIN32
+    pthread_mutex_t lock;
+#endif
+} Sweep_State;
+
+/**
+ * @brief Primary opcode and, for the extended-opcode primaries, bits 1-10
+ */
+static inline uint32_t sweep_group(uint32_t word) {
+    uint32_t primary = word >> 26;
+    bool extended = primary == 4 || primary == 19 || primary == 31 || primary == 59 || primary == 63;
+    return (primary << 10) | (extended ? (word >> 1) & 0x3FF : 0);
+}
+
+static inline bool sweep_counts_init(Sweep_Counts *counts) {
+    memset(counts, 0, sizeof(*counts));
+    size_t pairs = (size_t)OPCODE_TABLE_COUNT * OPCODE_TABLE_COUNT;
+    counts->pairs = (uint64_t*)calloc(pairs, sizeof(uint64_t));
+    counts->pair_example = (uint32_t*)calloc(pairs, sizeof(uint32_t));
+    counts->group_words = (uint64_t*)calloc(SWEEP_GROUPS, sizeof(uint64_t));
+    counts->group_unhandled = (uint64_t*)calloc(SWEEP_GROUPS, sizeof(uint64_t));
+    counts->chunk_handled = (bool*)calloc(SWEEP_CHUNK, sizeof(bool));
+    return counts->pairs && counts->pair_example && counts->group_words && counts->group_unhandled &&
+           counts->chunk_handled;
+}
+
+static inline void sweep_counts_free(Sweep_Counts *counts) {
+    free(counts->pairs);
+    free(counts->pair_example);
+    free(counts->group_words);
+    free(counts->group_unhandled);
+    free(counts->chunk_handled);
+}
+
+static inline void sweep_counts_merge(Sweep_Counts *into, const Sweep_Counts *from) {
+    into->words += from->words;
+    into->handled += from->handled;
+    into->unmatched += from->unmatched;
+    into->outside_table += from->outside_table;
+    into->transpile_seconds += from->transpile_seconds;
+    for (int d = 0; d < OPCODE_TABLE_COUNT; d++) {
+        if (from->undispatched[d] && !into->undispatched[d]) {
+            into->undispatched_example[d] = from->undispatched_example[d];
+        }
+        into->undispatched[d] += from->undispatched[d];
+    }
+    for (size_t p = 0; p < (size_t)OPCODE_TABLE_COUNT * OPCODE_TABLE_COUNT; p++) {
+        if (from->pairs[p] && !into->pairs[p]) into->pair_example[p] = from->pair_example[p];
+        into->pairs[p] += from->pairs[p];
+    }
+    for (int g = 0; g < SWEEP_GROUPS; g++) {
+        into->group_words[g] += from->group_words[g];
+        into->group_unhandled[g] += from->group_unhandled[g];
+    }
+}
+
+/**
+ * @brief Sweep one chunk: time the transpile pass, then cross-check every word
+ */
+static inline void sweep_chunk(const Sweep_State *state, uint64_t chunk, Sweep_Counts *counts) {
+    const Sweep_Options *options = state->options;
+    uint64_t base = chunk * SWEEP_CHUNK;
+    uint32_t n = (uint32_t)(state->samples - base < SWEEP_CHUNK ? state->samples - base : SWEEP_CHUNK);
+    char output[SWEEP_OUTPUT_SIZE], comment[128];
+
+    double start = stats_now();
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t word = (uint32_t)(options->first + (base + i) * options->step);
+        counts->chunk_handled[i] = state->transpile(word, SWEEP_ADDRESS, output, sizeof(output),
+                                                    comment, sizeof(comment));
+    }
+    counts->transpile_seconds += stats_now() - start;
+
+    uint16_t matches[OPCODE_TABLE_COUNT];
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t word = (uint32_t)(options->first + (base + i) * options->step);
+        bool handled = counts->chunk_handled[i];
+        int match_count = opcode_table_match(word, matches);
+        uint32_t group = sweep_group(word);
+
+        counts->words++;
+        counts->group_words[group]++;
+        if (handled) counts->handled++;
+        else counts->group_unhandled[group]++;
+        if (match_count == 0) {
+            if (handled) counts->outside_table++;
+            else counts->unmatched++;
+        } else if (!handled) {
+            if (!counts->undispatched[matches[0]]) counts->undispatched_example[matches[0]] = word;
+            counts->undispatched[matches[0]]++;
+        }
+        for (int a = 0; a < match_count; a++) {
+            for (int b = a + 1; b < match_count; b++) {
+                size_t p = (size_t)matches[a] * OPCODE_TABLE_COUNT + matches[b];
+                if (!counts->pairs[p]) counts->pair_example[p] = word;
+                counts->pairs[p]++;
+            }
+        }
+    }
+}
+
+static inline void sweep_progress(Sweep_State *state, uint64_t chunk) {
+    int tenth = (int)((chunk + 1) * 10 / state->chunks);
+    if (tenth > state->progress) {
+        state->progress = tenth;
+        printf("  [%3d%%] %llu words\n", tenth * 10,
+               (unsigned long long)((chunk + 1) * SWEEP_CHUNK < state->samples ? (chunk + 1) * SWEEP_CHUNK
+                                                                                : state->samples));
+        fflush(stdout);
+    }
+}
+
+typedef struct {
+    Sweep_State *state;
+    Sweep_Counts counts;
+} Sweep_Worker;
+
+#ifndef _WIN32
+static inline void* sweep_worker(void *arg) {
+    Sweep_Worker *worker = (Sweep_Worker*)arg;
+    Sweep_State *state = worker->state;
+    for (;;) {
+        pthread_mutex_lock(&state->lock);
+        uint64_t chunk = state->next < state->chunks ? state->next++ : UINT64_MAX;
+        pthread_mutex_unlock(&state->lock);
+        if (chunk == UINT64_MAX) return NULL;
+        sweep_chunk(state, chunk, &worker->counts);
+        pthread_mutex_lock(&state->lock);
+        sweep_progress(state, chunk);
+        pthread_mutex_unlock(&state->lock);
+    }
+}
+#endif
+
+//==============================================================================
+// REPORT
+//==============================================================================
+
+typedef struct {
+    uint64_t count;
+    int a, b;
+} Sweep_Pair;
+
+static inline int sweep_compare_pairs(const void *x, const void *y) {
+    const Sweep_Pair *p = (const Sweep_Pair*)x, *q = (const Sweep_Pair*)y;
+    if (p->count != q->count) return p->count > q->count ? -1 : 1;
+    return p->a != q->a ? p->a - q->a : p->b - q->b;
+}
+
+static inline double sweep_percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static inline void sweep_report(const Sweep_Counts *c, const Sweep_Options *options, int threads, double wall) {
+    printf("\n===========================================\n");
+    printf("   Decoder Sweep: 0x%08X-0x%08X step %u\n", options->first, options->last, options->step);
+    printf("===========================================\n");
+    double per_thread = stats_rate(c->words, c->transpile_seconds);
+    printf("Words: %llu in %.2fs on %d threads\n", (unsigned long long)c->words, wall, threads);
+    printf("transpile_instruction(): %.2f M words/s per thread, ~%.2f M words/s on %d threads\n",
+           per_thread / 1e6, per_thread * threads / 1e6, threads);
+    printf("Handled: %llu (%.2f%%), no decoder: %llu, decoded but rejected: %llu, outside the table: %llu\n",
+           (unsigned long long)c->handled, sweep_percent(c->handled, c->words),
+           (unsigned long long)c->unmatched, (unsigned long long)(c->words - c->handled - c->unmatched),
+           (unsigned long long)c->outside_table);
+
+    // Unhandled words by primary opcode; extended opcodes summarised (listed with --verbose)
+    printf("\nUnhandled words by primary opcode:\n");
+    for (uint32_t primary = 0; primary < 64; primary++) {
+        uint64_t words = 0, unhandled = 0;
+        int full = 0, partial = 0;
+        for (uint32_t xo = 0; xo < 1024; xo++) {
+            uint32_t g = (primary << 10) | xo;
+            words += c->group_words[g];
+            unhandled += c->group_unhandled[g];
+            if (c->group_unhandled[g] == 0) continue;
+            if (c->group_unhandled[g] == c->group_words[g]) full++;
+            else partial++;
+        }
+        if (unhandled == 0) continue;
+        bool extended = primary == 4 || primary == 19 || primary == 31 || primary == 59 || primary == 63;
+        printf("  %2u: %12llu (%6.2f%%)", primary, (unsigned long long)unhandled, sweep_percent(unhandled, words));
+        if (extended) printf("  extended opcodes: %d unhandled, %d partly handled", full, partial);
+        printf("\n");
+        if (!extended || !options->verbose) continue;
+        for (uint32_t xo = 0; xo < 1024; xo++) {
+            uint32_t g = (primary << 10) | xo;
+            if (c->group_unhandled[g] == 0) continue;
+            printf("      xo %4u: %llu of %llu\n", xo, (unsigned long long)c->group_unhandled[g],
+                   (unsigned long long)c->group_words[g]);
+        }
+    }
+
+    printf("\nDecoders that accept words transpile_instruction() rejects:\n");
+    int undispatched = 0;
+    for (int d = 0; d < OPCODE_TABLE_COUNT; d++) {
+        if (!c->undispatched[d]) continue;
+        printf("  %-12s %12llu words (e.g. 0x%08X)\n", opcode_table_names[d],
+               (unsigned long long)c->undispatched[d], c->undispatched_example[d]);
+        undispatched++;
+    }
+    if (!undispatched) printf("  none\n");
+
+    // Overlaps: the order of transpile_instruction() decides which one runs
+    int pair_count = 0;
+    for (size_t p = 0; p < (size_t)OPCODE_TABLE_COUNT * OPCODE_TABLE_COUNT; p++) pair_count += c->pairs[p] != 0;
+    printf("\nWords accepted by more than one decoder (%d pairs):\n", pair_count);
+    if (pair_count == 0) {
+        printf("  none\n");
+        return;
+    }
+    Sweep_Pair *pairs = (Sweep_Pair*)malloc(sizeof(Sweep_Pair) * pair_count);
+    if (!pairs) return;
+    int n = 0;
+    for (int a = 0; a < OPCODE_TABLE_COUNT; a++) {
+        for (int b = a + 1; b < OPCODE_TABLE_COUNT; b++) {
+            uint64_t count = c->pairs[(size_t)a * OPCODE_TABLE_COUNT + b];
+            if (count) pairs[n++] = (Sweep_Pair){ count, a, b };
+        }
+    }
+    qsort(pairs, n, sizeof(Sweep_Pair), sweep_compare_pairs);
+    for (int i = 0; i < n; i++) {
+        printf("  %-12s %-12s %12llu words (e.g. 0x%08X)\n", opcode_table_names[pairs[i].a],
+               opcode_table_names[pairs[i].b], (unsigned long long)pairs[i].count,
+               c->pair_example[(size_t)pairs[i].a * OPCODE_TABLE_COUNT + pairs[i].b]);
+    }
+    free(pairs);
+}
+
+//==============================================================================
+// SWEEP
+//==============================================================================
+
+/**
+ * @brief Run the sweep and print the report
+ * @return 0, or 1 if memory ran out
+ */
+static inline int run_decoder_sweep(Sweep_Transpile transpile, const Sweep_Options *options) {
+    Sweep_State state;
+    memset(&state, 0, sizeof(state));
+    state.options = options;
+    state.transpile = transpile;
+    state.samples = ((uint64_t)options->last - options->first) / options->step + 1;
+    state.chunks = (state.samples + SWEEP_CHUNK - 1) / SWEEP_CHUNK;
+
+    int jobs = options->jobs > 0 ? options->jobs : build_default_jobs();
+    if (jobs > BUILD_MAX_JOBS) jobs = BUILD_MAX_JOBS;
+    if ((uint64_t)jobs > state.chunks) jobs = (int)state.chunks;
+
+    Sweep_Worker *workers = (Sweep_Worker*)calloc(jobs, sizeof(Sweep_Worker));
+    if (!workers) return 1;
+    bool ok = true;
+    for (int t = 0; t < jobs; t++) {
+        workers[t].state = &state;
+        ok = sweep_counts_init(&workers[t].counts) && ok;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Out of memory for %d sweep threads\n", jobs);
+        for (int t = 0; t < jobs; t++) sweep_counts_free(&workers[t].counts);
+        free(workers);
+        return 1;
+    }
+
+    printf("Sweeping %llu words on %d threads...\n", (unsigned long long)state.samples, jobs);
+    double start = stats_now();
+    int threads = 0;
+#ifndef _WIN32
+    pthread_t handles[BUILD_MAX_JOBS];
+    if (jobs > 1 && pthread_mutex_init(&state.lock, NULL) == 0) {
+        for (; threads < jobs; threads++) {
+            if (pthread_create(&handles[threads], NULL, sweep_worker, &workers[threads]) != 0) break;
+        }
+        for (int t = 0; t < threads; t++) pthread_join(handles[t], NULL);
+        pthread_mutex_destroy(&state.lock);
+    }
+#endif
+    if (threads == 0) {
+        threads = 1;
+        for (uint64_t chunk = 0; chunk < state.chunks; chunk++) {
+            sweep_chunk(&state, chunk, &workers[0].counts);
+            sweep_progress(&state, chunk);
+        }
+    }
+    double wall = stats_now() - start;
+
+    for (int t = 1; t < jobs; t++) sweep_counts_merge(&workers[0].counts, &workers[t].counts);
+    sweep_report(&workers[0].counts, options, threads, wall);
+
+    for (int t = 0; t < jobs; t++) sweep_counts_free(&workers[t].counts);
+    free(workers);
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DECODER_SWEEP_H
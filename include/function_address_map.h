@@ -12,17 +12,23 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "powerpc_state.h"  // PPC_REGISTER_ABI
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief Function pointer type for transpiled functions (10-parameter convention)
+ * @brief Function pointer type for transpiled functions
+ * Takes no parameters under the register calling convention, r3-r10/f1-f2 otherwise.
  */
+#ifdef PPC_REGISTER_ABI
+typedef void (*TranspiledFunctionPtr)(void);
+#else
 typedef void (*TranspiledFunctionPtr)(uintptr_t r3, uintptr_t r4, uintptr_t r5, uintptr_t r6,
                                       uintptr_t r7, uintptr_t r8, uintptr_t r9, uintptr_t r10,
                                       double f1, double f2);
+#endif
 
 /**
  * @brief Function address map entry
@@ -51,11 +57,15 @@ void function_address_map_register(uint32_t gc_address, TranspiledFunctionPtr fu
  * @brief Call a function by its GameCube address
  * This looks up the address in the map and calls the corresponding function directly.
  * @param gc_address GameCube address of the function to call
- * @param r3-r10, f1, f2 Parameters to pass to the function
+ * @param r3-r10, f1, f2 Parameters to pass to the function (omitted under PPC_REGISTER_ABI)
  */
+#ifdef PPC_REGISTER_ABI
+void call_function_by_address(uint32_t gc_address);
+#else
 void call_function_by_address(uint32_t gc_address, uintptr_t r3, uintptr_t r4, uintptr_t r5, uintptr_t r6,
                               uintptr_t r7, uintptr_t r8, uintptr_t r9, uintptr_t r10,
                               double f1, double f2);
+#endif
 
 #ifdef __cplusplus
 }
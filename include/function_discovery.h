@@ -0,0 +1,347 @@
+/**
+ * @file function_discovery.h
+ * @brief Function boundary discovery for DOL/ELF input
+ *
+ * Finds functions in the code sections of a Binary_Image without any
+ * .fn/.endfn directives:
+ *   - Recursive descent from the seed addresses (symbols, entry point) and from
+ *     every bl target found along the way
+ *   - A linear sweep over code nothing reached yet, starting new functions at
+ *     prologue patterns (stwu r1, -N(r1) / mflr r0)
+ *
+ * Each code section is walked by its own thread. bl targets that land in another
+ * section are handed over between rounds, so threads never share state.
+ * The result is a sorted array of Function_Info records.
+ */
+
+#ifndef FUNCTION_DISCOVERY_H
+#define FUNCTION_DISCOVERY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "porpoise_tool.h"
+#include "binary_loader.h"
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INSTRUCTION PATTERNS
+//==============================================================================
+
+#define DISCOVERY_MFLR_R0           0x7C0802A6  // mflr r0
+#define DISCOVERY_STWU_R1_MASK      0xFFFF8000  // stwu r1, -N(r1) with negative N
+#define DISCOVERY_STWU_R1_PATTERN   0x94218000
+#define DISCOVERY_PROLOGUE_WINDOW   4           // mflr r0 must precede stwu within this many words
+
+//==============================================================================
+// STRUCTURES
+//==============================================================================
+
+typedef struct {
+    uint32_t *items;
+    int count;
+    int capacity;
+} Discovery_List;
+
+/**
+ * @brief A function entry point and the furthest instruction reached from it
+ */
+typedef struct {
+    uint32_t start;
+    uint32_t extent;            // One past the last reachable instruction
+} Discovery_Entry;
+
+/**
+ * @brief Per-section walk state (owned by exactly one thread per round)
+ */
+typedef struct {
+    const Binary_Image *img;
+    const Binary_Section *sec;
+    uint32_t words;             // Section size in instructions
+    uint32_t *owner;            // Per word: 1-based entry index that last reached it, 0 = unreached
+    uint8_t *is_entry;          // Per word: function starts here
+    uint32_t sweep_position;    // Next word the prologue sweep looks at
+
+    Discovery_Entry *entries;
+    int entry_count;
+    int entry_capacity;
+
+    Discovery_List pending;     // Entry points in this section not walked yet
+    Discovery_List external;    // bl targets outside this section (handed over between rounds)
+} Discovery_Section;
+
+//==============================================================================
+// HELPERS
+//==============================================================================
+
+static inline void discovery_list_push(Discovery_List *list, uint32_t value) {
+    if (list->count >= list->capacity) {
+        int new_capacity = list->capacity ? list->capacity * 2 : 256;
+        uint32_t *grown = (uint32_t*)realloc(list->items, sizeof(uint32_t) * new_capacity);
+        if (!grown) return;
+        list->items = grown;
+        list->capacity = new_capacity;
+    }
+    list->items[list->count++] = value;
+}
+
+static inline bool discovery_in_section(const Discovery_Section *ds, uint32_t addr) {
+    return (addr & 3) == 0 && addr - ds->sec->address < ds->sec->size;
+}
+
+static inline uint32_t discovery_index(const Discovery_Section *ds, uint32_t addr) {
+    return (addr - ds->sec->address) >> 2;
+}
+
+/**
+ * @brief Queue an entry point that lies inside this section
+ */
+static inline void discovery_add_entry(Discovery_Section *ds, uint32_t addr) {
+    if (!discovery_in_section(ds, addr)) return;
+    uint32_t i = discovery_index(ds, addr);
+    if (ds->is_entry[i]) return;
+    ds->is_entry[i] = 1;
+    discovery_list_push(&ds->pending, addr);
+}
+
+/**
+ * @brief True if a word starts a standard prologue
+ * Either stwu r1, -N(r1) directly, or mflr r0 with the stwu a few words later.
+ */
+static inline bool discovery_is_prologue(const Discovery_Section *ds, uint32_t i) {
+    uint32_t word = binary_section_word(ds->img, ds->sec, ds->sec->address + i * 4);
+    if ((word & DISCOVERY_STWU_R1_MASK) == DISCOVERY_STWU_R1_PATTERN) return true;
+    if (word != DISCOVERY_MFLR_R0) return false;
+
+    for (uint32_t k = 1; k <= DISCOVERY_PROLOGUE_WINDOW && i + k < ds->words; k++) {
+        uint32_t next = binary_section_word(ds->img, ds->sec, ds->sec->address + (i + k) * 4);
+        if ((next & DISCOVERY_STWU_R1_MASK) == DISCOVERY_STWU_R1_PATTERN) return true;
+    }
+    return false;
+}
+
+//==============================================================================
+// RECURSIVE DESCENT
+//==============================================================================
+
+/**
+ * @brief Walk every path reachable from one entry point
+ * Calls (bl) queue new entry points; paths end at blr, bctr, an unconditional
+ * branch, a tail branch to an earlier address or an invalid word.
+ */
+static inline void discovery_walk(Discovery_Section *ds, uint32_t start) {
+    if (ds->entry_count >= ds->entry_capacity) {
+        int new_capacity = ds->entry_capacity ? ds->entry_capacity * 2 : 256;
+        Discovery_Entry *grown = (Discovery_Entry*)realloc(ds->entries, sizeof(Discovery_Entry) * new_capacity);
+        if (!grown) return;
+        ds->entries = grown;
+        ds->entry_capacity = new_capacity;
+    }
+
+    uint32_t stamp = (uint32_t)ds->entry_count + 1;
+    Discovery_Entry *entry = &ds->entries[ds->entry_count++];
+    entry->start = start;
+    entry->extent = start;
+
+    Discovery_List paths = {0};
+    discovery_list_push(&paths, start);
+
+    while (paths.count > 0) {
+        uint32_t addr = paths.items[--paths.count];
+
+        while (discovery_in_section(ds, addr)) {
+            uint32_t i = discovery_index(ds, addr);
+            if (ds->owner[i] == stamp) break;
+            if (addr != start && ds->is_entry[i]) break;  // Fell through into the next function
+            ds->owner[i] = stamp;
+            if (addr + 4 > entry->extent) entry->extent = addr + 4;
+
+            uint32_t word = binary_section_word(ds->img, ds->sec, addr);
+            uint32_t opcode = word >> 26;
+            if (word == 0) break;
+
+            if (opcode == 18) {
+                uint32_t target;
+                binary_branch_target(word, addr, &target);
+                if (word & 1) {
+                    // bl: new function
+                    if (discovery_in_section(ds, target)) discovery_add_entry(ds, target);
+                    else discovery_list_push(&ds->external, target);
+                } else {
+                    // b: local jump, or a tail call when it leaves the function backwards
+                    if (target >= start && discovery_in_section(ds, target)) {
+                        discovery_list_push(&paths, target);
+                    }
+                    break;
+                }
+            } else if (opcode == 16) {
+                uint32_t target;
+                uint32_t bo = (word >> 21) & 0x1F;
+                binary_branch_target(word, addr, &target);
+                if (!(word & 1) && target >= start && discovery_in_section(ds, target)) {
+                    discovery_list_push(&paths, target);
+                }
+                if ((bo & 0x14) == 0x14 && !(word & 1)) break;  // Branch always
+            } else if (opcode == 19) {
+                uint32_t xo = (word >> 1) & 0x3FF;
+                uint32_t bo = (word >> 21) & 0x1F;
+                if ((xo == 16 || xo == 528) && (bo & 0x14) == 0x14 && !(word & 1)) break;  // blr / bctr
+            }
+
+            addr += 4;
+        }
+    }
+
+    free(paths.items);
+}
+
+/**
+ * @brief Walk all pending entry points, then sweep unreached code for prologues
+ */
+static inline void discovery_run_section(Discovery_Section *ds) {
+    for (;;) {
+        while (ds->pending.count > 0) {
+            discovery_walk(ds, ds->pending.items[--ds->pending.count]);
+        }
+
+        // Resume the sweep where it stopped: earlier words were already rejected
+        while (ds->sweep_position < ds->words) {
+            uint32_t i = ds->sweep_position++;
+            if (ds->owner[i] == 0 && !ds->is_entry[i] && discovery_is_prologue(ds, i)) {
+                discovery_add_entry(ds, ds->sec->address + i * 4);
+                break;
+            }
+        }
+        if (ds->pending.count == 0) return;
+    }
+}
+
+#ifndef _WIN32
+static inline void* discovery_thread(void *arg) {
+    discovery_run_section((Discovery_Section*)arg);
+    return NULL;
+}
+#endif
+
+//==============================================================================
+// DRIVER
+//==============================================================================
+
+static inline int discovery_entry_compare(const void *a, const void *b) {
+    uint32_t x = ((const Function_Info*)a)->start_address;
+    uint32_t y = ((const Function_Info*)b)->start_address;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Discover all functions in the image's code sections
+ * @param img Loaded executable
+ * @param seeds Known entry points (symbols, entry point)
+ * @param seed_count Number of seeds
+ * @param out Receives a malloc'd array sorted by start address (names fn_XXXXXXXX)
+ * @return Number of functions, or -1 on allocation failure
+ */
+static inline int discover_functions(const Binary_Image *img, const uint32_t *seeds, int seed_count,
+                                     Function_Info **out) {
+    Discovery_Section sections[BINARY_MAX_SECTIONS];
+    int section_count = 0;
+
+    for (int s = 0; s < img->section_count; s++) {
+        if (!img->sections[s].is_code) continue;
+        Discovery_Section *ds = &sections[section_count++];
+        memset(ds, 0, sizeof(*ds));
+        ds->img = img;
+        ds->sec = &img->sections[s];
+        ds->words = ds->sec->size / 4;
+        ds->owner = (uint32_t*)calloc(ds->words ? ds->words : 1, sizeof(uint32_t));
+        ds->is_entry = (uint8_t*)calloc(ds->words ? ds->words : 1, 1);
+        if (!ds->owner || !ds->is_entry) return -1;
+    }
+
+    for (int i = 0; i < seed_count; i++) {
+        for (int s = 0; s < section_count; s++) discovery_add_entry(&sections[s], seeds[i]);
+    }
+
+    // Rounds: every section with work runs on its own thread, then cross-section
+    // calls are handed to their owning section
+    for (;;) {
+#ifndef _WIN32
+        pthread_t threads[BINARY_MAX_SECTIONS];
+        bool started[BINARY_MAX_SECTIONS] = {0};
+        for (int s = 0; s < section_count; s++) {
+            started[s] = pthread_create(&threads[s], NULL, discovery_thread, &sections[s]) == 0;
+            if (!started[s]) discovery_run_section(&sections[s]);
+        }
+        for (int s = 0; s < section_count; s++) {
+            if (started[s]) pthread_join(threads[s], NULL);
+        }
+#else
+        for (int s = 0; s < section_count; s++) discovery_run_section(&sections[s]);
+#endif
+
+        bool handed_over = false;
+        for (int s = 0; s < section_count; s++) {
+            Discovery_List *ext = &sections[s].external;
+            for (int i = 0; i < ext->count; i++) {
+                for (int t = 0; t < section_count; t++) {
+                    int before = sections[t].pending.count;
+                    discovery_add_entry(&sections[t], ext->items[i]);
+                    handed_over |= sections[t].pending.count != before;
+                }
+            }
+            ext->count = 0;
+        }
+        if (!handed_over) break;
+    }
+
+    int total = 0;
+    for (int s = 0; s < section_count; s++) total += sections[s].entry_count;
+
+    Function_Info *funcs = (Function_Info*)calloc(total ? total : 1, sizeof(Function_Info));
+    int count = 0;
+    for (int s = 0; s < section_count && funcs; s++) {
+        for (int i = 0; i < sections[s].entry_count; i++) {
+            Function_Info *f = &funcs[count++];
+            f->start_address = sections[s].entries[i].start;
+            f->end_address = sections[s].entries[i].extent;
+            snprintf(f->name, sizeof(f->name), "fn_%08X", f->start_address);
+        }
+    }
+
+    if (funcs) {
+        qsort(funcs, count, sizeof(Function_Info), discovery_entry_compare);
+        // A function never runs into the next one
+        for (int i = 0; i + 1 < count; i++) {
+            if (funcs[i].end_address > funcs[i + 1].start_address) {
+                funcs[i].end_address = funcs[i + 1].start_address;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            funcs[i].size = funcs[i].end_address - funcs[i].start_address;
+        }
+    }
+
+    for (int s = 0; s < section_count; s++) {
+        free(sections[s].owner);
+        free(sections[s].is_entry);
+        free(sections[s].entries);
+        free(sections[s].pending.items);
+        free(sections[s].external.items);
+    }
+
+    *out = funcs;
+    return funcs ? count : -1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUNCTION_DISCOVERY_H
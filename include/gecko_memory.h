@@ -20,6 +20,8 @@
 #include <string.h>
 #include <stdbool.h>
 
+#include "address_map.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +42,37 @@ extern "C" {
 #define HWREG_BASE          0x0C000000  // Physical hardware registers
 #define HWREG_VIRTUAL       0xCC000000  // Virtual (uncached) hardware registers
 
+// Software TLB geometry (64 KB pages keyed on the top 16 address bits)
+#define GECKO_PAGE_SHIFT    16
+#define GECKO_PAGE_SIZE     (1u << GECKO_PAGE_SHIFT)
+#define GECKO_PAGE_MASK     (GECKO_PAGE_SIZE - 1)
+#define GECKO_PAGE_COUNT    (1u << (32 - GECKO_PAGE_SHIFT))
+
+// Byte swapping for big-endian guest words
+#if defined(_MSC_VER)
+    #define GECKO_BSWAP16(x)    _byteswap_ushort(x)
+    #define GECKO_BSWAP32(x)    _byteswap_ulong(x)
+#elif defined(__GNUC__) || defined(__clang__)
+    #define GECKO_BSWAP16(x)    __builtin_bswap16(x)
+    #define GECKO_BSWAP32(x)    __builtin_bswap32(x)
+#else
+    #define GECKO_BSWAP16(x)    ((uint16_t)(((x) >> 8) | ((x) << 8)))
+    #define GECKO_BSWAP32(x)    ((((x) >> 24) & 0x000000FF) | (((x) >> 8) & 0x0000FF00) | \
+                                 (((x) << 8) & 0x00FF0000) | (((x) << 24) & 0xFF000000))
+#endif
+
+// SIMD kernels for bulk byte swapping
+#if defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define GECKO_SIMD_SSSE3    1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define GECKO_SIMD_SSE2     1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define GECKO_SIMD_NEON     1
+#endif
+
 //==============================================================================
 // COMMAND PROCESSOR (CP) REGISTERS
 //==============================================================================
@@ -342,6 +375,294 @@ typedef struct {
     AI_Registers ai;                // Audio Interface
 } HW_Registers;
 
+//==============================================================================
+// MMIO DISPATCH (per-device handler tables)
+//==============================================================================
+
+// Device blocks inside the 64 KB hardware register page (offsets from HWREG_BASE)
+#define GECKO_MMIO_CP_BASE      0x0000  // Command Processor
+#define GECKO_MMIO_PE_BASE      0x1000  // Pixel Engine
+#define GECKO_MMIO_VI_BASE      0x2000  // Video Interface
+#define GECKO_MMIO_PI_BASE      0x3000  // Processor Interface
+#define GECKO_MMIO_MI_BASE      0x4000  // Memory Interface
+#define GECKO_MMIO_DSP_BASE     0x5000  // DSP Interface
+#define GECKO_MMIO_DI_BASE      0x6000  // DVD Interface
+#define GECKO_MMIO_SI_BASE      0x6400  // Serial Interface
+#define GECKO_MMIO_EXI_BASE     0x6800  // External Interface
+#define GECKO_MMIO_AI_BASE      0x6C00  // Audio Interface
+#define GECKO_MMIO_GX_FIFO_BASE 0x8000  // GX write-gather FIFO (every store is a FIFO push)
+
+#define GECKO_MMIO_BLOCK_SHIFT  10                                          // 1 KB dispatch blocks
+#define GECKO_MMIO_BLOCK_SIZE   (1u << GECKO_MMIO_BLOCK_SHIFT)
+#define GECKO_MMIO_BLOCK_COUNT  (GECKO_PAGE_SIZE >> GECKO_MMIO_BLOCK_SHIFT)  // Blocks per HW page
+#define GECKO_MMIO_REG_SLOTS    (GECKO_MMIO_BLOCK_SIZE / 2)                 // Halfword granularity
+#define GECKO_MMIO_NONE         0xFF                                        // Block with no device
+
+// True if a physical address falls inside the hardware register page
+#define GECKO_IS_MMIO(paddr)    ((uint32_t)((paddr) - HWREG_BASE) < GECKO_PAGE_SIZE)
+
+typedef enum {
+    GECKO_MMIO_CP,
+    GECKO_MMIO_PE,
+    GECKO_MMIO_VI,
+    GECKO_MMIO_PI,
+    GECKO_MMIO_MI,
+    GECKO_MMIO_DSP,
+    GECKO_MMIO_DI,
+    GECKO_MMIO_SI,
+    GECKO_MMIO_EXI,
+    GECKO_MMIO_AI,
+    GECKO_MMIO_GX_FIFO,
+    GECKO_MMIO_DEVICE_COUNT
+} Gecko_MMIO_Device;
+
+// Handlers receive the register offset relative to the device base
+typedef uint16_t (*Gecko_MMIO_Read16)(void *opaque, uint32_t offset);
+typedef void     (*Gecko_MMIO_Write16)(void *opaque, uint32_t offset, uint16_t value);
+typedef uint32_t (*Gecko_MMIO_Read32)(void *opaque, uint32_t offset);
+typedef void     (*Gecko_MMIO_Write32)(void *opaque, uint32_t offset, uint32_t value);
+typedef void     (*Gecko_MMIO_FifoWrite)(void *opaque, uint32_t value, int size);   // size 1, 2 or 4
+
+typedef struct {
+    Gecko_MMIO_Read16 read16;
+    Gecko_MMIO_Write16 write16;
+    Gecko_MMIO_Read32 read32;
+    Gecko_MMIO_Write32 write32;
+    void *opaque;                   // Passed back to every handler
+    uint16_t reg_offset;            // Offset the handler was registered at
+} Gecko_MMIO_Handler;
+
+typedef struct {
+    uint8_t block_device[GECKO_MMIO_BLOCK_COUNT];                          // 1 KB block -> device
+    Gecko_MMIO_Handler handlers[GECKO_MMIO_DEVICE_COUNT][GECKO_MMIO_REG_SLOTS];
+    uint8_t latch[GECKO_MMIO_DEVICE_COUNT][GECKO_MMIO_BLOCK_SIZE];          // Big-endian backing for unhandled registers
+    Gecko_MMIO_FifoWrite fifo_write;                                        // GX FIFO pushes (NULL drops them)
+    void *fifo_opaque;
+} Gecko_MMIO;
+
+/**
+ * Reset the MMIO dispatch tables (no handlers, all latches zero)
+ * @param mmio Pointer to MMIO dispatch state
+ */
+static inline void gecko_mmio_init(Gecko_MMIO *mmio) {
+    static const uint16_t device_base[GECKO_MMIO_DEVICE_COUNT] = {
+        GECKO_MMIO_CP_BASE, GECKO_MMIO_PE_BASE, GECKO_MMIO_VI_BASE, GECKO_MMIO_PI_BASE,
+        GECKO_MMIO_MI_BASE, GECKO_MMIO_DSP_BASE, GECKO_MMIO_DI_BASE, GECKO_MMIO_SI_BASE,
+        GECKO_MMIO_EXI_BASE, GECKO_MMIO_AI_BASE, GECKO_MMIO_GX_FIFO_BASE
+    };
+    
+    memset(mmio, 0, sizeof(*mmio));
+    memset(mmio->block_device, GECKO_MMIO_NONE, sizeof(mmio->block_device));
+    for (int dev = 0; dev < GECKO_MMIO_DEVICE_COUNT; dev++) {
+        mmio->block_device[device_base[dev] >> GECKO_MMIO_BLOCK_SHIFT] = (uint8_t)dev;
+    }
+}
+
+/**
+ * Register 16-bit handlers for a device register
+ * @param mmio Pointer to MMIO dispatch state
+ * @param dev Device owning the register
+ * @param offset Register offset from the device base (halfword aligned)
+ * @param read Read handler (NULL reads the latch)
+ * @param write Write handler (NULL only updates the latch)
+ * @param opaque User pointer passed to the handlers
+ * @return 0 on success, -1 on invalid device or offset
+ */
+static inline int gecko_mmio_register16(Gecko_MMIO *mmio, Gecko_MMIO_Device dev, uint32_t offset,
+                                        Gecko_MMIO_Read16 read, Gecko_MMIO_Write16 write, void *opaque) {
+    if ((unsigned)dev >= GECKO_MMIO_DEVICE_COUNT || offset >= GECKO_MMIO_BLOCK_SIZE || (offset & 1)) return -1;
+    
+    Gecko_MMIO_Handler *h = &mmio->handlers[dev][offset >> 1];
+    memset(h, 0, sizeof(*h));
+    h->read16 = read;
+    h->write16 = write;
+    h->opaque = opaque;
+    h->reg_offset = (uint16_t)offset;
+    return 0;
+}
+
+/**
+ * Register 32-bit handlers for a device register
+ * Halfword accesses to either half are routed through the 32-bit handlers.
+ * @param mmio Pointer to MMIO dispatch state
+ * @param dev Device owning the register
+ * @param offset Register offset from the device base (word aligned)
+ * @param read Read handler (NULL reads the latch)
+ * @param write Write handler (NULL only updates the latch)
+ * @param opaque User pointer passed to the handlers
+ * @return 0 on success, -1 on invalid device or offset
+ */
+static inline int gecko_mmio_register32(Gecko_MMIO *mmio, Gecko_MMIO_Device dev, uint32_t offset,
+                                        Gecko_MMIO_Read32 read, Gecko_MMIO_Write32 write, void *opaque) {
+    if ((unsigned)dev >= GECKO_MMIO_DEVICE_COUNT || offset >= GECKO_MMIO_BLOCK_SIZE || (offset & 3)) return -1;
+    
+    for (uint32_t slot = offset >> 1; slot < (offset >> 1) + 2; slot++) {
+        Gecko_MMIO_Handler *h = &mmio->handlers[dev][slot];
+        memset(h, 0, sizeof(*h));
+        h->read32 = read;
+        h->write32 = write;
+        h->opaque = opaque;
+        h->reg_offset = (uint16_t)offset;
+    }
+    return 0;
+}
+
+/**
+ * Register the GX write-gather FIFO handler
+ * Every store to the FIFO block is passed on whole, with its size, instead of
+ * being split into halfword register writes.
+ * @param mmio Pointer to MMIO dispatch state
+ * @param write Push handler (NULL drops FIFO writes)
+ * @param opaque User pointer passed to the handler
+ */
+static inline void gecko_mmio_register_fifo(Gecko_MMIO *mmio, Gecko_MMIO_FifoWrite write, void *opaque) {
+    mmio->fifo_write = write;
+    mmio->fifo_opaque = opaque;
+}
+
+/**
+ * Read a big-endian value from a device latch
+ */
+static inline uint32_t gecko_mmio_latch_get(const uint8_t *latch, uint32_t offset, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value = (value << 8) | latch[(offset + i) & (GECKO_MMIO_BLOCK_SIZE - 1)];
+    }
+    return value;
+}
+
+/**
+ * Store a big-endian value into a device latch
+ */
+static inline void gecko_mmio_latch_set(uint8_t *latch, uint32_t offset, int size, uint32_t value) {
+    for (int i = size - 1; i >= 0; i--) {
+        latch[(offset + i) & (GECKO_MMIO_BLOCK_SIZE - 1)] = value & 0xFF;
+        value >>= 8;
+    }
+}
+
+/**
+ * Dispatch a 16-bit MMIO read
+ * @param mmio Pointer to MMIO dispatch state
+ * @param hwoff Offset from HWREG_BASE (halfword aligned)
+ * @return Register value (0xFFFF if no device decodes the address)
+ */
+static inline uint16_t gecko_mmio_read16(const Gecko_MMIO *mmio, uint32_t hwoff) {
+    uint32_t dev = mmio->block_device[(hwoff >> GECKO_MMIO_BLOCK_SHIFT) & (GECKO_MMIO_BLOCK_COUNT - 1)];
+    if (dev == GECKO_MMIO_NONE) return 0xFFFF;
+    
+    uint32_t offset = hwoff & (GECKO_MMIO_BLOCK_SIZE - 1);
+    const Gecko_MMIO_Handler *h = &mmio->handlers[dev][offset >> 1];
+    
+    if (h->read16) {
+        return h->read16(h->opaque, offset);
+    }
+    if (h->read32) {
+        uint32_t value = h->read32(h->opaque, h->reg_offset);
+        return (offset == h->reg_offset) ? (uint16_t)(value >> 16) : (uint16_t)value;
+    }
+    return (uint16_t)gecko_mmio_latch_get(mmio->latch[dev], offset, 2);
+}
+
+/**
+ * Dispatch a 16-bit MMIO write (the latch always records the value)
+ * @param mmio Pointer to MMIO dispatch state
+ * @param hwoff Offset from HWREG_BASE (halfword aligned)
+ * @param value Value to write
+ */
+static inline void gecko_mmio_write16(Gecko_MMIO *mmio, uint32_t hwoff, uint16_t value) {
+    uint32_t dev = mmio->block_device[(hwoff >> GECKO_MMIO_BLOCK_SHIFT) & (GECKO_MMIO_BLOCK_COUNT - 1)];
+    if (dev == GECKO_MMIO_NONE) return;
+    
+    if (dev == GECKO_MMIO_GX_FIFO) {
+        if (mmio->fifo_write) mmio->fifo_write(mmio->fifo_opaque, value, 2);
+        return;
+    }
+    
+    uint32_t offset = hwoff & (GECKO_MMIO_BLOCK_SIZE - 1);
+    const Gecko_MMIO_Handler *h = &mmio->handlers[dev][offset >> 1];
+    
+    gecko_mmio_latch_set(mmio->latch[dev], offset, 2, value);
+    
+    if (h->write16) {
+        h->write16(h->opaque, offset, value);
+    } else if (h->write32) {
+        // Half-word write to a word register: merge with the latched other half
+        h->write32(h->opaque, h->reg_offset, gecko_mmio_latch_get(mmio->latch[dev], h->reg_offset, 4));
+    }
+}
+
+/**
+ * Dispatch a 32-bit MMIO read
+ * Registers without a 32-bit handler are read as two halfwords.
+ * @param mmio Pointer to MMIO dispatch state
+ * @param hwoff Offset from HWREG_BASE (halfword aligned)
+ * @return Register value
+ */
+static inline uint32_t gecko_mmio_read32(const Gecko_MMIO *mmio, uint32_t hwoff) {
+    uint32_t dev = mmio->block_device[(hwoff >> GECKO_MMIO_BLOCK_SHIFT) & (GECKO_MMIO_BLOCK_COUNT - 1)];
+    
+    if (dev != GECKO_MMIO_NONE) {
+        uint32_t offset = hwoff & (GECKO_MMIO_BLOCK_SIZE - 1);
+        const Gecko_MMIO_Handler *h = &mmio->handlers[dev][offset >> 1];
+        if (h->read32 && h->reg_offset == offset) {
+            return h->read32(h->opaque, offset);
+        }
+    }
+    
+    return ((uint32_t)gecko_mmio_read16(mmio, hwoff) << 16) | gecko_mmio_read16(mmio, hwoff + 2);
+}
+
+/**
+ * Dispatch a 32-bit MMIO write
+ * Registers without a 32-bit handler are written as two halfwords.
+ * @param mmio Pointer to MMIO dispatch state
+ * @param hwoff Offset from HWREG_BASE (halfword aligned)
+ * @param value Value to write
+ */
+static inline void gecko_mmio_write32(Gecko_MMIO *mmio, uint32_t hwoff, uint32_t value) {
+    uint32_t dev = mmio->block_device[(hwoff >> GECKO_MMIO_BLOCK_SHIFT) & (GECKO_MMIO_BLOCK_COUNT - 1)];
+    
+    if (dev == GECKO_MMIO_GX_FIFO) {
+        if (mmio->fifo_write) mmio->fifo_write(mmio->fifo_opaque, value, 4);
+        return;
+    }
+    if (dev != GECKO_MMIO_NONE) {
+        uint32_t offset = hwoff & (GECKO_MMIO_BLOCK_SIZE - 1);
+        const Gecko_MMIO_Handler *h = &mmio->handlers[dev][offset >> 1];
+        if (h->write32 && h->reg_offset == offset) {
+            gecko_mmio_latch_set(mmio->latch[dev], offset, 4, value);
+            h->write32(h->opaque, offset, value);
+            return;
+        }
+    }
+    
+    gecko_mmio_write16(mmio, hwoff, (uint16_t)(value >> 16));
+    gecko_mmio_write16(mmio, hwoff + 2, (uint16_t)value);
+}
+
+/**
+ * Dispatch an 8-bit MMIO write
+ * The byte is merged into the latched halfword, so no read handler runs.
+ * @param mmio Pointer to MMIO dispatch state
+ * @param hwoff Offset from HWREG_BASE
+ * @param value Value to write
+ */
+static inline void gecko_mmio_write8(Gecko_MMIO *mmio, uint32_t hwoff, uint8_t value) {
+    uint32_t dev = mmio->block_device[(hwoff >> GECKO_MMIO_BLOCK_SHIFT) & (GECKO_MMIO_BLOCK_COUNT - 1)];
+    if (dev == GECKO_MMIO_NONE) return;
+    
+    if (dev == GECKO_MMIO_GX_FIFO) {
+        if (mmio->fifo_write) mmio->fifo_write(mmio->fifo_opaque, value, 1);
+        return;
+    }
+    
+    uint32_t half_offset = hwoff & (GECKO_MMIO_BLOCK_SIZE - 2);
+    uint16_t half = (uint16_t)gecko_mmio_latch_get(mmio->latch[dev], half_offset, 2);
+    half = (hwoff & 1) ? (uint16_t)((half & 0xFF00) | value) : (uint16_t)((half & 0x00FF) | (value << 8));
+    gecko_mmio_write16(mmio, hwoff & ~1u, half);
+}
+
 //==============================================================================
 // MAIN MEMORY STRUCTURE
 //==============================================================================
@@ -355,9 +676,12 @@ typedef struct {
     // Audio RAM (16 MB - used by DSP)
     uint8_t *aram;
     
-    // Hardware Registers (memory-mapped I/O)
+    // Hardware Registers (emulator-side device state)
     HW_Registers hw_regs;           // Direct struct instead of pointer (simplified)
     
+    // MMIO dispatch for guest accesses to 0xCC000000-0xCC00FFFF
+    Gecko_MMIO mmio;
+    
     // Locked L1 Cache (can be used as scratchpad - 16 KB)
     uint8_t locked_cache[16 * 1024];
     
@@ -365,12 +689,52 @@ typedef struct {
     bool is_wii;                    // true = Wii mode, false = GameCube mode
     bool mem2_enabled;              // true = MEM2 allocated and available
     bool aram_enabled;              // true = ARAM allocated
+    
+    // Software TLB: host pointer to the start of each RAM page, NULL for MMIO/unmapped
+    uint8_t *page_table[GECKO_PAGE_COUNT];
 } Gecko_Memory;
 
 //==============================================================================
 // MEMORY ACCESS HELPER FUNCTIONS
 //==============================================================================
 
+/**
+ * Map a contiguous host buffer into the software TLB
+ * @param mem Pointer to memory structure
+ * @param vbase Page-aligned guest address of the first page
+ * @param host Host buffer backing the range (NULL unmaps it)
+ * @param size Size of the range in bytes (multiple of GECKO_PAGE_SIZE)
+ */
+static inline void gecko_map_pages(Gecko_Memory *mem, uint32_t vbase, uint8_t *host, uint32_t size) {
+    uint32_t first = vbase >> GECKO_PAGE_SHIFT;
+    uint32_t count = size >> GECKO_PAGE_SHIFT;
+    
+    for (uint32_t i = 0; i < count && first + i < GECKO_PAGE_COUNT; i++) {
+        mem->page_table[first + i] = host ? host + ((size_t)i << GECKO_PAGE_SHIFT) : NULL;
+    }
+}
+
+/**
+ * Rebuild the software TLB from the current memory configuration
+ * Hardware registers and the locked cache stay unmapped so they take the slow path.
+ * @param mem Pointer to memory structure
+ */
+static inline void gecko_memory_build_page_table(Gecko_Memory *mem) {
+    memset(mem->page_table, 0, sizeof(mem->page_table));
+    
+    // MEM1: physical, cached and uncached mirrors
+    gecko_map_pages(mem, PHYS_BASE, mem->mem1, MEM1_SIZE);
+    gecko_map_pages(mem, CACHED_BASE, mem->mem1, MEM1_SIZE);
+    gecko_map_pages(mem, UNCACHED_BASE, mem->mem1, MEM1_SIZE);
+    
+    // MEM2 (Wii): physical, cached and uncached mirrors
+    if (mem->mem2_enabled && mem->mem2) {
+        gecko_map_pages(mem, 0x10000000, mem->mem2, MEM2_SIZE);
+        gecko_map_pages(mem, 0x90000000, mem->mem2, MEM2_SIZE);
+        gecko_map_pages(mem, 0xD0000000, mem->mem2, MEM2_SIZE);
+    }
+}
+
 /**
  * Initialize memory structure
  * @param mem Pointer to memory structure
@@ -390,6 +754,7 @@ static inline int gecko_memory_init(Gecko_Memory *mem, bool is_wii) {
     
     // Clear hardware registers
     memset(&mem->hw_regs, 0, sizeof(HW_Registers));
+    gecko_mmio_init(&mem->mmio);
     
     // Allocate MEM2 if Wii mode
     if (is_wii) {
@@ -408,6 +773,9 @@ static inline int gecko_memory_init(Gecko_Memory *mem, bool is_wii) {
     // Clear locked cache
     memset(mem->locked_cache, 0, sizeof(mem->locked_cache));
     
+    // Populate the software TLB for all RAM mirrors
+    gecko_memory_build_page_table(mem);
+    
     return 0;
 }
 
@@ -438,6 +806,7 @@ static inline void gecko_memory_free(Gecko_Memory *mem) {
         free(mem->mem2);
         mem->mem2 = NULL;
         mem->mem2_enabled = false;
+        gecko_memory_build_page_table(mem);
     }
     
     if (mem->aram) {
@@ -449,30 +818,14 @@ static inline void gecko_memory_free(Gecko_Memory *mem) {
 
 /**
  * Translate virtual address to physical address
+ * Table-driven (see address_map.h): one load, one compare and a select.
  * @param vaddr Virtual address (effective address)
- * @return Physical address
+ * @return Physical address (unmapped and physical addresses are returned unchanged)
  */
 static inline uint32_t gecko_translate_address(uint32_t vaddr) {
-    // Handle common virtual address mirrors
-    if (vaddr >= 0x80000000 && vaddr < 0x81800000) {
-        // Cached mirror of MEM1
-        return vaddr & 0x01FFFFFF;
-    } else if (vaddr >= 0xC0000000 && vaddr < 0xC1800000) {
-        // Uncached mirror of MEM1
-        return vaddr & 0x01FFFFFF;
-    } else if (vaddr >= 0x90000000 && vaddr < 0x94000000) {
-        // Cached mirror of MEM2 (Wii)
-        return vaddr & 0x03FFFFFF;
-    } else if (vaddr >= 0xD0000000 && vaddr < 0xD4000000) {
-        // Uncached mirror of MEM2 (Wii)
-        return vaddr & 0x03FFFFFF;
-    } else if (vaddr >= 0xCC000000 && vaddr < 0xCD000000) {
-        // Hardware registers (uncached)
-        return (vaddr & 0x00FFFFFF) | 0x0C000000;
-    }
-    
-    // Already physical address or unmapped
-    return vaddr;
+    uint32_t paddr;
+    gc_address_map_lookup(gc_phys_slots, vaddr, &paddr);
+    return paddr;
 }
 
 /**
@@ -482,6 +835,11 @@ static inline uint32_t gecko_translate_address(uint32_t vaddr) {
  * @return 8-bit value
  */
 static inline uint8_t gecko_read8(const Gecko_Memory *mem, uint32_t vaddr) {
+    const uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    if (page) {
+        return page[vaddr & GECKO_PAGE_MASK];
+    }
+    
     uint32_t paddr = gecko_translate_address(vaddr);
     
     // MEM1
@@ -494,10 +852,10 @@ static inline uint8_t gecko_read8(const Gecko_Memory *mem, uint32_t vaddr) {
         return mem->mem2[paddr - 0x10000000];
     }
     
-    // Hardware registers
-    if (paddr >= 0x0C000000 && paddr < 0x0D000000) {
-        uint32_t offset = paddr - 0x0C000000;
-        return ((const uint8_t*)&mem->hw_regs)[offset];
+    // Hardware registers: byte access goes through the halfword handlers
+    if (GECKO_IS_MMIO(paddr)) {
+        uint16_t half = gecko_mmio_read16(&mem->mmio, (paddr - HWREG_BASE) & ~1u);
+        return (paddr & 1) ? (uint8_t)half : (uint8_t)(half >> 8);
     }
     
     // Unmapped
@@ -511,6 +869,12 @@ static inline uint8_t gecko_read8(const Gecko_Memory *mem, uint32_t vaddr) {
  * @param value 8-bit value to write
  */
 static inline void gecko_write8(Gecko_Memory *mem, uint32_t vaddr, uint8_t value) {
+    uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    if (page) {
+        page[vaddr & GECKO_PAGE_MASK] = value;
+        return;
+    }
+    
     uint32_t paddr = gecko_translate_address(vaddr);
     
     // MEM1
@@ -525,14 +889,29 @@ static inline void gecko_write8(Gecko_Memory *mem, uint32_t vaddr, uint8_t value
         return;
     }
     
-    // Hardware registers
-    if (paddr >= 0x0C000000 && paddr < 0x0D000000) {
-        uint32_t offset = paddr - 0x0C000000;
-        ((uint8_t*)&mem->hw_regs)[offset] = value;
+    // Hardware registers: merge the byte into the latched halfword (no read side effects)
+    if (GECKO_IS_MMIO(paddr)) {
+        gecko_mmio_write8(&mem->mmio, paddr - HWREG_BASE, value);
         return;
     }
 }
 
+/**
+ * Look up the host pointer for a guest address in the software TLB
+ * @param mem Pointer to memory structure
+ * @param vaddr Virtual address
+ * @return Host pointer, or NULL if the page is MMIO or unmapped
+ */
+static inline uint8_t* gecko_tlb_lookup(const Gecko_Memory *mem, uint32_t vaddr) {
+    uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    return page ? page + (vaddr & GECKO_PAGE_MASK) : NULL;
+}
+
+/**
+ * Check whether an access of the given size stays within one page
+ */
+#define GECKO_SAME_PAGE(vaddr, size) (((vaddr) & GECKO_PAGE_MASK) <= GECKO_PAGE_SIZE - (size))
+
 /**
  * Read 16-bit value from memory (big-endian)
  * @param mem Pointer to memory structure
@@ -540,6 +919,22 @@ static inline void gecko_write8(Gecko_Memory *mem, uint32_t vaddr, uint8_t value
  * @return 16-bit value
  */
 static inline uint16_t gecko_read16(const Gecko_Memory *mem, uint32_t vaddr) {
+    const uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    
+    // Fast path: RAM page, access does not straddle a page boundary
+    if (page && GECKO_SAME_PAGE(vaddr, 2)) {
+        uint16_t value;
+        memcpy(&value, page + (vaddr & GECKO_PAGE_MASK), sizeof(value));
+        return GECKO_BSWAP16(value);
+    }
+    
+    // MMIO: dispatch aligned accesses to the device handlers
+    uint32_t paddr = gecko_translate_address(vaddr);
+    if (GECKO_IS_MMIO(paddr) && !(paddr & 1)) {
+        return gecko_mmio_read16(&mem->mmio, paddr - HWREG_BASE);
+    }
+    
+    // Slow path: unmapped or page-crossing
     uint8_t b0 = gecko_read8(mem, vaddr);
     uint8_t b1 = gecko_read8(mem, vaddr + 1);
     return ((uint16_t)b0 << 8) | b1;
@@ -552,6 +947,20 @@ static inline uint16_t gecko_read16(const Gecko_Memory *mem, uint32_t vaddr) {
  * @param value 16-bit value to write
  */
 static inline void gecko_write16(Gecko_Memory *mem, uint32_t vaddr, uint16_t value) {
+    uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    
+    if (page && GECKO_SAME_PAGE(vaddr, 2)) {
+        uint16_t swapped = GECKO_BSWAP16(value);
+        memcpy(page + (vaddr & GECKO_PAGE_MASK), &swapped, sizeof(swapped));
+        return;
+    }
+    
+    uint32_t paddr = gecko_translate_address(vaddr);
+    if (GECKO_IS_MMIO(paddr) && !(paddr & 1)) {
+        gecko_mmio_write16(&mem->mmio, paddr - HWREG_BASE, value);
+        return;
+    }
+    
     gecko_write8(mem, vaddr, (value >> 8) & 0xFF);
     gecko_write8(mem, vaddr + 1, value & 0xFF);
 }
@@ -563,6 +972,22 @@ static inline void gecko_write16(Gecko_Memory *mem, uint32_t vaddr, uint16_t val
  * @return 32-bit value
  */
 static inline uint32_t gecko_read32(const Gecko_Memory *mem, uint32_t vaddr) {
+    const uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    
+    // Fast path: RAM page, access does not straddle a page boundary
+    if (page && GECKO_SAME_PAGE(vaddr, 4)) {
+        uint32_t value;
+        memcpy(&value, page + (vaddr & GECKO_PAGE_MASK), sizeof(value));
+        return GECKO_BSWAP32(value);
+    }
+    
+    // MMIO: dispatch aligned accesses to the device handlers
+    uint32_t paddr = gecko_translate_address(vaddr);
+    if (GECKO_IS_MMIO(paddr) && !(paddr & 1)) {
+        return gecko_mmio_read32(&mem->mmio, paddr - HWREG_BASE);
+    }
+    
+    // Slow path: unmapped or page-crossing
     uint8_t b0 = gecko_read8(mem, vaddr);
     uint8_t b1 = gecko_read8(mem, vaddr + 1);
     uint8_t b2 = gecko_read8(mem, vaddr + 2);
@@ -577,6 +1002,20 @@ static inline uint32_t gecko_read32(const Gecko_Memory *mem, uint32_t vaddr) {
  * @param value 32-bit value to write
  */
 static inline void gecko_write32(Gecko_Memory *mem, uint32_t vaddr, uint32_t value) {
+    uint8_t *page = mem->page_table[vaddr >> GECKO_PAGE_SHIFT];
+    
+    if (page && GECKO_SAME_PAGE(vaddr, 4)) {
+        uint32_t swapped = GECKO_BSWAP32(value);
+        memcpy(page + (vaddr & GECKO_PAGE_MASK), &swapped, sizeof(swapped));
+        return;
+    }
+    
+    uint32_t paddr = gecko_translate_address(vaddr);
+    if (GECKO_IS_MMIO(paddr) && !(paddr & 1)) {
+        gecko_mmio_write32(&mem->mmio, paddr - HWREG_BASE, value);
+        return;
+    }
+    
     gecko_write8(mem, vaddr, (value >> 24) & 0xFF);
     gecko_write8(mem, vaddr + 1, (value >> 16) & 0xFF);
     gecko_write8(mem, vaddr + 2, (value >> 8) & 0xFF);
@@ -591,6 +1030,11 @@ static inline void gecko_write32(Gecko_Memory *mem, uint32_t vaddr, uint32_t val
  * @return Pointer to memory or NULL if invalid
  */
 static inline void* gecko_get_pointer(Gecko_Memory *mem, uint32_t vaddr) {
+    uint8_t *host = gecko_tlb_lookup(mem, vaddr);
+    if (host) {
+        return host;
+    }
+    
     uint32_t paddr = gecko_translate_address(vaddr);
     
     // MEM1
@@ -603,15 +1047,217 @@ static inline void* gecko_get_pointer(Gecko_Memory *mem, uint32_t vaddr) {
         return &mem->mem2[paddr - 0x10000000];
     }
     
-    // Hardware registers
-    if (paddr >= 0x0C000000 && paddr < 0x0D000000) {
-        uint32_t offset = paddr - 0x0C000000;
-        return (uint8_t*)&mem->hw_regs + offset;
+    // Hardware registers: raw latch storage (bypasses handlers)
+    if (GECKO_IS_MMIO(paddr)) {
+        uint32_t hwoff = paddr - HWREG_BASE;
+        uint32_t dev = mem->mmio.block_device[hwoff >> GECKO_MMIO_BLOCK_SHIFT];
+        if (dev == GECKO_MMIO_NONE) return NULL;
+        return &mem->mmio.latch[dev][hwoff & (GECKO_MMIO_BLOCK_SIZE - 1)];
     }
     
     return NULL;
 }
 
+//==============================================================================
+// BULK TRANSFERS
+//==============================================================================
+
+/**
+ * Number of bytes from vaddr to the end of its page, capped at size
+ */
+static inline uint32_t gecko_page_chunk(uint32_t vaddr, uint32_t size) {
+    uint32_t left = GECKO_PAGE_SIZE - (vaddr & GECKO_PAGE_MASK);
+    return size < left ? size : left;
+}
+
+/**
+ * Number of bytes from the start of the page holding vend - 1 to vend, capped at size
+ */
+static inline uint32_t gecko_page_chunk_before(uint32_t vend, uint32_t size) {
+    uint32_t left = ((vend - 1) & GECKO_PAGE_MASK) + 1;
+    return size < left ? size : left;
+}
+
+/**
+ * Copy a block of guest memory to another guest address
+ * Works page by page: RAM-to-RAM chunks use memmove, anything touching
+ * MMIO or unmapped space falls back to byte accesses. Overlapping blocks are
+ * handled like memmove: when the destination lies above the source (compared
+ * physically, so cached and uncached aliases count), pages go last to first.
+ * @param mem Pointer to memory structure
+ * @param dst Destination virtual address
+ * @param src Source virtual address
+ * @param size Number of bytes to copy
+ */
+static inline void gecko_memcpy(Gecko_Memory *mem, uint32_t dst, uint32_t src, uint32_t size) {
+    uint32_t pdst = gecko_translate_address(dst);
+    uint32_t psrc = gecko_translate_address(src);
+    if (pdst > psrc && pdst - psrc < size) {
+        while (size > 0) {
+            uint32_t chunk = gecko_page_chunk_before(src + size, size);
+            chunk = gecko_page_chunk_before(dst + size, chunk);
+            size -= chunk;
+            
+            uint8_t *d = gecko_tlb_lookup(mem, dst + size);
+            const uint8_t *s = gecko_tlb_lookup(mem, src + size);
+            if (d && s) {
+                memmove(d, s, chunk);
+            } else {
+                for (uint32_t i = chunk; i-- > 0;) {
+                    gecko_write8(mem, dst + size + i, gecko_read8(mem, src + size + i));
+                }
+            }
+        }
+        return;
+    }
+    
+    while (size > 0) {
+        uint32_t chunk = gecko_page_chunk(src, size);
+        chunk = gecko_page_chunk(dst, chunk);
+        
+        uint8_t *d = gecko_tlb_lookup(mem, dst);
+        const uint8_t *s = gecko_tlb_lookup(mem, src);
+        if (d && s) {
+            memmove(d, s, chunk);
+        } else {
+            for (uint32_t i = 0; i < chunk; i++) {
+                gecko_write8(mem, dst + i, gecko_read8(mem, src + i));
+            }
+        }
+        
+        dst += chunk;
+        src += chunk;
+        size -= chunk;
+    }
+}
+
+/**
+ * Fill a block of guest memory with a byte value
+ * @param mem Pointer to memory structure
+ * @param vaddr Destination virtual address
+ * @param value Fill byte
+ * @param size Number of bytes to fill
+ */
+static inline void gecko_memset(Gecko_Memory *mem, uint32_t vaddr, uint8_t value, uint32_t size) {
+    while (size > 0) {
+        uint32_t chunk = gecko_page_chunk(vaddr, size);
+        
+        uint8_t *d = gecko_tlb_lookup(mem, vaddr);
+        if (d) {
+            memset(d, value, chunk);
+        } else {
+            for (uint32_t i = 0; i < chunk; i++) {
+                gecko_write8(mem, vaddr + i, value);
+            }
+        }
+        
+        vaddr += chunk;
+        size -= chunk;
+    }
+}
+
+/**
+ * DMA a block from ARAM into main memory (ARQ / DSP streaming)
+ * @param mem Pointer to memory structure
+ * @param mem_vaddr Destination virtual address in MEM1/MEM2
+ * @param aram_addr Source offset in ARAM
+ * @param size Number of bytes to transfer
+ * @return 0 on success, -1 if ARAM is not allocated or the range is out of bounds
+ */
+static inline int gecko_dma_aram_to_mem(Gecko_Memory *mem, uint32_t mem_vaddr, uint32_t aram_addr, uint32_t size) {
+    if (!mem->aram_enabled || aram_addr > ARAM_SIZE || size > ARAM_SIZE - aram_addr) return -1;
+    
+    const uint8_t *s = mem->aram + aram_addr;
+    while (size > 0) {
+        uint32_t chunk = gecko_page_chunk(mem_vaddr, size);
+        
+        uint8_t *d = gecko_tlb_lookup(mem, mem_vaddr);
+        if (d) {
+            memcpy(d, s, chunk);
+        } else {
+            for (uint32_t i = 0; i < chunk; i++) {
+                gecko_write8(mem, mem_vaddr + i, s[i]);
+            }
+        }
+        
+        mem_vaddr += chunk;
+        s += chunk;
+        size -= chunk;
+    }
+    return 0;
+}
+
+/**
+ * DMA a block from main memory into ARAM
+ * @param mem Pointer to memory structure
+ * @param aram_addr Destination offset in ARAM
+ * @param mem_vaddr Source virtual address in MEM1/MEM2
+ * @param size Number of bytes to transfer
+ * @return 0 on success, -1 if ARAM is not allocated or the range is out of bounds
+ */
+static inline int gecko_dma_mem_to_aram(Gecko_Memory *mem, uint32_t aram_addr, uint32_t mem_vaddr, uint32_t size) {
+    if (!mem->aram_enabled || aram_addr > ARAM_SIZE || size > ARAM_SIZE - aram_addr) return -1;
+    
+    uint8_t *d = mem->aram + aram_addr;
+    while (size > 0) {
+        uint32_t chunk = gecko_page_chunk(mem_vaddr, size);
+        
+        const uint8_t *s = gecko_tlb_lookup(mem, mem_vaddr);
+        if (s) {
+            memcpy(d, s, chunk);
+        } else {
+            for (uint32_t i = 0; i < chunk; i++) {
+                d[i] = gecko_read8(mem, mem_vaddr + i);
+            }
+        }
+        
+        mem_vaddr += chunk;
+        d += chunk;
+        size -= chunk;
+    }
+    return 0;
+}
+
+/**
+ * Byte-swap a block of 32-bit words (big-endian guest <-> host)
+ * dst and src may be the same buffer; neither needs to be aligned.
+ * @param dst Destination buffer
+ * @param src Source buffer
+ * @param count Number of 32-bit words
+ */
+static inline void gecko_bswap32_block(void *dst, const void *src, size_t count) {
+    uint8_t *d = (uint8_t*)dst;
+    const uint8_t *s = (const uint8_t*)src;
+    size_t i = 0;
+    
+#if defined(GECKO_SIMD_SSSE3)
+    const __m128i shuffle = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i * 4));
+        _mm_storeu_si128((__m128i*)(d + i * 4), _mm_shuffle_epi8(v, shuffle));
+    }
+#elif defined(GECKO_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i * 4));
+        // Swap bytes within each halfword, then swap the halfwords
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+        _mm_storeu_si128((__m128i*)(d + i * 4), v);
+    }
+#elif defined(GECKO_SIMD_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u8(d + i * 4, vrev32q_u8(vld1q_u8(s + i * 4)));
+    }
+#endif
+    
+    for (; i < count; i++) {
+        uint32_t w;
+        memcpy(&w, s + i * 4, sizeof(w));
+        w = GECKO_BSWAP32(w);
+        memcpy(d + i * 4, &w, sizeof(w));
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
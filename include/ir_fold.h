@@ -0,0 +1,174 @@
+/**
+ * @file ir_fold.h
+ * @brief Identical-code folding over the program IR
+ *
+ * Each function's instruction stream is hashed in an address-independent form:
+ * direct branch displacements are replaced by what they reach (an offset inside
+ * the function, another function, or an absolute address outside any function).
+ * Functions with equal hashes are compared instruction by instruction, and every
+ * duplicate records the function whose body it will share in `canonical`.
+ */
+
+#ifndef IR_FOLD_H
+#define IR_FOLD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "program_ir.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Below this size a forwarder saves nothing
+#define IR_FOLD_MIN_INSTRUCTIONS    3
+
+// Candidate classes passed to ir_fold_identical()
+#define IR_FOLD_NONE            0   // Not emitted with a body (skipped, stubbed, ...)
+#define IR_FOLD_FILE            1   // Foldable; callable only from its own file (static)
+#define IR_FOLD_GLOBAL          2   // Foldable and callable from every file
+
+#define IR_FOLD_TARGET_LOCAL    1
+#define IR_FOLD_TARGET_FUNCTION 2
+#define IR_FOLD_TARGET_ABSOLUTE 3
+
+/**
+ * @brief Address-independent form of one instruction
+ * @param key Instruction word with any branch displacement cleared
+ * @param target Tagged branch destination (0 for non-branches)
+ */
+static inline void ir_fold_normalize(const Program_IR *ir, const IR_Function *fn, const IR_Instruction *insn,
+                                     uint32_t *key, uint64_t *target) {
+    *key = insn->word;
+    *target = 0;
+    if (!insn->target) return;
+
+    if (insn->opcode == 18) *key &= ~0x03FFFFFCu;
+    else if (insn->opcode == 16) *key &= ~0xFFFCu;
+
+    if (insn->target >= fn->start_address && insn->target < fn->end_address) {
+        *target = ((uint64_t)IR_FOLD_TARGET_LOCAL << 32) | (insn->target - fn->start_address);
+    } else {
+        const IR_Function *callee = ir_function_at(ir, insn->target);
+        if (callee) *target = ((uint64_t)IR_FOLD_TARGET_FUNCTION << 32) | (uint32_t)(callee - ir->functions);
+        else *target = ((uint64_t)IR_FOLD_TARGET_ABSOLUTE << 32) | insn->target;
+    }
+}
+
+/**
+ * @brief True if a function can share its body: self-contained and big enough to be worth it
+ */
+static inline bool ir_fold_eligible(const Program_IR *ir, const IR_Function *fn) {
+    if (fn->instruction_count < IR_FOLD_MIN_INSTRUCTIONS || fn->start_address == 0) return false;
+    for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+        if (ir->instructions[i].flags & IR_INSN_UNPARSED) return false;
+    }
+
+    // Must not run into whatever follows it
+    const IR_Instruction *last = &ir->instructions[fn->first_instruction + fn->instruction_count - 1];
+    return (last->flags & IR_INSN_BRANCH) && !(last->flags & (IR_INSN_CONDITIONAL | IR_INSN_LINK));
+}
+
+static inline uint64_t ir_fold_hash(const Program_IR *ir, const IR_Function *fn) {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+    for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+        uint32_t key;
+        uint64_t target;
+        ir_fold_normalize(ir, fn, &ir->instructions[i], &key, &target);
+        hash = (hash ^ key) * 0x100000001b3ULL;
+        hash = (hash ^ target) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static inline bool ir_fold_equal(const Program_IR *ir, const IR_Function *a, const IR_Function *b) {
+    if (a->instruction_count != b->instruction_count) return false;
+    for (uint32_t i = 0; i < a->instruction_count; i++) {
+        uint32_t key_a, key_b;
+        uint64_t target_a, target_b;
+        ir_fold_normalize(ir, a, &ir->instructions[a->first_instruction + i], &key_a, &target_a);
+        ir_fold_normalize(ir, b, &ir->instructions[b->first_instruction + i], &key_b, &target_b);
+        if (key_a != key_b || target_a != target_b) return false;
+    }
+    return true;
+}
+
+typedef struct {
+    uint64_t hash;
+    uint32_t address;
+    uint32_t function;
+} IR_Fold_Entry;
+
+// By hash, then by address so a group is resolved lowest address first
+static inline int ir_fold_cmp(const void *a, const void *b) {
+    const IR_Fold_Entry *x = (const IR_Fold_Entry*)a, *y = (const IR_Fold_Entry*)b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    if (x->address != y->address) return x->address < y->address ? -1 : 1;
+    return (x->function > y->function) - (x->function < y->function);
+}
+
+/**
+ * @brief Fold byte-identical functions onto one body
+ * @param ir Finalized program IR (canonical fields are rewritten)
+ * @param candidates Per function: IR_FOLD_NONE / IR_FOLD_FILE / IR_FOLD_GLOBAL
+ * @return Number of functions folded onto another one
+ *
+ * Within a group the lowest-address candidate that every member can call
+ * becomes canonical: an IR_FOLD_GLOBAL function, or one in the member's own file.
+ * Members are resolved in address order, so every candidate has already kept its
+ * body or been folded: a canonical function is never itself a forwarder.
+ */
+static inline int ir_fold_identical(Program_IR *ir, const uint8_t *candidates) {
+    for (uint32_t f = 0; f < ir->function_count; f++) ir->functions[f].canonical = IR_NONE;
+
+    IR_Fold_Entry *entries = (IR_Fold_Entry*)malloc(sizeof(IR_Fold_Entry) * (ir->function_count + 1));
+    if (!entries) return 0;
+    uint32_t count = 0;
+    for (uint32_t slot = 0; slot < ir->function_count; slot++) {
+        uint32_t f = ir->by_address[slot];
+        if (candidates[f] == IR_FOLD_NONE || !ir_fold_eligible(ir, &ir->functions[f])) continue;
+        entries[count].hash = ir_fold_hash(ir, &ir->functions[f]);
+        entries[count].address = ir->functions[f].start_address;
+        entries[count].function = f;
+        count++;
+    }
+    qsort(entries, count, sizeof(IR_Fold_Entry), ir_fold_cmp);
+
+    int folded = 0;
+    for (uint32_t start = 0; start < count; ) {
+        uint32_t end = start + 1;
+        while (end < count && entries[end].hash == entries[start].hash) end++;
+
+        for (uint32_t i = start; i < end; i++) {
+            IR_Function *member = &ir->functions[entries[i].function];
+            if (member->canonical != IR_NONE) continue;
+
+            // Lowest address among the earlier members that kept their body, match, and this one can call
+            uint32_t best = IR_NONE;
+            for (uint32_t j = start; j < end; j++) {
+                uint32_t c = entries[j].function;
+                const IR_Function *candidate = &ir->functions[c];
+                if (c == entries[i].function || candidate->canonical != IR_NONE) continue;
+                if (candidate->start_address > member->start_address) continue;
+                if (candidates[c] != IR_FOLD_GLOBAL && candidate->file != member->file) continue;
+                if (best != IR_NONE && ir->functions[best].start_address <= candidate->start_address) continue;
+                if (ir_fold_equal(ir, candidate, member)) best = c;
+            }
+            if (best != IR_NONE) {
+                member->canonical = best;
+                folded++;
+            }
+        }
+        start = end;
+    }
+
+    free(entries);
+    return folded;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IR_FOLD_H
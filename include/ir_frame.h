@@ -0,0 +1,353 @@
+/**
+ * @file ir_frame.h
+ * @brief Stack-frame escape analysis: promote r1 spill slots to C locals
+ *
+ * A frame opened by `stwu r1, -N(r1)` is private to its function as long as r1
+ * is only used as the base of D-form loads and stores with constant offsets.
+ * Each slot (offset, width, kind) accessed consistently is then a C local
+ * instead of emulated memory. When no access is left in memory, the prologue
+ * `stwu` and the epilogue `addi r1, r1, N` are dropped as well.
+ *
+ * Slots stay in memory when they:
+ *   - overlap another access of a different offset, width or kind (stw + lfd
+ *     int-to-float conversion, partial reads)
+ *   - lie in the back chain (0..7) or in the caller's frame (>= N, except the
+ *     LR save word at N+4 that belongs to this function)
+ *   - lie in the outgoing argument area (8..) that a callee reads its stack
+ *     arguments from
+ */
+
+#ifndef IR_FRAME_H
+#define IR_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "program_ir.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IR_FRAME_INT            0
+#define IR_FRAME_SINGLE         1   // lfs / stfs
+#define IR_FRAME_DOUBLE         2   // lfd / stfd
+
+#define IR_FRAME_LINKAGE        8   // Back chain + LR save word at the bottom of every frame
+
+typedef struct {
+    uint32_t instruction;
+    int32_t offset;             // From r1 after the prologue
+    uint8_t width;              // Bytes per register
+    uint8_t kind;               // IR_FRAME_INT / SINGLE / DOUBLE
+    uint8_t reg;                // First register
+    uint8_t count;              // Registers moved (stmw / lmw), else 1
+    bool store;
+    bool sign;                  // lha
+    bool promoted;
+} IR_Frame_Access;
+
+typedef struct {
+    uint32_t size;              // N of `stwu r1, -N(r1)` (0 without a frame)
+    uint32_t prologue;          // Instruction index of the stwu (IR_NONE)
+    bool escapes;               // r1 used as anything but a load/store base or the frame adjust
+    uint32_t incoming;          // Bytes of stack arguments read from the caller's frame
+    IR_Frame_Access *accesses;
+    uint32_t access_count, access_capacity;
+} IR_Frame;
+
+/**
+ * @brief Decode an r1-relative D-form load or store
+ * @return true if `mnemonic operands` is one, with offset relative to the current r1
+ */
+static inline bool ir_frame_decode(const char *mnemonic, const char *operands, IR_Frame_Access *access) {
+    static const struct { const char *mnemonic; uint8_t width, kind; bool store, sign, multiple; } forms[] = {
+        {"lwz", 4, IR_FRAME_INT, false, false, false},   {"stw", 4, IR_FRAME_INT, true, false, false},
+        {"lhz", 2, IR_FRAME_INT, false, false, false},   {"lha", 2, IR_FRAME_INT, false, true, false},
+        {"sth", 2, IR_FRAME_INT, true, false, false},    {"lbz", 1, IR_FRAME_INT, false, false, false},
+        {"stb", 1, IR_FRAME_INT, true, false, false},    {"lfs", 4, IR_FRAME_SINGLE, false, false, false},
+        {"stfs", 4, IR_FRAME_SINGLE, true, false, false}, {"lfd", 8, IR_FRAME_DOUBLE, false, false, false},
+        {"stfd", 8, IR_FRAME_DOUBLE, true, false, false}, {"lmw", 4, IR_FRAME_INT, false, false, true},
+        {"stmw", 4, IR_FRAME_INT, true, false, true},
+    };
+    for (size_t i = 0; i < sizeof(forms) / sizeof(forms[0]); i++) {
+        if (strcmp(mnemonic, forms[i].mnemonic) != 0) continue;
+
+        char reg_class;
+        int reg, base;
+        int32_t offset;
+        if (sscanf(operands, "%c%d, %i(r%d)", &reg_class, &reg, &offset, &base) != 4 &&
+            sscanf(operands, "%c%d,%i(r%d)", &reg_class, &reg, &offset, &base) != 4) {
+            return false;
+        }
+        if (base != 1 || reg < 0 || reg > 31) return false;
+        if (reg_class != (forms[i].kind == IR_FRAME_INT ? 'r' : 'f')) return false;
+
+        access->offset = offset;
+        access->width = forms[i].width;
+        access->kind = forms[i].kind;
+        access->reg = (uint8_t)reg;
+        access->count = forms[i].multiple ? (uint8_t)(32 - reg) : 1;
+        access->store = forms[i].store;
+        access->sign = forms[i].sign;
+        access->promoted = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief True if r1 appears as a register operand
+ */
+static inline bool ir_frame_mentions_r1(const char *operands) {
+    for (const char *p = operands; (p = strstr(p, "r1")) != NULL; p += 2) {
+        bool starts = p == operands || strchr(" ,(\t", p[-1]) != NULL;
+        bool ends = p[2] == '\0' || strchr(" ,)\t\n", p[2]) != NULL;
+        if (starts && ends) return true;
+    }
+    return false;
+}
+
+static inline void ir_frame_free(IR_Frame *frame) {
+    free(frame->accesses);
+    memset(frame, 0, sizeof(*frame));
+}
+
+/**
+ * @brief Collect a function's frame and r1-relative accesses
+ *
+ * Accesses before the prologue and after an epilogue (`addi r1, r1, N` or
+ * `lwz r1, 0(r1)`) are rebased onto the frame. The prologue must come before any label or branch.
+ */
+static inline void ir_frame_collect(const Program_IR *ir, const IR_Function *fn, IR_Frame *frame) {
+    memset(frame, 0, sizeof(*frame));
+    frame->prologue = IR_NONE;
+
+    uint32_t end = fn->first_instruction + fn->instruction_count;
+    for (uint32_t i = fn->first_instruction; i < end; i++) {
+        const IR_Instruction *insn = &ir->instructions[i];
+        if (insn->flags & IR_INSN_UNPARSED) continue;
+        if (insn->flags & (IR_INSN_BRANCH | IR_INSN_LABELED)) {
+            if (i != fn->first_instruction || (insn->flags & IR_INSN_BRANCH)) break;
+        }
+        int32_t size;
+        if (strcmp(ir_mnemonic(ir, insn), "stwu") == 0 &&
+            sscanf(ir_operands(ir, insn), "r1, %i(r1)", &size) == 1 && size < 0) {
+            frame->size = (uint32_t)-size;
+            frame->prologue = i;
+            break;
+        }
+    }
+
+    // Frame state along the instruction stream: before the prologue and between an
+    // epilogue and the next branch, r1 still points at the caller's frame
+    bool rebased = true;
+    for (uint32_t i = fn->first_instruction; i < end; i++) {
+        const IR_Instruction *insn = &ir->instructions[i];
+        if (insn->flags & IR_INSN_UNPARSED) continue;
+        const char *mnemonic = ir_mnemonic(ir, insn);
+        const char *operands = ir_operands(ir, insn);
+
+        if (i == frame->prologue) {
+            rebased = false;
+            continue;
+        }
+        if ((insn->flags & IR_INSN_LABELED) && frame->prologue != IR_NONE && i > frame->prologue) rebased = false;
+
+        IR_Frame_Access access;
+        if (ir_frame_decode(mnemonic, operands, &access)) {
+            access.instruction = i;
+            if (rebased) access.offset += (int32_t)frame->size;
+            if (!ir_reserve((void**)&frame->accesses, &frame->access_capacity, frame->access_count,
+                            sizeof(IR_Frame_Access))) {
+                frame->escapes = true;
+                return;
+            }
+            frame->accesses[frame->access_count++] = access;
+
+            // `lwz r1, 0(r1)` pops the frame through the back chain (an epilogue);
+            // any other load into r1 moves the stack pointer somewhere unknown
+            if (!access.store && access.reg <= 1 && access.reg + access.count > 1) {
+                if (access.count == 1 && access.offset == 0 && !rebased) rebased = true;
+                else frame->escapes = true;
+                continue;
+            }
+
+            // Stack arguments sit above the caller's linkage area
+            int32_t caller_offset = access.offset - (int32_t)frame->size;
+            int32_t top = caller_offset + access.width * access.count - IR_FRAME_LINKAGE;
+            if (caller_offset >= IR_FRAME_LINKAGE && (uint32_t)top > frame->incoming) {
+                frame->incoming = (uint32_t)top;
+            }
+            continue;
+        }
+
+        int32_t size;
+        if (frame->size && strcmp(mnemonic, "addi") == 0 &&
+            sscanf(operands, "r1, r1, %i", &size) == 1 && (uint32_t)size == frame->size) {
+            if (rebased) frame->escapes = true;
+            rebased = true;
+            continue;
+        }
+        if (ir_frame_mentions_r1(operands)) frame->escapes = true;
+
+        // Code after the epilogue's branch runs with the frame still open
+        if ((insn->flags & IR_INSN_BRANCH) && !(insn->flags & (IR_INSN_CONDITIONAL | IR_INSN_LINK)) &&
+            frame->prologue != IR_NONE && i > frame->prologue) {
+            rebased = false;
+        }
+    }
+    if (frame->prologue == IR_NONE) frame->escapes = true;
+}
+
+static inline bool ir_frame_same_slot(const IR_Frame_Access *a, int32_t offset_a,
+                                      const IR_Frame_Access *b, int32_t offset_b) {
+    return offset_a == offset_b && a->width == b->width && a->kind == b->kind;
+}
+
+/**
+ * @brief Decide which accesses of an analysed frame become C locals
+ * @param outgoing Bytes at the bottom of the frame that callees may read as stack arguments
+ * @return true if every access was promoted (prologue and epilogue can go)
+ */
+static inline bool ir_frame_promote(IR_Frame *frame, uint32_t outgoing) {
+    if (frame->escapes) return false;
+
+    int32_t low = IR_FRAME_LINKAGE + (int32_t)outgoing;
+    int32_t lr_save = (int32_t)frame->size + 4;
+    for (uint32_t a = 0; a < frame->access_count; a++) {
+        IR_Frame_Access *access = &frame->accesses[a];
+        int32_t top = access->offset + access->width * access->count;
+        access->promoted = (access->offset >= low && top <= (int32_t)frame->size) ||
+                           (access->offset == lr_save && access->count == 1 && access->width == 4 &&
+                            access->kind == IR_FRAME_INT);
+    }
+
+    // Demote until stable: every byte lives either in memory or in one local,
+    // and a local is only read after something was stored to it
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t a = 0; a < frame->access_count; a++) {
+            IR_Frame_Access *x = &frame->accesses[a];
+            if (!x->promoted) continue;
+            bool keep = true;
+            for (uint8_t i = 0; i < x->count && keep; i++) {
+                int32_t offset_x = x->offset + i * x->width;
+                bool written = x->store;
+                for (uint32_t b = 0; b < frame->access_count && keep; b++) {
+                    const IR_Frame_Access *y = &frame->accesses[b];
+                    if (a == b) continue;
+                    for (uint8_t j = 0; j < y->count && keep; j++) {
+                        int32_t offset_y = y->offset + j * y->width;
+                        if (offset_x >= offset_y + y->width || offset_y >= offset_x + x->width) continue;
+                        if (!y->promoted || !ir_frame_same_slot(x, offset_x, y, offset_y)) keep = false;
+                        else if (y->store) written = true;
+                    }
+                }
+                if (!written) keep = false;
+            }
+            if (!keep) {
+                x->promoted = false;
+                changed = true;
+            }
+        }
+    }
+
+    for (uint32_t a = 0; a < frame->access_count; a++) {
+        if (!frame->accesses[a].promoted) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Promote frame slots program-wide
+ * @param ir Finalized program IR (instruction and function flags are set)
+ * @param candidates Per function: nonzero if it is emitted with a body
+ * @param promoted_accesses Receives the number of loads/stores turned into locals
+ * @param elided_frames Receives the number of functions whose prologue/epilogue were dropped
+ * @return Number of functions with at least one promoted slot
+ *
+ * A call lets the callee read its stack arguments from the bottom of this frame,
+ * so that many bytes above the linkage area stay in memory: the callee's own
+ * incoming size for direct calls, the largest in the program for indirect ones.
+ */
+static inline int ir_promote_frames(Program_IR *ir, const uint8_t *candidates,
+                                    int *promoted_accesses, int *elided_frames) {
+    *promoted_accesses = 0;
+    *elided_frames = 0;
+    for (uint32_t f = 0; f < ir->function_count; f++) {
+        IR_Function *fn = &ir->functions[f];
+        fn->flags &= ~IR_FUNCTION_FRAME_ELIDED;
+        for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+            ir->instructions[i].flags &= ~(IR_INSN_FRAME_SLOT | IR_INSN_FRAME_ADJUST);
+        }
+    }
+
+    uint32_t *incoming = (uint32_t*)calloc(ir->function_count + 1, sizeof(uint32_t));
+    if (!incoming) return 0;
+    uint32_t incoming_max = 0;
+    for (uint32_t f = 0; f < ir->function_count; f++) {
+        IR_Frame frame;
+        ir_frame_collect(ir, &ir->functions[f], &frame);
+        incoming[f] = frame.incoming;
+        if (frame.incoming > incoming_max) incoming_max = frame.incoming;
+        ir_frame_free(&frame);
+    }
+
+    int functions = 0;
+    for (uint32_t f = 0; f < ir->function_count; f++) {
+        IR_Function *fn = &ir->functions[f];
+        if (!candidates[f]) continue;
+
+        uint32_t outgoing = 0;
+        for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+            const IR_Instruction *insn = &ir->instructions[i];
+            if (!(insn->flags & IR_INSN_LINK)) continue;
+            uint32_t callee = ir_call_target(ir, fn, insn);
+            uint32_t bytes = callee != IR_NONE ? incoming[callee] : incoming_max;
+            if (bytes > outgoing) outgoing = bytes;
+        }
+
+        IR_Frame frame;
+        ir_frame_collect(ir, fn, &frame);
+        bool all = ir_frame_promote(&frame, outgoing);
+        int promoted = 0;
+        for (uint32_t a = 0; a < frame.access_count; a++) {
+            if (!frame.accesses[a].promoted) continue;
+            ir->instructions[frame.accesses[a].instruction].flags |= IR_INSN_FRAME_SLOT;
+            promoted++;
+        }
+        if (promoted) {
+            functions++;
+            *promoted_accesses += promoted;
+        }
+
+        // Nothing left in memory: the frame itself is no longer needed
+        if (all && frame.access_count > 0) {
+            for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+                IR_Instruction *insn = &ir->instructions[i];
+                int32_t size;
+                if (i == frame.prologue ||
+                    (strcmp(ir_mnemonic(ir, insn), "addi") == 0 &&
+                     sscanf(ir_operands(ir, insn), "r1, r1, %i", &size) == 1 && (uint32_t)size == frame.size)) {
+                    insn->flags |= IR_INSN_FRAME_ADJUST;
+                }
+            }
+            fn->flags |= IR_FUNCTION_FRAME_ELIDED;
+            (*elided_frames)++;
+        }
+        ir_frame_free(&frame);
+    }
+
+    free(incoming);
+    return functions;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IR_FRAME_H
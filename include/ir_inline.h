@@ -0,0 +1,110 @@
+/**
+ * @file ir_inline.h
+ * @brief Leaf-function inlining over the program IR
+ *
+ * Getters, setters and small math helpers are straight-line leaf functions:
+ * no stack frame, no calls, no branches other than the final blr. Such a body
+ * can be emitted in place of a `bl` to it, which removes the C call and, with
+ * the parameter calling convention, the argument copy on each side.
+ *
+ * Cost model: a leaf is inlined when its body (without the blr) is at most
+ * `max_instructions`, or at most twice that when it has a single call site.
+ */
+
+#ifndef IR_INLINE_H
+#define IR_INLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "program_ir.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IR_INLINE_DEFAULT_MAX_INSTRUCTIONS  4
+
+/**
+ * @brief True if an instruction writes r1 or touches the stack (EABI has no red zone,
+ *        so any r1-relative access means the function has a frame)
+ */
+static inline bool ir_uses_stack_frame(const char *operands) {
+    return strncmp(operands, "r1,", 3) == 0 || strstr(operands, "(r1)") != NULL;
+}
+
+/**
+ * @brief True if a function is a straight-line leaf that can be pasted into its callers
+ * @return Body size (instructions before the final blr), or -1 if not inlinable
+ */
+static inline int ir_inline_body_size(const Program_IR *ir, const IR_Function *fn) {
+    if (fn->instruction_count < 2 || fn->label_count != 0 || fn->start_address == 0) return -1;
+
+    uint32_t last = fn->first_instruction + fn->instruction_count - 1;
+    const IR_Instruction *ret = &ir->instructions[last];
+    bool is_blr = (ret->flags & IR_INSN_INDIRECT) && !(ret->flags & (IR_INSN_CONDITIONAL | IR_INSN_LINK)) &&
+                  ((ret->word >> 1) & 0x3FF) == 16;
+    if (!is_blr) return -1;
+
+    for (uint32_t i = fn->first_instruction; i < last; i++) {
+        const IR_Instruction *insn = &ir->instructions[i];
+        if (insn->flags & (IR_INSN_BRANCH | IR_INSN_UNPARSED)) return -1;
+
+        const char *mnemonic = ir_mnemonic(ir, insn);
+        const char *operands = ir_operands(ir, insn);
+        if (ir_uses_stack_frame(operands)) return -1;
+
+        // Reads or writes of LR, and anything that leaves user mode, stay out of line
+        if (strcmp(mnemonic, "mflr") == 0 || strcmp(mnemonic, "mtlr") == 0 ||
+            strcmp(mnemonic, "sc") == 0 || strcmp(mnemonic, "rfi") == 0 ||
+            strncmp(mnemonic, "tw", 2) == 0) {
+            return -1;
+        }
+    }
+    return (int)(fn->instruction_count - 1);
+}
+
+/**
+ * @brief Flag the functions to inline at their call sites
+ * @param ir Finalized program IR
+ * @param candidates Per function: nonzero if it is emitted from the IR (not skipped)
+ * @param max_instructions Body size limit (0 disables inlining)
+ * @return Number of functions flagged IR_FUNCTION_INLINE
+ */
+static inline int ir_mark_inline_leaves(Program_IR *ir, const uint8_t *candidates, int max_instructions) {
+    for (uint32_t f = 0; f < ir->function_count; f++) ir->functions[f].flags &= ~IR_FUNCTION_INLINE;
+    if (max_instructions <= 0) return 0;
+
+    // Direct call sites per function, from its own file: a body is only pasted where its
+    // string constants and statics are in scope
+    uint32_t *call_sites = (uint32_t*)calloc(ir->function_count + 1, sizeof(uint32_t));
+    if (!call_sites) return 0;
+    for (uint32_t f = 0; f < ir->function_count; f++) {
+        const IR_Function *fn = &ir->functions[f];
+        for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+            uint32_t callee = ir_call_target(ir, fn, &ir->instructions[i]);
+            if (callee != IR_NONE && ir->functions[callee].file == fn->file) call_sites[callee]++;
+        }
+    }
+
+    int inlined = 0;
+    for (uint32_t f = 0; f < ir->function_count; f++) {
+        if (!candidates[f] || call_sites[f] == 0) continue;
+        int size = ir_inline_body_size(ir, &ir->functions[f]);
+        if (size < 0) continue;
+        if (size <= max_instructions || (call_sites[f] == 1 && size <= 2 * max_instructions)) {
+            ir->functions[f].flags |= IR_FUNCTION_INLINE;
+            inlined++;
+        }
+    }
+
+    free(call_sites);
+    return inlined;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IR_INLINE_H
@@ -0,0 +1,149 @@
+/**
+ * @file ir_reachability.h
+ * @brief Whole-program reachability and dead-function marking
+ *
+ * Roots are the entry point (__start) and every function whose address is
+ * taken: pointers in data (vtables, callback tables) and sym@ha / sym@l
+ * operands in code (callbacks passed to registration functions). From there
+ * the pass follows direct calls, tail branches, address-taken references made
+ * by reached code, and fall-through into the next function. Everything left
+ * over is flagged IR_FUNCTION_UNREACHABLE.
+ */
+
+#ifndef IR_REACHABILITY_H
+#define IR_REACHABILITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "program_ir.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IR_ENTRY_POINT          "__start"
+
+/**
+ * @brief Function an address-taken reference points at (IR_NONE if none)
+ */
+static inline uint32_t ir_reference_target(const Program_IR *ir, const IR_Reference *ref) {
+    if (ref->name == IR_NONE) {
+        const IR_Function *fn = ir_function_at(ir, ref->address);
+        return fn ? (uint32_t)(fn - ir->functions) : IR_NONE;
+    }
+    uint32_t file = ref->function != IR_NONE ? ir->functions[ref->function].file : IR_NONE;
+    return ir_find_function_in(ir, ir_text(ir, ref->name), file);
+}
+
+static inline void ir_reach_push(uint32_t *stack, uint32_t *depth, bool *reached, uint32_t function) {
+    if (function == IR_NONE || reached[function]) return;
+    reached[function] = true;
+    stack[(*depth)++] = function;
+}
+
+/**
+ * @brief Flag every function not reachable from the roots
+ * @param ir Finalized program IR
+ * @param extra_roots Additional root names (may be NULL)
+ * @param extra_root_count Number of extra roots
+ * @return Number of unreachable functions, or -1 when the entry point is missing
+ *         (nothing is flagged then: a partial program cannot be judged)
+ */
+static inline int ir_mark_unreachable(Program_IR *ir, const char *const *extra_roots, int extra_root_count) {
+    uint32_t n = ir->function_count;
+    for (uint32_t f = 0; f < n; f++) ir->functions[f].flags &= ~IR_FUNCTION_UNREACHABLE;
+
+    uint32_t entry = ir_find_function(ir, IR_ENTRY_POINT);
+    if (entry == IR_NONE) return -1;
+
+    bool *reached = (bool*)calloc(n + 1, sizeof(bool));
+    uint32_t *stack = (uint32_t*)malloc(sizeof(uint32_t) * (n + 1));
+    uint32_t *ref_first = (uint32_t*)calloc(n + 1, sizeof(uint32_t));
+    uint32_t *ref_targets = (uint32_t*)malloc(sizeof(uint32_t) * (ir->reference_count + 1));
+    if (!reached || !stack || !ref_first || !ref_targets) {
+        free(reached); free(stack); free(ref_first); free(ref_targets);
+        return -1;
+    }
+    uint32_t depth = 0;
+
+    // Code references grouped by referencing function (CSR); data references are roots
+    for (uint32_t r = 0; r < ir->reference_count; r++) {
+        const IR_Reference *ref = &ir->references[r];
+        if (ref->function != IR_NONE) ref_first[ref->function + 1]++;
+    }
+    for (uint32_t f = 0; f < n; f++) ref_first[f + 1] += ref_first[f];
+    uint32_t *fill = (uint32_t*)malloc(sizeof(uint32_t) * (n + 1));
+    if (!fill) {
+        free(reached); free(stack); free(ref_first); free(ref_targets);
+        return -1;
+    }
+    memcpy(fill, ref_first, sizeof(uint32_t) * (n + 1));
+    for (uint32_t r = 0; r < ir->reference_count; r++) {
+        const IR_Reference *ref = &ir->references[r];
+        uint32_t target = ir_reference_target(ir, ref);
+        if (ref->function == IR_NONE) ir_reach_push(stack, &depth, reached, target);
+        else ref_targets[fill[ref->function]++] = target;
+    }
+    free(fill);
+
+    ir_reach_push(stack, &depth, reached, entry);
+    for (int i = 0; i < extra_root_count; i++) {
+        ir_reach_push(stack, &depth, reached, ir_find_function(ir, extra_roots[i]));
+    }
+
+    while (depth > 0) {
+        uint32_t f = stack[--depth];
+        const IR_Function *fn = &ir->functions[f];
+        const IR_Instruction *last = NULL;
+
+        for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+            const IR_Instruction *insn = &ir->instructions[i];
+            if (insn->flags & IR_INSN_UNPARSED) continue;
+            last = insn;
+            if (!(insn->flags & IR_INSN_BRANCH) || (insn->flags & IR_INSN_INDIRECT)) continue;
+
+            uint32_t callee = ir_call_target(ir, fn, insn);
+            ir_reach_push(stack, &depth, reached, callee);
+
+            // Jumps into the middle of another function keep that function alive
+            if (insn->flags & IR_INSN_LEAVES_FUNCTION) {
+                const IR_Function *host = ir_function_containing(ir, insn->target);
+                if (host) ir_reach_push(stack, &depth, reached, (uint32_t)(host - ir->functions));
+            }
+        }
+
+        for (uint32_t r = ref_first[f]; r < ref_first[f + 1]; r++) {
+            ir_reach_push(stack, &depth, reached, ref_targets[r]);
+        }
+
+        // Execution runs into the next function when the last instruction does not leave
+        bool falls_through = last && (!(last->flags & IR_INSN_BRANCH) ||
+                                      (last->flags & (IR_INSN_CONDITIONAL | IR_INSN_LINK)));
+        if (falls_through) {
+            const IR_Function *next = ir_function_at(ir, fn->end_address);
+            if (next) ir_reach_push(stack, &depth, reached, (uint32_t)(next - ir->functions));
+        }
+    }
+
+    int unreachable = 0;
+    for (uint32_t f = 0; f < n; f++) {
+        if (!reached[f]) {
+            ir->functions[f].flags |= IR_FUNCTION_UNREACHABLE;
+            unreachable++;
+        }
+    }
+
+    free(reached);
+    free(stack);
+    free(ref_first);
+    free(ref_targets);
+    return unreachable;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IR_REACHABILITY_H
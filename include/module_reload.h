@@ -0,0 +1,60 @@
+/**
+ * @file module_reload.h
+ * @brief Hot reload of transpiled modules (shared_modules output mode)
+ *
+ * With `shared_modules`, each top-level input directory is built as its own
+ * shared library and calls between modules go through the function address
+ * map. Rebuilding one module and reloading it re-registers that module's
+ * functions, so the next call through the map runs the new code without a
+ * relink or restart of the executable.
+ *
+ * Reloading is triggered by porpoise_modules_poll() (from a frame hook, for
+ * example) or by sending SIGUSR1 to the process; the signal is handled at the
+ * next indirect call.
+ */
+
+#ifndef MODULE_RELOAD_H
+#define MODULE_RELOAD_H
+
+#include <stdbool.h>
+#include <signal.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A module linked into the executable (generated in porpoise_modules.c)
+ */
+typedef struct {
+    const char *name;                   // Module name (identifier form of its directory)
+    void (*register_functions)(void);   // porpoise_register_<name>() in the linked copy
+} Porpoise_Module;
+
+extern const Porpoise_Module porpoise_modules[];
+extern const int porpoise_module_count;
+
+// Set by SIGUSR1, checked by call_function_by_address()
+extern volatile sig_atomic_t porpoise_reload_requested;
+
+/**
+ * @brief Record where each module was loaded from and install the SIGUSR1 trigger
+ */
+void porpoise_modules_init(void);
+
+/**
+ * @brief Reload every module whose library changed on disk
+ * @return Number of modules reloaded
+ */
+int porpoise_modules_poll(void);
+
+/**
+ * @brief Load the current build of a module and re-register its functions
+ */
+bool porpoise_module_reload(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODULE_RELOAD_H
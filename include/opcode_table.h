@@ -0,0 +1,305 @@
+/**
+ * @file opcode_table.h
+ * @brief Every decoder included by opcode.h, as an X-macro list
+ *
+ * OPCODE_TABLE(X) expands X(name, TYPE) once per opcode header, in opcode.h
+ * order, where decode_<name>() fills a TYPE_Instruction. The decoder sweep
+ * uses it to try every decoder on a word rather than only the first match
+ * of transpile_instruction(). Add an entry when an opcode header is added to
+ * opcode.h.
+ */
+
+#ifndef OPCODE_TABLE_H
+#define OPCODE_TABLE_H
+
+#include "opcode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPCODE_TABLE(X) \
+    /* Integer arithmetic instructions */ \
+    X(add, ADD) \
+    X(addc, ADDC) \
+    X(adde, ADDE) \
+    X(addi, ADDI) \
+    X(lis, LIS) \
+    X(subf, SUBF) \
+    X(subfc, SUBFC) \
+    X(subfe, SUBFE) \
+    X(neg, NEG) \
+    X(mulli, MULLI) \
+    X(mullw, MULLW) \
+    X(mulhw, MULHW) \
+    X(mulhwu, MULHWU) \
+    X(addze, ADDZE) \
+    X(addme, ADDME) \
+    X(addic, ADDIC) \
+    X(subfic, SUBFIC) \
+    X(subfze, SUBFZE) \
+    X(subfme, SUBFME) \
+    X(divw, DIVW) \
+    X(divwu, DIVWU) \
+    /* Logical instructions */ \
+    X(and, AND) \
+    X(andi, ANDI) \
+    X(andis, ANDIS) \
+    X(or, OR) \
+    X(ori, ORI) \
+    X(oris, ORIS) \
+    X(xor, XOR) \
+    X(xoris, XORIS) \
+    X(andc, ANDC) \
+    X(nor, NOR) \
+    X(nand, NAND) \
+    X(orc, ORC) \
+    X(eqv, EQV) \
+    X(xori, XORI) \
+    X(cntlzw, CNTLZW) \
+    X(extsh, EXTSH) \
+    X(extsb, EXTSB) \
+    /* Shift and rotate instructions */ \
+    X(slw, SLW) \
+    X(srw, SRW) \
+    X(srawi, SRAWI) \
+    X(sraw, SRAW) \
+    X(rlwinm, RLWINM) \
+    X(rlwimi, RLWIMI) \
+    X(rlwnm, RLWNM) \
+    /* Comparison instructions */ \
+    X(cmp, CMP) \
+    X(cmpi, CMPI) \
+    X(cmplw, CMPLW) \
+    X(cmplwi, CMPLWI) \
+    /* Branch instructions */ \
+    X(b, B) \
+    X(bc, BC) \
+    X(blr, BLR) \
+    X(bclr, BCLR) \
+    X(bctr, BCTR) \
+    X(bcctr, BCCTR) \
+    X(bdnz, BDNZ) \
+    X(bdz, BDZ) \
+    /* Load and store instructions */ \
+    X(lbz, LBZ) \
+    X(lbzu, LBZU) \
+    X(lbzx, LBZX) \
+    X(lbzux, LBZUX) \
+    X(stb, STB) \
+    X(stbu, STBU) \
+    X(stbx, STBX) \
+    X(stbux, STBUX) \
+    X(lhz, LHZ) \
+    X(lhzu, LHZU) \
+    X(lhzx, LHZX) \
+    X(lhzux, LHZUX) \
+    X(lha, LHA) \
+    X(lhau, LHAU) \
+    X(lhax, LHAX) \
+    X(lhaux, LHAUX) \
+    X(lhbrx, LHBRX) \
+    X(sth, STH) \
+    X(sthu, STHU) \
+    X(sthx, STHX) \
+    X(sthux, STHUX) \
+    X(sthbrx, STHBRX) \
+    X(lwz, LWZ) \
+    X(lwzu, LWZU) \
+    X(lwzx, LWZX) \
+    X(lwzux, LWZUX) \
+    X(lwbrx, LWBRX) \
+    X(stw, STW) \
+    X(stwu, STWU) \
+    X(stwx, STWX) \
+    X(stwux, STWUX) \
+    X(stwbrx, STWBRX) \
+    X(lmw, LMW) \
+    X(stmw, STMW) \
+    X(lswi, LSWI) \
+    X(lswx, LSWX) \
+    X(stswi, STSWI) \
+    X(stswx, STSWX) \
+    X(eciwx, ECIWX) \
+    X(ecowx, ECOWX) \
+    X(lwarx, LWARX) \
+    X(stwcx, STWCX) \
+    /* Floating-point instructions */ \
+    X(fadd, FADD) \
+    X(fadds, FADDS) \
+    X(fsub, FSUB) \
+    X(fsubs, FSUBS) \
+    X(fmul, FMUL) \
+    X(fmuls, FMULS) \
+    X(fdiv, FDIV) \
+    X(fdivs, FDIVS) \
+    X(lfs, LFS) \
+    X(fmadd, FMADD) \
+    X(fmadds, FMADDS) \
+    X(fmsub, FMSUB) \
+    X(fmsubs, FMSUBS) \
+    X(fnmadd, FNMADD) \
+    X(fnmadds, FNMADDS) \
+    X(fnmsub, FNMSUB) \
+    X(fnmsubs, FNMSUBS) \
+    X(fneg, FNEG) \
+    X(fabs, FABS) \
+    X(fnabs, FNABS) \
+    X(fsel, FSEL) \
+    X(fres, FRES) \
+    X(frsqrte, FRSQRTE) \
+    X(fsqrt, FSQRT) \
+    X(fsqrts, FSQRTS) \
+    X(fctiwz, FCTIWZ) \
+    X(fctiw, FCTIW) \
+    X(frsp, FRSP) \
+    X(fcmpo, FCMPO) \
+    X(fcmpu, FCMPU) \
+    X(fmr, FMR) \
+    /* Floating-point load/store instructions */ \
+    X(lfd, LFD) \
+    X(lfdu, LFDU) \
+    X(lfdx, LFDX) \
+    X(lfdux, LFDUX) \
+    X(lfsu, LFSU) \
+    X(lfsx, LFSX) \
+    X(lfsux, LFSUX) \
+    X(stfd, STFD) \
+    X(stfdu, STFDU) \
+    X(stfdx, STFDX) \
+    X(stfdux, STFDUX) \
+    X(stfs, STFS) \
+    X(stfsu, STFSU) \
+    X(stfsx, STFSX) \
+    X(stfsux, STFSUX) \
+    X(stfiwx, STFIWX) \
+    /* Cache management instructions */ \
+    X(dcbf, DCBF) \
+    X(dcbi, DCBI) \
+    X(dcbst, DCBST) \
+    X(dcbt, DCBT) \
+    X(dcbtst, DCBTST) \
+    X(dcbz, DCBZ) \
+    X(icbi, ICBI) \
+    /* Special purpose register instructions */ \
+    X(mfspr, MFSPR) \
+    X(mtspr, MTSPR) \
+    X(mfcr, MFCR) \
+    X(mfmsr, MFMSR) \
+    X(mtmsr, MTMSR) \
+    X(mtcrf, MTCRF) \
+    X(mftb, MFTB) \
+    X(mftbu, MFTBU) \
+    X(mfsr, MFSR) \
+    X(mtsr, MTSR) \
+    X(mfxer, MFXER) \
+    X(mtxer, MTXER) \
+    X(mflr, MFLR) \
+    X(mtlr, MTLR) \
+    X(mfctr, MFCTR) \
+    X(mtctr, MTCTR) \
+    X(mfpvr, MFPVR) \
+    X(mcrxr, MCRXR) \
+    /* Floating-point status and control */ \
+    X(mtfsf, MTFSF) \
+    X(mffs, MFFS) \
+    X(mcrfs, MCRFS) \
+    X(mtfsb0, MTFSB0) \
+    X(mtfsb1, MTFSB1) \
+    X(mtfsfi, MTFSFI) \
+    /* Condition register instructions */ \
+    X(crxor, CRXOR) \
+    X(cror, CROR) \
+    X(crand, CRAND) \
+    X(crandc, CRANDC) \
+    X(creqv, CREQV) \
+    X(crnand, CRNAND) \
+    X(crnor, CRNOR) \
+    X(crorc, CRORC) \
+    X(mcrf, MCRF) \
+    /* System instructions */ \
+    X(sync, SYNC) \
+    X(isync, ISYNC) \
+    X(eieio, EIEIO) \
+    X(rfi, RFI) \
+    X(sc, SC) \
+    X(tw, TW) \
+    X(twi, TWI) \
+    X(tlbie, TLBIE) \
+    X(tlbsync, TLBSYNC) \
+    X(tlbia, TLBIA) \
+    X(mtsrin, MTSRIN) \
+    X(mfsrin, MFSRIN) \
+    /* Gekko paired-single instructions */ \
+    X(psq_l, PSQ_L) \
+    X(psq_st, PSQ_ST) \
+    X(psq_lu, PSQ_LU) \
+    X(psq_stu, PSQ_STU) \
+    X(psq_lx, PSQ_LX) \
+    X(psq_stx, PSQ_STX) \
+    X(psq_lux, PSQ_LUX) \
+    X(psq_stux, PSQ_STUX) \
+    X(ps_add, PS_ADD) \
+    X(ps_sub, PS_SUB) \
+    X(ps_mul, PS_MUL) \
+    X(ps_div, PS_DIV) \
+    X(ps_abs, PS_ABS) \
+    X(ps_neg, PS_NEG) \
+    X(ps_nabs, PS_NABS) \
+    X(ps_mr, PS_MR) \
+    X(ps_madd, PS_MADD) \
+    X(ps_msub, PS_MSUB) \
+    X(ps_madds0, PS_MADDS0) \
+    X(ps_madds1, PS_MADDS1) \
+    X(ps_nmadd, PS_NMADD) \
+    X(ps_nmsub, PS_NMSUB) \
+    X(ps_res, PS_RES) \
+    X(ps_rsqrte, PS_RSQRTE) \
+    X(ps_sel, PS_SEL) \
+    X(ps_sum0, PS_SUM0) \
+    X(ps_sum1, PS_SUM1) \
+    X(ps_muls0, PS_MULS0) \
+    X(ps_muls1, PS_MULS1) \
+    X(ps_merge00, PS_MERGE00) \
+    X(ps_merge01, PS_MERGE01) \
+    X(ps_merge10, PS_MERGE10) \
+    X(ps_merge11, PS_MERGE11) \
+    X(ps_cmpu0, PS_CMPU0) \
+    X(ps_cmpo0, PS_CMPO0) \
+    X(ps_cmpu1, PS_CMPU1) \
+    X(ps_cmpo1, PS_CMPO1)
+
+#define OPCODE_TABLE_ENUM(name, TYPE) OPCODE_##TYPE,
+typedef enum {
+    OPCODE_TABLE(OPCODE_TABLE_ENUM)
+    OPCODE_TABLE_COUNT
+} Opcode_Table_Index;
+#undef OPCODE_TABLE_ENUM
+
+#define OPCODE_TABLE_NAME(name, TYPE) #name,
+static const char *const opcode_table_names[OPCODE_TABLE_COUNT] = {
+    OPCODE_TABLE(OPCODE_TABLE_NAME)
+};
+#undef OPCODE_TABLE_NAME
+
+/**
+ * @brief Every decoder that accepts instruction
+ * @param matches Receives up to OPCODE_TABLE_COUNT indices, in table order
+ * @return Number of decoders that accepted the word
+ */
+static inline int opcode_table_match(uint32_t instruction, uint16_t *matches) {
+    int count = 0;
+#define OPCODE_TABLE_TRY(name, TYPE) { \
+        TYPE##_Instruction decoded; \
+        if (decode_##name(instruction, &decoded)) matches[count++] = OPCODE_##TYPE; \
+    }
+    OPCODE_TABLE(OPCODE_TABLE_TRY)
+#undef OPCODE_TABLE_TRY
+    return count;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPCODE_TABLE_H
@@ -0,0 +1,260 @@
+/**
+ * @file porpoise_stats.h
+ * @brief Phase timers, per-file timings and emission counters (--stats)
+ *
+ * Time is charged to one phase at a time: entering a phase pauses the one it
+ * interrupts (the string table inside emit, for example), so the phase times
+ * add up to the run time. Counters are always kept; --stats only decides
+ * whether they are reported, as text or as porpoise_stats.json in the project.
+ */
+
+#ifndef PORPOISE_STATS_H
+#define PORPOISE_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATS_JSON_NAME         "porpoise_stats.json"
+#define STATS_SLOWEST_FILES     10
+
+typedef enum {
+    STATS_SETUP = 0,            // Configuration, symbol map, skip list
+    STATS_DECODE,               // Reading .s files (or the executable) into the IR
+    STATS_ANALYZE,              // Reachability, folding, frames, inlining
+    STATS_LABEL_MAP,
+    STATS_STRING_TABLE,
+    STATS_EMIT,                 // C and headers of the transpiled files
+    STATS_SCAN,                 // Program database (cross-reference) scan
+    STATS_WRITE,                // Shards, runtime, CMake and registry files
+    STATS_PHASE_COUNT
+} Stats_Phase;
+
+static const char *const stats_phase_names[STATS_PHASE_COUNT] = {
+    "setup", "decode", "analyze", "label map", "string table", "emit", "scan", "write"
+};
+
+typedef struct {
+    char *path;                 // Owned copy, any length
+    uint32_t instructions;
+    double seconds;
+} Stats_File;
+
+typedef struct {
+    bool report;                // --stats
+    bool json;                  // --stats=json
+    double start;
+    double mark;                // Start of the current phase's running interval
+    Stats_Phase current;
+    double phase_seconds[STATS_PHASE_COUNT];
+
+    Stats_File *files;
+    int file_count;
+    int file_capacity;
+
+    uint64_t instructions_decoded;
+    uint64_t instructions_emitted;
+    uint64_t unknown_opcodes;           // Emitted as /* UNKNOWN */ comments
+    uint64_t word_fallbacks;            // Text pass failed, decoded from the instruction word
+    uint64_t indirect_call_fallbacks;   // blrl / bctrl resolved at run time
+    uint64_t unparsed_lines;            // Source lines kept verbatim as comments
+} Porpoise_Stats;
+
+static Porpoise_Stats porpoise_stats;
+
+static inline double stats_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static inline void stats_start(void) {
+    porpoise_stats.start = porpoise_stats.mark = stats_now();
+    porpoise_stats.current = STATS_SETUP;
+}
+
+/**
+ * @brief Charge time to phase from now on
+ * @return The interrupted phase, for stats_leave()
+ */
+static inline Stats_Phase stats_enter(Stats_Phase phase) {
+    double now = stats_now();
+    Stats_Phase previous = porpoise_stats.current;
+    porpoise_stats.phase_seconds[previous] += now - porpoise_stats.mark;
+    porpoise_stats.current = phase;
+    porpoise_stats.mark = now;
+    return previous;
+}
+
+static inline void stats_leave(Stats_Phase previous) {
+    stats_enter(previous);
+}
+
+static inline void stats_add_file(const char *path, uint32_t instructions, double seconds) {
+    if (porpoise_stats.file_count == porpoise_stats.file_capacity) {
+        int grown = porpoise_stats.file_capacity ? porpoise_stats.file_capacity * 2 : 256;
+        Stats_File *resized = (Stats_File*)realloc(porpoise_stats.files, sizeof(Stats_File) * grown);
+        if (!resized) return;
+        porpoise_stats.files = resized;
+        porpoise_stats.file_capacity = grown;
+    }
+    char *copy = strdup(path);
+    if (!copy) return;
+    Stats_File *file = &porpoise_stats.files[porpoise_stats.file_count++];
+    file->path = copy;
+    file->instructions = instructions;
+    file->seconds = seconds;
+}
+
+/**
+ * @brief Peak resident set size in bytes (0 if unknown)
+ */
+static inline uint64_t stats_peak_rss(void) {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss;           // Bytes
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;    // Kilobytes
+#endif
+#endif
+}
+
+static inline double stats_rate(uint64_t count, double seconds) {
+    return seconds > 0 ? (double)count / seconds : 0;
+}
+
+static inline int stats_compare_seconds(const void *a, const void *b) {
+    const Stats_File *x = (const Stats_File*)a, *y = (const Stats_File*)b;
+    if (x->seconds != y->seconds) return x->seconds > y->seconds ? -1 : 1;
+    return strcmp(x->path, y->path);
+}
+
+static inline void stats_write_json_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static inline bool stats_write_json(const char *path, double total) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    const Porpoise_Stats *s = &porpoise_stats;
+    fprintf(f, "{\n  \"total_seconds\": %.6f,\n  \"phases\": {\n", total);
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        fprintf(f, "    \"%s\": %.6f%s\n", stats_phase_names[p], s->phase_seconds[p],
+                p + 1 < STATS_PHASE_COUNT ? "," : "");
+    }
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"instructions_decoded\": %llu,\n", (unsigned long long)s->instructions_decoded);
+    fprintf(f, "  \"instructions_emitted\": %llu,\n", (unsigned long long)s->instructions_emitted);
+    fprintf(f, "  \"instructions_per_second\": %.0f,\n", stats_rate(s->instructions_emitted, total));
+    fprintf(f, "  \"decode_instructions_per_second\": %.0f,\n",
+            stats_rate(s->instructions_decoded, s->phase_seconds[STATS_DECODE]));
+    fprintf(f, "  \"emit_instructions_per_second\": %.0f,\n",
+            stats_rate(s->instructions_emitted, s->phase_seconds[STATS_EMIT]));
+    fprintf(f, "  \"peak_rss_bytes\": %llu,\n", (unsigned long long)stats_peak_rss());
+    fprintf(f, "  \"unknown_opcodes\": %llu,\n", (unsigned long long)s->unknown_opcodes);
+    fprintf(f, "  \"word_fallbacks\": %llu,\n", (unsigned long long)s->word_fallbacks);
+    fprintf(f, "  \"indirect_call_fallbacks\": %llu,\n", (unsigned long long)s->indirect_call_fallbacks);
+    fprintf(f, "  \"unparsed_lines\": %llu,\n", (unsigned long long)s->unparsed_lines);
+    fprintf(f, "  \"files\": [");
+    for (int i = 0; i < s->file_count; i++) {
+        fprintf(f, "%s\n    { \"path\": ", i ? "," : "");
+        stats_write_json_string(f, s->files[i].path);
+        fprintf(f, ", \"instructions\": %u, \"seconds\": %.6f }", s->files[i].instructions, s->files[i].seconds);
+    }
+    fprintf(f, "%s]\n}\n", s->file_count ? "\n  " : "");
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Print the summary (or write porpoise_stats.json into project_dir)
+ */
+static inline void stats_free_files(void) {
+    for (int i = 0; i < porpoise_stats.file_count; i++) free(porpoise_stats.files[i].path);
+    free(porpoise_stats.files);
+    porpoise_stats.files = NULL;
+    porpoise_stats.file_count = porpoise_stats.file_capacity = 0;
+}
+
+static inline void stats_report(const char *project_dir) {
+    stats_enter(porpoise_stats.current);  // Close the running interval
+    Porpoise_Stats *s = &porpoise_stats;
+    double total = stats_now() - s->start;
+
+    if (s->json) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", project_dir, STATS_JSON_NAME);
+        if (stats_write_json(path, total)) {
+            printf("Statistics written to %s\n", path);
+        } else {
+            fprintf(stderr, "Error: Cannot write %s\n", path);
+        }
+        stats_free_files();
+        return;
+    }
+
+    printf("===========================================\n");
+    printf("   Statistics\n");
+    printf("===========================================\n");
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        printf("  %-14s %9.3fs %6.1f%%\n", stats_phase_names[p], s->phase_seconds[p],
+               total > 0 ? 100.0 * s->phase_seconds[p] / total : 0.0);
+    }
+    printf("  %-14s %9.3fs\n", "total", total);
+    printf("Instructions: %llu decoded, %llu emitted; %.0f/s overall, decode %.0f/s, emit %.0f/s\n",
+           (unsigned long long)s->instructions_decoded, (unsigned long long)s->instructions_emitted,
+           stats_rate(s->instructions_emitted, total),
+           stats_rate(s->instructions_decoded, s->phase_seconds[STATS_DECODE]),
+           stats_rate(s->instructions_emitted, s->phase_seconds[STATS_EMIT]));
+    printf("Peak RSS: %.1f MB\n", (double)stats_peak_rss() / (1024.0 * 1024.0));
+    printf("Unknown opcodes: %llu, word-decoder fallbacks: %llu, indirect-call fallbacks: %llu, "
+           "unparsed lines: %llu\n",
+           (unsigned long long)s->unknown_opcodes, (unsigned long long)s->word_fallbacks,
+           (unsigned long long)s->indirect_call_fallbacks, (unsigned long long)s->unparsed_lines);
+
+    if (s->file_count > 0) {
+        qsort(s->files, s->file_count, sizeof(Stats_File), stats_compare_seconds);
+        int shown = s->file_count < STATS_SLOWEST_FILES ? s->file_count : STATS_SLOWEST_FILES;
+        printf("Slowest files (of %d):\n", s->file_count);
+        for (int i = 0; i < shown; i++) {
+            printf("  %9.2f ms  %s (%u instructions)\n", s->files[i].seconds * 1000.0, s->files[i].path,
+                   s->files[i].instructions);
+        }
+    }
+    printf("\n");
+    stats_free_files();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PORPOISE_STATS_H
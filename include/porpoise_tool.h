@@ -34,6 +34,17 @@ extern "C" {
 #define MAX_LOOKBACK_LINES      20           // How many lines to look back for parameters
 #define MAX_LABELS              10000        // Maximum number of labels to track
 
+// Console output: quiet drops per-file lines, verbose adds per-file diagnostics
+typedef enum {
+    LOG_QUIET = 0,
+    LOG_NORMAL,
+    LOG_VERBOSE
+} Log_Level;
+
+static Log_Level porpoise_log_level = LOG_NORMAL;
+
+#define LOG_ENABLED(level)      (porpoise_log_level >= (level))
+
 //==============================================================================
 // RESERVED NAME HANDLING
 //==============================================================================
@@ -663,7 +674,9 @@ static inline StringTable* build_string_table(const char *filename) {
     
     fclose(f);
     
-    fprintf(stderr, "  [Debug: Found %d string(s) in file]\n", table->count);
+    if (LOG_ENABLED(LOG_VERBOSE)) {
+        fprintf(stderr, "  [Debug: Found %d string(s) in file]\n", table->count);
+    }
     return table;
 }
 
@@ -736,7 +749,7 @@ static inline LabelMap* build_label_map(const char *filename) {
     fclose(f);
     
     // Debug: Report how many labels were mapped
-    if (map) {
+    if (map && LOG_ENABLED(LOG_VERBOSE)) {
         fprintf(stderr, "  [Debug: Mapped %d labels in file]\n", map->count);
     }
     
@@ -808,8 +821,9 @@ static inline bool parse_asm_line(const char *line, ASM_Line *parsed) {
             while (*comma && isspace(*comma)) comma++;
             if (strncmp(comma, "local", 5) == 0) {
                 parsed->is_local_function = true;
-                // Debug: Uncomment to verify local function detection
-                fprintf(stderr, "[DEBUG] Detected local function: %s\n", parsed->function_name);
+                if (LOG_ENABLED(LOG_VERBOSE)) {
+                    fprintf(stderr, "[DEBUG] Detected local function: %s\n", parsed->function_name);
+                }
             }
         }
         return true;
@@ -995,6 +1009,28 @@ static inline void write_header_end(FILE *h_file) {
     fprintf(h_file, "#endif\n");
 }
 
+/**
+ * @brief True for SDK library names (OS*, EXI*, DC*, GX*, ...) that get no transpiled declaration
+ */
+static inline bool is_sdk_prefixed_name(const char *name) {
+    return strncmp(name, "OS", 2) == 0 ||       // OS functions
+        strncmp(name, "__OS", 4) == 0 ||        // Internal OS functions
+        strncmp(name, "EXI", 3) == 0 ||         // EXI functions
+        strncmp(name, "DC", 2) == 0 ||          // Data cache functions
+        strncmp(name, "IC", 2) == 0 ||          // Instruction cache functions
+        strncmp(name, "LC", 2) == 0 ||          // L2 cache functions
+        strncmp(name, "L2", 2) == 0 ||          // L2 cache functions
+        strncmp(name, "SI", 2) == 0 ||          // Serial Interface functions
+        strncmp(name, "VI", 2) == 0 ||          // Video Interface functions
+        strncmp(name, "CARD", 4) == 0 ||        // Memory card functions
+        strncmp(name, "DVD", 3) == 0 ||         // DVD functions
+        strncmp(name, "AR", 2) == 0 ||          // Audio functions
+        strncmp(name, "ARQ", 3) == 0 ||         // Audio Request Queue functions
+        strncmp(name, "PAD", 3) == 0 ||         // Controller functions
+        strncmp(name, "GX", 2) == 0 ||          // Graphics functions
+        strncmp(name, "AX", 2) == 0;            // Audio DSP functions
+}
+
 /**
  * @brief Write function declaration to header
  */
@@ -1022,24 +1058,7 @@ static inline void write_function_declaration(FILE *h_file, const Function_Info
     }
     
     // Skip standard library and SDK functions - these have their own declarations
-    // Use pattern matching to catch all SDK functions (OS*, EXI*, DC*, IC*, etc.)
-    const char *name = func->name;
-    if (strncmp(name, "OS", 2) == 0 ||          // OS functions
-        strncmp(name, "__OS", 4) == 0 ||        // Internal OS functions
-        strncmp(name, "EXI", 3) == 0 ||         // EXI functions
-        strncmp(name, "DC", 2) == 0 ||          // Data cache functions
-        strncmp(name, "IC", 2) == 0 ||          // Instruction cache functions
-        strncmp(name, "LC", 2) == 0 ||          // L2 cache functions
-        strncmp(name, "L2", 2) == 0 ||          // L2 cache functions
-        strncmp(name, "SI", 2) == 0 ||          // Serial Interface functions
-        strncmp(name, "VI", 2) == 0 ||          // Video Interface functions
-        strncmp(name, "CARD", 4) == 0 ||        // Memory card functions
-        strncmp(name, "DVD", 3) == 0 ||         // DVD functions
-        strncmp(name, "AR", 2) == 0 ||          // Audio functions
-        strncmp(name, "ARQ", 3) == 0 ||         // Audio Request Queue functions
-        strncmp(name, "PAD", 3) == 0 ||         // Controller functions
-        strncmp(name, "GX", 2) == 0 ||          // Graphics functions
-        strncmp(name, "AX", 2) == 0) {          // Audio DSP functions
+    if (is_sdk_prefixed_name(func->name)) {
         return;  // Skip SDK function declarations
     }
     
@@ -1163,21 +1182,11 @@ static inline void write_function_start(FILE *c_file, const Function_Info *func)
     // Convert GameCube addresses to host pointers immediately to ensure registers never contain GC addresses
     if (func->has_params) {
         fprintf(c_file, "    // Parameter marshaling (convert GC addresses to host pointers)\n");
-        fprintf(c_file, "    // Helper to convert GameCube addresses to host pointers\n");
-        fprintf(c_file, "    #define PARAM_TO_HOST_PTR(addr) (\\\n");
-        fprintf(c_file, "        ((addr) >= 0x80000000 && (addr) < 0x84000000) ? (uintptr_t)(mem + ((addr) - 0x80000000)) : \\\n");
-        fprintf(c_file, "        ((addr) >= 0xC0000000 && (addr) < 0xC2000000) ? (uintptr_t)(mem + ((addr) - 0xC0000000)) : \\\n");
-        fprintf(c_file, "        ((addr) >= 0xCC000000 && (addr) < 0xCC010000) ? (uintptr_t)(mem + ((addr) - 0xCC000000) + 0x4000000) : \\\n");
-        fprintf(c_file, "        ((addr) >= 0x90000000 && (addr) < 0x94000000) ? (uintptr_t)(mem + ((addr) - 0x90000000) + 0x1800000) : \\\n");
-        fprintf(c_file, "        ((addr) >= 0xD0000000 && (addr) < 0xD4000000) ? (uintptr_t)(mem + ((addr) - 0xD0000000) + 0x1800000) : \\\n");
-        fprintf(c_file, "        ((addr) >= 0xE0000000 && (addr) < 0xE0010000) ? (uintptr_t)(mem + ((addr) - 0xE0000000) + 0x5800000) : \\\n");
-        fprintf(c_file, "        (uintptr_t)(addr))\n");
         // Only marshal the consecutive parameters that were actually detected
         for (int i = 0; i < func->num_int_params; i++) {
-            // Convert GameCube addresses to host pointers immediately
-            fprintf(c_file, "    r%d = PARAM_TO_HOST_PTR(param_r%d);\n", 3 + i, 3 + i);
+            // Same table-driven mapping as values loaded from memory (see address_map.h)
+            fprintf(c_file, "    r%d = convert_gc_address(param_r%d);\n", 3 + i, 3 + i);
         }
-        fprintf(c_file, "    #undef PARAM_TO_HOST_PTR\n");
         for (int i = 0; i < func->num_float_params; i++) {
             fprintf(c_file, "    f%d = param_f%d;\n", 1 + i, 1 + i);
         }
@@ -1192,6 +1201,36 @@ static inline void write_function_end(FILE *c_file) {
     fprintf(c_file, "}\n\n");
 }
 
+/**
+ * @brief Write a function whose body is shared with an identical one
+ * @param func The duplicate
+ * @param target_name Function holding the shared body (same signature)
+ * @param target_address Address of that function
+ */
+static inline void write_function_forwarder(FILE *c_file, const Function_Info *func,
+                                            const char *target_name, uint32_t target_address) {
+    char sanitized_name[MAX_FUNCTION_NAME], sanitized_target[MAX_FUNCTION_NAME];
+    const char *func_name = sanitize_function_name(func->name, sanitized_name, sizeof(sanitized_name));
+    const char *target = sanitize_function_name(target_name, sanitized_target, sizeof(sanitized_target));
+
+    fprintf(c_file, "/**\n");
+    fprintf(c_file, " * Function: %s\n", func->name);
+    fprintf(c_file, " * Address: 0x%08X\n", func->start_address);
+    fprintf(c_file, " * Identical to %s (0x%08X): body shared\n", target_name, target_address);
+    fprintf(c_file, " */\n");
+    fprintf(c_file, "%svoid %s(", func->is_local ? "static " : "", func_name);
+    if (!func->has_params) {
+        fprintf(c_file, "void) {\n    %s();\n}\n\n", target);
+        return;
+    }
+    for (int i = 0; i < func->num_int_params; i++) fprintf(c_file, "%suint32_t param_r%d", i ? ", " : "", 3 + i);
+    for (int i = 0; i < func->num_float_params; i++) fprintf(c_file, ", double param_f%d", 1 + i);
+    fprintf(c_file, ") {\n    %s(", target);
+    for (int i = 0; i < func->num_int_params; i++) fprintf(c_file, "%sparam_r%d", i ? ", " : "", 3 + i);
+    for (int i = 0; i < func->num_float_params; i++) fprintf(c_file, ", param_f%d", 1 + i);
+    fprintf(c_file, ");\n}\n\n");
+}
+
 /**
  * @brief Write data section as byte array
  */
@@ -7,6 +7,7 @@
 #define PPC_RUNTIME_H
 
 #include <stdint.h>
+#include "powerpc_state.h"  // PPC_FUNC_PARAMS
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,9 +17,7 @@ extern "C" {
  * @brief Exit the process (transpiled from GameCube exit function)
  * @param r3 Exit code
  */
-void _ExitProcess(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6,
-                  uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10,
-                  double f1, double f2);
+void _ExitProcess(PPC_FUNC_PARAMS);
 
 /**
  * @brief PowerPC variadic argument handler
@@ -26,9 +25,7 @@ void _ExitProcess(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6,
  * @param r4 Type of argument to extract
  * @return The extracted argument value
  */
-void* ppc_va_arg(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6,
-                 uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10,
-                 double f1, double f2);
+void* ppc_va_arg(PPC_FUNC_PARAMS);
 
 /**
  * @brief Case-insensitive string comparison (Windows compatibility)
@@ -44,9 +41,13 @@ int strcasecmp(const char *s1, const char *s2);
  * @param param_r3-r10 Parameters passed in registers r3-r10
  * @param param_f1-f2 Parameters passed in floating-point registers f1-f2
  */
+#ifdef PPC_REGISTER_ABI
+void __init_registers(void);
+#else
 void __init_registers(uint32_t param_r3, uint32_t param_r4, uint32_t param_r5, uint32_t param_r6,
                       uint32_t param_r7, uint32_t param_r8, uint32_t param_r9, uint32_t param_r10,
                       double param_f1, double param_f2);
+#endif
 
 #ifdef __cplusplus
 }
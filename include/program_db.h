@@ -0,0 +1,986 @@
+/**
+ * @file program_db.h
+ * @brief Persistent whole-program symbol and cross-reference database
+ *
+ * Collects, across every .s file of a program:
+ *   - functions, labels, strings and data objects
+ *   - call edges (bl, and b to another function)
+ *   - data references (@ha / @sda21 operands, .4byte pointers inside objects)
+ *
+ * The database is one file of fixed-size record arrays plus a string pool, so a
+ * reader maps it and uses the arrays in place. Calls are stored sorted by callee
+ * with a secondary index by caller, references sorted by target, and functions
+ * have a by-name index, so every query is a binary search.
+ *
+ * Updates are incremental: each source file is stamped (size + mtime); records
+ * of unchanged files are carried over from the previous database and only
+ * changed files are re-scanned.
+ */
+
+#ifndef PROGRAM_DB_H
+#define PROGRAM_DB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "porpoise_tool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// FILE FORMAT
+//==============================================================================
+
+#define PDB_MAGIC               0x42445050  // "PPDB"
+#define PDB_VERSION             1
+#define PDB_DEFAULT_NAME        "program.pdb"
+#define PDB_NONE                0xFFFFFFFF  // "no name" / "no file" index
+
+typedef enum {
+    PDB_SECTION_FILES = 0,
+    PDB_SECTION_FUNCTIONS,          // Sorted by address
+    PDB_SECTION_FUNCTION_BY_NAME,   // uint32 function indices sorted by name
+    PDB_SECTION_LABELS,             // Sorted by address
+    PDB_SECTION_STRINGS,            // Sorted by address
+    PDB_SECTION_DATA,               // Sorted by address
+    PDB_SECTION_CALLS,              // Sorted by callee, then call site
+    PDB_SECTION_CALL_BY_CALLER,     // uint32 call indices sorted by caller, then call site
+    PDB_SECTION_XREFS,              // Sorted by target, then site
+    PDB_SECTION_NAMES,              // char pool
+    PDB_SECTION_COUNT
+} PDB_Section;
+
+typedef struct {
+    uint64_t offset;                // From the start of the file (8-byte aligned)
+    uint64_t count;                 // Records (bytes for PDB_SECTION_NAMES)
+} PDB_Section_Desc;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    PDB_Section_Desc sections[PDB_SECTION_COUNT];
+} PDB_Header;
+
+typedef struct {
+    uint32_t path;                  // Name pool offset
+    uint32_t reserved;
+    uint64_t size;                  // Source stamp
+    int64_t mtime;
+} PDB_File;
+
+#define PDB_FUNCTION_LOCAL      0x1
+
+typedef struct {
+    uint32_t address;
+    uint32_t size;
+    uint32_t name;
+    uint32_t file;
+    uint32_t flags;
+} PDB_Function;
+
+typedef struct {
+    uint32_t address;
+    uint32_t function;              // Address of the containing function (0 = none)
+    uint32_t name;
+    uint32_t file;
+} PDB_Label;
+
+typedef struct {
+    uint32_t address;
+    uint32_t text;
+    uint32_t file;
+} PDB_String;
+
+typedef struct {
+    uint32_t address;
+    uint32_t size;
+    uint32_t name;
+    uint32_t file;
+} PDB_Data;
+
+#define PDB_CALL_TAIL           0x1     // b instead of bl
+
+typedef struct {
+    uint32_t site;                  // Address of the branch
+    uint32_t caller;                // Containing function address
+    uint32_t callee;                // Resolved target address (0 = external / unresolved)
+    uint32_t callee_name;           // As written in the source (PDB_NONE for numeric targets)
+    uint32_t file;
+    uint32_t flags;
+} PDB_Call;
+
+typedef struct {
+    uint32_t site;                  // Referencing instruction or data word
+    uint32_t function;              // Containing function address (0 = from data)
+    uint32_t target;                // Resolved address (0 = unresolved)
+    uint32_t target_name;
+    uint32_t file;
+} PDB_Xref;
+
+//==============================================================================
+// DATABASE
+//==============================================================================
+
+/**
+ * @brief Program database (built in memory or mapped read-only from disk)
+ */
+typedef struct {
+    PDB_File *files;            uint32_t file_count;
+    PDB_Function *functions;    uint32_t function_count;
+    uint32_t *function_by_name;
+    PDB_Label *labels;          uint32_t label_count;
+    PDB_String *strings;        uint32_t string_count;
+    PDB_Data *data;             uint32_t data_count;
+    PDB_Call *calls;            uint32_t call_count;
+    uint32_t *call_by_caller;
+    PDB_Xref *xrefs;            uint32_t xref_count;
+    char *names;                uint32_t names_size;
+
+    // Builder capacities (unused for a mapped database)
+    uint32_t file_capacity, function_capacity, label_capacity, string_capacity;
+    uint32_t data_capacity, call_capacity, xref_capacity, names_capacity;
+
+    void *mapping;              // Non-NULL when the arrays point into a mapped file
+    size_t mapping_size;
+    bool mapped;                // mmap() (true) or malloc'd copy (false)
+} Program_DB;
+
+static inline const char* pdb_name(const Program_DB *db, uint32_t offset) {
+    return offset == PDB_NONE ? "" : db->names + offset;
+}
+
+//==============================================================================
+// BUILDING
+//==============================================================================
+
+/**
+ * @brief Grow a builder array to hold one more element
+ */
+static inline bool pdb_reserve(void **items, uint32_t *capacity, uint32_t count, size_t element_size) {
+    if (count < *capacity) return true;
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 256;
+    void *grown = realloc(*items, element_size * new_capacity);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+#define PDB_APPEND(db, array, count, capacity, value) \
+    do { \
+        if (pdb_reserve((void**)&(db)->array, &(db)->capacity, (db)->count, sizeof(*(db)->array))) { \
+            (db)->array[(db)->count++] = (value); \
+        } \
+    } while (0)
+
+static inline uint32_t pdb_intern(Program_DB *db, const char *text) {
+    uint32_t len = (uint32_t)strlen(text) + 1;
+    if (db->names_size + len > db->names_capacity) {
+        uint32_t new_capacity = db->names_capacity ? db->names_capacity * 2 : 64 * 1024;
+        while (new_capacity < db->names_size + len) new_capacity *= 2;
+        char *grown = (char*)realloc(db->names, new_capacity);
+        if (!grown) return PDB_NONE;
+        db->names = grown;
+        db->names_capacity = new_capacity;
+    }
+    uint32_t offset = db->names_size;
+    memcpy(db->names + offset, text, len);
+    db->names_size += len;
+    return offset;
+}
+
+static inline void pdb_init(Program_DB *db) {
+    memset(db, 0, sizeof(*db));
+}
+
+static inline void pdb_free(Program_DB *db) {
+    if (db->mapping) {
+#ifndef _WIN32
+        if (db->mapped) munmap(db->mapping, db->mapping_size);
+        else free(db->mapping);
+#else
+        free(db->mapping);
+#endif
+    } else {
+        free(db->files);
+        free(db->functions);
+        free(db->function_by_name);
+        free(db->labels);
+        free(db->strings);
+        free(db->data);
+        free(db->calls);
+        free(db->call_by_caller);
+        free(db->xrefs);
+        free(db->names);
+    }
+    memset(db, 0, sizeof(*db));
+}
+
+/**
+ * @brief Address encoded in a generated name (lbl_80401234, fn_8000A000, L_80005964)
+ */
+static inline uint32_t pdb_name_address(const char *name) {
+    const char *underscore = strrchr(name, '_');
+    if (!underscore || strlen(underscore + 1) != 8) return 0;
+    for (const char *p = underscore + 1; *p; p++) {
+        if (!isxdigit((unsigned char)*p)) return 0;
+    }
+    return (uint32_t)strtoul(underscore + 1, NULL, 16);
+}
+
+/**
+ * @brief True if a branch operand names a symbol (not a local .label or a number)
+ */
+static inline bool pdb_is_symbol_operand(const char *operand) {
+    return operand[0] && operand[0] != '.' && !isdigit((unsigned char)operand[0]) && operand[0] != '-';
+}
+
+//==============================================================================
+// SOURCE SCANNER
+//==============================================================================
+
+/**
+ * @brief Add every record found in one .s file
+ */
+static inline bool pdb_scan_file(Program_DB *db, const char *path, uint32_t file_index) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[MAX_LINE_LENGTH];
+    char pending_labels[16][MAX_LABEL_NAME];
+    int pending_label_count = 0;
+
+    int32_t func_index = -1;        // Function record being filled
+    bool func_started = false;
+    uint32_t func_address = 0;
+    uint32_t last_address = 0;
+
+    int32_t obj_index = -1;         // Data object being filled
+    uint32_t obj_offset = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = line;
+        while (*p && isspace((unsigned char)*p)) p++;
+
+        // Strings
+        if (strstr(p, ".string") || strstr(p, ".asciz")) {
+            uint32_t address;
+            char content[256];
+            if (parse_string_directive(line, &address, content, sizeof(content))) {
+                PDB_String s = { address, pdb_intern(db, content), file_index };
+                PDB_APPEND(db, strings, string_count, string_capacity, s);
+            }
+        }
+
+        // Data objects and the pointers inside them
+        if (strncmp(p, ".obj ", 5) == 0) {
+            char name[MAX_FUNCTION_NAME] = {0};
+            sscanf(p + 5, "%127[^, \t\n]", name);
+            const char *stamp = strstr(line, "| 0x");
+            uint32_t address = stamp ? (uint32_t)strtoul(stamp + 2, NULL, 16) : pdb_name_address(name);
+            PDB_Data d = { address, 0, pdb_intern(db, name), file_index };
+            PDB_APPEND(db, data, data_count, data_capacity, d);
+            obj_index = (int32_t)db->data_count - 1;
+            obj_offset = 0;
+            continue;
+        }
+        if (strncmp(p, ".endobj", 7) == 0) {
+            if (obj_index >= 0 && db->data[obj_index].size == 0) db->data[obj_index].size = obj_offset;
+            obj_index = -1;
+            continue;
+        }
+        if (obj_index >= 0) {
+            char operand[MAX_FUNCTION_NAME] = {0};
+            if (strncmp(p, ".4byte", 6) == 0 && sscanf(p + 6, " %127[^, \t\n]", operand) == 1 &&
+                pdb_is_symbol_operand(operand)) {
+                PDB_Xref x = { db->data[obj_index].address + obj_offset, 0, 0, pdb_intern(db, operand), file_index };
+                PDB_APPEND(db, xrefs, xref_count, xref_capacity, x);
+            }
+            if (strncmp(p, ".4byte", 6) == 0 || strncmp(p, ".float", 6) == 0) obj_offset += 4;
+            else if (strncmp(p, ".double", 7) == 0) obj_offset += 8;
+            else if (strncmp(p, ".2byte", 6) == 0) obj_offset += 2;
+            else if (strncmp(p, ".byte", 5) == 0) {
+                obj_offset += 1;
+                for (const char *c = p; *c; c++) obj_offset += *c == ',';
+            } else if (strncmp(p, ".skip", 5) == 0) {
+                obj_offset += (uint32_t)strtoul(p + 5, NULL, 0);
+            }
+            continue;
+        }
+
+        ASM_Line parsed;
+        if (!parse_asm_line(line, &parsed) || parsed.is_comment) continue;
+
+        if (parsed.is_function) {
+            PDB_Function fn = { 0, 0, pdb_intern(db, parsed.function_name), file_index,
+                                parsed.is_local_function ? PDB_FUNCTION_LOCAL : 0 };
+            PDB_APPEND(db, functions, function_count, function_capacity, fn);
+            func_index = (int32_t)db->function_count - 1;
+            func_started = false;
+            func_address = 0;
+            continue;
+        }
+
+        if (parsed.is_directive && strncmp(p, ".endfn", 6) == 0) {
+            if (func_index >= 0 && func_started) {
+                db->functions[func_index].size = last_address + 4 - db->functions[func_index].address;
+            }
+            func_index = -1;
+            func_address = 0;
+            continue;
+        }
+
+        if (parsed.is_label) {
+            if (pending_label_count < 16) {
+                snprintf(pending_labels[pending_label_count++], MAX_LABEL_NAME, "%s", parsed.label_name);
+            }
+            continue;
+        }
+
+        if (parsed.address == 0 || parsed.mnemonic[0] == '\0') continue;
+        last_address = parsed.address;
+
+        if (func_index >= 0 && !func_started) {
+            db->functions[func_index].address = parsed.address;
+            func_address = parsed.address;
+            func_started = true;
+        }
+
+        // Labels take the address of the instruction that follows them
+        for (int i = 0; i < pending_label_count; i++) {
+            PDB_Label l = { parsed.address, func_address, pdb_intern(db, pending_labels[i]), file_index };
+            PDB_APPEND(db, labels, label_count, label_capacity, l);
+        }
+        pending_label_count = 0;
+
+        // Calls: bl to anything, b to a named symbol (tail call)
+        bool is_bl = strcmp(parsed.mnemonic, "bl") == 0;
+        if (is_bl || strcmp(parsed.mnemonic, "b") == 0) {
+            char target[MAX_FUNCTION_NAME] = {0};
+            sscanf(parsed.operands, "%127s", target);
+            if (pdb_is_symbol_operand(target)) {
+                PDB_Call c = { parsed.address, func_address, 0, pdb_intern(db, target), file_index,
+                               is_bl ? 0 : PDB_CALL_TAIL };
+                PDB_APPEND(db, calls, call_count, call_capacity, c);
+            } else if (is_bl && strncmp(target, "0x", 2) == 0) {
+                PDB_Call c = { parsed.address, func_address, (uint32_t)strtoul(target, NULL, 16),
+                               PDB_NONE, file_index, 0 };
+                PDB_APPEND(db, calls, call_count, call_capacity, c);
+            }
+            continue;
+        }
+
+        // Data references: sym@ha (paired @l not repeated) and small-data sym@sda21
+        const char *at = strchr(parsed.operands, '@');
+        if (at && (strncmp(at + 1, "ha", 2) == 0 || strncmp(at + 1, "sda21", 5) == 0)) {
+            const char *start = at;
+            while (start > parsed.operands && (isalnum((unsigned char)start[-1]) || start[-1] == '_' ||
+                                               start[-1] == '$' || start[-1] == '.')) {
+                start--;
+            }
+            char target[MAX_FUNCTION_NAME] = {0};
+            size_t len = (size_t)(at - start);
+            if (len > 0 && len < sizeof(target)) {
+                memcpy(target, start, len);
+                PDB_Xref x = { parsed.address, func_address, 0, pdb_intern(db, target), file_index };
+                PDB_APPEND(db, xrefs, xref_count, xref_capacity, x);
+            }
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+//==============================================================================
+// FINALIZE (sort, resolve names, build indexes)
+//==============================================================================
+
+static const Program_DB *pdb_sort_context;  // qsort has no user pointer in C99
+
+static inline int pdb_cmp_u32(uint32_t a, uint32_t b) { return (a > b) - (a < b); }
+
+static inline int pdb_cmp_function(const void *a, const void *b) {
+    return pdb_cmp_u32(((const PDB_Function*)a)->address, ((const PDB_Function*)b)->address);
+}
+static inline int pdb_cmp_label(const void *a, const void *b) {
+    return pdb_cmp_u32(((const PDB_Label*)a)->address, ((const PDB_Label*)b)->address);
+}
+static inline int pdb_cmp_string(const void *a, const void *b) {
+    return pdb_cmp_u32(((const PDB_String*)a)->address, ((const PDB_String*)b)->address);
+}
+static inline int pdb_cmp_data(const void *a, const void *b) {
+    return pdb_cmp_u32(((const PDB_Data*)a)->address, ((const PDB_Data*)b)->address);
+}
+static inline int pdb_cmp_call(const void *a, const void *b) {
+    const PDB_Call *x = (const PDB_Call*)a, *y = (const PDB_Call*)b;
+    int c = pdb_cmp_u32(x->callee, y->callee);
+    return c ? c : pdb_cmp_u32(x->site, y->site);
+}
+static inline int pdb_cmp_xref(const void *a, const void *b) {
+    const PDB_Xref *x = (const PDB_Xref*)a, *y = (const PDB_Xref*)b;
+    int c = pdb_cmp_u32(x->target, y->target);
+    return c ? c : pdb_cmp_u32(x->site, y->site);
+}
+static inline int pdb_cmp_function_name(const void *a, const void *b) {
+    const Program_DB *db = pdb_sort_context;
+    return strcmp(pdb_name(db, db->functions[*(const uint32_t*)a].name),
+                  pdb_name(db, db->functions[*(const uint32_t*)b].name));
+}
+static inline int pdb_cmp_call_by_caller(const void *a, const void *b) {
+    const PDB_Call *x = &pdb_sort_context->calls[*(const uint32_t*)a];
+    const PDB_Call *y = &pdb_sort_context->calls[*(const uint32_t*)b];
+    int c = pdb_cmp_u32(x->caller, y->caller);
+    return c ? c : pdb_cmp_u32(x->site, y->site);
+}
+
+/**
+ * @brief Function index by exact name (requires function_by_name)
+ */
+static inline int64_t pdb_find_function_by_name(const Program_DB *db, const char *name) {
+    int64_t lo = 0, hi = (int64_t)db->function_count - 1;
+    while (lo <= hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        uint32_t index = db->function_by_name[mid];
+        int c = strcmp(pdb_name(db, db->functions[index].name), name);
+        if (c == 0) return index;
+        if (c < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Address of a named function, data object or label (0 if unknown)
+ */
+static inline uint32_t pdb_resolve_name(const Program_DB *db, const char *name) {
+    int64_t index = pdb_find_function_by_name(db, name);
+    if (index >= 0) return db->functions[index].address;
+
+    // Objects and labels are named after their address in generated sources
+    uint32_t address = pdb_name_address(name);
+    if (address) return address;
+
+    for (uint32_t i = 0; i < db->data_count; i++) {
+        if (strcmp(pdb_name(db, db->data[i].name), name) == 0) return db->data[i].address;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sort every table, resolve call/reference names and build the indexes
+ */
+static inline bool pdb_finalize(Program_DB *db) {
+    qsort(db->functions, db->function_count, sizeof(PDB_Function), pdb_cmp_function);
+    qsort(db->labels, db->label_count, sizeof(PDB_Label), pdb_cmp_label);
+    qsort(db->strings, db->string_count, sizeof(PDB_String), pdb_cmp_string);
+    qsort(db->data, db->data_count, sizeof(PDB_Data), pdb_cmp_data);
+
+    free(db->function_by_name);
+    db->function_by_name = (uint32_t*)malloc(sizeof(uint32_t) * (db->function_count + 1));
+    if (!db->function_by_name) return false;
+    for (uint32_t i = 0; i < db->function_count; i++) db->function_by_name[i] = i;
+    pdb_sort_context = db;
+    qsort(db->function_by_name, db->function_count, sizeof(uint32_t), pdb_cmp_function_name);
+
+    // Tail branches that do not reach a known function were local jumps after all
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < db->call_count; i++) {
+        PDB_Call *c = &db->calls[i];
+        if (c->callee_name != PDB_NONE) {
+            int64_t index = pdb_find_function_by_name(db, pdb_name(db, c->callee_name));
+            c->callee = index >= 0 ? db->functions[index].address : 0;
+            if ((c->flags & PDB_CALL_TAIL) && index < 0) continue;
+        }
+        db->calls[kept++] = *c;
+    }
+    db->call_count = kept;
+
+    for (uint32_t i = 0; i < db->xref_count; i++) {
+        PDB_Xref *x = &db->xrefs[i];
+        x->target = pdb_resolve_name(db, pdb_name(db, x->target_name));
+    }
+
+    qsort(db->calls, db->call_count, sizeof(PDB_Call), pdb_cmp_call);
+    qsort(db->xrefs, db->xref_count, sizeof(PDB_Xref), pdb_cmp_xref);
+
+    free(db->call_by_caller);
+    db->call_by_caller = (uint32_t*)malloc(sizeof(uint32_t) * (db->call_count + 1));
+    if (!db->call_by_caller) return false;
+    for (uint32_t i = 0; i < db->call_count; i++) db->call_by_caller[i] = i;
+    pdb_sort_context = db;
+    qsort(db->call_by_caller, db->call_count, sizeof(uint32_t), pdb_cmp_call_by_caller);
+    pdb_sort_context = NULL;
+    return true;
+}
+
+//==============================================================================
+// PERSISTENCE
+//==============================================================================
+
+static inline bool pdb_write_section(FILE *f, PDB_Header *header, PDB_Section section,
+                                     const void *items, uint64_t count, size_t element_size) {
+    long position = ftell(f);
+    long aligned = (position + 7) & ~7L;
+    static const char zeros[8] = {0};
+    if (aligned > position && fwrite(zeros, 1, (size_t)(aligned - position), f) != (size_t)(aligned - position)) {
+        return false;
+    }
+    header->sections[section].offset = (uint64_t)aligned;
+    header->sections[section].count = count;
+    return count == 0 || fwrite(items, element_size, (size_t)count, f) == (size_t)count;
+}
+
+/**
+ * @brief Write a finalized database (to <path>.tmp, then renamed over <path>)
+ */
+static inline bool pdb_save(const Program_DB *db, const char *path) {
+    char temp_path[1024];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    FILE *f = fopen(temp_path, "wb");
+    if (!f) return false;
+
+    PDB_Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PDB_MAGIC;
+    header.version = PDB_VERSION;
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+        pdb_write_section(f, &header, PDB_SECTION_FILES, db->files, db->file_count, sizeof(PDB_File)) &&
+        pdb_write_section(f, &header, PDB_SECTION_FUNCTIONS, db->functions, db->function_count, sizeof(PDB_Function)) &&
+        pdb_write_section(f, &header, PDB_SECTION_FUNCTION_BY_NAME, db->function_by_name, db->function_count, sizeof(uint32_t)) &&
+        pdb_write_section(f, &header, PDB_SECTION_LABELS, db->labels, db->label_count, sizeof(PDB_Label)) &&
+        pdb_write_section(f, &header, PDB_SECTION_STRINGS, db->strings, db->string_count, sizeof(PDB_String)) &&
+        pdb_write_section(f, &header, PDB_SECTION_DATA, db->data, db->data_count, sizeof(PDB_Data)) &&
+        pdb_write_section(f, &header, PDB_SECTION_CALLS, db->calls, db->call_count, sizeof(PDB_Call)) &&
+        pdb_write_section(f, &header, PDB_SECTION_CALL_BY_CALLER, db->call_by_caller, db->call_count, sizeof(uint32_t)) &&
+        pdb_write_section(f, &header, PDB_SECTION_XREFS, db->xrefs, db->xref_count, sizeof(PDB_Xref)) &&
+        pdb_write_section(f, &header, PDB_SECTION_NAMES, db->names, db->names_size, 1);
+
+    // Rewrite the header now that the section table is known
+    ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        remove(temp_path);
+        return false;
+    }
+    remove(path);
+    return rename(temp_path, path) == 0;
+}
+
+/**
+ * @brief Map a database file read-only
+ * @return true on success; db then points into the mapping (release with pdb_free)
+ */
+static inline bool pdb_open(Program_DB *db, const char *path) {
+    pdb_init(db);
+
+    size_t size = 0;
+    void *base = NULL;
+    bool mapped = false;
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(PDB_Header)) {
+        size = (size_t)st.st_size;
+        base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) base = NULL;
+        mapped = base != NULL;
+    }
+    close(fd);
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (length >= (long)sizeof(PDB_Header)) {
+        base = malloc((size_t)length);
+        if (base && fread(base, 1, (size_t)length, f) == (size_t)length) {
+            size = (size_t)length;
+        } else {
+            free(base);
+            base = NULL;
+        }
+    }
+    fclose(f);
+#endif
+    if (!base) return false;
+
+    db->mapping = base;
+    db->mapping_size = size;
+    db->mapped = mapped;
+
+    const PDB_Header *header = (const PDB_Header*)base;
+    if (header->magic != PDB_MAGIC || header->version != PDB_VERSION) {
+        pdb_free(db);
+        return false;
+    }
+    static const size_t element_sizes[PDB_SECTION_COUNT] = {
+        sizeof(PDB_File), sizeof(PDB_Function), sizeof(uint32_t), sizeof(PDB_Label), sizeof(PDB_String),
+        sizeof(PDB_Data), sizeof(PDB_Call), sizeof(uint32_t), sizeof(PDB_Xref), 1
+    };
+    for (int s = 0; s < PDB_SECTION_COUNT; s++) {
+        const PDB_Section_Desc *d = &header->sections[s];
+        if (d->offset > size || d->count > (size - d->offset) / element_sizes[s]) {
+            pdb_free(db);
+            return false;
+        }
+    }
+
+    #define PDB_SECTION_PTR(type, s) ((type*)((char*)base + header->sections[s].offset))
+    db->files = PDB_SECTION_PTR(PDB_File, PDB_SECTION_FILES);
+    db->file_count = (uint32_t)header->sections[PDB_SECTION_FILES].count;
+    db->functions = PDB_SECTION_PTR(PDB_Function, PDB_SECTION_FUNCTIONS);
+    db->function_count = (uint32_t)header->sections[PDB_SECTION_FUNCTIONS].count;
+    db->function_by_name = PDB_SECTION_PTR(uint32_t, PDB_SECTION_FUNCTION_BY_NAME);
+    db->labels = PDB_SECTION_PTR(PDB_Label, PDB_SECTION_LABELS);
+    db->label_count = (uint32_t)header->sections[PDB_SECTION_LABELS].count;
+    db->strings = PDB_SECTION_PTR(PDB_String, PDB_SECTION_STRINGS);
+    db->string_count = (uint32_t)header->sections[PDB_SECTION_STRINGS].count;
+    db->data = PDB_SECTION_PTR(PDB_Data, PDB_SECTION_DATA);
+    db->data_count = (uint32_t)header->sections[PDB_SECTION_DATA].count;
+    db->calls = PDB_SECTION_PTR(PDB_Call, PDB_SECTION_CALLS);
+    db->call_count = (uint32_t)header->sections[PDB_SECTION_CALLS].count;
+    db->call_by_caller = PDB_SECTION_PTR(uint32_t, PDB_SECTION_CALL_BY_CALLER);
+    db->xrefs = PDB_SECTION_PTR(PDB_Xref, PDB_SECTION_XREFS);
+    db->xref_count = (uint32_t)header->sections[PDB_SECTION_XREFS].count;
+    db->names = PDB_SECTION_PTR(char, PDB_SECTION_NAMES);
+    db->names_size = (uint32_t)header->sections[PDB_SECTION_NAMES].count;
+    #undef PDB_SECTION_PTR
+    return true;
+}
+
+//==============================================================================
+// INCREMENTAL UPDATE
+//==============================================================================
+
+static inline uint32_t pdb_copy_name(Program_DB *dst, const Program_DB *src, uint32_t offset) {
+    return offset == PDB_NONE ? PDB_NONE : pdb_intern(dst, pdb_name(src, offset));
+}
+
+typedef enum {
+    PDB_REUSE_FUNCTIONS = 0,
+    PDB_REUSE_LABELS,
+    PDB_REUSE_STRINGS,
+    PDB_REUSE_DATA,
+    PDB_REUSE_CALLS,
+    PDB_REUSE_XREFS,
+    PDB_REUSE_TABLE_COUNT
+} PDB_Reuse_Table;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t file;
+} PDB_Path_Entry;
+
+/**
+ * @brief Lookup structures over the previous database, built once per update
+ *
+ * Files are found by path hash (binary search), and each record table is
+ * bucketed by file, so carrying a file over costs only its own records.
+ */
+typedef struct {
+    const Program_DB *db;
+    PDB_Path_Entry *paths;                          // Sorted by hash
+    uint32_t *first[PDB_REUSE_TABLE_COUNT];         // file_count + 1 bucket starts per table
+    uint32_t *order[PDB_REUSE_TABLE_COUNT];         // Record indices grouped by file, in table order
+} PDB_Reuse;
+
+static inline uint64_t pdb_path_hash(const char *path) {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+    for (const unsigned char *p = (const unsigned char*)path; *p; p++) hash = (hash ^ *p) * 0x100000001b3ULL;
+    return hash;
+}
+
+static inline int pdb_path_entry_cmp(const void *a, const void *b) {
+    const PDB_Path_Entry *x = (const PDB_Path_Entry*)a, *y = (const PDB_Path_Entry*)b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return (x->file > y->file) - (x->file < y->file);
+}
+
+/**
+ * @brief Counting sort of one record table by its file field (stable)
+ */
+static inline bool pdb_reuse_bucket(PDB_Reuse *reuse, PDB_Reuse_Table table, const void *records,
+                                    uint32_t count, size_t stride, size_t file_offset) {
+    uint32_t file_count = reuse->db->file_count;
+    uint32_t *first = (uint32_t*)calloc((size_t)file_count + 1, sizeof(uint32_t));
+    uint32_t *order = (uint32_t*)malloc(((size_t)count + 1) * sizeof(uint32_t));
+    reuse->first[table] = first;
+    reuse->order[table] = order;
+    if (!first || !order) return false;
+
+    #define PDB_RECORD_FILE(i) (*(const uint32_t*)((const char*)records + (size_t)(i) * stride + file_offset))
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t file = PDB_RECORD_FILE(i);
+        if (file < file_count) first[file + 1]++;
+    }
+    for (uint32_t f = 0; f < file_count; f++) first[f + 1] += first[f];
+    uint32_t *next = (uint32_t*)malloc(((size_t)file_count + 1) * sizeof(uint32_t));
+    if (!next) return false;
+    memcpy(next, first, ((size_t)file_count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t file = PDB_RECORD_FILE(i);
+        if (file < file_count) order[next[file]++] = i;
+    }
+    #undef PDB_RECORD_FILE
+    free(next);
+    return true;
+}
+
+static inline void pdb_reuse_free(PDB_Reuse *reuse) {
+    free(reuse->paths);
+    for (int t = 0; t < PDB_REUSE_TABLE_COUNT; t++) {
+        free(reuse->first[t]);
+        free(reuse->order[t]);
+    }
+    memset(reuse, 0, sizeof(*reuse));
+}
+
+static inline bool pdb_reuse_init(PDB_Reuse *reuse, const Program_DB *previous) {
+    memset(reuse, 0, sizeof(*reuse));
+    reuse->db = previous;
+    reuse->paths = (PDB_Path_Entry*)malloc(((size_t)previous->file_count + 1) * sizeof(PDB_Path_Entry));
+    if (!reuse->paths) return false;
+    for (uint32_t i = 0; i < previous->file_count; i++) {
+        reuse->paths[i].hash = pdb_path_hash(pdb_name(previous, previous->files[i].path));
+        reuse->paths[i].file = i;
+    }
+    qsort(reuse->paths, previous->file_count, sizeof(PDB_Path_Entry), pdb_path_entry_cmp);
+
+    #define PDB_BUCKET(table, array, count, type) \
+        pdb_reuse_bucket(reuse, table, previous->array, previous->count, sizeof(type), offsetof(type, file))
+    bool ok = PDB_BUCKET(PDB_REUSE_FUNCTIONS, functions, function_count, PDB_Function) &&
+              PDB_BUCKET(PDB_REUSE_LABELS, labels, label_count, PDB_Label) &&
+              PDB_BUCKET(PDB_REUSE_STRINGS, strings, string_count, PDB_String) &&
+              PDB_BUCKET(PDB_REUSE_DATA, data, data_count, PDB_Data) &&
+              PDB_BUCKET(PDB_REUSE_CALLS, calls, call_count, PDB_Call) &&
+              PDB_BUCKET(PDB_REUSE_XREFS, xrefs, xref_count, PDB_Xref);
+    #undef PDB_BUCKET
+    if (!ok) pdb_reuse_free(reuse);
+    return ok;
+}
+
+/**
+ * @brief Index of the previous record for a path with the same stamp (PDB_NONE if none)
+ */
+static inline uint32_t pdb_reuse_find(const PDB_Reuse *reuse, const char *path, uint64_t size, int64_t mtime) {
+    const Program_DB *previous = reuse->db;
+    uint64_t hash = pdb_path_hash(path);
+    uint32_t lo = 0, hi = previous->file_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (reuse->paths[mid].hash < hash) lo = mid + 1;
+        else hi = mid;
+    }
+    for (uint32_t i = lo; i < previous->file_count && reuse->paths[i].hash == hash; i++) {
+        const PDB_File *old = &previous->files[reuse->paths[i].file];
+        if (old->size == size && old->mtime == mtime && strcmp(pdb_name(previous, old->path), path) == 0) {
+            return reuse->paths[i].file;
+        }
+    }
+    return PDB_NONE;
+}
+
+/**
+ * @brief Carry every record of one unchanged file over from the previous database
+ */
+static inline void pdb_copy_file_records(Program_DB *dst, const PDB_Reuse *reuse,
+                                         uint32_t old_file, uint32_t new_file) {
+    const Program_DB *src = reuse->db;
+    #define PDB_FOR_FILE(table, k) \
+        for (uint32_t k = reuse->first[table][old_file]; k < reuse->first[table][old_file + 1]; k++)
+    PDB_FOR_FILE(PDB_REUSE_FUNCTIONS, k) {
+        PDB_Function r = src->functions[reuse->order[PDB_REUSE_FUNCTIONS][k]];
+        r.name = pdb_copy_name(dst, src, r.name);
+        r.file = new_file;
+        PDB_APPEND(dst, functions, function_count, function_capacity, r);
+    }
+    PDB_FOR_FILE(PDB_REUSE_LABELS, k) {
+        PDB_Label r = src->labels[reuse->order[PDB_REUSE_LABELS][k]];
+        r.name = pdb_copy_name(dst, src, r.name);
+        r.file = new_file;
+        PDB_APPEND(dst, labels, label_count, label_capacity, r);
+    }
+    PDB_FOR_FILE(PDB_REUSE_STRINGS, k) {
+        PDB_String r = src->strings[reuse->order[PDB_REUSE_STRINGS][k]];
+        r.text = pdb_copy_name(dst, src, r.text);
+        r.file = new_file;
+        PDB_APPEND(dst, strings, string_count, string_capacity, r);
+    }
+    PDB_FOR_FILE(PDB_REUSE_DATA, k) {
+        PDB_Data r = src->data[reuse->order[PDB_REUSE_DATA][k]];
+        r.name = pdb_copy_name(dst, src, r.name);
+        r.file = new_file;
+        PDB_APPEND(dst, data, data_count, data_capacity, r);
+    }
+    PDB_FOR_FILE(PDB_REUSE_CALLS, k) {
+        PDB_Call r = src->calls[reuse->order[PDB_REUSE_CALLS][k]];
+        r.callee_name = pdb_copy_name(dst, src, r.callee_name);
+        r.file = new_file;
+        PDB_APPEND(dst, calls, call_count, call_capacity, r);
+    }
+    PDB_FOR_FILE(PDB_REUSE_XREFS, k) {
+        PDB_Xref r = src->xrefs[reuse->order[PDB_REUSE_XREFS][k]];
+        r.target_name = pdb_copy_name(dst, src, r.target_name);
+        r.file = new_file;
+        PDB_APPEND(dst, xrefs, xref_count, xref_capacity, r);
+    }
+    #undef PDB_FOR_FILE
+}
+
+/**
+ * @brief Add every .s file under a directory to the database, reusing unchanged ones
+ * @param reuse Lookup over the previous database (NULL scans every file)
+ */
+static inline void pdb_add_directory(Program_DB *db, const PDB_Reuse *reuse, const char *dir_path,
+                                     int *scanned, int *reused) {
+    DIR *dir = opendir(dir_path);
+    if (!dir) return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            pdb_add_directory(db, reuse, path, scanned, reused);
+            continue;
+        }
+
+        size_t len = strlen(entry->d_name);
+        if (len < 3 || strcmp(entry->d_name + len - 2, ".s") != 0) continue;
+
+        PDB_File file = { pdb_intern(db, path), 0, (uint64_t)st.st_size, (int64_t)st.st_mtime };
+        uint32_t file_index = db->file_count;
+        PDB_APPEND(db, files, file_count, file_capacity, file);
+
+        uint32_t old_index = reuse ? pdb_reuse_find(reuse, path, file.size, file.mtime) : PDB_NONE;
+        if (old_index != PDB_NONE) {
+            pdb_copy_file_records(db, reuse, old_index, file_index);
+            (*reused)++;
+        } else {
+            pdb_scan_file(db, path, file_index);
+            (*scanned)++;
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * @brief Build or incrementally update the database for a source tree
+ * @param db Receives the updated database (in memory, finalized)
+ * @param db_path Database file (read if present, then rewritten)
+ * @param input_dir Root of the .s tree
+ * @return Number of files re-scanned, or -1 on failure
+ */
+static inline int pdb_update(Program_DB *db, const char *db_path, const char *input_dir) {
+    Program_DB previous;
+    bool have_previous = pdb_open(&previous, db_path);
+
+    PDB_Reuse reuse;
+    bool have_reuse = have_previous && pdb_reuse_init(&reuse, &previous);
+
+    pdb_init(db);
+    int scanned = 0, reused = 0;
+    pdb_add_directory(db, have_reuse ? &reuse : NULL, input_dir, &scanned, &reused);
+    if (have_reuse) pdb_reuse_free(&reuse);
+
+    bool changed = scanned > 0 || !have_previous || previous.file_count != db->file_count;
+    if (have_previous) pdb_free(&previous);
+
+    if (!pdb_finalize(db)) return -1;
+    if (changed && !pdb_save(db, db_path)) return -1;
+    return scanned;
+}
+
+//==============================================================================
+// QUERIES
+//==============================================================================
+
+/**
+ * @brief Function containing an address (NULL if none)
+ */
+static inline const PDB_Function* pdb_function_at(const Program_DB *db, uint32_t address) {
+    int64_t lo = 0, hi = (int64_t)db->function_count - 1, found = -1;
+    while (lo <= hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (db->functions[mid].address <= address) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (found < 0) return NULL;
+    const PDB_Function *fn = &db->functions[found];
+    return address < fn->address + (fn->size ? fn->size : 4) ? fn : NULL;
+}
+
+/**
+ * @brief First index in a sorted range whose key is >= value
+ */
+#define PDB_LOWER_BOUND(result, count, key_of_index, value) \
+    do { \
+        uint32_t lo_ = 0, hi_ = (count); \
+        while (lo_ < hi_) { \
+            uint32_t mid_ = lo_ + (hi_ - lo_) / 2; \
+            if ((key_of_index(mid_)) < (value)) lo_ = mid_ + 1; \
+            else hi_ = mid_; \
+        } \
+        (result) = lo_; \
+    } while (0)
+
+/**
+ * @brief Range [*first, *last) of calls whose callee is address
+ */
+static inline void pdb_calls_to(const Program_DB *db, uint32_t address, uint32_t *first, uint32_t *last) {
+    #define PDB_CALLEE_KEY(i) db->calls[i].callee
+    PDB_LOWER_BOUND(*first, db->call_count, PDB_CALLEE_KEY, address);
+    PDB_LOWER_BOUND(*last, db->call_count, PDB_CALLEE_KEY, (uint64_t)address + 1);
+    #undef PDB_CALLEE_KEY
+}
+
+/**
+ * @brief Range [*first, *last) of call_by_caller entries for calls made by the function at address
+ */
+static inline void pdb_calls_from(const Program_DB *db, uint32_t address, uint32_t *first, uint32_t *last) {
+    #define PDB_CALLER_KEY(i) db->calls[db->call_by_caller[i]].caller
+    PDB_LOWER_BOUND(*first, db->call_count, PDB_CALLER_KEY, address);
+    PDB_LOWER_BOUND(*last, db->call_count, PDB_CALLER_KEY, (uint64_t)address + 1);
+    #undef PDB_CALLER_KEY
+}
+
+/**
+ * @brief Range [*first, *last) of data references to address
+ */
+static inline void pdb_refs_to(const Program_DB *db, uint32_t address, uint32_t *first, uint32_t *last) {
+    #define PDB_TARGET_KEY(i) db->xrefs[i].target
+    PDB_LOWER_BOUND(*first, db->xref_count, PDB_TARGET_KEY, address);
+    PDB_LOWER_BOUND(*last, db->xref_count, PDB_TARGET_KEY, (uint64_t)address + 1);
+    #undef PDB_TARGET_KEY
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROGRAM_DB_H
@@ -0,0 +1,667 @@
+/**
+ * @file program_ir.h
+ * @brief Whole-program intermediate representation
+ *
+ * Every .s file of a program is decoded once into flat arrays:
+ *   files -> functions -> basic blocks -> instructions (+ labels)
+ *
+ * Functions own contiguous ranges of instructions and blocks, and each block
+ * records its successors, so passes can look ahead, across functions and over
+ * the control-flow graph before any C is emitted. Emission walks the IR as a
+ * final pass instead of streaming text lines straight to the output.
+ */
+
+#ifndef PROGRAM_IR_H
+#define PROGRAM_IR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "porpoise_tool.h"
+#include "binary_loader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IR_NONE                 0xFFFFFFFF
+
+//==============================================================================
+// RECORDS
+//==============================================================================
+
+// Instruction flags
+#define IR_INSN_BRANCH          0x0001  // Transfers control (b, bc, bclr, bcctr)
+#define IR_INSN_CONDITIONAL     0x0002  // May fall through
+#define IR_INSN_LINK            0x0004  // Sets LR (call)
+#define IR_INSN_INDIRECT        0x0008  // Target in LR/CTR
+#define IR_INSN_LABELED         0x0010  // One or more labels precede it
+#define IR_INSN_UNPARSED        0x0020  // Source line kept verbatim as a comment
+#define IR_INSN_LEAVES_FUNCTION 0x0040  // Direct target outside the function and not a function entry
+#define IR_INSN_CALLS_FUNCTION  0x0080  // Direct target is a function entry
+#define IR_INSN_FRAME_SLOT      0x0100  // r1-relative load/store of a slot promoted to a C local (ir_frame.h)
+#define IR_INSN_FRAME_ADJUST    0x0200  // Prologue/epilogue of an elided frame (ir_frame.h)
+
+typedef struct {
+    uint32_t address;
+    uint32_t word;
+    uint32_t target;            // Direct branch target (0 if none)
+    uint32_t text;              // Pool offset: "mnemonic\0operands\0" (raw line if UNPARSED)
+    uint32_t block;             // Containing basic block
+    uint16_t opcode;            // Primary opcode (word >> 26)
+    uint16_t flags;
+} IR_Instruction;
+
+typedef struct {
+    uint32_t instruction;       // Instruction the label precedes
+    uint32_t name;
+} IR_Label;
+
+typedef struct {
+    uint32_t first;             // First instruction
+    uint32_t count;
+    uint32_t fallthrough;       // Successor blocks (IR_NONE if absent or outside the function)
+    uint32_t taken;
+    uint32_t function;
+} IR_Block;
+
+// Function flags
+#define IR_FUNCTION_LOCAL       0x1     // .fn name, local
+#define IR_FUNCTION_TRAMPOLINE  0x2     // Body is a single jump into another function's code
+#define IR_FUNCTION_ESCAPES_BACK 0x4    // Jumps backwards out of its own range
+#define IR_FUNCTION_UNREACHABLE 0x8     // Not reached from the program roots (ir_reachability.h)
+#define IR_FUNCTION_INLINE      0x10    // Leaf emitted in place at its call sites (ir_inline.h)
+#define IR_FUNCTION_FRAME_ELIDED 0x20   // Every stack slot is a C local; no stwu/addi r1 (ir_frame.h)
+
+typedef struct {
+    uint32_t name;
+    uint32_t file;
+    uint32_t start_address;     // First instruction (0 if empty)
+    uint32_t end_address;       // One past the last instruction
+    uint32_t first_instruction, instruction_count;
+    uint32_t first_block, block_count;
+    uint32_t first_label, label_count;
+    uint32_t flags;
+    uint32_t canonical;         // Identical function whose body this one shares (IR_NONE; ir_fold.h)
+} IR_Function;
+
+/**
+ * @brief Address-taken symbol: a .4byte in data, or a sym@ha / sym@l / sym@sda21 operand in code
+ */
+typedef struct {
+    uint32_t name;              // Symbol as written (IR_NONE for numeric values)
+    uint32_t address;           // Numeric value (0 for symbols)
+    uint32_t function;          // Referencing function (IR_NONE from data)
+} IR_Reference;
+
+typedef struct {
+    uint32_t path;
+    uint32_t first_function, function_count;
+    uint32_t first_include, include_count;
+} IR_File;
+
+/**
+ * @brief Whole-program IR
+ */
+typedef struct {
+    IR_File *files;                 uint32_t file_count, file_capacity;
+    IR_Function *functions;         uint32_t function_count, function_capacity;
+    IR_Instruction *instructions;   uint32_t instruction_count, instruction_capacity;
+    IR_Label *labels;               uint32_t label_count, label_capacity;
+    IR_Block *blocks;               uint32_t block_count, block_capacity;
+    uint32_t *includes;             uint32_t include_count, include_capacity;   // Raw .include lines
+    IR_Reference *references;       uint32_t reference_count, reference_capacity;
+    char *text;                     uint32_t text_size, text_capacity;
+    uint32_t *by_address;           // Function indices sorted by start address
+    uint32_t *by_name;              // Function indices sorted by name
+} Program_IR;
+
+static inline const char* ir_text(const Program_IR *ir, uint32_t offset) {
+    return offset == IR_NONE ? "" : ir->text + offset;
+}
+
+static inline const char* ir_mnemonic(const Program_IR *ir, const IR_Instruction *insn) {
+    return ir->text + insn->text;
+}
+
+static inline const char* ir_operands(const Program_IR *ir, const IR_Instruction *insn) {
+    const char *mnemonic = ir->text + insn->text;
+    return mnemonic + strlen(mnemonic) + 1;
+}
+
+//==============================================================================
+// STORAGE
+//==============================================================================
+
+static inline bool ir_reserve(void **items, uint32_t *capacity, uint32_t count, size_t element_size) {
+    if (count < *capacity) return true;
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 256;
+    void *grown = realloc(*items, element_size * new_capacity);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+// Appends value; evaluates to the new index, or IR_NONE when out of memory
+#define IR_APPEND(ir, array, count, capacity, value) \
+    (ir_reserve((void**)&(ir)->array, &(ir)->capacity, (ir)->count, sizeof(*(ir)->array)) \
+        ? ((ir)->array[(ir)->count] = (value), (ir)->count++) : IR_NONE)
+
+/**
+ * @brief Copy one or two NUL-terminated strings into the text pool
+ */
+static inline uint32_t ir_intern_pair(Program_IR *ir, const char *first, const char *second) {
+    size_t first_len = strlen(first) + 1;
+    size_t second_len = second ? strlen(second) + 1 : 0;
+    size_t needed = ir->text_size + first_len + second_len;
+    if (needed > ir->text_capacity) {
+        size_t new_capacity = ir->text_capacity ? ir->text_capacity * 2 : 256 * 1024;
+        while (new_capacity < needed) new_capacity *= 2;
+        char *grown = (char*)realloc(ir->text, new_capacity);
+        if (!grown) return IR_NONE;
+        ir->text = grown;
+        ir->text_capacity = (uint32_t)new_capacity;
+    }
+    uint32_t offset = ir->text_size;
+    memcpy(ir->text + offset, first, first_len);
+    if (second) memcpy(ir->text + offset + first_len, second, second_len);
+    ir->text_size = (uint32_t)needed;
+    return offset;
+}
+
+static inline void ir_init(Program_IR *ir) {
+    memset(ir, 0, sizeof(*ir));
+}
+
+static inline void ir_free(Program_IR *ir) {
+    free(ir->files);
+    free(ir->functions);
+    free(ir->instructions);
+    free(ir->labels);
+    free(ir->blocks);
+    free(ir->includes);
+    free(ir->references);
+    free(ir->text);
+    free(ir->by_address);
+    free(ir->by_name);
+    memset(ir, 0, sizeof(*ir));
+}
+
+//==============================================================================
+// DECODING
+//==============================================================================
+
+/**
+ * @brief Control-flow flags and direct target of an instruction word
+ */
+static inline void ir_decode_flow(IR_Instruction *insn) {
+    uint32_t word = insn->word;
+    uint32_t bo = (word >> 21) & 0x1F;
+    bool always = (bo & 0x14) == 0x14;
+
+    insn->opcode = (uint16_t)(word >> 26);
+    insn->target = 0;
+
+    if (insn->opcode == 18 || insn->opcode == 16) {
+        insn->flags |= IR_INSN_BRANCH;
+        if (insn->opcode == 16 && !always) insn->flags |= IR_INSN_CONDITIONAL;
+        binary_branch_target(word, insn->address, &insn->target);
+    } else if (insn->opcode == 19) {
+        uint32_t xo = (word >> 1) & 0x3FF;
+        if (xo == 16 || xo == 528) {  // bclr, bcctr
+            insn->flags |= IR_INSN_BRANCH | IR_INSN_INDIRECT;
+            if (!always) insn->flags |= IR_INSN_CONDITIONAL;
+        }
+    }
+    if ((insn->flags & IR_INSN_BRANCH) && (word & 1)) insn->flags |= IR_INSN_LINK;
+}
+
+//==============================================================================
+// FRONT END (.s files)
+//==============================================================================
+
+/**
+ * @brief Record the symbol or number of a .4byte directive
+ */
+static inline void ir_add_data_reference(Program_IR *ir, const char *directive_line) {
+    const char *p = strstr(directive_line, ".4byte");
+    char operand[MAX_FUNCTION_NAME] = {0};
+    if (!p || sscanf(p + 6, " %127[^, \t\n]", operand) != 1) return;
+
+    IR_Reference ref = { IR_NONE, 0, IR_NONE };
+    if (operand[0] == '0' && (operand[1] == 'x' || operand[1] == 'X')) {
+        ref.address = (uint32_t)strtoul(operand, NULL, 16);
+        if (ref.address == 0) return;
+    } else if (isalpha((unsigned char)operand[0]) || operand[0] == '_' || operand[0] == '@') {
+        ref.name = ir_intern_pair(ir, operand, NULL);
+    } else {
+        return;
+    }
+    IR_APPEND(ir, references, reference_count, reference_capacity, ref);
+}
+
+/**
+ * @brief Record sym@ha / sym@l / sym@sda21 operands (address materialized in a register)
+ */
+static inline void ir_add_code_reference(Program_IR *ir, const char *operands, uint32_t function) {
+    const char *at = strchr(operands, '@');
+    if (!at || at[1] == '\0') return;
+    const char *start = at;
+    while (start > operands && (isalnum((unsigned char)start[-1]) || start[-1] == '_' ||
+                                start[-1] == '$' || start[-1] == '.')) {
+        start--;
+    }
+    char name[MAX_FUNCTION_NAME];
+    size_t len = (size_t)(at - start);
+    if (len == 0 || len >= sizeof(name)) return;
+    memcpy(name, start, len);
+    name[len] = '\0';
+
+    IR_Reference ref = { ir_intern_pair(ir, name, NULL), 0, function };
+    IR_APPEND(ir, references, reference_count, reference_capacity, ref);
+}
+
+/**
+ * @brief Close the function being filled (records its address range)
+ */
+static inline void ir_end_function(Program_IR *ir, IR_Function *fn) {
+    fn->instruction_count = ir->instruction_count - fn->first_instruction;
+    fn->label_count = ir->label_count - fn->first_label;
+    for (uint32_t i = 0; i < fn->instruction_count; i++) {
+        const IR_Instruction *insn = &ir->instructions[fn->first_instruction + i];
+        if (insn->flags & IR_INSN_UNPARSED) continue;
+        if (fn->start_address == 0) fn->start_address = insn->address;
+        fn->end_address = insn->address + 4;
+    }
+}
+
+/**
+ * @brief Decode one .s file into the IR
+ * Functions are decoded from code sections only; after the first data section
+ * only .4byte values are collected (as address-taken references).
+ * @return File index, or IR_NONE if the file cannot be read
+ */
+static inline uint32_t ir_load_file(Program_IR *ir, const char *path) {
+    FILE *input = fopen(path, "r");
+    if (!input) return IR_NONE;
+
+    IR_File file = { ir_intern_pair(ir, path, NULL), ir->function_count, 0, ir->include_count, 0 };
+    uint32_t file_index = IR_APPEND(ir, files, file_count, file_capacity, file);
+    if (file_index == IR_NONE) {
+        fclose(input);
+        return IR_NONE;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    bool seen_text_section = false;
+    bool in_data = false;           // Past the code: only .4byte references are collected
+    int32_t current = -1;           // Function being filled
+    uint32_t pending_labels = 0;    // Labels waiting for the next instruction
+
+    while (fgets(line, sizeof(line), input)) {
+        ASM_Line parsed;
+
+        if (in_data) {
+            const char *p = line;
+            while (isspace((unsigned char)*p)) p++;
+            if (strncmp(p, ".4byte", 6) == 0) ir_add_data_reference(ir, p);
+            continue;
+        }
+
+        if (!parse_asm_line(line, &parsed)) {
+            // Kept as a comment at its position inside the function
+            if (current >= 0) {
+                IR_Instruction insn = {0};
+                insn.text = ir_intern_pair(ir, line, NULL);
+                insn.flags = IR_INSN_UNPARSED;
+                IR_APPEND(ir, instructions, instruction_count, instruction_capacity, insn);
+            }
+            continue;
+        }
+        if (parsed.is_comment) continue;
+
+        if (parsed.is_directive || parsed.is_data) {
+            if (strstr(line, ".text") != NULL || strstr(line, ".init") != NULL) {
+                seen_text_section = true;
+            }
+            if (parsed.is_data || (seen_text_section && strstr(line, ".section") != NULL &&
+                                   strstr(line, ".text") == NULL && strstr(line, ".init") == NULL)) {
+                if (current >= 0) ir_end_function(ir, &ir->functions[current]);
+                current = -1;
+                in_data = true;  // Data sections follow
+                continue;
+            }
+            if (current < 0 && strncmp(line + strspn(line, " \t"), ".4byte", 6) == 0) {
+                ir_add_data_reference(ir, line);
+            }
+            if (strstr(line, ".include") != NULL) {
+                IR_APPEND(ir, includes, include_count, include_capacity, ir_intern_pair(ir, line, NULL));
+            }
+            if (strstr(line, ".endfn") != NULL && current >= 0) {
+                ir_end_function(ir, &ir->functions[current]);
+                current = -1;
+            }
+            continue;
+        }
+
+        if (parsed.is_function) {
+            if (current >= 0) ir_end_function(ir, &ir->functions[current]);
+            IR_Function fn = {0};
+            fn.name = ir_intern_pair(ir, parsed.function_name, NULL);
+            fn.file = file_index;
+            fn.first_instruction = ir->instruction_count;
+            fn.first_label = ir->label_count;
+            fn.flags = parsed.is_local_function ? IR_FUNCTION_LOCAL : 0;
+            fn.canonical = IR_NONE;
+            uint32_t index = IR_APPEND(ir, functions, function_count, function_capacity, fn);
+            current = index == IR_NONE ? -1 : (int32_t)index;
+            pending_labels = 0;
+            continue;
+        }
+
+        if (parsed.is_label) {
+            // Labels before a function's first instruction are its entry point and are dropped
+            if (current >= 0 && ir->instruction_count > ir->functions[current].first_instruction) {
+                IR_Label label = { IR_NONE, ir_intern_pair(ir, parsed.label_name, NULL) };
+                if (IR_APPEND(ir, labels, label_count, label_capacity, label) != IR_NONE) pending_labels++;
+            }
+            continue;
+        }
+
+        if (parsed.instruction != 0 && current >= 0) {
+            IR_Instruction insn = {0};
+            insn.address = parsed.address;
+            insn.word = parsed.instruction;
+            insn.text = ir_intern_pair(ir, parsed.mnemonic, parsed.operands);
+            insn.block = IR_NONE;
+            ir_decode_flow(&insn);
+            if (pending_labels) insn.flags |= IR_INSN_LABELED;
+            if (!(insn.flags & IR_INSN_BRANCH)) ir_add_code_reference(ir, parsed.operands, (uint32_t)current);
+            uint32_t index = IR_APPEND(ir, instructions, instruction_count, instruction_capacity, insn);
+            for (uint32_t l = ir->label_count - pending_labels; l < ir->label_count; l++) {
+                ir->labels[l].instruction = index;
+            }
+            pending_labels = 0;
+        }
+    }
+    if (current >= 0) ir_end_function(ir, &ir->functions[current]);
+    fclose(input);
+
+    ir->files[file_index].function_count = ir->function_count - ir->files[file_index].first_function;
+    ir->files[file_index].include_count = ir->include_count - ir->files[file_index].first_include;
+    return file_index;
+}
+
+/**
+ * @brief Decode every .s file under a directory (recursively)
+ */
+static inline int ir_load_directory(Program_IR *ir, const char *dir_path) {
+    DIR *dir = opendir(dir_path);
+    if (!dir) return -1;
+
+    int loaded = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            int sub = ir_load_directory(ir, path);
+            if (sub > 0) loaded += sub;
+            continue;
+        }
+        size_t len = strlen(entry->d_name);
+        if (len >= 3 && strcmp(entry->d_name + len - 2, ".s") == 0 && ir_load_file(ir, path) != IR_NONE) {
+            loaded++;
+        }
+    }
+    closedir(dir);
+    return loaded;
+}
+
+//==============================================================================
+// LOOKUP
+//==============================================================================
+
+/**
+ * @brief File decoded from a path (IR_NONE if not loaded)
+ */
+static inline uint32_t ir_find_file(const Program_IR *ir, const char *path) {
+    for (uint32_t i = 0; i < ir->file_count; i++) {
+        if (strcmp(ir_text(ir, ir->files[i].path), path) == 0) return i;
+    }
+    return IR_NONE;
+}
+
+/**
+ * @brief First by-name slot whose function name is >= name
+ */
+static inline uint32_t ir_name_lower_bound(const Program_IR *ir, const char *name) {
+    uint32_t lo = 0, hi = ir->by_name ? ir->function_count : 0;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (strcmp(ir_text(ir, ir->functions[ir->by_name[mid]].name), name) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Function index by exact name (IR_NONE if none); needs ir_finalize()
+ */
+static inline uint32_t ir_find_function(const Program_IR *ir, const char *name) {
+    uint32_t slot = ir_name_lower_bound(ir, name);
+    if (slot < ir->function_count && ir->by_name &&
+        strcmp(ir_text(ir, ir->functions[ir->by_name[slot]].name), name) == 0) {
+        return ir->by_name[slot];
+    }
+    return IR_NONE;
+}
+
+/**
+ * @brief Function index by name, preferring a definition in the given file (local functions)
+ */
+static inline uint32_t ir_find_function_in(const Program_IR *ir, const char *name, uint32_t file) {
+    uint32_t found = IR_NONE;
+    for (uint32_t slot = ir_name_lower_bound(ir, name); slot < ir->function_count; slot++) {
+        uint32_t index = ir->by_name[slot];
+        if (strcmp(ir_text(ir, ir->functions[index].name), name) != 0) break;
+        if (ir->functions[index].file == file) return index;
+        if (found == IR_NONE) found = index;
+    }
+    return found;
+}
+
+/**
+ * @brief Function whose range contains an address (NULL if none); needs ir_finalize()
+ */
+static inline const IR_Function* ir_function_containing(const Program_IR *ir, uint32_t address) {
+    int64_t lo = 0, hi = (int64_t)ir->function_count - 1, found = -1;
+    if (!ir->by_address) return NULL;
+    while (lo <= hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (ir->functions[ir->by_address[mid]].start_address <= address) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (found < 0) return NULL;
+    const IR_Function *fn = &ir->functions[ir->by_address[found]];
+    return address < fn->end_address ? fn : NULL;
+}
+
+/**
+ * @brief Function starting exactly at an address (NULL if none)
+ */
+static inline const IR_Function* ir_function_at(const Program_IR *ir, uint32_t address) {
+    const IR_Function *fn = ir_function_containing(ir, address);
+    return fn && fn->start_address == address ? fn : NULL;
+}
+
+/**
+ * @brief Instruction of a function at an address (IR_NONE if none)
+ */
+static inline uint32_t ir_instruction_at(const Program_IR *ir, const IR_Function *fn, uint32_t address) {
+    int64_t lo = fn->first_instruction, hi = (int64_t)fn->first_instruction + fn->instruction_count - 1;
+    while (lo <= hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        // Unparsed lines carry no address; step over them
+        int64_t probe = mid;
+        while (probe <= hi && (ir->instructions[probe].flags & IR_INSN_UNPARSED)) probe++;
+        if (probe > hi) {
+            hi = mid - 1;
+            continue;
+        }
+        const IR_Instruction *insn = &ir->instructions[probe];
+        if (insn->address == address) return (uint32_t)probe;
+        if (insn->address < address) lo = probe + 1;
+        else hi = mid - 1;
+    }
+    return IR_NONE;
+}
+
+/**
+ * @brief Function reached by a direct call or tail branch (IR_NONE if none)
+ * The symbol operand is tried first so local functions resolve within the caller's file.
+ */
+static inline uint32_t ir_call_target(const Program_IR *ir, const IR_Function *caller, const IR_Instruction *insn) {
+    if (!(insn->flags & IR_INSN_BRANCH) || (insn->flags & (IR_INSN_INDIRECT | IR_INSN_UNPARSED))) return IR_NONE;
+
+    const char *operand = ir_operands(ir, insn);
+    if (operand[0] != '.' && operand[0] != '\0' && !isdigit((unsigned char)operand[0])) {
+        char name[MAX_FUNCTION_NAME] = {0};
+        sscanf(operand, "%127[^, \t\n]", name);
+        uint32_t callee = ir_find_function_in(ir, name, caller->file);
+        if (callee != IR_NONE) return callee;
+    }
+    if (insn->flags & IR_INSN_CALLS_FUNCTION) {
+        const IR_Function *target = ir_function_at(ir, insn->target);
+        if (target) return (uint32_t)(target - ir->functions);
+    }
+    return IR_NONE;
+}
+
+//==============================================================================
+// CONTROL-FLOW GRAPH
+//==============================================================================
+
+/**
+ * @brief Split a function into basic blocks and link their successors
+ */
+static inline void ir_build_blocks(Program_IR *ir, uint32_t function_index) {
+    IR_Function *fn = &ir->functions[function_index];
+    fn->first_block = ir->block_count;
+    fn->block_count = 0;
+    if (fn->instruction_count == 0) return;
+
+    uint32_t first = fn->first_instruction;
+    uint32_t end = first + fn->instruction_count;
+    bool *leader = (bool*)calloc(fn->instruction_count, sizeof(bool));
+    if (!leader) return;
+
+    leader[0] = true;
+    for (uint32_t i = first; i < end; i++) {
+        const IR_Instruction *insn = &ir->instructions[i];
+        if (insn->flags & IR_INSN_LABELED) leader[i - first] = true;
+        if (!(insn->flags & IR_INSN_BRANCH) || (insn->flags & IR_INSN_LINK)) continue;
+        if (i + 1 < end) leader[i + 1 - first] = true;
+        if (insn->target) {
+            uint32_t t = ir_instruction_at(ir, fn, insn->target);
+            if (t != IR_NONE) leader[t - first] = true;
+        }
+    }
+
+    for (uint32_t i = first; i < end; i++) {
+        if (leader[i - first]) {
+            IR_Block block = { i, 0, IR_NONE, IR_NONE, function_index };
+            if (IR_APPEND(ir, blocks, block_count, block_capacity, block) == IR_NONE) break;
+            fn->block_count++;
+        }
+        ir->blocks[ir->block_count - 1].count++;
+        ir->instructions[i].block = ir->block_count - 1;
+    }
+    free(leader);
+
+    for (uint32_t b = fn->first_block; b < fn->first_block + fn->block_count; b++) {
+        IR_Block *block = &ir->blocks[b];
+        const IR_Instruction *last = &ir->instructions[block->first + block->count - 1];
+        bool has_next = b + 1 < fn->first_block + fn->block_count;
+        bool is_jump = (last->flags & IR_INSN_BRANCH) && !(last->flags & IR_INSN_LINK);
+
+        if (has_next && (!is_jump || (last->flags & IR_INSN_CONDITIONAL))) block->fallthrough = b + 1;
+        if (is_jump && last->target) {
+            uint32_t t = ir_instruction_at(ir, fn, last->target);
+            if (t != IR_NONE) block->taken = ir->instructions[t].block;
+        }
+    }
+}
+
+static const Program_IR *ir_sort_context;  // qsort has no user pointer in C99
+
+static inline int ir_cmp_by_address(const void *a, const void *b) {
+    uint32_t x = ir_sort_context->functions[*(const uint32_t*)a].start_address;
+    uint32_t y = ir_sort_context->functions[*(const uint32_t*)b].start_address;
+    return (x > y) - (x < y);
+}
+
+static inline int ir_cmp_by_name(const void *a, const void *b) {
+    return strcmp(ir_text(ir_sort_context, ir_sort_context->functions[*(const uint32_t*)a].name),
+                  ir_text(ir_sort_context, ir_sort_context->functions[*(const uint32_t*)b].name));
+}
+
+/**
+ * @brief Build the address index and CFGs, then classify inter-function branches
+ */
+static inline bool ir_finalize(Program_IR *ir) {
+    free(ir->by_address);
+    free(ir->by_name);
+    ir->by_address = (uint32_t*)malloc(sizeof(uint32_t) * (ir->function_count + 1));
+    ir->by_name = (uint32_t*)malloc(sizeof(uint32_t) * (ir->function_count + 1));
+    if (!ir->by_address || !ir->by_name) return false;
+    for (uint32_t i = 0; i < ir->function_count; i++) ir->by_address[i] = ir->by_name[i] = i;
+    ir_sort_context = ir;
+    qsort(ir->by_address, ir->function_count, sizeof(uint32_t), ir_cmp_by_address);
+    qsort(ir->by_name, ir->function_count, sizeof(uint32_t), ir_cmp_by_name);
+    ir_sort_context = NULL;
+
+    ir->block_count = 0;
+    for (uint32_t f = 0; f < ir->function_count; f++) {
+        ir_build_blocks(ir, f);
+
+        IR_Function *fn = &ir->functions[f];
+        bool first_real = true;
+        for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+            IR_Instruction *insn = &ir->instructions[i];
+            if (insn->flags & IR_INSN_UNPARSED) continue;
+
+            if (insn->target && (insn->target < fn->start_address || insn->target >= fn->end_address)) {
+                if (ir_function_at(ir, insn->target)) {
+                    insn->flags |= IR_INSN_CALLS_FUNCTION;
+                } else if (!(insn->flags & IR_INSN_LINK)) {
+                    insn->flags |= IR_INSN_LEAVES_FUNCTION;
+                    if (insn->target < fn->start_address) fn->flags |= IR_FUNCTION_ESCAPES_BACK;
+                    if (first_real && !(insn->flags & IR_INSN_CONDITIONAL)) fn->flags |= IR_FUNCTION_TRAMPOLINE;
+                }
+            }
+            first_real = false;
+        }
+    }
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROGRAM_IR_H
@@ -9,9 +9,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "address_map.h"
+
 #ifdef _WIN32
 #include <direct.h>
 #define mkdir(path, mode) _mkdir(path)
@@ -28,12 +31,71 @@ static inline int create_directory(const char *path) {
     return 0;
 }
 
+// Build settings written into CMakeLists.txt as option() defaults
+typedef struct {
+    int transpiled_count;       // The first transpiled_count sources are transpiled files
+    int unity_shards;           // src/unity/unity_NNN.c files (0 = none)
+    bool precompiled_headers;   // powerpc_state.h + stdlib_headers.h for the transpiled libraries
+    bool lto;                   // Interprocedural optimization
+    bool gc_sections;           // Per-function sections, unreferenced ones dropped at link time
+    bool shared_modules;        // Top-level directories become shared libraries (hot reload)
+} CMake_Options;
+
+static inline const char* cmake_bool(bool value) {
+    return value ? "ON" : "OFF";
+}
+
+static inline size_t cmake_dir_length(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? (size_t)(slash - path) : 0;
+}
+
+// Top-level directory: the library of a source when each one is a module
+static inline size_t cmake_top_dir_length(const char *path) {
+    const char *slash = strchr(path, '/');
+    return slash ? (size_t)(slash - path) : 0;
+}
+
+// Directory first, then file name: each directory's sources end up contiguous
+static inline int cmake_compare_source(const void *a, const void *b) {
+    const char *x = *(const char* const*)a, *y = *(const char* const*)b;
+    size_t dx = cmake_dir_length(x), dy = cmake_dir_length(y);
+    int c = strncmp(x, y, dx < dy ? dx : dy);
+    if (c != 0) return c;
+    if (dx != dy) return dx < dy ? -1 : 1;
+    return strcmp(x, y);
+}
+
+/**
+ * @brief CMake target name for a source directory: "" -> "<project>_transpiled", "a/b-c" -> "<project>_a_b_c"
+ */
+static inline void cmake_library_name(const char *path, size_t dir_length, char *output, size_t output_size) {
+    if (dir_length == 0) {
+        snprintf(output, output_size, "${PROJECT_NAME}_transpiled");
+        return;
+    }
+    int n = snprintf(output, output_size, "${PROJECT_NAME}_");
+    for (size_t i = 0; i < dir_length && (size_t)n + 1 < output_size; i++) {
+        char c = path[i];
+        bool ident = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        output[n++] = ident ? c : '_';
+    }
+    output[n] = '\0';
+}
+
 /**
  * @brief Generate CMakeLists.txt for the project
+ * Sources are listed explicitly (no glob to re-run, exact dependency tracking). Transpiled
+ * files form one static library per directory; runtime files and main.c form the executable.
+ * @param options Build settings (NULL: every source goes into the executable)
  */
 static inline int generate_cmake(const char *project_dir, const char *project_name, 
                                 int c_file_count, const char **c_files,
-                                int h_file_count, const char **h_files) {
+                                int h_file_count, const char **h_files,
+                                const CMake_Options *options) {
+    static const CMake_Options defaults = { 0, 0, true, false, false, false };
+    if (!options) options = &defaults;
+    
     char cmake_path[512];
     snprintf(cmake_path, sizeof(cmake_path), "%s/CMakeLists.txt", project_dir);
     
@@ -43,11 +105,36 @@ static inline int generate_cmake(const char *project_dir, const char *project_na
         return -1;
     }
     
+    fprintf(f, "# Generated by Porpoise Tool\n");
+    fprintf(f, "# Configure with: cmake -S . -B build -G Ninja  (any generator works)\n");
     fprintf(f, "cmake_minimum_required(VERSION 3.10)\n");
     fprintf(f, "project(%s C)\n\n", project_name);
     fprintf(f, "set(CMAKE_C_STANDARD 99)\n");
     fprintf(f, "set(CMAKE_C_STANDARD_REQUIRED ON)\n\n");
     
+    fprintf(f, "# Build options (defaults from the transpiler's config.json)\n");
+    if (options->unity_shards > 0) {
+        fprintf(f, "option(PORPOISE_UNITY_BUILD \"Compile transpiled code through src/unity shards\" ON)\n");
+    }
+    fprintf(f, "option(PORPOISE_PCH \"Precompile powerpc_state.h and stdlib_headers.h\" %s)\n",
+            cmake_bool(options->precompiled_headers));
+    fprintf(f, "option(PORPOISE_LTO \"Interprocedural (link-time) optimization\" %s)\n", cmake_bool(options->lto));
+    fprintf(f, "option(PORPOISE_GC_SECTIONS \"Drop unreferenced functions at link time\" %s)\n",
+            cmake_bool(options->gc_sections));
+    if (options->shared_modules) {
+        fprintf(f, "option(PORPOISE_HOT_RELOAD \"Build each top-level directory as a reloadable shared module\" ON)\n");
+        fprintf(f, "if(WIN32)\n");
+        fprintf(f, "    set(PORPOISE_HOT_RELOAD OFF)  # Modules call back into the executable: needs dlopen semantics\n");
+        fprintf(f, "endif()\n");
+        fprintf(f, "if(PORPOISE_HOT_RELOAD)\n");
+        fprintf(f, "    set(PORPOISE_MODULE_TYPE SHARED)\n");
+        fprintf(f, "    set(CMAKE_POSITION_INDEPENDENT_CODE ON)\n");
+        fprintf(f, "else()\n");
+        fprintf(f, "    set(PORPOISE_MODULE_TYPE STATIC)\n");
+        fprintf(f, "endif()\n");
+    }
+    fprintf(f, "\n");
+    
     fprintf(f, "# Include directories\n");
     fprintf(f, "include_directories(${CMAKE_SOURCE_DIR}/include)\n");
     fprintf(f, "# Add SDK include directory if it exists\n");
@@ -66,39 +153,155 @@ static inline int generate_cmake(const char *project_dir, const char *project_na
     fprintf(f, "    add_compile_options(-Wall -Wextra -Wpedantic)\n");
     fprintf(f, "endif()\n\n");
     
-    fprintf(f, "# Automatically find all source files recursively\n");
-    fprintf(f, "# This includes transpiled files and SDK files if they're in src/\n");
-    fprintf(f, "file(GLOB_RECURSE SOURCES \n");
-    fprintf(f, "    \"src/*.c\"\n");
+    fprintf(f, "if(PORPOISE_LTO)\n");
+    fprintf(f, "    include(CheckIPOSupported)\n");
+    fprintf(f, "    check_ipo_supported(RESULT PORPOISE_IPO_SUPPORTED OUTPUT PORPOISE_IPO_ERROR LANGUAGES C)\n");
+    fprintf(f, "    if(PORPOISE_IPO_SUPPORTED)\n");
+    fprintf(f, "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)\n");
+    fprintf(f, "    else()\n");
+    fprintf(f, "        message(WARNING \"LTO not supported: ${PORPOISE_IPO_ERROR}\")\n");
+    fprintf(f, "    endif()\n");
+    fprintf(f, "endif()\n\n");
+    
+    fprintf(f, "if(PORPOISE_GC_SECTIONS)\n");
+    fprintf(f, "    if(MSVC)\n");
+    fprintf(f, "        add_compile_options(/Gy /Gw)\n");
+    fprintf(f, "        set(CMAKE_EXE_LINKER_FLAGS \"${CMAKE_EXE_LINKER_FLAGS} /OPT:REF /OPT:ICF\")\n");
+    fprintf(f, "    else()\n");
+    fprintf(f, "        add_compile_options(-ffunction-sections -fdata-sections)\n");
+    fprintf(f, "        if(APPLE)\n");
+    fprintf(f, "            set(CMAKE_EXE_LINKER_FLAGS \"${CMAKE_EXE_LINKER_FLAGS} -Wl,-dead_strip\")\n");
+    fprintf(f, "        else()\n");
+    fprintf(f, "            set(CMAKE_EXE_LINKER_FLAGS \"${CMAKE_EXE_LINKER_FLAGS} -Wl,--gc-sections\")\n");
+    fprintf(f, "        endif()\n");
+    fprintf(f, "    endif()\n");
+    fprintf(f, "endif()\n\n");
+    
+    int transpiled_count = options->transpiled_count < c_file_count ? options->transpiled_count : c_file_count;
+    
+    fprintf(f, "# Runtime and entry point\n");
+    fprintf(f, "set(SOURCES\n");
+    for (int i = transpiled_count; i < c_file_count; i++) {
+        fprintf(f, "    src/%s\n", c_files[i]);
+    }
     fprintf(f, ")\n\n");
     
-    fprintf(f, "# Also find SDK files if they're in a separate sdk/ directory\n");
+    fprintf(f, "# SDK sources are supplied by the user after generation\n");
     fprintf(f, "if(EXISTS ${CMAKE_SOURCE_DIR}/sdk)\n");
     fprintf(f, "    file(GLOB_RECURSE SDK_SOURCES \"sdk/src/*.c\")\n");
     fprintf(f, "    list(APPEND SOURCES ${SDK_SOURCES})\n");
     fprintf(f, "endif()\n\n");
     
-    fprintf(f, "# Automatically find all header files (for IDE project view)\n");
-    fprintf(f, "# This includes transpiled headers and SDK headers if they're in include/\n");
-    fprintf(f, "file(GLOB_RECURSE HEADERS \n");
-    fprintf(f, "    \"include/*.h\"\n");
+    // Fixed order whatever order the directories were read in
+    int sorted_size = transpiled_count > h_file_count ? transpiled_count : h_file_count;
+    const char **sorted = (const char**)malloc(sizeof(char*) * (sorted_size + 1));
+    if (!sorted) {
+        fclose(f);
+        return -1;
+    }
+    memcpy(sorted, h_files, sizeof(char*) * h_file_count);
+    qsort(sorted, h_file_count, sizeof(char*), cmake_compare_source);
+    fprintf(f, "# Headers (for IDE project view)\n");
+    fprintf(f, "set(HEADERS\n");
+    for (int i = 0; i < h_file_count; i++) {
+        fprintf(f, "    include/%s\n", sorted[i]);
+    }
     fprintf(f, ")\n\n");
     
-    fprintf(f, "# Also find SDK headers if they're in a separate sdk/ directory\n");
-    fprintf(f, "if(EXISTS ${CMAKE_SOURCE_DIR}/sdk)\n");
-    fprintf(f, "    file(GLOB_RECURSE SDK_HEADERS \"sdk/include/*.h\")\n");
-    fprintf(f, "    list(APPEND HEADERS ${SDK_HEADERS})\n");
-    fprintf(f, "endif()\n\n");
-    
-    fprintf(f, "# Print number of files found (helpful for debugging)\n");
-    fprintf(f, "list(LENGTH SOURCES SOURCE_COUNT)\n");
-    fprintf(f, "list(LENGTH HEADERS HEADER_COUNT)\n");
-    fprintf(f, "message(STATUS \"Found ${SOURCE_COUNT} source files and ${HEADER_COUNT} header files\")\n\n");
+    // Transpiled sources grouped by directory
+    memcpy(sorted, c_files, sizeof(char*) * transpiled_count);
+    qsort(sorted, transpiled_count, sizeof(char*), cmake_compare_source);
+    
+    size_t (*group_length)(const char*) = options->shared_modules ? cmake_top_dir_length : cmake_dir_length;
+    if (transpiled_count > 0) {
+        if (options->shared_modules) {
+            fprintf(f, "# Transpiled code: one module per top-level directory, the rest in the executable\n");
+        } else {
+            fprintf(f, "# Transpiled code: one static library per source directory\n");
+        }
+        if (options->unity_shards > 0) {
+            fprintf(f, "if(PORPOISE_UNITY_BUILD)\n");
+            fprintf(f, "    add_library(${PROJECT_NAME}_unity STATIC\n");
+            for (int s = 0; s < options->unity_shards; s++) {
+                fprintf(f, "        src/unity/unity_%03d.c\n", s);
+            }
+            fprintf(f, "    )\n");
+            fprintf(f, "    set(TRANSPILED_LIBRARIES ${PROJECT_NAME}_unity)\n");
+            fprintf(f, "else()\n");
+        }
+        const char *indent = options->unity_shards > 0 ? "    " : "";
+        fprintf(f, "%sset(TRANSPILED_LIBRARIES)\n", indent);
+        if (options->shared_modules) {
+            fprintf(f, "set(PORPOISE_MODULES)\n");
+        }
+        for (int i = 0; i < transpiled_count; ) {
+            size_t dir_length = group_length(sorted[i]);
+            bool module = options->shared_modules && dir_length > 0;
+            char library[256];
+            cmake_library_name(sorted[i], dir_length, library, sizeof(library));
+            fprintf(f, "%sadd_library(%s %s\n", indent, library, module ? "${PORPOISE_MODULE_TYPE}" : "STATIC");
+            int j = i;
+            for (; j < transpiled_count && group_length(sorted[j]) == dir_length &&
+                   strncmp(sorted[j], sorted[i], dir_length) == 0; j++) {
+                fprintf(f, "%s    src/%s\n", indent, sorted[j]);
+            }
+            fprintf(f, "%s)\n", indent);
+            fprintf(f, "%slist(APPEND TRANSPILED_LIBRARIES %s)\n", indent, library);
+            if (module) {
+                fprintf(f, "list(APPEND PORPOISE_MODULES %s)\n", library);
+            }
+            i = j;
+        }
+        if (options->unity_shards > 0) {
+            fprintf(f, "endif()\n");
+        }
+        fprintf(f, "\n");
+        
+        fprintf(f, "# Transpiled code only: the runtime files use the real C library declarations\n");
+        fprintf(f, "if(PORPOISE_PCH AND NOT CMAKE_VERSION VERSION_LESS 3.16)\n");
+        fprintf(f, "    list(GET TRANSPILED_LIBRARIES 0 PORPOISE_PCH_TARGET)\n");
+        fprintf(f, "    target_precompile_headers(${PORPOISE_PCH_TARGET} PRIVATE\n");
+        fprintf(f, "        ${CMAKE_SOURCE_DIR}/include/powerpc_state.h\n");
+        fprintf(f, "        ${CMAKE_SOURCE_DIR}/include/stdlib_headers.h\n");
+        fprintf(f, "    )\n");
+        fprintf(f, "    foreach(library ${TRANSPILED_LIBRARIES})\n");
+        fprintf(f, "        if(NOT library STREQUAL PORPOISE_PCH_TARGET)\n");
+        fprintf(f, "            target_precompile_headers(${library} REUSE_FROM ${PORPOISE_PCH_TARGET})\n");
+        fprintf(f, "        endif()\n");
+        fprintf(f, "    endforeach()\n");
+        fprintf(f, "endif()\n\n");
+    }
+    free(sorted);
     
     fprintf(f, "# Create executable\n");
     fprintf(f, "add_executable(${PROJECT_NAME} ${SOURCES} ${HEADERS})\n\n");
     
-    fprintf(f, "# Link libraries (if needed)\n");
+    if (options->shared_modules) {
+        fprintf(f, "# Modules resolve the runtime and registers from the executable, and bind their\n");
+        fprintf(f, "# own functions locally so a reloaded copy runs its own code\n");
+        fprintf(f, "if(PORPOISE_HOT_RELOAD)\n");
+        fprintf(f, "    set_target_properties(${PROJECT_NAME} PROPERTIES ENABLE_EXPORTS ON)\n");
+        fprintf(f, "    target_compile_definitions(${PROJECT_NAME} PRIVATE PORPOISE_HOT_RELOAD)\n");
+        fprintf(f, "    target_link_libraries(${PROJECT_NAME} ${CMAKE_DL_LIBS})\n");
+        fprintf(f, "    foreach(module ${PORPOISE_MODULES})\n");
+        fprintf(f, "        if(APPLE)\n");
+        fprintf(f, "            set_target_properties(${module} PROPERTIES LINK_FLAGS \"-undefined dynamic_lookup\")\n");
+        fprintf(f, "        else()\n");
+        fprintf(f, "            set_target_properties(${module} PROPERTIES LINK_FLAGS \"-Wl,-Bsymbolic\")\n");
+        fprintf(f, "        endif()\n");
+        fprintf(f, "    endforeach()\n");
+        fprintf(f, "endif()\n\n");
+    }
+    
+    fprintf(f, "# Link libraries\n");
+    if (transpiled_count > 0) {
+        fprintf(f, "# Directories call each other, so GNU ld needs the libraries as one group\n");
+        fprintf(f, "if(CMAKE_C_COMPILER_ID MATCHES \"GNU|Clang\" AND NOT APPLE AND NOT WIN32)\n");
+        fprintf(f, "    target_link_libraries(${PROJECT_NAME} -Wl,--start-group ${TRANSPILED_LIBRARIES} -Wl,--end-group)\n");
+        fprintf(f, "else()\n");
+        fprintf(f, "    target_link_libraries(${PROJECT_NAME} ${TRANSPILED_LIBRARIES})\n");
+        fprintf(f, "endif()\n");
+    }
     fprintf(f, "if(UNIX)\n");
     fprintf(f, "    target_link_libraries(${PROJECT_NAME} m)\n");
     fprintf(f, "endif()\n");
@@ -107,10 +310,69 @@ static inline int generate_cmake(const char *project_dir, const char *project_na
     return 0;
 }
 
+/**
+ * @brief Write porpoise_build.txt, the source list and flags for `porpoise_tool build`
+ * Mirrors the CMake defaults; CMake options do not apply (use $CFLAGS / $LDFLAGS).
+ * @param options Same settings as generate_cmake() (NULL: every source is a runtime source)
+ */
+static inline int generate_build_manifest(const char *project_dir, const char *project_name,
+                                          int c_file_count, const char **c_files,
+                                          const CMake_Options *options) {
+    static const CMake_Options defaults = { 0, 0, true, false, false, false };
+    if (!options) options = &defaults;
+    
+    char manifest_path[512];
+    snprintf(manifest_path, sizeof(manifest_path), "%s/porpoise_build.txt", project_dir);
+    FILE *f = fopen(manifest_path, "w");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot create porpoise_build.txt\n");
+        return -1;
+    }
+    
+    // Modules are linked statically: hot reload needs the CMake build
+    char cflags[256] = "-std=c99 -O2";
+    char ldflags[256] = "";
+    if (options->lto) {
+        strcat(cflags, " -flto");
+    }
+    if (options->gc_sections) {
+        strcat(cflags, " -ffunction-sections -fdata-sections");
+#ifdef __APPLE__
+        strcat(ldflags, " -Wl,-dead_strip");
+#else
+        strcat(ldflags, " -Wl,--gc-sections");
+#endif
+    }
+#ifndef _WIN32
+    strcat(ldflags, " -lm");
+#endif
+    
+    fprintf(f, "# Generated by Porpoise Tool: sources and flags for `porpoise_tool build %s`\n", project_dir);
+    fprintf(f, "name %s\n", project_name);
+    fprintf(f, "cflags %s\n", cflags);
+    fprintf(f, "ldflags %s\n", ldflags[0] ? ldflags + 1 : "");
+    if (options->precompiled_headers) {
+        fprintf(f, "transpiled_cflags -include powerpc_state.h -include stdlib_headers.h\n");
+    }
+    int transpiled_count = options->transpiled_count < c_file_count ? options->transpiled_count : c_file_count;
+    for (int i = transpiled_count; i < c_file_count; i++) {
+        fprintf(f, "source src/%s\n", c_files[i]);
+    }
+    for (int i = 0; i < transpiled_count; i++) {
+        fprintf(f, "transpiled src/%s\n", c_files[i]);
+    }
+    for (int s = 0; s < options->unity_shards; s++) {
+        fprintf(f, "unity src/unity/unity_%03d.c\n", s);
+    }
+    
+    fclose(f);
+    return 0;
+}
+
 /**
  * @brief Generate main.c entry point
  */
-static inline int generate_main_c(const char *project_dir) {
+static inline int generate_main_c(const char *project_dir, bool register_abi) {
     char main_path[512];
     snprintf(main_path, sizeof(main_path), "%s/src/main.c", project_dir);
     
@@ -138,7 +400,7 @@ static inline int generate_main_c(const char *project_dir) {
     
     fprintf(f, "// Forward declare GameCube startup function\n");
     fprintf(f, "// __start() performs OS initialization and then calls the game's main() function\n");
-    fprintf(f, "extern void __start(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double);\n\n");
+    fprintf(f, "extern void __start(PPC_FUNC_PARAMS);\n\n");
     
     fprintf(f, "/**\n");
     fprintf(f, " * @brief Program entry point\n");
@@ -172,7 +434,11 @@ static inline int generate_main_c(const char *project_dir) {
     fprintf(f, "    // __start() performs OS initialization (OSInit, hardware setup, etc.)\n");
     fprintf(f, "    // and then calls the game's main() function (renamed to main_impl)\n");
     fprintf(f, "    printf(\"Calling game's __start()...\\n\\n\");\n");
-    fprintf(f, "    __start(0, 0, 0, 0, 0, 0, 0, 0, 0.0, 0.0);  // Call GameCube startup\n\n");
+    if (register_abi) {
+        fprintf(f, "    __start();  // Call GameCube startup (arguments live in r3-r10/f1-f2)\n\n");
+    } else {
+        fprintf(f, "    __start(0, 0, 0, 0, 0, 0, 0, 0, 0.0, 0.0);  // Call GameCube startup\n\n");
+    }
     
     fprintf(f, "    // If you want to call individual functions instead of __start(), add test code here:\n");
     fprintf(f, "    // printf(\"Add function calls here for testing.\\n\");\n");
@@ -194,7 +460,8 @@ static inline int generate_main_c(const char *project_dir) {
 /**
  * @brief Generate runtime.h header
  */
-static inline int generate_runtime_h(const char *project_dir) {
+static inline int generate_runtime_h(const char *project_dir, bool register_abi,
+                                     uint32_t sda_base, uint32_t sda2_base) {
     char runtime_path[512];
     snprintf(runtime_path, sizeof(runtime_path), "%s/include/powerpc_state.h", project_dir);
     
@@ -254,29 +521,43 @@ static inline int generate_runtime_h(const char *project_dir) {
     fprintf(f, "extern uint32_t pvr;  // Processor Version Register\n");
     fprintf(f, "extern uint32_t *spr;  // Generic SPR array\n\n");
     
+    fprintf(f, "// Calling convention for transpiled functions\n");
+    if (register_abi) {
+        fprintf(f, "// Register convention: functions take no C parameters, arguments stay in r3-r10/f1-f2\n");
+        fprintf(f, "#define PPC_REGISTER_ABI 1\n");
+        fprintf(f, "#define PPC_FUNC_PARAMS void\n\n");
+    } else {
+        fprintf(f, "// Parameter convention: r3-r10/f1-f2 are passed as C parameters\n");
+        fprintf(f, "#define PPC_FUNC_PARAMS uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, \\\n");
+        fprintf(f, "                        uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, \\\n");
+        fprintf(f, "                        double f1, double f2\n\n");
+    }
+    
     fprintf(f, "extern uint8_t *mem;  // Emulated memory\n");
     fprintf(f, "#define MEM_SIZE (256 * 1024 * 1024)  // 256MB (expanded to accommodate all address ranges)\n");
     fprintf(f, "#define MEM_BASE 0x80000000  // GameCube RAM base address\n\n");
     
+    fprintf(f, "// Small-data bases loaded into r13 / r2 (accesses through them are resolved at transpile time)\n");
+    fprintf(f, "#define PPC_SDA_BASE  0x%08Xu  // _SDA_BASE_\n", sda_base);
+    fprintf(f, "#define PPC_SDA2_BASE 0x%08Xu  // _SDA2_BASE_\n\n", sda2_base);
+    
     fprintf(f, "// Note: translate_address() is no longer used - all addresses are converted to host pointers at transpile time\n");
     fprintf(f, "// This define is kept for backwards compatibility but should not be used in generated code\n");
     fprintf(f, "#define translate_address(addr) (mem)  // Deprecated - use direct pointer casts\n\n");
+    fprintf(f, "// Guest address map: one slot per top address byte (generated from address_map.h)\n");
+    fprintf(f, "// Addresses with (addr & 0xFFFFFF) < limit map to mem + base + low bits\n");
+    fprintf(f, "typedef struct {\n");
+    fprintf(f, "    uint32_t base;\n");
+    fprintf(f, "    uint32_t limit;\n");
+    fprintf(f, "} gc_address_slot;\n\n");
+    fprintf(f, "extern const gc_address_slot gc_address_map[256];\n\n");
     fprintf(f, "// Helper function to convert GameCube addresses loaded from memory to host pointers\n");
+    fprintf(f, "// Branchless: unknown addresses are returned as-is\n");
     fprintf(f, "static inline uintptr_t convert_gc_address(uint32_t addr) {\n");
-    fprintf(f, "    // MEM1 cached: 0x80000000-0x84000000\n");
-    fprintf(f, "    if (addr >= 0x80000000 && addr < 0x84000000) return (uintptr_t)(mem + (addr - 0x80000000));\n");
-    fprintf(f, "    // MEM1 uncached: 0xC0000000-0xC2000000\n");
-    fprintf(f, "    if (addr >= 0xC0000000 && addr < 0xC2000000) return (uintptr_t)(mem + (addr - 0xC0000000));\n");
-    fprintf(f, "    // Hardware I/O: 0xCC000000-0xCC010000\n");
-    fprintf(f, "    if (addr >= 0xCC000000 && addr < 0xCC010000) return (uintptr_t)(mem + (addr - 0xCC000000) + 0x1800000);\n");
-    fprintf(f, "    // MEM2 cached: 0x90000000-0x94000000\n");
-    fprintf(f, "    if (addr >= 0x90000000 && addr < 0x94000000) return (uintptr_t)(mem + (addr - 0x90000000) + 0x1800000);\n");
-    fprintf(f, "    // MEM2 uncached: 0xD0000000-0xD4000000\n");
-    fprintf(f, "    if (addr >= 0xD0000000 && addr < 0xD4000000) return (uintptr_t)(mem + (addr - 0xD0000000) + 0x1800000);\n");
-    fprintf(f, "    // Locked cache: 0xE0000000-0xE0010000\n");
-    fprintf(f, "    if (addr >= 0xE0000000 && addr < 0xE0010000) return (uintptr_t)(mem + (addr - 0xE0000000) + 0x5800000);\n");
-    fprintf(f, "    // Not a GameCube address - return as-is\n");
-    fprintf(f, "    return (uintptr_t)addr;\n");
+    fprintf(f, "    const gc_address_slot *slot = &gc_address_map[addr >> 24];\n");
+    fprintf(f, "    uint32_t low = addr & 0x00FFFFFF;\n");
+    fprintf(f, "    uintptr_t hit = (uintptr_t)0 - (uintptr_t)(low < slot->limit);\n");
+    fprintf(f, "    return (((uintptr_t)mem + slot->base + low) & hit) | ((uintptr_t)addr & ~hit);\n");
     fprintf(f, "}\n\n");
     
     fprintf(f, "/**\n");
@@ -296,6 +577,22 @@ static inline int generate_runtime_h(const char *project_dir) {
     return 0;
 }
 
+/**
+ * @brief Emit the gc_address_map table used by convert_gc_address()
+ */
+static inline void generate_address_map_table(FILE *f) {
+    fprintf(f, "// Guest address map (generated from address_map.h, unlisted slots pass through)\n");
+    fprintf(f, "const gc_address_slot gc_address_map[256] = {\n");
+    const GC_AddressSlot *slots = gc_host_slots;
+    for (uint32_t i = 0; i < GC_ADDRESS_SLOT_COUNT; i++) {
+        if (slots[i].limit == 0) continue;
+        const GC_Region *region = gc_address_region(i << GC_ADDRESS_SLOT_SHIFT);
+        fprintf(f, "    [0x%02X] = { 0x%08X, 0x%08X },  // %s\n",
+                i, slots[i].base, slots[i].limit, region ? region->name : "");
+    }
+    fprintf(f, "};\n\n");
+}
+
 /**
  * @brief Generate powerpc_state.c implementation
  */
@@ -345,6 +642,8 @@ static inline int generate_runtime_c(const char *project_dir) {
     fprintf(f, "uint32_t *spr = spr_array;\n\n");
     
     fprintf(f, "uint8_t *mem = NULL;\n\n");
+    generate_address_map_table(f);
+    
     
     fprintf(f, "int runtime_init(void) {\n");
     fprintf(f, "    // Allocate emulated memory\n");
@@ -356,9 +655,9 @@ static inline int generate_runtime_c(const char *project_dir) {
     fprintf(f, "    // Initialize registers\n");
     fprintf(f, "    memset(sr, 0, sizeof(sr));\n");
     fprintf(f, "    r1 = 0x81700000;  // Stack pointer (stack grows downward)\n");
-    fprintf(f, "    // r2 and r13 are Small Data Area bases - from __start.s\n");
-    fprintf(f, "    r2 = 0x804DF9E0;  // SDA2 base (_SDA2_BASE_)\n");
-    fprintf(f, "    r13 = 0x804DB6A0; // SDA base (_SDA_BASE_)\n\n");
+    fprintf(f, "    // r2 and r13 are Small Data Area bases (host pointers like every other register)\n");
+    fprintf(f, "    r2 = convert_gc_address(PPC_SDA2_BASE);\n");
+    fprintf(f, "    r13 = convert_gc_address(PPC_SDA_BASE);\n\n");
     
     fprintf(f, "    return 0;\n");
     fprintf(f, "}\n\n");
@@ -0,0 +1,166 @@
+/**
+ * @file small_data.h
+ * @brief Small-data area (r13 / r2) base discovery and access resolution
+ *
+ * EABI code reaches small globals as `lwz rX, sym@sda21(r13)` and small
+ * constants as `lfs fX, sym@sda21(r2)`. Once the two bases are known, every
+ * such access has a fixed address and can be emitted as a direct access to
+ * the memory image instead of going through the r13/r2 register globals.
+ *
+ * The bases come from, in order: the configuration, the linker-generated
+ * _SDA_BASE_ / _SDA2_BASE_ symbols of an imported map, and the lis/addi
+ * pairs of the game's __init_registers.
+ */
+
+#ifndef SMALL_DATA_H
+#define SMALL_DATA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "program_ir.h"
+#include "symbol_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Used by the generated runtime when nothing better is known
+#define SDA_DEFAULT_BASE        0x804DB6A0  // r13 (_SDA_BASE_)
+#define SDA2_DEFAULT_BASE       0x804DF9E0  // r2  (_SDA2_BASE_)
+
+#define SDA_INIT_FUNCTION       "__init_registers"
+
+typedef struct {
+    uint32_t sda_base;          // r13 (0 = unknown)
+    uint32_t sda2_base;         // r2 (0 = unknown)
+    const char *source;         // Where the bases were found
+} Small_Data_Bases;
+
+/**
+ * @brief Base register value for an rA field (0 if not a known small-data base)
+ */
+static inline uint32_t small_data_base(const Small_Data_Bases *bases, uint32_t ra) {
+    if (ra == 13) return bases->sda_base;
+    if (ra == 2) return bases->sda2_base;
+    return 0;
+}
+
+/**
+ * @brief Look up _SDA_BASE_ / _SDA2_BASE_ in an imported symbol map
+ */
+static inline bool small_data_from_symbols(const Symbol_Map *map, Small_Data_Bases *bases) {
+    const Symbol_Table *tables[3] = { &map->objects, &map->functions, &map->units };
+    bool found = false;
+    for (int t = 0; t < 3; t++) {
+        for (int i = 0; i < tables[t]->count; i++) {
+            const Symbol_Entry *entry = &tables[t]->entries[i];
+            const char *name = symbol_map_name(map, entry);
+            if (!bases->sda_base && strcmp(name, "_SDA_BASE_") == 0) {
+                bases->sda_base = entry->address;
+                found = true;
+            } else if (!bases->sda2_base && strcmp(name, "_SDA2_BASE_") == 0) {
+                bases->sda2_base = entry->address;
+                found = true;
+            }
+        }
+    }
+    if (found && !bases->source) bases->source = "symbol map";
+    return found;
+}
+
+/**
+ * @brief Evaluate the lis / addi / ori sequences that load r13 and r2 in __init_registers
+ * Works on instruction words, so relocated operands (_SDA_BASE_@ha) need no symbols.
+ */
+static inline bool small_data_from_ir(const Program_IR *ir, Small_Data_Bases *bases) {
+    uint32_t f = ir_find_function(ir, SDA_INIT_FUNCTION);
+    if (f == IR_NONE) return false;
+
+    const IR_Function *fn = &ir->functions[f];
+    uint32_t value[32] = {0};
+    bool known[32] = {false};
+    for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+        const IR_Instruction *insn = &ir->instructions[i];
+        if (insn->flags & IR_INSN_UNPARSED) continue;
+        uint32_t word = insn->word;
+        uint32_t rd = (word >> 21) & 0x1F, ra = (word >> 16) & 0x1F;
+        int32_t simm = (int16_t)(word & 0xFFFF);
+
+        if (insn->opcode == 15 && ra == 0) {            // lis rD, hi
+            value[rd] = (uint32_t)simm << 16;
+            known[rd] = true;
+        } else if (insn->opcode == 14 && known[ra]) {   // addi rD, rA, lo
+            value[rd] = value[ra] + (uint32_t)simm;
+            known[rd] = true;
+        } else if (insn->opcode == 24 && known[rd]) {   // ori rA, rS, lo
+            value[ra] = value[rd] | (word & 0xFFFF);
+            known[ra] = true;
+        } else if (insn->flags & IR_INSN_BRANCH) {
+            break;                                      // Straight-line prologue only
+        }
+    }
+    bool found = false;
+    if (known[13] && !bases->sda_base) {
+        bases->sda_base = value[13];
+        found = true;
+    }
+    if (known[2] && !bases->sda2_base) {
+        bases->sda2_base = value[2];
+        found = true;
+    }
+    if (found && !bases->source) bases->source = SDA_INIT_FUNCTION;
+    return found;
+}
+
+/**
+ * @brief Address reached by an r13/r2-relative load, store or addi
+ * @return true for a non-update D-form access (or addi) whose base is known
+ */
+static inline bool small_data_address(const Small_Data_Bases *bases, uint32_t word, uint32_t *address) {
+    uint32_t opcode = word >> 26;
+    bool access = opcode == 14 ||                                  // addi (address of the variable)
+                  opcode == 32 || opcode == 34 || opcode == 36 || opcode == 38 ||   // lwz lbz stw stb
+                  opcode == 40 || opcode == 42 || opcode == 44 ||                   // lhz lha sth
+                  opcode == 48 || opcode == 50 || opcode == 52 || opcode == 54;     // lfs lfd stfs stfd
+    if (!access) return false;
+
+    uint32_t base = small_data_base(bases, (word >> 16) & 0x1F);
+    if (!base) return false;
+    *address = base + (uint32_t)(int32_t)(int16_t)(word & 0xFFFF);
+    return true;
+}
+
+/**
+ * @brief C for a small-data access at a fixed offset into the memory image
+ * Same forms as the register-relative opcode transpilers, with `mem + offset` as the base.
+ */
+static inline bool small_data_transpile(uint32_t word, uint32_t host_offset, char *output, size_t output_size) {
+    uint32_t rd = (word >> 21) & 0x1F;
+    switch (word >> 26) {
+        case 14: snprintf(output, output_size, "r%u = (uintptr_t)(mem + 0x%08X);", rd, host_offset); break;
+        case 32: snprintf(output, output_size,
+                          "r%u = *(uint32_t*)(mem + 0x%08X); r%u = convert_gc_address((uint32_t)r%u);",
+                          rd, host_offset, rd, rd); break;
+        case 34: snprintf(output, output_size, "r%u = *(uint8_t*)(mem + 0x%08X);", rd, host_offset); break;
+        case 40: snprintf(output, output_size, "r%u = *(uint16_t*)(mem + 0x%08X);", rd, host_offset); break;
+        case 42: snprintf(output, output_size, "r%u = (int32_t)(int16_t)*(uint16_t*)(mem + 0x%08X);",
+                          rd, host_offset); break;
+        case 36: snprintf(output, output_size, "*(uint32_t*)(mem + 0x%08X) = r%u;", host_offset, rd); break;
+        case 38: snprintf(output, output_size, "*(uint8_t*)(mem + 0x%08X) = r%u;", host_offset, rd); break;
+        case 44: snprintf(output, output_size, "*(uint16_t*)(mem + 0x%08X) = r%u;", host_offset, rd); break;
+        case 48: snprintf(output, output_size, "f%u = (double)*(float*)(mem + 0x%08X);", rd, host_offset); break;
+        case 50: snprintf(output, output_size, "f%u = *(double*)(mem + 0x%08X);", rd, host_offset); break;
+        case 52: snprintf(output, output_size, "*(float*)(mem + 0x%08X) = (float)f%u;", host_offset, rd); break;
+        case 54: snprintf(output, output_size, "*(double*)(mem + 0x%08X) = f%u;", host_offset, rd); break;
+        default: return false;
+    }
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMALL_DATA_H
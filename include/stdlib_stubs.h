@@ -2,8 +2,8 @@
  * @file stdlib_stubs.h
  * @brief Forward declarations for standard library functions with transpiler signature
  * 
- * Transpiled code always passes 10 parameters (r3-r10, f1-f2) to all function calls.
- * These declarations match that signature so the compiler accepts the calls.
+ * Transpiled code passes r3-r10, f1-f2 to all function calls (or nothing under the
+ * register calling convention). PPC_FUNC_PARAMS matches whichever the project uses.
  * 
  * The actual implementations will ignore unused parameters.
  * 
@@ -15,44 +15,45 @@
 #define STDLIB_STUBS_H
 
 #include <stdint.h>
+#include "powerpc_state.h"  // PPC_FUNC_PARAMS
 
 // Check if we're using Metrowerks Standard Library (MSL_C)
 // If so, don't redefine standard library functions
 #ifndef __MWERKS__
 #ifndef _MSL_C_H
 
-// Declare stdlib functions with the transpiler's 10-parameter signature
+// Declare stdlib functions with the transpiler's calling convention
 // The implementations ignore extra parameters
-extern void strcmp(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void strncmp(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void strlen(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void strcpy(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void strncpy(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void strcat(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void memcpy(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void memset(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void memcmp(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void memchr(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void sprintf(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void snprintf(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void printf(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void fprintf(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void vsprintf(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void sscanf(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
+extern void strcmp(PPC_FUNC_PARAMS);
+extern void strncmp(PPC_FUNC_PARAMS);
+extern void strlen(PPC_FUNC_PARAMS);
+extern void strcpy(PPC_FUNC_PARAMS);
+extern void strncpy(PPC_FUNC_PARAMS);
+extern void strcat(PPC_FUNC_PARAMS);
+extern void memcpy(PPC_FUNC_PARAMS);
+extern void memset(PPC_FUNC_PARAMS);
+extern void memcmp(PPC_FUNC_PARAMS);
+extern void memchr(PPC_FUNC_PARAMS);
+extern void sprintf(PPC_FUNC_PARAMS);
+extern void snprintf(PPC_FUNC_PARAMS);
+extern void printf(PPC_FUNC_PARAMS);
+extern void fprintf(PPC_FUNC_PARAMS);
+extern void vsprintf(PPC_FUNC_PARAMS);
+extern void sscanf(PPC_FUNC_PARAMS);
 
 // Memory allocation
-extern void malloc(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void free(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void calloc(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void realloc(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
+extern void malloc(PPC_FUNC_PARAMS);
+extern void free(PPC_FUNC_PARAMS);
+extern void calloc(PPC_FUNC_PARAMS);
+extern void realloc(PPC_FUNC_PARAMS);
 
 // Math functions - SKIP if MSL_C is present (it has these)
-extern void abs(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void fabs(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void sqrt(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void pow(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void sin(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
-extern void cos(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6, uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10, double f1, double f2);
+extern void abs(PPC_FUNC_PARAMS);
+extern void fabs(PPC_FUNC_PARAMS);
+extern void sqrt(PPC_FUNC_PARAMS);
+extern void pow(PPC_FUNC_PARAMS);
+extern void sin(PPC_FUNC_PARAMS);
+extern void cos(PPC_FUNC_PARAMS);
 
 #endif // _MSL_C_H
 #endif // __MWERKS__
@@ -0,0 +1,522 @@
+/**
+ * @file symbol_map.h
+ * @brief Address-indexed symbol table imported from linker maps
+ *
+ * Importers:
+ *   - CodeWarrior .map (section layout tables)
+ *   - decomp-toolkit symbols.txt   (name = .text:0xADDR; // type:function size:0xN)
+ *   - decomp-toolkit splits.txt    (per-unit start:/end: ranges)
+ *   - Plain "0xADDR name [size]" lines
+ *
+ * Entries are kept sorted by address so "which function contains this address"
+ * is a binary search. A parsed map is cached next to the source as a compact
+ * binary file (<source>.idx) and reloaded without parsing while the source is
+ * unchanged.
+ */
+
+#ifndef SYMBOL_MAP_H
+#define SYMBOL_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// CONFIGURATION
+//==============================================================================
+
+#define SYMBOL_MAP_CACHE_MAGIC      0x4D595350  // "PSYM"
+#define SYMBOL_MAP_CACHE_VERSION    2
+#define SYMBOL_MAP_CACHE_SUFFIX     ".idx"
+
+typedef enum {
+    SYMBOL_KIND_FUNCTION = 0,
+    SYMBOL_KIND_OBJECT   = 1,   // Data
+    SYMBOL_KIND_LABEL    = 2,   // Local code label
+    SYMBOL_KIND_UNIT     = 3    // Translation unit range (splits.txt / .map object column)
+} Symbol_Kind;
+
+//==============================================================================
+// STRUCTURES
+//==============================================================================
+
+/**
+ * @brief One symbol; names live in the map's shared string pool
+ */
+typedef struct {
+    uint32_t address;
+    uint32_t size;              // 0 = unknown, runs to the next entry of the same table
+    uint32_t name_offset;       // Offset into Symbol_Map.names
+    uint32_t kind;              // Symbol_Kind
+} Symbol_Entry;
+
+typedef struct {
+    Symbol_Entry *entries;
+    int count;
+    int capacity;
+} Symbol_Table;
+
+/**
+ * @brief Functions, other symbols and translation-unit ranges, each sorted by address
+ */
+typedef struct {
+    Symbol_Table functions;
+    Symbol_Table objects;       // Data objects and local labels
+    Symbol_Table units;         // Translation unit ranges
+    char *names;
+    uint32_t names_size;
+    uint32_t names_capacity;
+} Symbol_Map;
+
+/**
+ * @brief On-disk cache header (followed by the three entry tables, then names)
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t source_size;       // Source file stamp: the cache is stale if either differs
+    int64_t source_mtime;
+    uint32_t function_count;
+    uint32_t object_count;
+    uint32_t unit_count;
+    uint32_t names_size;
+} Symbol_Map_Cache_Header;
+
+//==============================================================================
+// BUILDING
+//==============================================================================
+
+static inline void symbol_map_init(Symbol_Map *map) {
+    memset(map, 0, sizeof(*map));
+}
+
+static inline void symbol_map_free(Symbol_Map *map) {
+    free(map->functions.entries);
+    free(map->objects.entries);
+    free(map->units.entries);
+    free(map->names);
+    memset(map, 0, sizeof(*map));
+}
+
+static inline int symbol_map_count(const Symbol_Map *map) {
+    return map->functions.count + map->objects.count + map->units.count;
+}
+
+static inline const char* symbol_map_name(const Symbol_Map *map, const Symbol_Entry *entry) {
+    return map->names + entry->name_offset;
+}
+
+static inline uint32_t symbol_map_intern(Symbol_Map *map, const char *name) {
+    uint32_t len = (uint32_t)strlen(name) + 1;
+    if (map->names_size + len > map->names_capacity) {
+        uint32_t new_capacity = map->names_capacity ? map->names_capacity * 2 : 64 * 1024;
+        while (new_capacity < map->names_size + len) new_capacity *= 2;
+        char *grown = (char*)realloc(map->names, new_capacity);
+        if (!grown) return 0;
+        map->names = grown;
+        map->names_capacity = new_capacity;
+    }
+    uint32_t offset = map->names_size;
+    memcpy(map->names + offset, name, len);
+    map->names_size += len;
+    return offset;
+}
+
+/**
+ * @brief Append a symbol (call symbol_map_sort() once all are added)
+ */
+static inline Symbol_Table* symbol_map_table(Symbol_Map *map, Symbol_Kind kind) {
+    if (kind == SYMBOL_KIND_FUNCTION) return &map->functions;
+    if (kind == SYMBOL_KIND_UNIT) return &map->units;
+    return &map->objects;
+}
+
+static inline bool symbol_map_add(Symbol_Map *map, const char *name, uint32_t address,
+                                  uint32_t size, Symbol_Kind kind) {
+    Symbol_Table *table = symbol_map_table(map, kind);
+    if (table->count >= table->capacity) {
+        int new_capacity = table->capacity ? table->capacity * 2 : 1024;
+        Symbol_Entry *grown = (Symbol_Entry*)realloc(table->entries, sizeof(Symbol_Entry) * new_capacity);
+        if (!grown) return false;
+        table->entries = grown;
+        table->capacity = new_capacity;
+    }
+
+    Symbol_Entry *entry = &table->entries[table->count++];
+    entry->address = address;
+    entry->size = size;
+    entry->name_offset = symbol_map_intern(map, name);
+    entry->kind = (uint32_t)kind;
+    return true;
+}
+
+static inline int symbol_entry_compare(const void *a, const void *b) {
+    const Symbol_Entry *x = (const Symbol_Entry*)a;
+    const Symbol_Entry *y = (const Symbol_Entry*)b;
+    return (x->address > y->address) - (x->address < y->address);
+}
+
+/**
+ * @brief Sort every table and drop exact duplicates
+ */
+static inline void symbol_map_sort(Symbol_Map *map) {
+    Symbol_Table *tables[3] = { &map->functions, &map->objects, &map->units };
+    for (int t = 0; t < 3; t++) {
+        Symbol_Table *table = tables[t];
+        if (table->count < 2) continue;
+        qsort(table->entries, table->count, sizeof(Symbol_Entry), symbol_entry_compare);
+
+        int out = 1;
+        for (int i = 1; i < table->count; i++) {
+            const Symbol_Entry *prev = &table->entries[out - 1];
+            const Symbol_Entry *cur = &table->entries[i];
+            if (cur->address == prev->address &&
+                strcmp(symbol_map_name(map, cur), symbol_map_name(map, prev)) == 0) {
+                continue;
+            }
+            table->entries[out++] = *cur;
+        }
+        table->count = out;
+    }
+}
+
+//==============================================================================
+// LOOKUP
+//==============================================================================
+
+/**
+ * @brief Index of the last entry with address <= addr, or -1
+ */
+static inline int symbol_table_floor(const Symbol_Table *table, uint32_t addr) {
+    int lo = 0, hi = table->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (table->entries[mid].address <= addr) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo - 1;
+}
+
+/**
+ * @brief End address of an entry (explicit size, else the next entry's start)
+ */
+static inline uint32_t symbol_table_end(const Symbol_Table *table, int i) {
+    const Symbol_Entry *entry = &table->entries[i];
+    if (entry->size) return entry->address + entry->size;
+    for (int n = i + 1; n < table->count; n++) {
+        if (table->entries[n].address > entry->address) return table->entries[n].address;
+    }
+    return 0xFFFFFFFF;
+}
+
+/**
+ * @brief Function starting exactly at an address
+ */
+static inline const Symbol_Entry* symbol_map_find(const Symbol_Map *map, uint32_t addr) {
+    int i = symbol_table_floor(&map->functions, addr);
+    if (i < 0 || map->functions.entries[i].address != addr) return NULL;
+    return &map->functions.entries[i];
+}
+
+/**
+ * @brief Function whose [address, end) interval contains addr
+ */
+static inline const Symbol_Entry* symbol_map_containing_function(const Symbol_Map *map, uint32_t addr) {
+    int i = symbol_table_floor(&map->functions, addr);
+    if (i < 0 || addr >= symbol_table_end(&map->functions, i)) return NULL;
+    return &map->functions.entries[i];
+}
+
+/**
+ * @brief Translation unit whose range contains addr
+ */
+static inline const Symbol_Entry* symbol_map_containing_unit(const Symbol_Map *map, uint32_t addr) {
+    int i = symbol_table_floor(&map->units, addr);
+    if (i < 0 || addr >= symbol_table_end(&map->units, i)) return NULL;
+    return &map->units.entries[i];
+}
+
+//==============================================================================
+// TEXT IMPORTERS
+//==============================================================================
+
+static inline bool symbol_map_is_hex(const char *token, size_t digits) {
+    if (strlen(token) != digits) return false;
+    for (const char *p = token; *p; p++) {
+        if (!isxdigit((unsigned char)*p)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a CodeWarrior link map
+ * Section layout rows are "offset size vaddr [fileoffset] align name object".
+ * Rows in .init/.text layouts are functions, others objects; a row named after
+ * its section (".text") spans the whole object and becomes a unit range.
+ * The "Linker generated symbols" table (_SDA_BASE_, _stack_addr, ...) adds objects.
+ */
+static inline int symbol_map_parse_codewarrior(Symbol_Map *map, FILE *f) {
+    char line[1024];
+    bool in_code = false;
+    bool in_layout = false;
+    int added = 0;
+
+    bool in_linker = false;
+    while (fgets(line, sizeof(line), f)) {
+        if (strstr(line, "section layout")) {
+            in_layout = true;
+            in_linker = false;
+            in_code = strstr(line, ".text") != NULL || strstr(line, ".init") != NULL;
+            continue;
+        }
+        if (strstr(line, "Linker generated symbols:")) {
+            in_layout = false;
+            in_linker = true;
+            continue;
+        }
+        if (in_linker) {
+            // "_SDA_BASE_ 804db6a0" (section bounds, small-data bases, stack)
+            char name[128], value[64];
+            if (sscanf(line, "%127s %63s", name, value) == 2 && symbol_map_is_hex(value, 8)) {
+                symbol_map_add(map, name, (uint32_t)strtoul(value, NULL, 16), 0, SYMBOL_KIND_OBJECT);
+                added++;
+            }
+            continue;
+        }
+        if (!in_layout) continue;
+        if (strstr(line, "Memory map:")) {
+            in_layout = false;
+            continue;
+        }
+
+        char tokens[8][128];
+        int n = sscanf(line, "%127s %127s %127s %127s %127s %127s %127s %127s",
+                       tokens[0], tokens[1], tokens[2], tokens[3],
+                       tokens[4], tokens[5], tokens[6], tokens[7]);
+        if (n < 5 || !symbol_map_is_hex(tokens[0], 8) || !symbol_map_is_hex(tokens[2], 8)) continue;
+
+        // Newer maps add an 8-digit file offset before the alignment column
+        int name_index = (symbol_map_is_hex(tokens[3], 8) && n >= 6) ? 5 : 4;
+        const char *name = tokens[name_index];
+        const char *object = tokens[n - 1];  // Last column: object file (after any archive name)
+        uint32_t size = (uint32_t)strtoul(tokens[1], NULL, 16);
+        uint32_t vaddr = (uint32_t)strtoul(tokens[2], NULL, 16);
+        if (vaddr == 0 || strcmp(name, "UNUSED") == 0) continue;
+
+        if (name[0] == '.') {
+            if (in_code && size && name_index + 1 < n) {
+                symbol_map_add(map, object, vaddr, size, SYMBOL_KIND_UNIT);
+            }
+        } else {
+            symbol_map_add(map, name, vaddr, size, in_code ? SYMBOL_KIND_FUNCTION : SYMBOL_KIND_OBJECT);
+        }
+        added++;
+    }
+    return added;
+}
+
+/**
+ * @brief Parse dtk symbols.txt, dtk splits.txt or "0xADDR name [size]" lines
+ */
+static inline int symbol_map_parse_text(Symbol_Map *map, FILE *f) {
+    char line[1024];
+    char unit[128] = {0};
+    int added = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#' || (p[0] == '/' && p[1] == '/')) continue;
+
+        char name[128] = {0};
+        unsigned int address = 0, size = 0, end = 0;
+
+        if (strstr(p, "start:") && strstr(p, "end:")) {
+            // splits.txt range under the current "unit.c:" heading
+            if (!unit[0] || (strncmp(p, ".text", 5) != 0 && strncmp(p, ".init", 5) != 0)) continue;
+            sscanf(strstr(p, "start:") + 6, "%x", &address);
+            sscanf(strstr(p, "end:") + 4, "%x", &end);
+            if (end > address) {
+                symbol_map_add(map, unit, address, end - address, SYMBOL_KIND_UNIT);
+                added++;
+            }
+        } else if (strchr(p, '=')) {
+            // symbols.txt: name = .section:0xADDR; // type:function size:0xN
+            char section[64];
+            if (sscanf(p, "%127s = %63[^:]:%x", name, section, &address) != 3) continue;
+            const char *type = strstr(p, "type:");
+            const char *sz = strstr(p, "size:");
+            if (sz) sscanf(sz + 5, "%x", &size);
+
+            Symbol_Kind kind = SYMBOL_KIND_OBJECT;
+            if (type && strncmp(type + 5, "function", 8) == 0) kind = SYMBOL_KIND_FUNCTION;
+            else if (type && strncmp(type + 5, "label", 5) == 0) kind = SYMBOL_KIND_LABEL;
+            else if (!type && (strncmp(section, ".text", 5) == 0 || strncmp(section, ".init", 5) == 0)) {
+                kind = SYMBOL_KIND_FUNCTION;
+            }
+            symbol_map_add(map, name, address, size, kind);
+            added++;
+        } else if (sscanf(p, "%127s", name) == 1 && name[strlen(name) - 1] == ':' &&
+                   strchr(p, ' ') == NULL && strchr(p, '\t') == NULL) {
+            // splits.txt unit heading "path/to/unit.c:" (the "Sections:" block has no ranges)
+            name[strlen(name) - 1] = '\0';
+            snprintf(unit, sizeof(unit), "%s", name);
+        } else {
+            // address name [size]
+            if (sscanf(p, "%x %127s %x", &address, name, &size) < 2) continue;
+            symbol_map_add(map, name, address, size, SYMBOL_KIND_FUNCTION);
+            added++;
+        }
+    }
+    return added;
+}
+
+//==============================================================================
+// BINARY CACHE
+//==============================================================================
+
+static inline bool symbol_map_stat(const char *path, uint64_t *size, int64_t *mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *size = (uint64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+/**
+ * @brief Write the sorted map as a binary cache stamped with its source file
+ */
+static inline bool symbol_map_save_cache(const Symbol_Map *map, const char *cache_path, const char *source_path) {
+    Symbol_Map_Cache_Header header = {0};
+    header.magic = SYMBOL_MAP_CACHE_MAGIC;
+    header.version = SYMBOL_MAP_CACHE_VERSION;
+    if (!symbol_map_stat(source_path, &header.source_size, &header.source_mtime)) return false;
+    header.function_count = (uint32_t)map->functions.count;
+    header.object_count = (uint32_t)map->objects.count;
+    header.unit_count = (uint32_t)map->units.count;
+    header.names_size = map->names_size;
+
+    FILE *f = fopen(cache_path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(map->functions.entries, sizeof(Symbol_Entry), header.function_count, f) == header.function_count &&
+              fwrite(map->objects.entries, sizeof(Symbol_Entry), header.object_count, f) == header.object_count &&
+              fwrite(map->units.entries, sizeof(Symbol_Entry), header.unit_count, f) == header.unit_count &&
+              fwrite(map->names, 1, header.names_size, f) == header.names_size;
+    fclose(f);
+    if (!ok) remove(cache_path);
+    return ok;
+}
+
+/**
+ * @brief Load a binary cache into an empty map if it was built from the current source
+ */
+static inline bool symbol_map_load_cache(Symbol_Map *map, const char *cache_path, const char *source_path) {
+    FILE *f = fopen(cache_path, "rb");
+    if (!f) return false;
+
+    Symbol_Map_Cache_Header header;
+    uint64_t size;
+    int64_t mtime;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        header.magic != SYMBOL_MAP_CACHE_MAGIC || header.version != SYMBOL_MAP_CACHE_VERSION ||
+        !symbol_map_stat(source_path, &size, &mtime) ||
+        header.source_size != size || header.source_mtime != mtime) {
+        fclose(f);
+        return false;
+    }
+
+    map->functions.entries = (Symbol_Entry*)malloc(sizeof(Symbol_Entry) * (header.function_count + 1));
+    map->objects.entries = (Symbol_Entry*)malloc(sizeof(Symbol_Entry) * (header.object_count + 1));
+    map->units.entries = (Symbol_Entry*)malloc(sizeof(Symbol_Entry) * (header.unit_count + 1));
+    map->names = (char*)malloc(header.names_size + 1);
+    bool ok = map->functions.entries && map->objects.entries && map->units.entries && map->names &&
+              fread(map->functions.entries, sizeof(Symbol_Entry), header.function_count, f) == header.function_count &&
+              fread(map->objects.entries, sizeof(Symbol_Entry), header.object_count, f) == header.object_count &&
+              fread(map->units.entries, sizeof(Symbol_Entry), header.unit_count, f) == header.unit_count &&
+              fread(map->names, 1, header.names_size, f) == header.names_size;
+    fclose(f);
+
+    if (!ok) {
+        symbol_map_free(map);
+        return false;
+    }
+    map->functions.count = map->functions.capacity = (int)header.function_count;
+    map->objects.count = map->objects.capacity = (int)header.object_count;
+    map->units.count = map->units.capacity = (int)header.unit_count;
+    map->names_size = map->names_capacity = header.names_size;
+    return true;
+}
+
+/**
+ * @brief Move every entry of src into dst and free src
+ */
+static inline void symbol_map_merge(Symbol_Map *dst, Symbol_Map *src) {
+    if (symbol_map_count(dst) == 0) {
+        symbol_map_free(dst);
+        *dst = *src;
+        memset(src, 0, sizeof(*src));
+        return;
+    }
+
+    const Symbol_Table *tables[3] = { &src->functions, &src->objects, &src->units };
+    for (int t = 0; t < 3; t++) {
+        const Symbol_Table *table = tables[t];
+        for (int i = 0; i < table->count; i++) {
+            const Symbol_Entry *e = &table->entries[i];
+            symbol_map_add(dst, symbol_map_name(src, e), e->address, e->size, (Symbol_Kind)e->kind);
+        }
+    }
+    symbol_map_free(src);
+    symbol_map_sort(dst);
+}
+
+/**
+ * @brief Import a symbol source, using <path>.idx when it is up to date
+ * The format is picked from the content: CodeWarrior maps contain "section layout".
+ * Several sources (e.g. symbols.txt and splits.txt) can be loaded into one map.
+ * @return Number of entries in the map afterwards, or -1 if unreadable
+ */
+static inline int symbol_map_load(Symbol_Map *map, const char *path) {
+    char cache_path[1024];
+    snprintf(cache_path, sizeof(cache_path), "%s%s", path, SYMBOL_MAP_CACHE_SUFFIX);
+
+    Symbol_Map loaded;
+    symbol_map_init(&loaded);
+
+    if (!symbol_map_load_cache(&loaded, cache_path, path)) {
+        FILE *f = fopen(path, "r");
+        if (!f) return -1;
+
+        char probe[4096];
+        size_t got = fread(probe, 1, sizeof(probe) - 1, f);
+        probe[got] = '\0';
+        rewind(f);
+
+        if (strstr(probe, "section layout")) {
+            symbol_map_parse_codewarrior(&loaded, f);
+        } else {
+            symbol_map_parse_text(&loaded, f);
+        }
+        fclose(f);
+        symbol_map_sort(&loaded);
+        symbol_map_save_cache(&loaded, cache_path, path);
+    }
+
+    symbol_map_merge(map, &loaded);
+    return symbol_map_count(map);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYMBOL_MAP_H
@@ -0,0 +1,234 @@
+/**
+ * @file unity_build.h
+ * @brief Unity (sharded) translation units for generated projects
+ *
+ * One .c per .s gives thousands of small translation units, each paying for
+ * compiler startup and for parsing powerpc_state.h. In unity mode the generated
+ * sources are grouped into N shards, src/unity/unity_NNN.c, that #include them.
+ *
+ * Shards are balanced by instruction count (largest file to the lightest shard)
+ * and depend only on the file list and sizes, so the same input always gives
+ * the same shards and unchanged shard files are not rewritten. Local (static)
+ * functions are renamed with a per-source prefix while their file is included,
+ * so two files with a `static void helper()` can share a shard.
+ */
+
+#ifndef UNITY_BUILD_H
+#define UNITY_BUILD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UNITY_DIR               "unity"
+#define UNITY_MAX_SHARDS        999
+
+typedef struct {
+    const char *path;           // Generated source, relative to src/
+    uint32_t weight;            // Instructions emitted into it
+    char **locals;              // Static function names to prefix
+    int local_count;
+    int shard;                  // Assigned by unity_assign_shards()
+} Unity_Source;
+
+static const Unity_Source *unity_sort_sources;
+
+static inline int unity_compare_weight(const void *a, const void *b) {
+    const Unity_Source *x = &unity_sort_sources[*(const int*)a], *y = &unity_sort_sources[*(const int*)b];
+    if (x->weight != y->weight) return x->weight > y->weight ? -1 : 1;
+    return strcmp(x->path, y->path);
+}
+
+/**
+ * @brief Spread the sources over shard_count shards of about equal instruction count
+ */
+static inline void unity_assign_shards(Unity_Source *sources, int count, int shard_count) {
+    int *order = (int*)malloc(sizeof(int) * (count + 1));
+    uint64_t *load = (uint64_t*)calloc(shard_count + 1, sizeof(uint64_t));
+    if (!order || !load) {
+        for (int i = 0; i < count; i++) sources[i].shard = i % shard_count;
+        free(order); free(load);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) order[i] = i;
+    unity_sort_sources = sources;
+    qsort(order, count, sizeof(int), unity_compare_weight);
+
+    for (int i = 0; i < count; i++) {
+        int lightest = 0;
+        for (int s = 1; s < shard_count; s++) {
+            if (load[s] < load[lightest]) lightest = s;
+        }
+        sources[order[i]].shard = lightest;
+        load[lightest] += sources[order[i]].weight + 1;  // +1: empty files still cost a little
+    }
+    free(order);
+    free(load);
+}
+
+/**
+ * @brief Per-source identifier prefix: "sub/test.c" -> "sub_test_"
+ */
+static inline void unity_prefix(const char *path, char *output, size_t output_size) {
+    size_t n = 0;
+    for (const char *p = path; *p && n + 2 < output_size; p++) {
+        if (*p == '.' && strchr(p, '/') == NULL) break;
+        bool ident = (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || *p == '_';
+        output[n++] = ident ? *p : '_';
+    }
+    output[n++] = '_';
+    output[n] = '\0';
+}
+
+/**
+ * @brief Replace a file with the contents of a temporary file, unless they are equal
+ * Keeping the old file (and its timestamp) lets the build skip the shard.
+ */
+static inline bool unity_replace_if_changed(FILE *content, const char *path) {
+    bool same = false;
+    FILE *old = fopen(path, "rb");
+    if (old) {
+        rewind(content);
+        int a, b;
+        do {
+            a = fgetc(content);
+            b = fgetc(old);
+        } while (a == b && a != EOF);
+        same = a == b;
+        fclose(old);
+    }
+    if (same) return false;
+
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        fprintf(stderr, "Error: Cannot create %s\n", path);
+        return false;
+    }
+    rewind(content);
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), content)) > 0) fwrite(chunk, 1, n, out);
+    fclose(out);
+    return true;
+}
+
+/**
+ * @brief Include lines at the top of a generated source (the file's dependencies)
+ */
+static inline void unity_collect_includes(const char *source_path, char ***includes, int *count, int *capacity) {
+    FILE *f = fopen(source_path, "r");
+    if (!f) return;
+    char line[1024];
+    while (fgets(line, sizeof(line), f) && strncmp(line, "#include", 8) == 0) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *comment = strstr(line, "  //");
+        if (comment) *comment = '\0';
+
+        bool seen = false;
+        for (int i = 0; i < *count && !seen; i++) seen = strcmp((*includes)[i], line) == 0;
+        if (seen) continue;
+        if (*count == *capacity) {
+            int grown = *capacity ? *capacity * 2 : 64;
+            char **resized = (char**)realloc(*includes, sizeof(char*) * grown);
+            if (!resized) break;
+            *includes = resized;
+            *capacity = grown;
+        }
+        (*includes)[(*count)++] = strdup(line);
+    }
+    fclose(f);
+}
+
+/**
+ * @brief Write src/unity/unity_NNN.c for every shard and delete shards left over from earlier runs
+ * @param src_dir Project src/ directory (src/unity must exist when shard_count > 0)
+ * @param sources Sources with their shard assigned
+ * @param shard_count Number of shards (0 only removes old shards)
+ * @return Number of shard files rewritten
+ */
+static inline int unity_write_shards(const char *src_dir, const Unity_Source *sources, int count, int shard_count) {
+    int rewritten = 0;
+    for (int s = 0; s < shard_count; s++) {
+        // Members in path order, so a shard's text does not depend on the weights
+        int *members = (int*)malloc(sizeof(int) * (count + 1));
+        if (!members) return rewritten;
+        int member_count = 0;
+        for (int i = 0; i < count; i++) {
+            if (sources[i].shard == s) members[member_count++] = i;
+        }
+        for (int i = 1; i < member_count; i++) {
+            int m = members[i], j = i;
+            for (; j > 0 && strcmp(sources[members[j - 1]].path, sources[m].path) > 0; j--) members[j] = members[j - 1];
+            members[j] = m;
+        }
+
+        // Every dependency first: a header pulled in while a rename is active would be renamed too
+        char **includes = NULL;
+        int include_count = 0, include_capacity = 0;
+        uint64_t weight = 0;
+        for (int i = 0; i < member_count; i++) {
+            char source_path[1024];
+            snprintf(source_path, sizeof(source_path), "%s/%s", src_dir, sources[members[i]].path);
+            unity_collect_includes(source_path, &includes, &include_count, &include_capacity);
+            weight += sources[members[i]].weight;
+        }
+
+        FILE *content = tmpfile();
+        if (!content) {
+            free(members);
+            return rewritten;
+        }
+        fprintf(content, "/**\n");
+        fprintf(content, " * @file unity_%03d.c\n", s);
+        fprintf(content, " * @brief Unity shard %d of %d: %d sources, %llu instructions\n",
+                s + 1, shard_count, member_count, (unsigned long long)weight);
+        fprintf(content, " * Generated by Porpoise Tool - do not edit\n");
+        fprintf(content, " */\n\n");
+        for (int i = 0; i < include_count; i++) {
+            fprintf(content, "%s\n", includes[i]);
+            free(includes[i]);
+        }
+        free(includes);
+
+        for (int i = 0; i < member_count; i++) {
+            const Unity_Source *source = &sources[members[i]];
+            char prefix[256];
+            unity_prefix(source->path, prefix, sizeof(prefix));
+            fprintf(content, "\n// %s (%u instructions)\n", source->path, source->weight);
+            for (int l = 0; l < source->local_count; l++) {
+                fprintf(content, "#define %s %s%s\n", source->locals[l], prefix, source->locals[l]);
+            }
+            fprintf(content, "#include \"../%s\"\n", source->path);
+            for (int l = 0; l < source->local_count; l++) {
+                fprintf(content, "#undef %s\n", source->locals[l]);
+            }
+        }
+        free(members);
+
+        char shard_path[1024];
+        snprintf(shard_path, sizeof(shard_path), "%s/%s/unity_%03d.c", src_dir, UNITY_DIR, s);
+        if (unity_replace_if_changed(content, shard_path)) rewritten++;
+        fclose(content);
+    }
+
+    // A smaller shard count (or unity mode turned off) leaves old shards behind
+    for (int s = shard_count; s < UNITY_MAX_SHARDS; s++) {
+        char shard_path[1024];
+        snprintf(shard_path, sizeof(shard_path), "%s/%s/unity_%03d.c", src_dir, UNITY_DIR, s);
+        if (remove(shard_path) != 0) break;
+    }
+    return rewritten;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UNITY_BUILD_H
@@ -0,0 +1,712 @@
+/**
+ * @file bench_codegen.c
+ * @brief Codegen-quality benchmark: transpiled kernels against hand-written C (make bench-codegen)
+ *
+ * Linked with the project the transpiler generates from the listings in bench/kernels:
+ * memcpy and strlen loops, 4x4 matrix multiply on the FPU and with paired
+ * singles, vec3 normalize, a branchy tokenizer state machine, a vtable
+ * dispatch loop, a call loop through non-trivial stack frames, a loop over
+ * three identical helpers and a loop of small leaf calls. Each kernel runs on data in emulated memory and its
+ * result is checked against the C version. Both are then timed, best of five,
+ * per call.
+ *
+ * Each kernel runs in its own process (`--kernel NAME`). A kernel whose
+ * generated code exits (an unresolved indirect call, for one) is reported as
+ * failed and does not stop the suite.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "powerpc_state.h"
+#include "all_functions.h"
+#include "function_address_map.h"
+#include "porpoise_stats.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+#define CODEGEN_REPEATS         5
+#define CODEGEN_MIN_SECONDS     0.02
+#define CODEGEN_LINE_SIZE       4096
+
+// Kernel data in emulated MEM1
+#define DATA_SOURCE             0x80100000u
+#define DATA_DEST               0x80120000u
+#define DATA_STRING             0x80140000u
+#define DATA_MATRIX_A           0x80150000u
+#define DATA_MATRIX_B           0x80150040u
+#define DATA_MATRIX_C           0x80150080u
+#define DATA_VECTORS            0x80160000u
+#define DATA_CONSTANTS          0x8016F000u
+#define DATA_TEXT               0x80170000u
+#define DATA_OBJECT_LIST        0x80180000u
+#define DATA_OBJECTS            0x80190000u
+#define DATA_VTABLES            0x801A0000u
+#define DATA_FRAME_VALUES       0x801B0000u
+#define DATA_STACK_TOP          0x801C0000u
+#define DATA_FOLD_VALUES        0x801D0000u
+#define DATA_RECORDS            0x801E0000u
+
+#define COPY_WORDS              4096
+#define STRING_LENGTH           4095
+#define VECTOR_COUNT            1024
+#define TEXT_LENGTH             8192
+#define OBJECT_COUNT            1024
+#define FRAME_VALUE_COUNT       1024
+#define FOLD_VALUE_COUNT        1024
+#define RECORD_COUNT            1024
+
+// Guest addresses of the methods in bench/kernels/vtable.s
+#define SQUARE_AREA_ADDRESS     0x8000A000u
+#define CIRCLE_AREA_ADDRESS     0x8000A00Cu
+#define TRIANGLE_AREA_ADDRESS   0x8000A01Cu
+
+// Guest addresses of the identical helpers in bench/kernels/fold.s
+#define FOLD_MIX_A_ADDRESS      0x8000C000u
+#define FOLD_MIX_B_ADDRESS      0x8000C028u
+#define FOLD_MIX_C_ADDRESS      0x8000C050u
+
+#ifdef PPC_REGISTER_ABI
+#define KERNEL_CALL(fn, a, b, c) do { \
+        r3 = convert_gc_address(a); r4 = convert_gc_address(b); r5 = convert_gc_address(c); fn(); \
+    } while (0)
+#else
+#define KERNEL_CALL(fn, a, b, c) fn((a), (b), (c), 0, 0, 0, 0, 0, 0.0, 0.0)
+#endif
+
+static void *guest(uint32_t address) {
+    return (void*)convert_gc_address(address);
+}
+
+typedef void (*Codegen_Run)(void);
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    Codegen_Run transpiled;
+    Codegen_Run native;
+    bool (*verify)(void);       // Runs both once on fresh data and compares
+} Codegen_Kernel;
+
+static volatile uint64_t codegen_sink;
+static uint32_t rng_state = 2463534242u;
+
+static uint32_t codegen_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool close_enough(float a, float b) {
+    return fabsf(a - b) <= 1e-3f * (fabsf(b) > 1.0f ? fabsf(b) : 1.0f);
+}
+
+//==============================================================================
+// MEMCPY / STRLEN
+//==============================================================================
+
+static uint32_t native_copy[COPY_WORDS];
+
+static void memcpy_setup(void) {
+    uint32_t *source = (uint32_t*)guest(DATA_SOURCE);
+    for (int i = 0; i < COPY_WORDS; i++) source[i] = codegen_random() & 0x7FFFFFFF;
+    memset(guest(DATA_DEST), 0, COPY_WORDS * 4);
+}
+
+static void memcpy_transpiled(void) {
+    KERNEL_CALL(bench_memcpy, DATA_DEST, DATA_SOURCE, COPY_WORDS);
+}
+
+static void memcpy_native(void) {
+    const uint32_t *source = (const uint32_t*)guest(DATA_SOURCE);
+    for (int i = 0; i < COPY_WORDS; i++) native_copy[i] = source[i];
+    codegen_sink += native_copy[COPY_WORDS - 1];
+}
+
+static bool memcpy_verify(void) {
+    memcpy_transpiled();
+    memcpy_native();
+    return memcmp(guest(DATA_DEST), native_copy, sizeof(native_copy)) == 0;
+}
+
+static size_t native_length;
+
+static void strlen_setup(void) {
+    char *s = (char*)guest(DATA_STRING);
+    for (int i = 0; i < STRING_LENGTH; i++) s[i] = (char)('a' + codegen_random() % 26);
+    s[STRING_LENGTH] = '\0';
+}
+
+static void strlen_transpiled(void) {
+    KERNEL_CALL(bench_strlen, DATA_STRING, 0, 0);
+    codegen_sink += r3;
+}
+
+static void strlen_native(void) {
+    const char *s = (const char*)guest(DATA_STRING);
+    const char *p = s;
+    while (*p) p++;
+    native_length = (size_t)(p - s);
+    codegen_sink += native_length;
+}
+
+static bool strlen_verify(void) {
+    strlen_transpiled();
+    strlen_native();
+    return (size_t)r3 == native_length;
+}
+
+//==============================================================================
+// MATRIX MULTIPLY (FPU AND PAIRED SINGLE)
+//==============================================================================
+
+static float native_matrix[16];
+
+static void matrix_setup(void) {
+    float *a = (float*)guest(DATA_MATRIX_A), *b = (float*)guest(DATA_MATRIX_B);
+    for (int i = 0; i < 16; i++) {
+        a[i] = (float)(codegen_random() % 200) / 50.0f - 2.0f;
+        b[i] = (float)(codegen_random() % 200) / 50.0f - 2.0f;
+    }
+    memset(guest(DATA_MATRIX_C), 0, 64);
+}
+
+static void matrix_transpiled(void) {
+    KERNEL_CALL(bench_mtx44_mul, DATA_MATRIX_A, DATA_MATRIX_B, DATA_MATRIX_C);
+}
+
+static void matrix_ps_transpiled(void) {
+    KERNEL_CALL(bench_mtx44_mul_ps, DATA_MATRIX_A, DATA_MATRIX_B, DATA_MATRIX_C);
+}
+
+static void matrix_native(void) {
+    const float *a = (const float*)guest(DATA_MATRIX_A), *b = (const float*)guest(DATA_MATRIX_B);
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            float sum = a[i * 4] * b[j];
+            for (int k = 1; k < 4; k++) sum += a[i * 4 + k] * b[k * 4 + j];
+            native_matrix[i * 4 + j] = sum;
+        }
+    }
+    codegen_sink += (uint64_t)native_matrix[5];
+}
+
+static bool matrix_compare(void) {
+    const float *c = (const float*)guest(DATA_MATRIX_C);
+    for (int i = 0; i < 16; i++) {
+        if (!close_enough(c[i], native_matrix[i])) return false;
+    }
+    return true;
+}
+
+static bool matrix_verify(void) {
+    matrix_transpiled();
+    matrix_native();
+    return matrix_compare();
+}
+
+static bool matrix_ps_verify(void) {
+    matrix_ps_transpiled();
+    matrix_native();
+    return matrix_compare();
+}
+
+//==============================================================================
+// VECTOR NORMALIZE
+//==============================================================================
+
+static float vector_input[VECTOR_COUNT * 3];
+static float native_vectors[VECTOR_COUNT * 3];
+
+static void normalize_setup(void) {
+    for (int i = 0; i < VECTOR_COUNT * 3; i++) {
+        vector_input[i] = (float)(codegen_random() % 2000) / 100.0f - 10.0f;
+    }
+    vector_input[0] = 1.0f;  // No zero-length vector
+    memcpy(guest(DATA_VECTORS), vector_input, sizeof(vector_input));
+    float *constants = (float*)guest(DATA_CONSTANTS);
+    constants[0] = 0.5f;
+    constants[1] = 3.0f;
+}
+
+static void normalize_transpiled(void) {
+    KERNEL_CALL(bench_vec_normalize, DATA_VECTORS, VECTOR_COUNT, DATA_CONSTANTS);
+}
+
+static void normalize_native(void) {
+    float *v = native_vectors;
+    for (int i = 0; i < VECTOR_COUNT; i++, v += 3) {
+        float scale = 1.0f / sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        v[0] *= scale;
+        v[1] *= scale;
+        v[2] *= scale;
+    }
+    codegen_sink += (uint64_t)(native_vectors[0] * 100.0f);
+}
+
+static bool normalize_verify(void) {
+    memcpy(guest(DATA_VECTORS), vector_input, sizeof(vector_input));
+    memcpy(native_vectors, vector_input, sizeof(vector_input));
+    normalize_transpiled();
+    normalize_native();
+    const float *v = (const float*)guest(DATA_VECTORS);
+    for (int i = 0; i < VECTOR_COUNT * 3; i++) {
+        if (!close_enough(v[i], native_vectors[i])) return false;
+    }
+    return true;
+}
+
+//==============================================================================
+// TOKENIZER STATE MACHINE
+//==============================================================================
+
+static uint32_t native_tokens;
+
+static void tokens_setup(void) {
+    char *text = (char*)guest(DATA_TEXT);
+    for (int i = 0; i < TEXT_LENGTH; i++) {
+        uint32_t roll = codegen_random() % 10;
+        text[i] = roll < 3 ? ' ' : roll < 6 ? (char)('0' + codegen_random() % 10) : (char)('a' + codegen_random() % 26);
+    }
+}
+
+static void tokens_transpiled(void) {
+    KERNEL_CALL(bench_count_tokens, DATA_TEXT, TEXT_LENGTH, 0);
+    codegen_sink += r3;
+}
+
+// Same machine as bench/kernels/tokens.s: 0 = between tokens, 1 = word, 2 = number
+static void tokens_native(void) {
+    const unsigned char *text = (const unsigned char*)guest(DATA_TEXT);
+    uint32_t state = 0, count = 0;
+    for (int i = 0; i < TEXT_LENGTH; i++) {
+        uint32_t c = text[i];
+        uint32_t cls = c <= 0x20 ? 0 : c - '0' <= 9 ? 2 : 1;
+        switch (state) {
+            case 1:
+                if (cls == 0) state = 0;
+                break;
+            case 2:
+                if (cls == 0) state = 0;
+                else if (cls == 1) {
+                    count++;
+                    state = 1;
+                }
+                break;
+            default:
+                if (cls != 0) {
+                    count++;
+                    state = cls;
+                }
+                break;
+        }
+    }
+    native_tokens = count;
+    codegen_sink += count;
+}
+
+static bool tokens_verify(void) {
+    tokens_transpiled();
+    tokens_native();
+    return (uint32_t)r3 == native_tokens;
+}
+
+//==============================================================================
+// VTABLE DISPATCH
+//==============================================================================
+
+typedef struct Native_Shape Native_Shape;
+typedef struct {
+    int32_t (*area)(const Native_Shape *shape);
+} Native_Vtable;
+struct Native_Shape {
+    const Native_Vtable *vtable;
+    int32_t a, b;
+};
+
+static int32_t native_square(const Native_Shape *s) { return s->a * s->a; }
+static int32_t native_circle(const Native_Shape *s) { return s->a * s->a * 3; }
+static int32_t native_triangle(const Native_Shape *s) { return (s->b * s->a) >> 1; }
+
+static const Native_Vtable native_vtables[3] = { { native_square }, { native_circle }, { native_triangle } };
+static Native_Shape native_shapes[OBJECT_COUNT];
+static uint32_t native_area;
+
+static void vtable_setup(void) {
+    // Guest vtables: two header words, then the area method (offset 8, as the kernel loads it)
+    static const uint32_t methods[3] = { SQUARE_AREA_ADDRESS, CIRCLE_AREA_ADDRESS, TRIANGLE_AREA_ADDRESS };
+    uint32_t *vtables = (uint32_t*)guest(DATA_VTABLES);
+    for (int t = 0; t < 3; t++) {
+        vtables[t * 3] = 0;
+        vtables[t * 3 + 1] = 0;
+        vtables[t * 3 + 2] = methods[t];
+    }
+    uint32_t *list = (uint32_t*)guest(DATA_OBJECT_LIST);
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        int type = (int)(codegen_random() % 3);
+        int32_t a = (int32_t)(codegen_random() % 100), b = (int32_t)(codegen_random() % 100);
+        uint32_t object = DATA_OBJECTS + (uint32_t)i * 12;
+        uint32_t *words = (uint32_t*)guest(object);
+        words[0] = DATA_VTABLES + (uint32_t)type * 12;
+        words[1] = (uint32_t)a;
+        words[2] = (uint32_t)b;
+        list[i] = object;
+        native_shapes[i].vtable = &native_vtables[type];
+        native_shapes[i].a = a;
+        native_shapes[i].b = b;
+    }
+}
+
+static void vtable_transpiled(void) {
+    KERNEL_CALL(bench_sum_areas, DATA_OBJECT_LIST, OBJECT_COUNT, 0);
+    codegen_sink += r3;
+}
+
+static void vtable_native(void) {
+    uint32_t sum = 0;
+    for (int i = 0; i < OBJECT_COUNT; i++) sum += (uint32_t)native_shapes[i].vtable->area(&native_shapes[i]);
+    native_area = sum;
+    codegen_sink += sum;
+}
+
+static bool vtable_verify(void) {
+    vtable_transpiled();
+    vtable_native();
+    return (uint32_t)r3 == native_area;
+}
+
+//==============================================================================
+// STACK FRAMES
+//==============================================================================
+
+// bench/kernels/frames.s: saved LR, callee-saved registers, a spill across a call, nested frames
+static uint32_t native_frame_sum;
+
+static void frames_setup(void) {
+    uint32_t *values = (uint32_t*)guest(DATA_FRAME_VALUES);
+    for (int i = 0; i < FRAME_VALUE_COUNT; i++) values[i] = codegen_random() % 1000;
+    r1 = convert_gc_address(DATA_STACK_TOP);  // Frames live in emulated memory
+}
+
+static void frames_transpiled(void) {
+    KERNEL_CALL(bench_frame_sum, DATA_FRAME_VALUES, FRAME_VALUE_COUNT, 0);
+    codegen_sink += r3;
+}
+
+static void frames_native(void) {
+    const uint32_t *values = (const uint32_t*)guest(DATA_FRAME_VALUES);
+    uint32_t sum = 0;
+    for (int i = 0; i < FRAME_VALUE_COUNT; i++) sum += values[i] * values[i] + 7;
+    native_frame_sum = sum;
+    codegen_sink += sum;
+}
+
+static bool frames_verify(void) {
+    // The caller's callee-saved registers must survive the kernel's epilogue
+    uintptr_t stack = r1;
+    r28 = 0x28282828;
+    r29 = 0x29292929;
+    r31 = 0x31313131;
+    frames_transpiled();
+    bool kept = r1 == stack && r28 == 0x28282828 && r29 == 0x29292929 && r31 == 0x31313131;
+    frames_native();
+    return kept && (uint32_t)r3 == native_frame_sum;
+}
+
+//==============================================================================
+// IDENTICAL FUNCTIONS
+//==============================================================================
+
+// bench/kernels/fold.s: three byte-identical helpers, each called directly
+static uint32_t native_fold_sum;
+
+static uint32_t native_fold_mix(uint32_t x, uint32_t y) {
+    uint32_t v = ((x * 9u) ^ y) * (y + 17u);
+    v ^= v >> 7;
+    return (v & 0xFFFF) + 1;
+}
+
+static void fold_setup(void) {
+    uint32_t *values = (uint32_t*)guest(DATA_FOLD_VALUES);
+    for (int i = 0; i < FOLD_VALUE_COUNT; i++) values[i] = codegen_random() % 100000;
+    r1 = convert_gc_address(DATA_STACK_TOP);  // Frames live in emulated memory
+}
+
+static void fold_transpiled(void) {
+    KERNEL_CALL(bench_fold_sum, DATA_FOLD_VALUES, FOLD_VALUE_COUNT, 0);
+    codegen_sink += r3;
+}
+
+static void fold_native(void) {
+    const uint32_t *values = (const uint32_t*)guest(DATA_FOLD_VALUES);
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < FOLD_VALUE_COUNT; i++) {
+        sum += native_fold_mix(values[i], i) + native_fold_mix(values[i], i + 0x100) +
+               native_fold_mix(values[i], i + 0x200);
+    }
+    native_fold_sum = sum;
+    codegen_sink += sum;
+}
+
+/**
+ * @brief Call a helper the way a function pointer does: through the function address map
+ */
+static uint32_t fold_call_by_address(uint32_t address, uint32_t x, uint32_t y) {
+#ifdef PPC_REGISTER_ABI
+    r3 = x;
+    r4 = y;
+    call_function_by_address(address);
+#else
+    call_function_by_address(address, x, y, 0, 0, 0, 0, 0, 0, 0.0, 0.0);
+#endif
+    return (uint32_t)r3;
+}
+
+static bool fold_verify(void) {
+    // Every copy's address must still reach a body that computes the same thing
+    static const uint32_t helpers[3] = { FOLD_MIX_A_ADDRESS, FOLD_MIX_B_ADDRESS, FOLD_MIX_C_ADDRESS };
+    bool mapped = true;
+    for (int h = 0; h < 3; h++) {
+        mapped = mapped && fold_call_by_address(helpers[h], 12345, (uint32_t)h) == native_fold_mix(12345, (uint32_t)h);
+    }
+    fold_transpiled();
+    fold_native();
+    return mapped && (uint32_t)r3 == native_fold_sum;
+}
+
+//==============================================================================
+// SMALL LEAF CALLS
+//==============================================================================
+
+// bench/kernels/inline.s: records of { a, b, checksum } updated through small integer leaf calls
+static uint32_t native_checksums[RECORD_COUNT];
+static uint32_t native_record_sum;
+
+static void records_setup(void) {
+    uint32_t *records = (uint32_t*)guest(DATA_RECORDS);
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        records[i * 3] = codegen_random() % 100;
+        records[i * 3 + 1] = codegen_random() % 100;
+        records[i * 3 + 2] = 0;
+    }
+    r1 = convert_gc_address(DATA_STACK_TOP);  // Frames live in emulated memory
+}
+
+static void records_transpiled(void) {
+    KERNEL_CALL(bench_inline_sum, DATA_RECORDS, RECORD_COUNT, 0);
+    codegen_sink += r3;
+}
+
+static void records_native(void) {
+    const uint32_t *records = (const uint32_t*)guest(DATA_RECORDS);
+    uint32_t sum = 0;
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        uint32_t a = records[i * 3], b = records[i * 3 + 1];
+        sum += a * b + a + 5;
+        native_checksums[i] = ((sum ^ a) + 3) & 0xFF;
+    }
+    native_record_sum = sum;
+    codegen_sink += sum;
+}
+
+static bool records_verify(void) {
+    records_transpiled();
+    records_native();
+    const uint32_t *records = (const uint32_t*)guest(DATA_RECORDS);
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        if (records[i * 3 + 2] != native_checksums[i]) return false;
+    }
+    return (uint32_t)r3 == native_record_sum;
+}
+
+//==============================================================================
+// SUITE
+//==============================================================================
+
+static const Codegen_Kernel kernels[] = {
+    { "memcpy", memcpy_setup, memcpy_transpiled, memcpy_native, memcpy_verify },
+    { "strlen", strlen_setup, strlen_transpiled, strlen_native, strlen_verify },
+    { "mtx44_fpu", matrix_setup, matrix_transpiled, matrix_native, matrix_verify },
+    { "mtx44_ps", matrix_setup, matrix_ps_transpiled, matrix_native, matrix_ps_verify },
+    { "vec_normalize", normalize_setup, normalize_transpiled, normalize_native, normalize_verify },
+    { "tokenizer", tokens_setup, tokens_transpiled, tokens_native, tokens_verify },
+    { "vtable_dispatch", vtable_setup, vtable_transpiled, vtable_native, vtable_verify },
+    { "stack_frames", frames_setup, frames_transpiled, frames_native, frames_verify },
+    { "identical_fold", fold_setup, fold_transpiled, fold_native, fold_verify },
+    { "leaf_calls", records_setup, records_transpiled, records_native, records_verify },
+};
+#define KERNEL_COUNT ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+/**
+ * @brief Best-of-CODEGEN_REPEATS time per call, in ns
+ */
+static double time_calls(Codegen_Run run) {
+    uint64_t calls = 1;
+    for (;;) {
+        double start = stats_now();
+        for (uint64_t i = 0; i < calls; i++) run();
+        if (stats_now() - start >= CODEGEN_MIN_SECONDS) break;
+        calls *= 2;
+    }
+    double best = 1e30;
+    for (int repeat = 0; repeat < CODEGEN_REPEATS; repeat++) {
+        double start = stats_now();
+        for (uint64_t i = 0; i < calls; i++) run();
+        double ns = (stats_now() - start) * 1e9 / (double)calls;
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+/**
+ * @brief Child mode: set up, verify and time one kernel; one RESULT line on stdout
+ */
+static int run_kernel(const char *name) {
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        if (strcmp(kernels[k].name, name) != 0) continue;
+        if (runtime_init() != 0) return 1;
+        extern void init_function_registry(void);
+        init_function_registry();
+
+        kernels[k].setup();
+        bool ok = kernels[k].verify();
+        fflush(stdout);  // Generated code may print; keep RESULT on its own line
+        double transpiled = time_calls(kernels[k].transpiled);
+        double native = time_calls(kernels[k].native);
+        printf("\nRESULT %s %s %.3f %.3f\n", name, ok ? "ok" : "mismatch", transpiled, native);
+        runtime_cleanup();
+        return 0;
+    }
+    fprintf(stderr, "Error: Unknown kernel %s\n", name);
+    return 1;
+}
+
+typedef struct {
+    const char *name;
+    char status[32];
+    double transpiled;          // ns per call
+    double native;
+} Codegen_Result;
+
+static bool run_child(const char *program, const char *name, Codegen_Result *result) {
+    char command[1200], line[CODEGEN_LINE_SIZE];
+#ifdef _WIN32
+    snprintf(command, sizeof(command), "\"%s\" --kernel %s 2>NUL", program, name);
+#else
+    snprintf(command, sizeof(command), "'%s' --kernel %s 2>/dev/null", program, name);
+#endif
+    result->name = name;
+    snprintf(result->status, sizeof(result->status), "failed");
+    result->transpiled = result->native = 0;
+    FILE *child = popen(command, "r");
+    if (!child) return false;
+    bool found = false;
+    while (fgets(line, sizeof(line), child)) {
+        char kernel[64], status[32];
+        double transpiled, native;
+        if (sscanf(line, "RESULT %63s %31s %lf %lf", kernel, status, &transpiled, &native) == 4 &&
+            strcmp(kernel, name) == 0) {
+            snprintf(result->status, sizeof(result->status), "%s", status);
+            result->transpiled = transpiled;
+            result->native = native;
+            found = true;
+        }
+    }
+    int status = pclose(child);
+    if (!found && status != 0) snprintf(result->status, sizeof(result->status), "failed");
+    return found;
+}
+
+static bool find_baseline(const char *path, const char *label, char *line, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    char buffer[CODEGEN_LINE_SIZE], label_key[300];
+    snprintf(label_key, sizeof(label_key), "\"label\": \"%s\"", label);
+    bool found = false;
+    while (fgets(buffer, sizeof(buffer), f)) {
+        if (strstr(buffer, "\"label\": \"") && !strstr(buffer, label_key)) {
+            snprintf(line, size, "%s", buffer);
+            found = true;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+static double baseline_ns(const char *line, const char *name) {
+    char key[128];
+    snprintf(key, sizeof(key), "\"%s\": {", name);
+    const char *p = strstr(line, key);
+    if (!p) return 0;
+    p = strstr(p, "\"transpiled_ns\": ");
+    return p ? strtod(p + 17, NULL) : 0;
+}
+
+static int write_results(const char *path, const char *label, const Codegen_Result *results) {
+    char baseline[CODEGEN_LINE_SIZE];
+    bool have_baseline = find_baseline(path, label, baseline, sizeof(baseline));
+    FILE *f = fopen(path, "a");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot write %s\n", path);
+        return 1;
+    }
+    fprintf(f, "{\"label\": \"%s\", \"kernels\": {", label);
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        fprintf(f, "%s\"%s\": {\"status\": \"%s\", \"transpiled_ns\": %.3f, \"native_ns\": %.3f}", k ? ", " : "",
+                results[k].name, results[k].status, results[k].transpiled, results[k].native);
+    }
+    fprintf(f, "}}\n");
+    fclose(f);
+    printf("Results appended to %s\n", path);
+
+    if (have_baseline) {
+        const char *p = strstr(baseline, "\"label\": \"") + 10;
+        int length = (int)(strchr(p, '"') ? strchr(p, '"') - p : 0);
+        printf("Compared with %.*s (transpiled):\n", length, p);
+        for (int k = 0; k < KERNEL_COUNT; k++) {
+            double before = baseline_ns(baseline, results[k].name);
+            if (before <= 0 || results[k].transpiled <= 0) continue;
+            printf("  %-16s %12.1f -> %12.1f ns  %+6.1f%%\n", results[k].name, before, results[k].transpiled,
+                   100.0 * (results[k].transpiled - before) / before);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *label = "local";
+    const char *results_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) return run_kernel(argv[i + 1]);
+        if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) label = argv[++i];
+        else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) results_path = argv[++i];
+        else {
+            printf("Usage: %s [--label NAME] [--results FILE] | --kernel NAME\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Codegen_Result results[KERNEL_COUNT];
+    printf("  %-16s %-9s %14s %14s %9s\n", "kernel", "result", "transpiled", "hand C", "ratio");
+    int failed = 0;
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        run_child(argv[0], kernels[k].name, &results[k]);
+        const Codegen_Result *r = &results[k];
+        if (r->transpiled > 0) {
+            printf("  %-16s %-9s %11.1f ns %11.1f ns %8.2fx\n", r->name, r->status, r->transpiled, r->native,
+                   r->native > 0 ? r->transpiled / r->native : 0.0);
+        } else {
+            printf("  %-16s %-9s\n", r->name, r->status);
+        }
+        failed += strcmp(r->status, "ok") != 0;
+        fflush(stdout);
+    }
+    if (failed) printf("%d kernel(s) failed or produced wrong results; their times are not comparable\n", failed);
+    return results_path ? write_results(results_path, label, results) : 0;
+}
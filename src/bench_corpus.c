@@ -0,0 +1,461 @@
+/**
+ * @file bench_corpus.c
+ * @brief Synthetic .s corpus for benchmarking the transpiler (make bench)
+ *
+ * Writes a tree of decomp-toolkit style assembly files: `.fn` / `.endfn`
+ * functions with prologues and epilogues, integer, load/store, floating-point
+ * and paired-single instructions, compare-and-branch pairs to `.L_` labels,
+ * `bl` calls across files, small-data accesses, and data / rodata sections
+ * with function pointers and strings. Every instruction carries its real
+ * encoding, so both the text and the word decoder paths are exercised.
+ *
+ * The output depends only on the parameters and the seed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#endif
+
+#define CORPUS_BASE_ADDRESS     0x80004000
+#define CORPUS_FILE_OFFSET      0x80003000  // Address minus file offset, as in the listing column
+#define CORPUS_DATA_ADDRESS     0x80400000
+#define CORPUS_FILES_PER_DIR    50
+#define CORPUS_STAMP            "corpus.txt"
+
+typedef struct {
+    int files;
+    int functions;              // Per file
+    int instructions;           // Average body length per function
+    int label_percent;          // Body instructions that are branch targets
+    int paired_percent;         // Body instructions that are paired-single / FP
+    uint64_t seed;
+} Corpus_Options;
+
+typedef struct {
+    uint32_t address;
+    int file;
+    bool local;
+} Corpus_Function;
+
+static uint64_t rng_state;
+
+static uint32_t rng_next(void) {
+    // xorshift64*: fast, and identical on every platform
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static int rng_range(int lo, int hi) {
+    return lo + (int)(rng_next() % (uint32_t)(hi - lo + 1));
+}
+
+static bool rng_percent(int percent) {
+    return (int)(rng_next() % 100) < percent;
+}
+
+//==============================================================================
+// INSTRUCTION ENCODING
+//==============================================================================
+
+static FILE *out;
+static uint32_t pc;
+
+static void emit(uint32_t word, const char *format, ...) {
+    char text[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    fprintf(out, "/* %08X %08X  %02X %02X %02X %02X */\t%s\n", pc, pc - CORPUS_FILE_OFFSET,
+            word >> 24, (word >> 16) & 0xFF, (word >> 8) & 0xFF, word & 0xFF, text);
+    pc += 4;
+}
+
+static const char* hex_offset(int value, char *buffer, size_t size) {
+    if (value < 0) snprintf(buffer, size, "-0x%x", -value);
+    else snprintf(buffer, size, "0x%x", value);
+    return buffer;
+}
+
+static uint32_t d_form(int opcode, int rd, int ra, int imm) {
+    return ((uint32_t)opcode << 26) | ((uint32_t)rd << 21) | ((uint32_t)ra << 16) | ((uint32_t)imm & 0xFFFF);
+}
+
+static uint32_t x_form(int opcode, int rd, int ra, int rb, int xo) {
+    return ((uint32_t)opcode << 26) | ((uint32_t)rd << 21) | ((uint32_t)ra << 16) | ((uint32_t)rb << 11) |
+           ((uint32_t)xo << 1);
+}
+
+static uint32_t a_form(int opcode, int frd, int fra, int frb, int frc, int xo) {
+    return ((uint32_t)opcode << 26) | ((uint32_t)frd << 21) | ((uint32_t)fra << 16) | ((uint32_t)frb << 11) |
+           ((uint32_t)frc << 6) | ((uint32_t)xo << 1);
+}
+
+static int gpr(void) {
+    static const int pool[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 0, 29, 30, 31 };
+    return pool[rng_next() % (sizeof(pool) / sizeof(pool[0]))];
+}
+
+static int fpr(void) {
+    return rng_range(0, 13);
+}
+
+static void emit_integer(void) {
+    int rd = gpr(), ra = gpr(), rb = gpr();
+    char imm[16];
+    switch (rng_next() % 9) {
+        case 0: {
+            int v = rng_range(-0x80, 0x7F);
+            emit(d_form(14, rd, ra == 0 ? 3 : ra, v), "addi r%d, r%d, %s", rd, ra == 0 ? 3 : ra,
+                 hex_offset(v, imm, sizeof(imm)));
+            break;
+        }
+        case 1: emit(x_form(31, rd, ra, rb, 266), "add r%d, r%d, r%d", rd, ra, rb); break;
+        case 2: emit(x_form(31, rd, ra, rb, 40), "subf r%d, r%d, r%d", rd, ra, rb); break;
+        case 3: emit(x_form(31, rd, ra, rb, 235), "mullw r%d, r%d, r%d", rd, ra, rb); break;
+        case 4: emit(x_form(31, ra, rd, ra, 444), "mr r%d, r%d", rd, ra); break;  // or rD, rS, rS
+        case 5: emit(x_form(31, ra, rd, rb, 28), "and r%d, r%d, r%d", rd, ra, rb); break;
+        case 6: {
+            int sh = rng_range(0, 31), mb = rng_range(0, 15), me = rng_range(16, 31);
+            emit(((uint32_t)21 << 26) | ((uint32_t)ra << 21) | ((uint32_t)rd << 16) | ((uint32_t)sh << 11) |
+                 ((uint32_t)mb << 6) | ((uint32_t)me << 1), "rlwinm r%d, r%d, %d, %d, %d", rd, ra, sh, mb, me);
+            break;
+        }
+        case 7: {
+            int v = rng_range(0, 0xFFFF);
+            emit(d_form(24, ra, rd, v), "ori r%d, r%d, 0x%x", rd, ra, v);
+            break;
+        }
+        default: {
+            int v = rng_range(-0x100, 0xFF);
+            emit(d_form(14, rd, 0, v), "li r%d, %s", rd, hex_offset(v, imm, sizeof(imm)));
+            break;
+        }
+    }
+}
+
+static void emit_load_store(int frame_size) {
+    static const struct { int opcode; const char *name; bool fp; } forms[] = {
+        { 32, "lwz", false }, { 36, "stw", false }, { 34, "lbz", false }, { 38, "stb", false },
+        { 40, "lhz", false }, { 44, "sth", false }, { 48, "lfs", true }, { 54, "stfd", true },
+    };
+    int f = (int)(rng_next() % (sizeof(forms) / sizeof(forms[0])));
+    int rd = forms[f].fp ? fpr() : gpr();
+    char disp[16];
+    if (rng_percent(15)) {
+        // Small-data global (r13) or constant (r2)
+        int base = forms[f].fp ? 2 : 13;
+        int offset = -0x8000 + rng_range(0, 0x7FF) * 4;
+        emit(d_form(forms[f].opcode, rd, base, offset), "%s %s%d, %s(r%d)", forms[f].name, forms[f].fp ? "f" : "r",
+             rd, hex_offset(offset, disp, sizeof(disp)), base);
+    } else if (frame_size > 16 && rng_percent(50)) {
+        int offset = 8 + rng_range(0, (frame_size - 16) / 4) * 4;
+        emit(d_form(forms[f].opcode, rd, 1, offset), "%s %s%d, %s(r1)", forms[f].name, forms[f].fp ? "f" : "r",
+             rd, hex_offset(offset, disp, sizeof(disp)));
+    } else {
+        int ra = rng_range(3, 12);
+        int offset = rng_range(0, 0x40) * 4;
+        emit(d_form(forms[f].opcode, rd, ra, offset), "%s %s%d, %s(r%d)", forms[f].name, forms[f].fp ? "f" : "r",
+             rd, hex_offset(offset, disp, sizeof(disp)), ra);
+    }
+}
+
+static void emit_float(void) {
+    int d = fpr(), a = fpr(), b = fpr(), c = fpr();
+    switch (rng_next() % 10) {
+        case 0: emit(a_form(59, d, a, b, 0, 21), "fadds f%d, f%d, f%d", d, a, b); break;
+        case 1: emit(a_form(59, d, a, 0, c, 25), "fmuls f%d, f%d, f%d", d, a, c); break;
+        case 2: emit(a_form(63, d, 0, b, 0, 72), "fmr f%d, f%d", d, b); break;
+        case 3: emit(a_form(4, d, a, b, 0, 21), "ps_add f%d, f%d, f%d", d, a, b); break;
+        case 4: emit(a_form(4, d, a, b, 0, 20), "ps_sub f%d, f%d, f%d", d, a, b); break;
+        case 5: emit(a_form(4, d, a, 0, c, 25), "ps_mul f%d, f%d, f%d", d, a, c); break;
+        case 6: emit(a_form(4, d, a, b, c, 29), "ps_madd f%d, f%d, f%d, f%d", d, a, c, b); break;
+        case 7: emit(x_form(4, d, a, b, 528), "ps_merge00 f%d, f%d, f%d", d, a, b); break;
+        case 8: {
+            int ra = rng_range(3, 12), offset = rng_range(0, 0x1F) * 8, qr = rng_range(0, 7);
+            emit(((uint32_t)56 << 26) | ((uint32_t)d << 21) | ((uint32_t)ra << 16) | ((uint32_t)qr << 12) |
+                 (uint32_t)offset, "psq_l f%d, 0x%x(r%d), 0, qr%d", d, offset, ra, qr);
+            break;
+        }
+        default: {
+            int ra = rng_range(3, 12), offset = rng_range(0, 0x1F) * 8, qr = rng_range(0, 7);
+            emit(((uint32_t)60 << 26) | ((uint32_t)d << 21) | ((uint32_t)ra << 16) | ((uint32_t)qr << 12) |
+                 (uint32_t)offset, "psq_st f%d, 0x%x(r%d), 0, qr%d", d, offset, ra, qr);
+            break;
+        }
+    }
+}
+
+static void emit_compare_branch(uint32_t target) {
+    static const struct { const char *name; int bo, bi; } conditions[] = {
+        { "beq", 12, 2 }, { "bne", 4, 2 }, { "blt", 12, 0 }, { "bge", 4, 0 }, { "bgt", 12, 1 }, { "ble", 4, 1 },
+    };
+    int ra = gpr(), v = rng_range(0, 0x40);
+    emit(d_form(11, 0, ra, v), "cmpwi r%d, 0x%x", ra, v);
+    int c = (int)(rng_next() % (sizeof(conditions) / sizeof(conditions[0])));
+    uint32_t offset = target - pc;
+    emit(((uint32_t)16 << 26) | ((uint32_t)conditions[c].bo << 21) | ((uint32_t)conditions[c].bi << 16) |
+         (offset & 0xFFFC), "%s .L_%08X", conditions[c].name, target);
+}
+
+//==============================================================================
+// FILES
+//==============================================================================
+
+static char *function_name(const Corpus_Function *fn, char *buffer, size_t size) {
+    snprintf(buffer, size, "%s_%08X", fn->local ? "local" : "fn", fn->address);
+    return buffer;
+}
+
+/**
+ * @brief One function: prologue, body with labels / branches / calls, epilogue
+ */
+static void write_function(Corpus_Function *functions, int index, int first_in_file,
+                           const Corpus_Options *options) {
+    Corpus_Function *fn = &functions[index];
+    char name[64];
+    fprintf(out, ".fn %s, %s\n", function_name(fn, name, sizeof(name)), fn->local ? "local" : "global");
+
+    int body = rng_range(options->instructions / 2 + 1, options->instructions * 3 / 2 + 1);
+    bool leaf = rng_percent(30);
+    int frame_size = leaf ? 0 : 16 + rng_range(0, 6) * 8;
+    char disp[16];
+
+    // Slots: each body slot is one generated item; label slots get a .L_ line
+    bool *labeled = (bool*)calloc((size_t)body + 1, sizeof(bool));
+    uint32_t *slot_address = (uint32_t*)calloc((size_t)body + 1, sizeof(uint32_t));
+    if (!labeled || !slot_address) {
+        free(labeled);
+        free(slot_address);
+        return;
+    }
+    for (int i = 1; i < body; i++) labeled[i] = rng_percent(options->label_percent);
+
+    // Every item's size is decided up front so forward branches know their targets
+    typedef enum { ITEM_INTEGER, ITEM_MEMORY, ITEM_FLOAT, ITEM_BRANCH, ITEM_CALL } Item;
+    Item *items = (Item*)malloc(sizeof(Item) * ((size_t)body + 1));
+    if (!items) {
+        free(labeled);
+        free(slot_address);
+        return;
+    }
+    uint32_t address = fn->address + (leaf ? 0 : 12);
+    for (int i = 0; i < body; i++) {
+        slot_address[i] = address;
+        int roll = (int)(rng_next() % 100);
+        if (roll < options->paired_percent) items[i] = ITEM_FLOAT;
+        else if (roll < options->paired_percent + options->label_percent) items[i] = ITEM_BRANCH;
+        else if (!leaf && roll < options->paired_percent + options->label_percent + 8) items[i] = ITEM_CALL;
+        else if (roll < 60) items[i] = ITEM_INTEGER;
+        else items[i] = ITEM_MEMORY;
+        address += items[i] == ITEM_BRANCH ? 8 : 4;
+    }
+
+    if (!leaf) {
+        emit(d_form(37, 1, 1, -frame_size), "stwu r1, %s(r1)", hex_offset(-frame_size, disp, sizeof(disp)));
+        emit(0x7C0802A6, "mflr r0");
+        emit(d_form(36, 0, 1, frame_size + 4), "stw r0, 0x%x(r1)", frame_size + 4);
+    }
+    for (int i = 0; i < body; i++) {
+        if (labeled[i]) fprintf(out, ".L_%08X:\n", pc);
+        switch (items[i]) {
+            case ITEM_INTEGER: emit_integer(); break;
+            case ITEM_MEMORY: emit_load_store(frame_size); break;
+            case ITEM_FLOAT: emit_float(); break;
+            case ITEM_BRANCH: {
+                // Any labeled slot of this function, before or after the branch
+                int target = -1;
+                for (int tries = 0; tries < 8 && target < 0; tries++) {
+                    int t = rng_range(1, body > 1 ? body - 1 : 1);
+                    if (labeled[t]) target = t;
+                }
+                if (target >= 0) {
+                    emit_compare_branch(slot_address[target]);
+                } else {
+                    emit_integer();
+                    emit_integer();
+                }
+                break;
+            }
+            case ITEM_CALL: {
+                // An earlier global function anywhere, or an earlier local of this file
+                int callee = rng_range(0, index > 0 ? index - 1 : 0);
+                if (index == 0 || (functions[callee].local && callee < first_in_file)) {
+                    emit_integer();
+                    break;
+                }
+                char callee_name[64];
+                uint32_t offset = functions[callee].address - pc;
+                emit(((uint32_t)18 << 26) | (offset & 0x03FFFFFC) | 1, "bl %s",
+                     function_name(&functions[callee], callee_name, sizeof(callee_name)));
+                break;
+            }
+        }
+    }
+    if (!leaf) {
+        emit(d_form(32, 0, 1, frame_size + 4), "lwz r0, 0x%x(r1)", frame_size + 4);
+        emit(0x7C0803A6, "mtlr r0");
+        emit(d_form(14, 1, 1, frame_size), "addi r1, r1, 0x%x", frame_size);
+    }
+    emit(0x4E800020, "blr");
+    fprintf(out, ".endfn %s\n\n", name);
+
+    free(items);
+    free(labeled);
+    free(slot_address);
+}
+
+static bool make_directory(const char *path) {
+    struct stat st;
+    if (stat(path, &st) == 0) return true;
+    return mkdir(path, 0755) == 0;
+}
+
+/**
+ * @brief Generate the corpus under dir
+ * @return Number of lines written, or -1 on error
+ */
+static long write_corpus(const char *dir, const Corpus_Options *options) {
+    if (!make_directory(dir)) {
+        fprintf(stderr, "Error: Cannot create %s\n", dir);
+        return -1;
+    }
+    int total = options->files * options->functions;
+    Corpus_Function *functions = (Corpus_Function*)calloc((size_t)total + 1, sizeof(Corpus_Function));
+    if (!functions) return -1;
+
+    rng_state = options->seed ? options->seed : 1;
+    pc = CORPUS_BASE_ADDRESS;
+    uint32_t data_address = CORPUS_DATA_ADDRESS;
+    long lines = 0;
+
+    for (int file = 0; file < options->files; file++) {
+        char subdir[512], path[600];
+        snprintf(subdir, sizeof(subdir), "%s/mod%03d", dir, file / CORPUS_FILES_PER_DIR);
+        if (!make_directory(subdir)) {
+            fprintf(stderr, "Error: Cannot create %s\n", subdir);
+            free(functions);
+            return -1;
+        }
+        snprintf(path, sizeof(path), "%s/file%05d.s", subdir, file);
+        out = fopen(path, "w");
+        if (!out) {
+            fprintf(stderr, "Error: Cannot create %s\n", path);
+            free(functions);
+            return -1;
+        }
+
+        fprintf(out, ".include \"macros.inc\"\n");
+        fprintf(out, ".file \"file%05d.c\"\n\n", file);
+        fprintf(out, ".section .text, \"ax\"\n\n");
+        int first = file * options->functions;
+        for (int f = first; f < first + options->functions; f++) {
+            functions[f].address = pc;
+            functions[f].file = file;
+            functions[f].local = rng_percent(10);
+            write_function(functions, f, first, options);
+        }
+
+        // Function pointer table (vtable-like) and a few strings
+        fprintf(out, ".section .data, \"wa\"\n");
+        fprintf(out, ".obj lbl_%08X, global\n", data_address);
+        for (int f = first; f < first + options->functions; f++) {
+            if (!functions[f].local && rng_percent(20)) {
+                fprintf(out, "\t.4byte 0x%08X\n", functions[f].address);
+                data_address += 4;
+            }
+        }
+        fprintf(out, "\t.4byte 0x00000000\n");
+        fprintf(out, ".endobj lbl_%08X\n\n", data_address);
+        data_address += 4;
+
+        fprintf(out, ".section .rodata, \"a\"\n");
+        for (int s = 0; s < 3; s++) {
+            char text[32];
+            int length = snprintf(text, sizeof(text), "file%05d message %d", file, s);
+            fprintf(out, "\t.string \"%s\"  # .rodata:0x%x | 0x%08X | size: 0x%x\n",
+                    text, s * 32, data_address, length + 1);
+            data_address += 32;
+        }
+        fclose(out);
+
+        // Count what was written (the listing is what the transpiler reads)
+        FILE *f = fopen(path, "r");
+        if (f) {
+            int c;
+            while ((c = fgetc(f)) != EOF) lines += c == '\n';
+            fclose(f);
+        }
+    }
+    free(functions);
+    return lines;
+}
+
+static void usage(const char *program) {
+    printf("Usage: %s <output_dir> [--files N] [--functions N] [--instructions N]\n", program);
+    printf("          [--labels PERCENT] [--paired PERCENT] [--seed N]\n\n");
+    printf("  --files N          .s files (default 200, %d per subdirectory)\n", CORPUS_FILES_PER_DIR);
+    printf("  --functions N      Functions per file (default 20)\n");
+    printf("  --instructions N   Average body instructions per function (default 40)\n");
+    printf("  --labels PERCENT   Body instructions that are branch targets (default 10)\n");
+    printf("  --paired PERCENT   Floating-point / paired-single share of the body (default 10)\n");
+    printf("  --seed N           Random seed (default 1)\n");
+}
+
+int main(int argc, char *argv[]) {
+    Corpus_Options options = { 200, 20, 40, 10, 10, 1 };
+    if (argc < 2 || argv[1][0] == '-') {
+        usage(argv[0]);
+        return 1;
+    }
+    for (int i = 2; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        long value = strtol(argv[i + 1], NULL, 0);
+        if (strcmp(argv[i], "--files") == 0) options.files = (int)value;
+        else if (strcmp(argv[i], "--functions") == 0) options.functions = (int)value;
+        else if (strcmp(argv[i], "--instructions") == 0) options.instructions = (int)value;
+        else if (strcmp(argv[i], "--labels") == 0) options.label_percent = (int)value;
+        else if (strcmp(argv[i], "--paired") == 0) options.paired_percent = (int)value;
+        else if (strcmp(argv[i], "--seed") == 0) options.seed = (uint64_t)value;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (options.files < 1 || options.functions < 1 || options.instructions < 1 ||
+        options.label_percent < 0 || options.paired_percent < 0 ||
+        options.label_percent + options.paired_percent > 50) {
+        fprintf(stderr, "Error: counts must be positive and --labels + --paired at most 50\n");
+        return 1;
+    }
+
+    long lines = write_corpus(argv[1], &options);
+    if (lines < 0) return 1;
+
+    char stamp[512];
+    snprintf(stamp, sizeof(stamp), "%s/%s", argv[1], CORPUS_STAMP);
+    FILE *f = fopen(stamp, "w");
+    if (f) {
+        fprintf(f, "files %d\nfunctions %d\ninstructions %d\nlabels %d\npaired %d\nseed %llu\nlines %ld\n",
+                options.files, options.functions, options.instructions, options.label_percent,
+                options.paired_percent, (unsigned long long)options.seed, lines);
+        fclose(f);
+    }
+    printf("Corpus %s: %d files, %d functions, %ld lines\n", argv[1], options.files,
+           options.files * options.functions, lines);
+    return 0;
+}
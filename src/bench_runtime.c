@@ -0,0 +1,465 @@
+/**
+ * @file bench_runtime.c
+ * @brief Microbenchmarks of the runtime primitives generated code uses (make bench-runtime)
+ *
+ * Built against a freshly generated project (powerpc_state.h/.c and
+ * function_address_map.c as the transpiler writes them), so what is timed is
+ * what ships. Covers:
+ * - convert_gc_address() and the emitted `lwz` load + convert pattern
+ * - call_function_by_address() with 1k / 10k / 50k registered functions
+ * - gecko_read32() / gecko_write32() against a plain host load
+ * - one emitted statement sequence on the global registers and on locals
+ * - the emitted CR-update expression against branchless and plain-compare forms
+ *
+ * Every result is the best of several runs, in ns and in cycle-counter ticks
+ * per operation. Results are appended to a JSON-lines file under a label. Each
+ * one is compared with the last result recorded under another label.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "powerpc_state.h"
+#include "function_address_map.h"
+#include "gecko_memory.h"
+#include "porpoise_stats.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BENCH_TICK_SOURCE "rdtsc"
+static inline uint64_t bench_ticks(void) { return __rdtsc(); }
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TICK_SOURCE "rdtsc"
+static inline uint64_t bench_ticks(void) { return __rdtsc(); }
+#elif defined(__aarch64__)
+#define BENCH_TICK_SOURCE "cntvct_el0"
+static inline uint64_t bench_ticks(void) {
+    uint64_t value;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+}
+#else
+#define BENCH_TICK_SOURCE "none"
+static inline uint64_t bench_ticks(void) { return 0; }
+#endif
+
+#define BENCH_REPEATS           5
+#define BENCH_MIN_SECONDS       0.05        // Calibrated run length
+#define BENCH_TABLE_SIZE        4096        // Precomputed inputs, indexed i & (size - 1)
+#define BENCH_MAX_RESULTS       32
+#define BENCH_FUNCTION_BASE     0x80004000
+#define BENCH_LINE_SIZE         4096
+
+// Must match the value function_address_map.c was compiled with (the Makefile passes it to both)
+#ifndef MAX_FUNCTION_MAP_ENTRIES
+#define MAX_FUNCTION_MAP_ENTRIES 10000
+#endif
+
+typedef uint64_t (*Bench_Kernel)(uint64_t iterations);
+
+typedef struct {
+    const char *name;
+    double ns;                  // Per operation
+    double ticks;
+    uint64_t iterations;
+} Bench_Result;
+
+static Bench_Result results[BENCH_MAX_RESULTS];
+static int result_count = 0;
+static volatile uint64_t bench_sink;
+
+static uint32_t rng_state = 12345;
+
+static uint32_t bench_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/**
+ * @brief Time kernel: grow the iteration count to BENCH_MIN_SECONDS, keep the best of BENCH_REPEATS
+ */
+static void bench_run(const char *name, Bench_Kernel kernel) {
+    uint64_t iterations = 1024;
+    for (;;) {
+        double start = stats_now();
+        bench_sink += kernel(iterations);
+        if (stats_now() - start >= BENCH_MIN_SECONDS || iterations >= ((uint64_t)1 << 40)) break;
+        iterations *= 2;
+    }
+
+    Bench_Result *r = &results[result_count++];
+    r->name = name;
+    r->iterations = iterations;
+    r->ns = 1e30;
+    for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+        uint64_t t0 = bench_ticks();
+        double start = stats_now();
+        bench_sink += kernel(iterations);
+        double seconds = stats_now() - start;
+        uint64_t t1 = bench_ticks();
+        double ns = seconds * 1e9 / (double)iterations;
+        if (ns < r->ns) {
+            r->ns = ns;
+            r->ticks = (double)(t1 - t0) / (double)iterations;
+        }
+    }
+    printf("  %-34s %10.2f ns %10.1f ticks\n", name, r->ns, r->ticks);
+    fflush(stdout);
+}
+
+//==============================================================================
+// ADDRESS CONVERSION AND EMITTED LOADS
+//==============================================================================
+
+static uint32_t guest_addresses[BENCH_TABLE_SIZE];
+static uint32_t ram_offsets[BENCH_TABLE_SIZE];
+
+static uint64_t kernel_convert_gc_address(uint64_t iterations) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += convert_gc_address(guest_addresses[i & (BENCH_TABLE_SIZE - 1)]);
+    }
+    return sum;
+}
+
+// lwz as emitted: host load, then convert in case the word is a guest pointer
+static uint64_t kernel_emitted_lwz(uint64_t iterations) {
+    uintptr_t base = convert_gc_address(0x80000000);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        uintptr_t value = *(uint32_t*)(base + ram_offsets[i & (BENCH_TABLE_SIZE - 1)]);
+        value = convert_gc_address((uint32_t)value);
+        sum += value;
+    }
+    return sum;
+}
+
+static uint64_t kernel_host_load32(uint64_t iterations) {
+    uintptr_t base = convert_gc_address(0x80000000);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += *(uint32_t*)(base + ram_offsets[i & (BENCH_TABLE_SIZE - 1)]);
+    }
+    return sum;
+}
+
+//==============================================================================
+// GECKO MEMORY
+//==============================================================================
+
+static Gecko_Memory *gecko;
+
+static uint64_t kernel_gecko_read32(uint64_t iterations) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += gecko_read32(gecko, 0x80000000 + ram_offsets[i & (BENCH_TABLE_SIZE - 1)]);
+    }
+    return sum;
+}
+
+static uint64_t kernel_gecko_write32(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+        gecko_write32(gecko, 0x80000000 + ram_offsets[i & (BENCH_TABLE_SIZE - 1)], (uint32_t)i);
+    }
+    return iterations;
+}
+
+//==============================================================================
+// INDIRECT CALLS
+//==============================================================================
+
+static volatile uint64_t call_counter;
+static uint32_t call_targets[BENCH_TABLE_SIZE];
+
+#ifdef PPC_REGISTER_ABI
+static void bench_target(void) {
+    call_counter++;
+}
+#else
+static void bench_target(uintptr_t a, uintptr_t b, uintptr_t c, uintptr_t d, uintptr_t e, uintptr_t f,
+                         uintptr_t g, uintptr_t h, double x, double y) {
+    (void)a; (void)b; (void)c; (void)d; (void)e; (void)f; (void)g; (void)h; (void)x; (void)y;
+    call_counter++;
+}
+#endif
+
+static uint64_t kernel_call_function_by_address(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+#ifdef PPC_REGISTER_ABI
+        call_function_by_address(call_targets[i & (BENCH_TABLE_SIZE - 1)]);
+#else
+        call_function_by_address(call_targets[i & (BENCH_TABLE_SIZE - 1)], 0, 0, 0, 0, 0, 0, 0, 0, 0.0, 0.0);
+#endif
+    }
+    return call_counter;
+}
+
+/**
+ * @brief Grow the map to count entries, then time calls to random registered addresses
+ */
+static void bench_call_sizes(void) {
+    static const struct { int count; const char *register_name; const char *call_name; } sizes[] = {
+        { 1000, "function_map_register (to 1k)", "call_function_by_address 1k" },
+        { 10000, "function_map_register (to 10k)", "call_function_by_address 10k" },
+        { 50000, "function_map_register (to 50k)", "call_function_by_address 50k" },
+    };
+    function_address_map_init();
+    int registered = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (sizes[s].count > MAX_FUNCTION_MAP_ENTRIES) {
+            printf("  %-34s skipped (MAX_FUNCTION_MAP_ENTRIES is %d)\n", sizes[s].call_name,
+                   MAX_FUNCTION_MAP_ENTRIES);
+            continue;
+        }
+        // Registration is timed once: it is cumulative and cannot be repeated
+        int added = sizes[s].count - registered;
+        uint64_t t0 = bench_ticks();
+        double start = stats_now();
+        for (; registered < sizes[s].count; registered++) {
+            function_address_map_register(BENCH_FUNCTION_BASE + (uint32_t)registered * 0x40,
+                                          (TranspiledFunctionPtr)bench_target, "bench_target");
+        }
+        double seconds = stats_now() - start;
+        Bench_Result *r = &results[result_count++];
+        r->name = sizes[s].register_name;
+        r->iterations = (uint64_t)added;
+        r->ns = seconds * 1e9 / added;
+        r->ticks = (double)(bench_ticks() - t0) / added;
+        printf("  %-34s %10.2f ns %10.1f ticks\n", r->name, r->ns, r->ticks);
+
+        for (int i = 0; i < BENCH_TABLE_SIZE; i++) {
+            call_targets[i] = BENCH_FUNCTION_BASE + (bench_random() % (uint32_t)registered) * 0x40;
+        }
+        bench_run(sizes[s].call_name, kernel_call_function_by_address);
+    }
+}
+
+//==============================================================================
+// GLOBAL VERSUS LOCAL REGISTERS
+//==============================================================================
+
+// Statements exactly as the transpiler emits them (add, mullw, rlwinm, xor, addi, cmpwi + beq)
+#define BENCH_REGISTER_KERNEL \
+    r5 = r3 + r4; \
+    r6 = r5 * r4; \
+    r7 = ((r6 << 5) | (r6 >> 27)) & 0x0000FFE0; \
+    r8 = r7 ^ r3; \
+    r3 = r8 + 1; \
+    cr0 = ((int32_t)r3 < 1000 ? 0x8 : (int32_t)r3 > 1000 ? 0x4 : 0x2) | (xer >> 28 & 0x1); \
+    if (cr0 & 0x2) r4 = r4 + 3;
+
+// A bl to another transpiled function: opaque to the optimizer, so globals are spilled around it
+static void bench_callee(void) {
+}
+static void (*volatile bench_call)(void) = bench_callee;
+
+static uint64_t kernel_registers_global(uint64_t iterations) {
+    r3 = 1;
+    r4 = 7;
+    for (uint64_t i = 0; i < iterations; i++) {
+        BENCH_REGISTER_KERNEL
+    }
+    return r3 + r4 + r8;
+}
+
+static uint64_t kernel_registers_local(uint64_t iterations) {
+    uintptr_t r3 = 1, r4 = 7, r5, r6, r7, r8 = 0;
+    uint32_t cr0, xer = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        BENCH_REGISTER_KERNEL
+    }
+    (void)cr0;
+    return r3 + r4 + r8;
+}
+
+static uint64_t kernel_registers_global_calls(uint64_t iterations) {
+    r3 = 1;
+    r4 = 7;
+    for (uint64_t i = 0; i < iterations; i++) {
+        BENCH_REGISTER_KERNEL
+        bench_call();
+    }
+    return r3 + r4 + r8;
+}
+
+static uint64_t kernel_registers_local_calls(uint64_t iterations) {
+    uintptr_t r3 = 1, r4 = 7, r5, r6, r7, r8 = 0;
+    uint32_t cr0, xer = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        BENCH_REGISTER_KERNEL
+        bench_call();
+    }
+    (void)cr0;
+    return r3 + r4 + r8;
+}
+
+//==============================================================================
+// CONDITION REGISTER UPDATES
+//==============================================================================
+
+static int32_t compare_a[BENCH_TABLE_SIZE];
+static int32_t compare_b[BENCH_TABLE_SIZE];
+
+// cmpw as emitted, followed by blt
+static uint64_t kernel_cr_emitted(uint64_t iterations) {
+    uint64_t taken = 0;
+    uint32_t xer_local = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        int32_t a = compare_a[i & (BENCH_TABLE_SIZE - 1)], b = compare_b[i & (BENCH_TABLE_SIZE - 1)];
+        uint32_t cr = (a < b ? 0x8 : a > b ? 0x4 : 0x2) | (xer_local >> 28 & 0x1);
+        if (cr & 0x8) taken++;
+    }
+    return taken;
+}
+
+static uint64_t kernel_cr_branchless(uint64_t iterations) {
+    uint64_t taken = 0;
+    uint32_t xer_local = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        int32_t a = compare_a[i & (BENCH_TABLE_SIZE - 1)], b = compare_b[i & (BENCH_TABLE_SIZE - 1)];
+        uint32_t cr = ((uint32_t)(a < b) << 3) | ((uint32_t)(a > b) << 2) | ((uint32_t)(a == b) << 1) |
+                      (xer_local >> 28 & 0x1);
+        if (cr & 0x8) taken++;
+    }
+    return taken;
+}
+
+// Lower bound: the compare feeding the branch directly, no CR field
+static uint64_t kernel_cr_direct(uint64_t iterations) {
+    uint64_t taken = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (compare_a[i & (BENCH_TABLE_SIZE - 1)] < compare_b[i & (BENCH_TABLE_SIZE - 1)]) taken++;
+    }
+    return taken;
+}
+
+//==============================================================================
+// RESULTS
+//==============================================================================
+
+/**
+ * @brief Last results line recorded under a different label, if any
+ */
+static bool find_baseline(const char *path, const char *label, char *line, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    char buffer[BENCH_LINE_SIZE], label_key[300];
+    snprintf(label_key, sizeof(label_key), "\"label\": \"%s\"", label);
+    bool found = false;
+    while (fgets(buffer, sizeof(buffer), f)) {
+        if (strstr(buffer, "\"label\": \"") && !strstr(buffer, label_key)) {
+            snprintf(line, size, "%s", buffer);
+            found = true;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+static double baseline_ns(const char *line, const char *name) {
+    char key[128];
+    snprintf(key, sizeof(key), "\"%s\": {\"ns\": ", name);
+    const char *p = strstr(line, key);
+    return p ? strtod(p + strlen(key), NULL) : 0;
+}
+
+static int write_results(const char *path, const char *label) {
+    char baseline[BENCH_LINE_SIZE];
+    bool have_baseline = find_baseline(path, label, baseline, sizeof(baseline));
+
+    FILE *f = fopen(path, "a");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot write %s\n", path);
+        return 1;
+    }
+    fprintf(f, "{\"label\": \"%s\", \"ticks\": \"%s\", \"abi\": \"%s\", \"benchmarks\": {", label, BENCH_TICK_SOURCE,
+#ifdef PPC_REGISTER_ABI
+            "register"
+#else
+            "parameter"
+#endif
+            );
+    for (int i = 0; i < result_count; i++) {
+        fprintf(f, "%s\"%s\": {\"ns\": %.3f, \"ticks\": %.1f, \"iterations\": %llu}", i ? ", " : "",
+                results[i].name, results[i].ns, results[i].ticks, (unsigned long long)results[i].iterations);
+    }
+    fprintf(f, "}}\n");
+    fclose(f);
+    printf("Results appended to %s\n", path);
+
+    if (have_baseline) {
+        const char *p = strstr(baseline, "\"label\": \"") + 10;
+        int length = (int)(strchr(p, '"') ? strchr(p, '"') - p : 0);
+        printf("Compared with %.*s:\n", length, p);
+        for (int i = 0; i < result_count; i++) {
+            double before = baseline_ns(baseline, results[i].name);
+            if (before <= 0) continue;
+            printf("  %-34s %10.2f -> %10.2f ns  %+6.1f%%\n", results[i].name, before, results[i].ns,
+                   100.0 * (results[i].ns - before) / before);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *label = "local";
+    const char *results_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) label = argv[++i];
+        else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) results_path = argv[++i];
+        else {
+            printf("Usage: %s [--label NAME] [--results FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (runtime_init() != 0) {
+        fprintf(stderr, "Error: runtime_init failed\n");
+        return 1;
+    }
+    gecko = (Gecko_Memory*)calloc(1, sizeof(Gecko_Memory));
+    if (!gecko || gecko_memory_init(gecko, false) != 0) {
+        fprintf(stderr, "Error: Cannot initialize Gecko memory\n");
+        return 1;
+    }
+
+    // Inputs: RAM pointers with a quarter pass-through values; offsets across 16 MB of MEM1
+    for (int i = 0; i < BENCH_TABLE_SIZE; i++) {
+        uint32_t offset = (bench_random() % (16u * 1024 * 1024)) & ~3u;
+        ram_offsets[i] = offset;
+        guest_addresses[i] = (i & 3) == 3 ? bench_random() % 0x10000 : 0x80000000 + offset;
+        compare_a[i] = (int32_t)(bench_random() % 2001) - 1000;
+        compare_b[i] = (int32_t)(bench_random() % 2001) - 1000;
+    }
+
+    printf("Runtime microbenchmarks (%s ticks, %s calling convention):\n", BENCH_TICK_SOURCE,
+#ifdef PPC_REGISTER_ABI
+           "register"
+#else
+           "parameter"
+#endif
+           );
+    bench_run("convert_gc_address", kernel_convert_gc_address);
+    bench_run("emitted lwz + convert_gc_address", kernel_emitted_lwz);
+    bench_run("host load32", kernel_host_load32);
+    bench_run("gecko_read32", kernel_gecko_read32);
+    bench_run("gecko_write32", kernel_gecko_write32);
+    bench_call_sizes();
+    bench_run("registers global", kernel_registers_global);
+    bench_run("registers local", kernel_registers_local);
+    bench_run("registers global + call", kernel_registers_global_calls);
+    bench_run("registers local + call", kernel_registers_local_calls);
+    bench_run("cr update emitted", kernel_cr_emitted);
+    bench_run("cr update branchless", kernel_cr_branchless);
+    bench_run("cr compare direct", kernel_cr_direct);
+
+    int status = results_path ? write_results(results_path, label) : 0;
+    gecko_memory_free(gecko);
+    free(gecko);
+    runtime_cleanup();
+    return status;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file bench_transpile.c
+ * @brief Transpiler benchmark harness (make bench)
+ *
+ * Runs porpoise_tool over a corpus N times with --stats=json, and reports the
+ * median and best wall time, the median time of every phase and input lines
+ * per second. Each result is appended as one JSON line to a results file,
+ * tagged with a label (the Makefile passes the git revision). The harness
+ * compares each result with the last one for the same corpus under another label.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "porpoise_stats.h"
+
+#define BENCH_MAX_RUNS      100
+#define BENCH_LINE_SIZE     2048
+
+typedef struct {
+    double wall;                                // Seconds, measured around the process
+    double total;                               // total_seconds reported by the tool
+    double phases[STATS_PHASE_COUNT];
+    double instructions;
+} Bench_Run;
+
+static char *read_text(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *text = (char*)malloc((size_t)size + 1);
+    if (!text) {
+        fclose(f);
+        return NULL;
+    }
+    size_t n = fread(text, 1, (size_t)size, f);
+    text[n] = '\0';
+    fclose(f);
+    return text;
+}
+
+/**
+ * @brief Number after "key": in text (0 if missing)
+ */
+static double json_number(const char *text, const char *key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(text, pattern);
+    return p ? strtod(p + strlen(pattern), NULL) : 0;
+}
+
+static long corpus_lines(const char *corpus) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/corpus.txt", corpus);
+    char *text = read_text(path);
+    if (!text) return 0;
+    const char *p = strstr(text, "\nlines ");
+    long lines = p ? strtol(p + 7, NULL, 10) : 0;
+    free(text);
+    return lines;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *values, int count) {
+    qsort(values, count, sizeof(double), compare_double);
+    return count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+static void remove_tree(const char *path) {
+    char command[1200];
+#ifdef _WIN32
+    snprintf(command, sizeof(command), "if exist \"%s\" rmdir /s /q \"%s\"", path, path);
+#else
+    snprintf(command, sizeof(command), "rm -rf '%s'", path);
+#endif
+    if (system(command) != 0) fprintf(stderr, "Warning: could not remove %s\n", path);
+}
+
+static bool run_once(const char *tool, const char *corpus, const char *project, Bench_Run *run) {
+    remove_tree(project);  // Every run starts without a program database
+    char command[3200];
+#ifdef _WIN32
+    snprintf(command, sizeof(command), "\"%s\" \"%s\" \"%s\" --stats=json --quiet > NUL", tool, corpus, project);
+#else
+    snprintf(command, sizeof(command), "'%s' '%s' '%s' --stats=json --quiet > /dev/null", tool, corpus, project);
+#endif
+    double start = stats_now();
+    int status = system(command);
+    run->wall = stats_now() - start;
+    if (status != 0) {
+        fprintf(stderr, "Error: %s failed (status %d)\n", tool, status);
+        return false;
+    }
+
+    char path[1200];
+    snprintf(path, sizeof(path), "%s/%s", project, STATS_JSON_NAME);
+    char *json = read_text(path);
+    if (!json) {
+        fprintf(stderr, "Error: %s was not written\n", path);
+        return false;
+    }
+    run->total = json_number(json, "total_seconds");
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) run->phases[p] = json_number(json, stats_phase_names[p]);
+    run->instructions = json_number(json, "instructions_emitted");
+    free(json);
+    return true;
+}
+
+/**
+ * @brief Last result for corpus recorded under a different label, if any
+ */
+static bool find_baseline(const char *results, const char *corpus, const char *label, char *line, size_t size) {
+    FILE *f = fopen(results, "r");
+    if (!f) return false;
+    char buffer[BENCH_LINE_SIZE];
+    char corpus_key[1100], label_key[300];
+    snprintf(corpus_key, sizeof(corpus_key), "\"corpus\": \"%s\"", corpus);
+    snprintf(label_key, sizeof(label_key), "\"label\": \"%s\"", label);
+    bool found = false;
+    while (fgets(buffer, sizeof(buffer), f)) {
+        if (strstr(buffer, corpus_key) && !strstr(buffer, label_key)) {
+            snprintf(line, size, "%s", buffer);
+            found = true;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+static const char *json_label(const char *line, char *buffer, size_t size) {
+    const char *p = strstr(line, "\"label\": \"");
+    buffer[0] = '\0';
+    if (!p) return buffer;
+    p += 10;
+    size_t n = 0;
+    while (p[n] && p[n] != '"' && n + 1 < size) n++;
+    memcpy(buffer, p, n);
+    buffer[n] = '\0';
+    return buffer;
+}
+
+static void usage(const char *program) {
+    printf("Usage: %s <porpoise_tool> <corpus_dir> [--runs N] [--project DIR] [--label NAME] [--results FILE]\n\n",
+           program);
+    printf("  --runs N        Transpiler runs (default 5)\n");
+    printf("  --project DIR   Output project, recreated every run (default <corpus_dir>_project)\n");
+    printf("  --label NAME    Tag for this result, e.g. a commit hash (default \"local\")\n");
+    printf("  --results FILE  Append the result as a JSON line and compare with the previous label\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *tool = argv[1];
+    const char *corpus = argv[2];
+    const char *label = "local";
+    const char *results = NULL;
+    char project[1024];
+    snprintf(project, sizeof(project), "%s_project", corpus);
+    int runs = 5;
+
+    for (int i = 3; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--runs") == 0) runs = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--project") == 0) snprintf(project, sizeof(project), "%s", argv[i + 1]);
+        else if (strcmp(argv[i], "--label") == 0) label = argv[i + 1];
+        else if (strcmp(argv[i], "--results") == 0) results = argv[i + 1];
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (runs < 1 || runs > BENCH_MAX_RUNS) {
+        fprintf(stderr, "Error: --runs must be between 1 and %d\n", BENCH_MAX_RUNS);
+        return 1;
+    }
+
+    long lines = corpus_lines(corpus);
+    if (lines == 0) fprintf(stderr, "Warning: %s/corpus.txt has no line count; lines/sec will be 0\n", corpus);
+
+    static Bench_Run samples[BENCH_MAX_RUNS];
+    for (int r = 0; r < runs; r++) {
+        if (!run_once(tool, corpus, project, &samples[r])) return 1;
+        printf("  run %d/%d: %.1f ms\n", r + 1, runs, samples[r].wall * 1000.0);
+    }
+
+    // Medians of every series; the best wall time shows the noise floor
+    double values[BENCH_MAX_RUNS];
+    double phases[STATS_PHASE_COUNT];
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        for (int r = 0; r < runs; r++) values[r] = samples[r].phases[p];
+        phases[p] = median(values, runs);
+    }
+    for (int r = 0; r < runs; r++) values[r] = samples[r].total;
+    double total = median(values, runs);
+    for (int r = 0; r < runs; r++) values[r] = samples[r].wall;
+    double wall = median(values, runs);
+    double best = values[0];
+    double lines_per_second = stats_rate((uint64_t)lines, wall);
+
+    printf("===========================================\n");
+    printf("   Benchmark: %s (%s, %d runs)\n", corpus, label, runs);
+    printf("===========================================\n");
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        printf("  %-14s %9.1f ms\n", stats_phase_names[p], phases[p] * 1000.0);
+    }
+    printf("  %-14s %9.1f ms\n", "total", total * 1000.0);
+    printf("  %-14s %9.1f ms (best %.1f ms)\n", "wall", wall * 1000.0, best * 1000.0);
+    printf("Input: %ld lines, %.0f lines/sec; %.0f instructions emitted\n", lines, lines_per_second,
+           samples[0].instructions);
+
+    if (!results) return 0;
+
+    char baseline[BENCH_LINE_SIZE];
+    bool have_baseline = find_baseline(results, corpus, label, baseline, sizeof(baseline));
+
+    FILE *f = fopen(results, "a");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot write %s\n", results);
+        return 1;
+    }
+    fprintf(f, "{\"label\": \"%s\", \"corpus\": \"%s\", \"runs\": %d, \"lines\": %ld, \"lines_per_second\": %.0f, "
+            "\"wall_ms\": %.3f, \"best_ms\": %.3f, \"total_ms\": %.3f, \"phases_ms\": {",
+            label, corpus, runs, lines, lines_per_second, wall * 1000.0, best * 1000.0, total * 1000.0);
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        fprintf(f, "%s\"%s\": %.3f", p ? ", " : "", stats_phase_names[p], phases[p] * 1000.0);
+    }
+    fprintf(f, "}}\n");
+    fclose(f);
+    printf("Result appended to %s\n", results);
+
+    if (have_baseline) {
+        char previous[256];
+        json_label(baseline, previous, sizeof(previous));
+        printf("Compared with %s:\n", previous);
+        double before = json_number(baseline, "wall_ms");
+        const char *old_phases = strstr(baseline, "\"phases_ms\"");
+        printf("  %-14s %9.1f -> %9.1f ms  %+6.1f%%\n", "wall", before, wall * 1000.0,
+               before > 0 ? 100.0 * (wall * 1000.0 - before) / before : 0.0);
+        for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+            double old_ms = old_phases ? json_number(old_phases, stats_phase_names[p]) : 0;
+            double new_ms = phases[p] * 1000.0;
+            printf("  %-14s %9.1f -> %9.1f ms  %+6.1f%%\n", stats_phase_names[p], old_ms, new_ms,
+                   old_ms > 0 ? 100.0 * (new_ms - old_ms) / old_ms : 0.0);
+        }
+    }
+    return 0;
+}
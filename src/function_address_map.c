@@ -11,7 +11,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef PORPOISE_HOT_RELOAD
+#include "module_reload.h"
+#endif
+
+// Override with -DMAX_FUNCTION_MAP_ENTRIES=N for larger programs
+#ifndef MAX_FUNCTION_MAP_ENTRIES
 #define MAX_FUNCTION_MAP_ENTRIES 10000
+#endif
 
 static FunctionAddressEntry function_map[MAX_FUNCTION_MAP_ENTRIES];
 static int function_map_count = 0;
@@ -56,20 +63,35 @@ void function_address_map_register(uint32_t gc_address, TranspiledFunctionPtr fu
     function_map_count++;
 }
 
+#ifdef PPC_REGISTER_ABI
+void call_function_by_address(uint32_t gc_address) {
+#else
 void call_function_by_address(uint32_t gc_address, uintptr_t r3, uintptr_t r4, uintptr_t r5, uintptr_t r6,
                               uintptr_t r7, uintptr_t r8, uintptr_t r9, uintptr_t r10,
                               double f1, double f2) {
+#endif
     if (!initialized) {
         fprintf(stderr, "FATAL ERROR: Indirect call to 0x%08X before function address map initialized!\n", gc_address);
         exit(1);
     }
     
+#ifdef PORPOISE_HOT_RELOAD
+    // SIGUSR1 asked for rebuilt modules to be loaded
+    if (porpoise_reload_requested) {
+        porpoise_modules_poll();
+    }
+#endif
+    
     // Linear search for the address (could be optimized with hash map)
     for (int i = 0; i < function_map_count; i++) {
         if (function_map[i].gc_address == gc_address) {
             // Call the transpiled C function directly
             if (function_map[i].func_ptr) {
+#ifdef PPC_REGISTER_ABI
+                function_map[i].func_ptr();
+#else
                 function_map[i].func_ptr(r3, r4, r5, r6, r7, r8, r9, r10, f1, f2);
+#endif
                 return;
             }
         }
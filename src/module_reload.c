@@ -0,0 +1,171 @@
+/**
+ * @file module_reload.c
+ * @brief Hot reload of transpiled modules (see module_reload.h)
+ *
+ * The linked copy of a module is never unloaded: its code may still be on the
+ * stack. A reload copies the rebuilt library to a new file name (dlopen of the
+ * same path would return the already-loaded copy), opens it privately and calls
+ * its porpoise_register_<name>(), which points the address map at the new code.
+ */
+
+#if defined(PORPOISE_HOT_RELOAD) && !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // dladdr
+#endif
+
+#include "module_reload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+volatile sig_atomic_t porpoise_reload_requested = 0;
+
+#if defined(PORPOISE_HOT_RELOAD) && !defined(_WIN32)
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+
+#define MODULE_PATH_SIZE 1024
+
+typedef struct {
+    char path[MODULE_PATH_SIZE];    // Library the module was linked from
+    struct timespec mtime;          // Its modification time at the last (re)load
+    int generation;                 // Number of reloads
+} Module_State;
+
+static Module_State *module_states = NULL;
+
+static void reload_signal_handler(int signal_number) {
+    (void)signal_number;
+    porpoise_reload_requested = 1;
+}
+
+static bool module_mtime(const char *path, struct timespec *mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+#ifdef __APPLE__
+    *mtime = st.st_mtimespec;
+#else
+    *mtime = st.st_mtim;
+#endif
+    return true;
+}
+
+static bool copy_file(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb");
+    if (!in) return false;
+    FILE *out = fopen(to, "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+    char buffer[65536];
+    size_t n;
+    bool ok = true;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        if (fwrite(buffer, 1, n, out) != n) {
+            ok = false;
+            break;
+        }
+    }
+    fclose(in);
+    if (fclose(out) != 0) ok = false;
+    return ok;
+}
+
+void porpoise_modules_init(void) {
+    free(module_states);
+    module_states = (Module_State*)calloc(porpoise_module_count + 1, sizeof(Module_State));
+    if (!module_states) return;
+
+    for (int i = 0; i < porpoise_module_count; i++) {
+        Dl_info info;
+        void *address;
+        memcpy(&address, &porpoise_modules[i].register_functions, sizeof(address));  // ISO C: no function-to-object cast
+        if (dladdr(address, &info) && info.dli_fname) {
+            snprintf(module_states[i].path, MODULE_PATH_SIZE, "%s", info.dli_fname);
+            module_mtime(module_states[i].path, &module_states[i].mtime);
+        }
+    }
+    signal(SIGUSR1, reload_signal_handler);
+    printf("  - Hot reload: %d modules (send SIGUSR1 after rebuilding one)\n", porpoise_module_count);
+}
+
+static bool reload_module(int index) {
+    Module_State *state = &module_states[index];
+    const Porpoise_Module *module = &porpoise_modules[index];
+
+    char copy[MODULE_PATH_SIZE + 32];
+    snprintf(copy, sizeof(copy), "%s.reload%d", state->path, state->generation + 1);
+    if (!copy_file(state->path, copy)) {
+        fprintf(stderr, "Hot reload: cannot copy %s\n", state->path);
+        return false;
+    }
+
+    void *handle = dlopen(copy, RTLD_NOW | RTLD_LOCAL);
+    remove(copy);  // The mapping stays valid
+    if (!handle) {
+        fprintf(stderr, "Hot reload: %s\n", dlerror());
+        return false;
+    }
+
+    char symbol[256];
+    snprintf(symbol, sizeof(symbol), "porpoise_register_%s", module->name);
+    void (*register_functions)(void);
+    *(void**)&register_functions = dlsym(handle, symbol);
+    if (!register_functions) {
+        fprintf(stderr, "Hot reload: %s has no %s\n", state->path, symbol);
+        dlclose(handle);
+        return false;
+    }
+
+    register_functions();
+    state->generation++;
+    printf("Hot reload: module %s reloaded (generation %d)\n", module->name, state->generation);
+    return true;
+}
+
+int porpoise_modules_poll(void) {
+    porpoise_reload_requested = 0;
+    if (!module_states) return 0;
+
+    int reloaded = 0;
+    for (int i = 0; i < porpoise_module_count; i++) {
+        struct timespec mtime;
+        if (!module_states[i].path[0] || !module_mtime(module_states[i].path, &mtime)) continue;
+        if (mtime.tv_sec == module_states[i].mtime.tv_sec && mtime.tv_nsec == module_states[i].mtime.tv_nsec) {
+            continue;
+        }
+        module_states[i].mtime = mtime;
+        if (reload_module(i)) reloaded++;
+    }
+    return reloaded;
+}
+
+bool porpoise_module_reload(const char *name) {
+    if (!module_states) return false;
+    for (int i = 0; i < porpoise_module_count; i++) {
+        if (strcmp(porpoise_modules[i].name, name) == 0 && module_states[i].path[0]) {
+            module_mtime(module_states[i].path, &module_states[i].mtime);
+            return reload_module(i);
+        }
+    }
+    return false;
+}
+
+#else
+
+// Modules are linked statically (Windows, or PORPOISE_HOT_RELOAD off): nothing to reload
+void porpoise_modules_init(void) {
+}
+
+int porpoise_modules_poll(void) {
+    porpoise_reload_requested = 0;
+    return 0;
+}
+
+bool porpoise_module_reload(const char *name) {
+    (void)name;
+    return false;
+}
+
+#endif
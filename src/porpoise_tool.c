@@ -5,6 +5,8 @@
  * PowerPC to C Transpiler for GameCube/Wii Assembly
  */
 
+#define _DEFAULT_SOURCE  // strdup, readlink and mmap under -std=c99
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,8 +19,23 @@
 #include <unistd.h>
 #endif
 #include "porpoise_tool.h"
+#include "address_map.h"
+#include "binary_loader.h"
+#include "function_discovery.h"
+#include "symbol_map.h"
+#include "program_db.h"
+#include "program_ir.h"
+#include "ir_reachability.h"
+#include "ir_fold.h"
+#include "ir_inline.h"
+#include "ir_frame.h"
+#include "small_data.h"
+#include "unity_build.h"
 #include "opcode.h"
 #include "project_generator.h"
+#include "build_driver.h"
+#include "porpoise_stats.h"
+#include "decoder_sweep.h"
 
 // SDK function configuration
 typedef enum {
@@ -42,29 +59,70 @@ typedef struct {
     bool transpile_sdk_functions;      // Transpile SDK functions (true) or ignore them (false)
     bool skip_stdlib_stubs;             // Skip stdlib_stubs.h inclusion (for MSL_C compatibility)
     bool ignore_cstd_calls;             // Ignore C++ standard library calls (std:: namespace)
+    bool register_calling_convention;   // Functions take no C parameters; r3-r10/f1-f2 stay in the globals
     char sdk_functions_file[256];      // Path to SDK functions file
     char skip_list_file[256];          // Path to skip list file
+    char symbol_map_file[256];         // CodeWarrior .map or dtk symbols.txt
+    char splits_file[256];             // dtk splits.txt (translation unit ranges)
+    char dead_functions[16];           // Unreachable functions: "keep", "stub" or "omit"
+    bool fold_identical_functions;     // Emit identical function bodies once
+    int inline_max_instructions;       // Leaf functions up to this size are inlined at call sites (0 = off)
+    bool promote_frame_slots;          // Private r1 stack slots become C locals
+    uint32_t sda_base;                 // r13 small-data base (0 = discover)
+    uint32_t sda2_base;                // r2 small-data base (0 = discover)
+    int unity_shards;                  // Compile the generated sources as this many unity files (0 = off)
+    bool shared_modules;               // Each top-level input directory becomes a reloadable shared library
+    bool cmake_precompiled_headers;    // Generated CMake: precompile powerpc_state.h / stdlib_headers.h
+    bool cmake_lto;                    // Generated CMake: interprocedural optimization on by default
+    bool cmake_gc_sections;            // Generated CMake: -ffunction-sections + --gc-sections on by default
 } TranspilerConfig;
 
 static TranspilerConfig config = {
     .transpile_sdk_functions = false,  // Default: ignore SDK functions
     .skip_stdlib_stubs = false,         // Default: include stdlib stubs
     .ignore_cstd_calls = true,          // Default: ignore C++ std calls
+    .register_calling_convention = false, // Default: pass r3-r10, f1-f2 as C parameters
     .sdk_functions_file = "sdk_functions.txt",
-    .skip_list_file = ""
+    .skip_list_file = "",
+    .symbol_map_file = "",
+    .splits_file = "",
+    .dead_functions = "keep",
+    .fold_identical_functions = true,
+    .inline_max_instructions = IR_INLINE_DEFAULT_MAX_INSTRUCTIONS,
+    .promote_frame_slots = false,  // Checked by bench-codegen with bench/passes.json: opt-in
+    .sda_base = 0,
+    .sda2_base = 0,
+    .unity_shards = 0,
+    .shared_modules = false,
+    .cmake_precompiled_headers = true,
+    .cmake_lto = false,
+    .cmake_gc_sections = false
 };
 
+// Address-indexed symbols from linker maps, shared by every file
+static Symbol_Map symbol_index;
+
+// Whole-program IR of the .s input, decoded before any file is emitted
+static Program_IR program_ir;
+
+// r13 / r2 small-data bases (configured or discovered before emission)
+static Small_Data_Bases small_data;
+
 // Function registry for indirect call resolution
 typedef struct {
     char name[128];
     uint32_t gc_address;
     bool is_local;  // Skip local/static functions
+    uint32_t module;  // Shared module of the defining file (IR_NONE: executable)
 } FunctionRegistryEntry;
 
 static FunctionRegistryEntry *function_registry = NULL;
 static int function_registry_count = 0;
 static int function_registry_capacity = 0;
 
+// Module of the file being emitted, recorded with each registry entry
+static uint32_t registry_module = IR_NONE;
+
 // Check if a function name is a C++ standard library call
 static bool is_cstd_call(const char *name) {
     if (!name || name[0] == '\0') return false;
@@ -169,6 +227,18 @@ static const char* lookup_function_by_address(uint32_t gc_address) {
     return NULL;
 }
 
+// Argument list passed to transpiled functions under the configured calling convention
+static const char* game_call_args(void) {
+    return config.register_calling_convention ? "" : "r3, r4, r5, r6, r7, r8, r9, r10, f1, f2";
+}
+
+// Function pointer type matching game_call_args()
+static const char* game_func_ptr_type(void) {
+    return config.register_calling_convention
+        ? "void (*)(void)"
+        : "void (*)(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double)";
+}
+
 // Add function to registry for indirect call resolution
 static void register_transpiled_function(const char *name, uint32_t gc_address, bool is_local) {
     // Initialize registry if needed
@@ -196,7 +266,34 @@ static void register_transpiled_function(const char *name, uint32_t gc_address,
         entry->name[sizeof(entry->name) - 1] = '\0';
         entry->gc_address = gc_address;
         entry->is_local = is_local;
+        entry->module = registry_module;
+    }
+}
+
+// True if a registry entry can be referenced from C (mangled C++ and internal names cannot)
+static bool registry_entry_valid(const FunctionRegistryEntry *entry) {
+    // Check for invalid characters
+    // C++ mangled names can have @, <, >, numeric prefixes like __32ClassName, Q23zen18..., etc.
+    for (const char *p = entry->name; *p; p++) {
+        if (*p == '@' || *p == '<' || *p == '>' || *p == '?' || *p == '`' || *p == ' ') {
+            return false;
+        }
+    }
+    
+    // Check for C++ mangled names with numbers (Q219, Q23zen18, __32Class, etc.)
+    for (const char *scan = entry->name; *scan; scan++) {
+        // Check for digit followed by uppercase (like 32Class, 19Navi, 18ogScr)
+        if (scan[0] >= '0' && scan[0] <= '9' && scan[1] >= 'A' && scan[1] <= 'Z') {
+            return false;
+        }
+        // Check for consecutive uppercase then digit (like Q219, FP19)
+        if (scan[0] >= 'A' && scan[0] <= 'Z' && scan[1] >= '0' && scan[1] <= '9') {
+            return false;
+        }
     }
+    
+    // Skip internal functions (starting with __ are usually internal SDK/runtime)
+    return !(entry->name[0] == '_' && entry->name[1] == '_');
 }
 
 // Generate function_registry.c file
@@ -218,7 +315,11 @@ static void generate_function_registry(const char *project_dir) {
     fprintf(f, " * Used for vtables, callbacks, and other indirect calls.\n");
     fprintf(f, " */\n\n");
     fprintf(f, "#include \"function_address_map.h\"\n");
-    fprintf(f, "#include \"all_functions.h\"\n\n");
+    fprintf(f, "#include \"all_functions.h\"\n");
+    if (config.shared_modules) {
+        fprintf(f, "#include \"module_reload.h\"\n");
+    }
+    fprintf(f, "\n");
     fprintf(f, "/**\n");
     fprintf(f, " * @brief Initialize all function mappings\n");
     fprintf(f, " * Must be called before any indirect calls are made\n");
@@ -230,52 +331,19 @@ static void generate_function_registry(const char *project_dir) {
     fprintf(f, "    }\n\n");
     fprintf(f, "    // Register all %d transpiled functions\n", function_registry_count);
     
-    // Generate all function registrations
+    // Generate all function registrations (only valid function names)
     for (int i = 0; i < function_registry_count; i++) {
         const FunctionRegistryEntry *entry = &function_registry[i];
-        
-        // Check if function name is valid as a C identifier
-        // C++ mangled names can have @, <, >, numeric prefixes like __32ClassName, Q23zen18..., etc.
-        bool is_valid = true;
-        const char *p = entry->name;
-        
-        // Check for invalid characters
-        for (; *p; p++) {
-            if (*p == '@' || *p == '<' || *p == '>' || *p == '?' || *p == '`' || *p == ' ') {
-                is_valid = false;
-                break;
-            }
-        }
-        
-        // Check for C++ mangled names with numbers (Q219, Q23zen18, __32Class, etc.)
-        if (is_valid) {
-            // Patterns like __32ClassName or __Q219 or Q23zen
-            for (const char *scan = entry->name; scan && *scan; scan++) {
-                // Check for digit followed by uppercase (like 32Class, 19Navi, 18ogScr)
-                if (scan[0] >= '0' && scan[0] <= '9' && scan[1] >= 'A' && scan[1] <= 'Z') {
-                    is_valid = false;
-                    break;
-                }
-                // Check for consecutive uppercase then digit (like Q219, FP19)
-                if (scan[0] >= 'A' && scan[0] <= 'Z' && scan[1] >= '0' && scan[1] <= '9') {
-                    is_valid = false;
-                    break;
-                }
-            }
-        }
-        
-        // Skip internal functions (starting with __ are usually internal SDK/runtime)
-        if (is_valid && entry->name[0] == '_' && entry->name[1] == '_') {
-            is_valid = false;
-        }
-        
-        // Only register valid function names
-        if (is_valid) {
+        if (registry_entry_valid(entry)) {
             fprintf(f, "    function_address_map_register(0x%08X, (TranspiledFunctionPtr)%s, \"%s\");\n",
                    entry->gc_address, entry->name, entry->name);
         }
     }
     
+    if (config.shared_modules) {
+        fprintf(f, "\n    // Remember where each module was loaded from, for hot reload\n");
+        fprintf(f, "    porpoise_modules_init();\n");
+    }
     fprintf(f, "}\n");
     fclose(f);
 }
@@ -440,52 +508,571 @@ static const SDK_Function_Info* get_sdk_function_info(const char *func_name) {
 // Helper function to check if an address is a GameCube address that should be converted
 // Returns true if the address should be converted to a host pointer
 static inline bool is_gamecube_address(uint32_t addr) {
-    // MEM1 cached: 0x80000000-0x84000000 (24 MB + some headroom)
-    if (addr >= 0x80000000 && addr < 0x84000000) return true;
-    // MEM1 uncached: 0xC0000000-0xC2000000
-    if (addr >= 0xC0000000 && addr < 0xC2000000) return true;
-    // Hardware I/O registers: 0xCC000000-0xCC010000 (VI, PI, MI, etc.)
-    if (addr >= 0xCC000000 && addr < 0xCC010000) return true;
-    // MEM2 cached (Wii): 0x90000000-0x94000000
-    if (addr >= 0x90000000 && addr < 0x94000000) return true;
-    // MEM2 uncached (Wii): 0xD0000000-0xD4000000
-    if (addr >= 0xD0000000 && addr < 0xD4000000) return true;
-    // Locked cache: 0xE0000000-0xE0010000
-    if (addr >= 0xE0000000 && addr < 0xE0010000) return true;
-    return false;
+    return gc_address_map_lookup(gc_host_slots, addr, NULL);
 }
 
 // Helper function to convert GameCube address to host pointer offset
 // Returns the offset from mem base, or 0xFFFFFFFF if not a known GameCube address
 static inline uint32_t gamecube_to_offset(uint32_t addr) {
-    // MEM1 cached: map to mem buffer
-    if (addr >= 0x80000000 && addr < 0x84000000) {
-        return addr - 0x80000000;
+    uint32_t offset;
+    if (!gc_address_map_lookup(gc_host_slots, addr, &offset)) {
+        return 0xFFFFFFFF;  // Not a known GameCube address
+    }
+    return offset;
+}
+
+/**
+ * @brief Rewrite an r13/r2-relative access to a fixed slot of the memory image
+ * @param operands Assembly operands (for the sym@sda21 name), may be NULL
+ * @return false if the instruction is not a small-data access or the base is unknown
+ */
+static bool transpile_small_data(uint32_t word, const char *operands, char *output, size_t output_size,
+                                 char *comment, size_t comment_size, RegisterTracker *tracker) {
+    uint32_t address;
+    if (!small_data_address(&small_data, word, &address)) return false;
+    uint32_t offset = gamecube_to_offset(address);
+    if (offset == 0xFFFFFFFF || !small_data_transpile(word, offset, output, output_size)) return false;
+
+    // Name the variable: relocation in the operand, else an imported data symbol
+    char name[MAX_FUNCTION_NAME] = {0};
+    const char *at = operands ? strstr(operands, "@sda21") : NULL;
+    if (at) {
+        const char *start = at;
+        while (start > operands && start[-1] != ' ' && start[-1] != ',') start--;
+        snprintf(name, sizeof(name), "%.*s", (int)(at - start), start);
+    } else {
+        int i = symbol_table_floor(&symbol_index.objects, address);
+        if (i >= 0 && symbol_index.objects.entries[i].address == address) {
+            snprintf(name, sizeof(name), "%s", symbol_map_name(&symbol_index, &symbol_index.objects.entries[i]));
+        }
+    }
+    size_t len = strlen(comment);
+    if (len < comment_size) {
+        snprintf(comment + len, comment_size - len, " [SDA 0x%08X%s%s]", address, name[0] ? " " : "", name);
+    }
+
+    // Loads and addi leave a data value (or data address) in rD
+    uint32_t opcode = word >> 26;
+    if (tracker && opcode != 36 && opcode != 38 && opcode != 44 && opcode < 48) {
+        register_tracker_clear(tracker, (word >> 21) & 0x1F);
+    }
+    return true;
+}
+
+static void report_small_data(void) {
+    if (!small_data.sda_base && !small_data.sda2_base) {
+        printf("Small data: bases unknown, r13/r2 accesses stay register-relative\n");
+        return;
+    }
+    printf("Small data: r13 = 0x%08X, r2 = 0x%08X (%s)\n",
+           small_data.sda_base, small_data.sda2_base, small_data.source);
+}
+
+/**
+ * @brief Name of the function containing an address
+ * Uses the imported symbol map when one is loaded, then the program IR, then the per-file label map.
+ */
+static const char* find_containing_function(const LabelMap *label_map, uint32_t address) {
+    const Symbol_Entry *entry = symbol_map_containing_function(&symbol_index, address);
+    if (entry) return symbol_map_name(&symbol_index, entry);
+    const IR_Function *fn = ir_function_containing(&program_ir, address);
+    if (fn) return ir_text(&program_ir, fn->name);
+    return labelmap_find_function(label_map, address);
+}
+
+//============================================================================
+// Register tracking and call rewrites
+// Shared by the .s path (operands parsed from text) and the DOL/ELF path
+// (fields decoded from the instruction word).
+//============================================================================
+
+// Pending lis that is not a mapped address, for a following addi/ori
+static uint32_t last_lis_value = 0;
+static int last_lis_reg = -1;
+
+/**
+ * @brief lis rD, value: a mapped GameCube address becomes a host pointer, anything else is tracked
+ * @return true if output was generated
+ */
+static bool rewrite_lis(int reg, uint32_t value, char *output, size_t output_size,
+                        char *comment, size_t comment_size, RegisterTracker *tracker) {
+    uint32_t shifted_value = value << 16;  // lis shifts left by 16
+    
+    // Convert GameCube addresses to host pointers immediately
+    if (is_gamecube_address(shifted_value)) {
+        uint32_t offset = gamecube_to_offset(shifted_value);
+        if (offset != 0xFFFFFFFF) {
+            // Generate code that directly creates host pointer: mem + offset
+            snprintf(output, output_size, "r%d = (uintptr_t)(mem + 0x%08X);",
+                    reg, offset);
+            snprintf(comment, comment_size, "lis r%d, %i (GC 0x%08X -> host ptr)",
+                    reg, value, shifted_value);
+            // Don't track - register now contains host pointer, not GameCube address
+            last_lis_reg = -1;  // Reset since we've converted it
+            if (tracker) {
+                register_tracker_clear(tracker, reg);
+            }
+            return true;
+        }
+    }
+    // Not a GameCube address - track it for potential addi/ori combination
+    last_lis_reg = reg;
+    last_lis_value = shifted_value;
+    // Track this partial address
+    if (tracker) {
+        register_tracker_set(tracker, reg, last_lis_value);
+    }
+    return false;
+}
+
+/**
+ * @brief addi/ori rD, rA, imm on top of a pending lis or a tracked base
+ * @param string_table Strings to name the address after, may be NULL
+ * @return true if output was generated
+ */
+static bool rewrite_add_immediate(const char *mnemonic, int rD, int rA, int32_t simm,
+                                  char *output, size_t output_size,
+                                  char *comment, size_t comment_size,
+                                  const StringTable *string_table, RegisterTracker *tracker) {
+    if (rA == last_lis_reg) {
+        // Combine lis + addi to form full address
+        uint32_t full_addr = last_lis_value + simm;
+        
+        // Check if this address matches a string
+        if (string_table) {
+            const StringEntry *str_entry = string_table_find(string_table, full_addr);
+            if (str_entry) {
+                // Generate string reference instead of raw address
+                snprintf(output, output_size, "r%d = (uintptr_t)&%s;  /* \"%s\" */",
+                        rD, str_entry->label, str_entry->content);
+                snprintf(comment, comment_size, "%s r%d, r%d, %d (string ref)",
+                        mnemonic, rD, rA, simm);
+                last_lis_reg = -1;  // Reset
+                // Track as host pointer (string address)
+                if (tracker) {
+                    register_tracker_clear(tracker, rD);  // Can't track string addresses
+                }
+                return true;
+            }
+        }
+        
+        // Convert GameCube addresses to host pointers immediately
+        if (is_gamecube_address(full_addr)) {
+            uint32_t offset = gamecube_to_offset(full_addr);
+            if (offset != 0xFFFFFFFF) {
+                // Generate code that directly creates host pointer: mem + offset
+                snprintf(output, output_size, "r%d = (uintptr_t)(mem + 0x%08X);",
+                        rD, offset);
+                snprintf(comment, comment_size, "%s r%d, r%d, %d (GC 0x%08X -> host ptr)",
+                        mnemonic, rD, rA, simm, full_addr);
+                last_lis_reg = -1;  // Reset
+                // Don't track - register now contains host pointer, not GameCube address
+                if (tracker) {
+                    register_tracker_clear(tracker, rD);
+                }
+                return true;
+            }
+        }
+        // Not a GameCube address - just set the value
+        // Track the full address
+        if (tracker) {
+            register_tracker_set(tracker, rD, full_addr);
+        }
+    } else if (tracker && tracker->r_known[rA]) {
+        // rA contains a known address, add offset to it
+        uint32_t base_addr = tracker->r[rA];
+        uint32_t new_addr = base_addr + simm;
+        
+        // Check if the result is a GameCube address - generate host pointer directly
+        if (is_gamecube_address(new_addr)) {
+            uint32_t offset = gamecube_to_offset(new_addr);
+            if (offset != 0xFFFFFFFF) {
+                // Generate code that directly creates host pointer: mem + offset
+                snprintf(output, output_size, "r%d = (uintptr_t)(mem + 0x%08X);",
+                        rD, offset);
+                snprintf(comment, comment_size, "%s r%d, r%d, %d (GC 0x%08X -> host ptr)",
+                        mnemonic, rD, rA, simm, new_addr);
+                // Don't track - register now contains host pointer
+                register_tracker_clear(tracker, rD);
+                return true;
+            }
+        }
+        // Not a GameCube address - track it
+        register_tracker_set(tracker, rD, new_addr);
+    } else {
+        // Unknown value - clear tracking
+        if (tracker) register_tracker_clear(tracker, rD);
+    }
+    return false;
+}
+
+/**
+ * @brief mtlr/mtctr: LR or CTR takes the tracked value of reg
+ */
+static void track_move_to_spr(int reg, bool ctr, RegisterTracker *tracker) {
+    if (!tracker) return;
+    uint32_t addr = register_tracker_get(tracker, reg);
+    if (ctr) {
+        if (addr != 0) register_tracker_set_ctr(tracker, addr);
+        else tracker->ctr_known = false;
+    } else {
+        if (addr != 0) register_tracker_set_lr(tracker, addr);
+        else tracker->lr_known = false;
+    }
+}
+
+/**
+ * @brief mflr/mfctr: reg takes the tracked value of LR or CTR
+ */
+static void track_move_from_spr(int reg, bool ctr, RegisterTracker *tracker) {
+    if (!tracker) return;
+    bool known = ctr ? tracker->ctr_known : tracker->lr_known;
+    if (known) {
+        register_tracker_set(tracker, reg, ctr ? tracker->ctr : tracker->lr);
+    } else {
+        register_tracker_clear(tracker, reg);
     }
-    // MEM1 uncached: also map to mem buffer (same physical memory)
-    if (addr >= 0xC0000000 && addr < 0xC2000000) {
-        return addr - 0xC0000000;
+}
+
+/**
+ * @brief lwz from an absolute or tracked address - might load function pointers from vtables or function tables
+ * @return true if output was generated
+ */
+static bool rewrite_lwz(int rD, int32_t offset, int rA, char *output, size_t output_size,
+                        char *comment, size_t comment_size, RegisterTracker *tracker) {
+    // Check if this is loading from an absolute address (rA == 0)
+    if (rA == 0) {
+        // Absolute address load: lwz rD, offset(0) means load from address = offset
+        uint32_t abs_addr = (uint32_t)offset;
+        
+        // Generate code with literal address (for transpiler resolution)
+        // Add conversion to handle GameCube addresses loaded from memory
+        snprintf(output, output_size, 
+                "r%u = *(uint32_t*)(uintptr_t)0x%08X; "
+                "r%u = convert_gc_address((uint32_t)r%u);", 
+                rD, abs_addr, rD, rD);
+        snprintf(comment, comment_size, "lwz r%u, %i(0) [convert GC addr if needed]", rD, offset);
+        
+        // Check if this address contains a function pointer
+        const char *func_name = lookup_function_by_address(abs_addr);
+        if (func_name && tracker) {
+            // The address itself is a function - track that rD contains this function address
+            register_tracker_set(tracker, rD, abs_addr);
+        } else if (tracker) {
+            // TODO: Parse assembly data sections to find what value is stored at abs_addr
+            // For now, mark as unknown
+            register_tracker_clear(tracker, rD);
+        }
+        return true;
     }
-        // Hardware I/O: map to mem buffer (SDK will handle actual I/O)
-        // Use offset after MEM1 (24MB) but within 256MB buffer
-        if (addr >= 0xCC000000 && addr < 0xCC010000) {
-            return addr - 0xCC000000 + 0x1800000;  // After MEM1 (24MB), within 256MB buffer
+    // Register-based load: lwz rD, offset(rA)
+    // Check if rA contains a known address (from lis/addi)
+    if (tracker && tracker->r_known[rA]) {
+        uint32_t base_addr = tracker->r[rA];
+        uint32_t load_addr = base_addr + offset;
+        
+        // Generate code with literal address (for transpiler resolution)
+        // Add conversion to handle GameCube addresses loaded from memory
+        snprintf(output, output_size, 
+                "r%u = *(uint32_t*)(uintptr_t)0x%08X; "
+                "r%u = convert_gc_address((uint32_t)r%u);", 
+                rD, load_addr, rD, rD);
+        snprintf(comment, comment_size, "lwz r%u, %i(r%u) [resolved: 0x%08X, convert GC addr if needed]", rD, offset, rA, load_addr);
+        
+        // Check if the value at this address is a function pointer
+        // TODO: Parse assembly data sections to find the actual value stored at load_addr
+        const char *func_name = lookup_function_by_address(load_addr);
+        if (func_name) {
+            // The address being loaded from is a function - track it
+            register_tracker_set(tracker, rD, load_addr);
+        } else {
+            // Can't determine what value is stored there at compile time
+            register_tracker_clear(tracker, rD);
         }
-    // MEM2 cached: map to mem buffer (if allocated)
-    if (addr >= 0x90000000 && addr < 0x94000000) {
-        return addr - 0x90000000 + 0x1800000;  // After MEM1
+        return true;
+    }
+    // Base register unknown - fall through to opcode transpile function
+    // Registers contain host pointers, so opcode will use direct cast
+    if (tracker) register_tracker_clear(tracker, rD);
+    return false;
+}
+
+/**
+ * @brief stw to an absolute or tracked address
+ * @return true if output was generated
+ */
+static bool rewrite_stw(int rS, int32_t offset, int rA, char *output, size_t output_size,
+                        char *comment, size_t comment_size, const RegisterTracker *tracker) {
+    // Check if this is storing to an absolute address (rA == 0)
+    if (rA == 0) {
+        // Absolute address store: stw rS, offset(0) means store to address = offset
+        uint32_t abs_addr = (uint32_t)offset;
+        
+        // Generate code with literal address (for transpiler resolution)
+        snprintf(output, output_size, "*(uint32_t*)(uintptr_t)0x%08X = r%u;", abs_addr, rS);
+        snprintf(comment, comment_size, "stw r%u, %i(0)", rS, offset);
+        return true;
+    }
+    // Register-based store: stw rS, offset(rA)
+    // Check if rA contains a known address (from lis/addi)
+    if (tracker && tracker->r_known[rA]) {
+        uint32_t base_addr = tracker->r[rA];
+        uint32_t store_addr = base_addr + offset;
+        
+        // Generate code with literal address (for transpiler resolution)
+        snprintf(output, output_size, "*(uint32_t*)(uintptr_t)0x%08X = r%u;", store_addr, rS);
+        snprintf(comment, comment_size, "stw r%u, %i(r%u) [resolved: 0x%08X]", rS, offset, rA, store_addr);
+        return true;
+    }
+    // Base register unknown - fall through to opcode transpile function
+    // Registers contain host pointers, so opcode will use direct cast
+    return false;
+}
+
+/**
+ * @brief stwu through a tracked base register
+ * @return true if output was generated
+ */
+static bool rewrite_stwu(int rS, int32_t offset, int rA, char *output, size_t output_size,
+                         char *comment, size_t comment_size, RegisterTracker *tracker) {
+    // Check if rA contains a known address (from lis/addi)
+    if (!tracker || !tracker->r_known[rA]) {
+        // Base register unknown or runtime address - use translate_address()
+        // Fall through to opcode transpile function which will use translate_address()
+        return false;
+    }
+    uint32_t base_addr = tracker->r[rA];
+    uint32_t store_addr = base_addr + offset;
+    
+    // Generate code with literal address (for transpiler resolution)
+    // Note: stwu updates rA, so we need to update the tracker too
+    if (offset >= 0) {
+        snprintf(output, output_size, "r%u = r%u + 0x%x; *(uint32_t*)(uintptr_t)0x%08X = r%u;", 
+                rA, rA, (uint16_t)offset, store_addr, rS);
+    } else {
+        snprintf(output, output_size, "r%u = r%u - 0x%x; *(uint32_t*)(uintptr_t)0x%08X = r%u;", 
+                rA, rA, (uint16_t)(-offset), store_addr, rS);
+    }
+    snprintf(comment, comment_size, "stwu r%u, %i(r%u) [resolved: 0x%08X]", rS, offset, rA, store_addr);
+    
+    // Update tracker with new rA value
+    register_tracker_set(tracker, rA, store_addr);
+    return true;
+}
+
+/**
+ * @brief blr: return r3 when the function returns a value
+ */
+static void transpile_return(const Function_Info *func_context, char *output, size_t output_size,
+                                             char *comment, size_t comment_size) {
+    if (func_context && func_context->returns_value) {
+        snprintf(output, output_size, "return r3;");
+    } else {
+        snprintf(output, output_size, "return;");
     }
-    // MEM2 uncached: map to mem buffer
-    if (addr >= 0xD0000000 && addr < 0xD4000000) {
-        return addr - 0xD0000000 + 0x1800000;  // After MEM1
+    snprintf(comment, comment_size, "blr");
+}
+
+/**
+ * @brief blrl/bctrl: a direct call when LR/CTR holds a known function, else call_function_by_address()
+ */
+static void transpile_indirect_call(bool via_ctr, uint32_t address, char *output, size_t output_size,
+                                                    char *comment, size_t comment_size, RegisterTracker *tracker) {
+    const char *mnemonic = via_ctr ? "bctrl" : "blrl";
+    const char *reg = via_ctr ? "ctr" : "lr";
+    uint32_t return_addr = address + 4;
+    uint32_t func_addr = 0;
+    const char *func_name = NULL;
+    
+    // Check if LR/CTR contains a known function address
+    if (tracker) {
+        func_addr = via_ctr ? register_tracker_get_ctr(tracker) : register_tracker_get_lr(tracker);
+        if (func_addr != 0) {
+            func_name = lookup_function_by_address(func_addr);
+        }
     }
-    // Locked cache: map to mem buffer
-    if (addr >= 0xE0000000 && addr < 0xE0010000) {
-        return addr - 0xE0000000 + 0x5800000;  // After MEM2
+    
+    if (func_name) {
+        // Replace with direct function call!
+        snprintf(output, output_size,
+                "{ lr = 0x%08X; %s(%s); }",
+                return_addr, func_name, game_call_args());
+        snprintf(comment, comment_size, "%s - replaced with direct call to %s (0x%08X)", mnemonic, func_name, func_addr);
+    } else {
+        // Fallback to runtime resolution
+        porpoise_stats.indirect_call_fallbacks++;
+        snprintf(output, output_size,
+                "{ uintptr_t saved_%s = %s; lr = 0x%08X; "
+                "call_function_by_address((uint32_t)saved_%s%s%s); }",
+                reg, reg, return_addr, reg, config.register_calling_convention ? "" : ", ", game_call_args());
+        snprintf(comment, comment_size, "%s - indirect call via %s (address unknown at compile time)", mnemonic, reg);
     }
-    return 0xFFFFFFFF;  // Not a known GameCube address
 }
 
+/**
+ * @brief b/bl to a named function: a call (bl) or a tail call (b)
+ * Sanitizes the name, stubs long C++ names, drops ignored C++ std calls and
+ * passes typed arguments to SDK functions.
+ */
+static void transpile_named_call(const char *mnemonic, const char *target, bool link,
+                                                 char *output, size_t output_size,
+                                                 char *comment, size_t comment_size) {
+    // Both b and bl should be function calls for external symbols
+    // IMPORTANT: We MUST sanitize reserved names when calling them too,
+    // because the function was defined with a sanitized name (e.g., main -> main_impl)
+    // This ensures calls to reserved names match the renamed definitions.
+    
+    // Sanitize the function name to get the actual C function name
+    char sanitized_target[MAX_FUNCTION_NAME];
+    char stub_name[256];
+    const char *actual_target;
+    
+    // Special case: __va_arg -> ppc_va_arg (to avoid MSVC intrinsic conflict)
+    if (strcmp(target, "__va_arg") == 0) {
+        actual_target = "ppc_va_arg";
+    }
+    // Handle C++ template names, @unnamed@ patterns, and extremely long mangled names
+    // These contain '<', '>', ',', '@' or are very long
+    else if (strlen(target) > 80 || strchr(target, '<') != NULL || 
+             strchr(target, '>') != NULL || strchr(target, ',') != NULL ||
+             strchr(target, '@') != NULL) {
+        // Check if this is a C++ standard library call that should be ignored
+        if (config.ignore_cstd_calls && is_cstd_call(target)) {
+            // Generate a comment instead of a function call
+            if (link) {
+                snprintf(output, output_size, "/* C++ std call ignored: %s */", target);
+            } else {
+                snprintf(output, output_size, "/* C++ std branch ignored: %s */", target);
+            }
+            snprintf(comment, comment_size, "%s %s (C++ std call - ignored)", mnemonic, target);
+            return;
+        }
+        
+        // Create a shorter stub name based on hash
+        unsigned int hash = 0;
+        for (const char *p = target; *p; p++) {
+            hash = hash * 31 + (unsigned char)*p;
+        }
+        snprintf(stub_name, sizeof(stub_name), "cpp_stub_func_%08x", hash);
+        actual_target = stub_name;
+    } else {
+        // Normal function name - check if it should be ignored first
+        if (config.ignore_cstd_calls && is_cstd_call(target)) {
+            // Generate a comment instead of a function call
+            if (link) {
+                snprintf(output, output_size, "/* C++ std call ignored: %s */", target);
+            } else {
+                snprintf(output, output_size, "/* C++ std branch ignored: %s */", target);
+            }
+            snprintf(comment, comment_size, "%s %s (C++ std call - ignored)", mnemonic, target);
+            return;
+        }
+        // Sanitize it (handles reserved names like main -> main_impl)
+        sanitize_function_name(target, sanitized_target, sizeof(sanitized_target));
+        actual_target = sanitized_target;
+    }
+    
+    // Check if this is an SDK function
+    const SDK_Function_Info *sdk_info = get_sdk_function_info(actual_target);
+    
+    char params[512];
+    bool is_sdk_func = (sdk_info != NULL);
+    
+    if (is_sdk_func) {
+        // SDK function - generate typed parameters (or empty if no params)
+        if (sdk_info->num_params > 0) {
+            const char *int_regs[] = {"r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10"};
+            const char *float_regs[] = {"f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8"};
+            
+            char *p = params;
+            size_t remaining = sizeof(params);
+            int int_reg_idx = 0;
+            int float_reg_idx = 0;
+            
+            for (int i = 0; i < sdk_info->num_params && i < 10; i++) {
+                if (i > 0) {
+                    int written = snprintf(p, remaining, ", ");
+                    p += written;
+                    remaining -= written;
+                }
+                
+                switch (sdk_info->param_types[i]) {
+                    case SDK_PARAM_PTR:
+                        if (int_reg_idx < 8) {
+                                            int written = snprintf(p, remaining, "(void*)%s", int_regs[int_reg_idx++]);
+                                            p += written;
+                                            remaining -= written;
+                        }
+                        break;
+                    case SDK_PARAM_INT:
+                        if (int_reg_idx < 8) {
+                                            int written = snprintf(p, remaining, "(int)%s", int_regs[int_reg_idx++]);
+                                            p += written;
+                                            remaining -= written;
+                        }
+                        break;
+                    case SDK_PARAM_FLOAT:
+                        if (float_reg_idx < 8) {
+                                            int written = snprintf(p, remaining, "(float)%s", float_regs[float_reg_idx++]);
+                                            p += written;
+                                            remaining -= written;
+                        }
+                        break;
+                    case SDK_PARAM_DOUBLE:
+                        if (float_reg_idx < 8) {
+                                            int written = snprintf(p, remaining, "%s", float_regs[float_reg_idx++]);
+                                            p += written;
+                                            remaining -= written;
+                        }
+                        break;
+                }
+            }
+        } else {
+            // SDK function with no parameters - empty parameter list
+            params[0] = '\0';
+        }
+    } else {
+        // Game function - use the configured calling convention
+        snprintf(params, sizeof(params), "%s", game_call_args());
+    }
+    
+    // Check if this SDK function returns a value (functions that return pointers or ints)
+    // For now, we'll assume SDK functions with names starting with "OSGet" return values
+    bool returns_value = false;
+    if (is_sdk_func && (strncmp(actual_target, "OSGet", 5) == 0 || 
+                        strncmp(actual_target, "OSIs", 4) == 0 ||
+                        strncmp(actual_target, "OSCreate", 8) == 0 ||
+                        strncmp(actual_target, "OSAlloc", 7) == 0 ||
+                        strncmp(actual_target, "OSGetCurrent", 12) == 0 ||
+                        strncmp(actual_target, "OSGetThread", 11) == 0)) {
+        returns_value = true;
+    }
+    
+    if (link) {
+        if (is_sdk_func && returns_value) {
+            // SDK function that returns a value - capture return in r3
+            if (sdk_info->num_params > 0) {
+                snprintf(output, output_size, "r3 = (uintptr_t)%s(%s);", actual_target, params);
+            } else {
+                snprintf(output, output_size, "r3 = (uintptr_t)%s();", actual_target);
+            }
+        } else {
+            // SDK function with no return, or game function
+            if (is_sdk_func && sdk_info->num_params == 0) {
+                snprintf(output, output_size, "%s();", actual_target);
+            } else {
+                snprintf(output, output_size, "%s(%s);", actual_target, params);
+            }
+        }
+    } else {
+        // Tail call optimization (branch without link)
+        if (is_sdk_func && sdk_info->num_params == 0) {
+            snprintf(output, output_size, "return %s();  /* Tail call */", actual_target);
+        } else {
+            snprintf(output, output_size, "return %s(%s);  /* Tail call */", actual_target, params);
+        }    }
+    snprintf(comment, comment_size, "%s %s", mnemonic, target);
+}
 /**
  * @brief Transpile from assembly text (mnemonic + operands)
  */
@@ -497,43 +1084,14 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
                         const LabelMap *label_map,
                         const StringTable *string_table,
                         RegisterTracker *tracker) {
-    // Detect string address loading patterns (lis followed by addi/ori)
-    // Check if previous instruction was lis and current is addi
-    static uint32_t last_lis_value = 0;
-    static int last_lis_reg = -1;
-    
     if (strcmp(mnemonic, "lis") == 0) {
         // Parse: lis rD, value
         int reg;
         uint32_t value;
-        if (sscanf(operands, "r%d, %i", &reg, &value) == 2 ||
-            sscanf(operands, "r%d,%i", &reg, &value) == 2) {
-            uint32_t shifted_value = value << 16;  // lis shifts left by 16
-            
-            // Convert GameCube addresses to host pointers immediately
-            if (is_gamecube_address(shifted_value)) {
-                uint32_t offset = gamecube_to_offset(shifted_value);
-                if (offset != 0xFFFFFFFF) {
-                    // Generate code that directly creates host pointer: mem + offset
-                    snprintf(output, output_size, "r%d = (uintptr_t)(mem + 0x%08X);",
-                            reg, offset);
-                    snprintf(comment, comment_size, "lis r%d, %i (GC 0x%08X -> host ptr)",
-                            reg, value, shifted_value);
-                    // Don't track - register now contains host pointer, not GameCube address
-                    last_lis_reg = -1;  // Reset since we've converted it
-                    if (tracker) {
-                        register_tracker_clear(tracker, reg);
-                    }
-                    return true;
-                }
-            }
-            // Not a GameCube address - track it for potential addi/ori combination
-            last_lis_reg = reg;
-            last_lis_value = shifted_value;
-            // Track this partial address
-            if (tracker) {
-                register_tracker_set(tracker, reg, last_lis_value);
-            }
+        if ((sscanf(operands, "r%d, %i", &reg, &value) == 2 ||
+             sscanf(operands, "r%d,%i", &reg, &value) == 2) &&
+            rewrite_lis(reg, value, output, output_size, comment, comment_size, tracker)) {
+            return true;
         }
     }
     
@@ -541,172 +1099,30 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
         // Parse: addi rD, rA, simm
         int rD, rA;
         int32_t simm;
-        if (sscanf(operands, "r%d, r%d, %i", &rD, &rA, &simm) == 3 ||
-            sscanf(operands, "r%d,r%d,%i", &rD, &rA, &simm) == 3) {
-            if (rA == last_lis_reg) {
-                // Combine lis + addi to form full address
-                uint32_t full_addr = last_lis_value + simm;
-                
-                // Check if this address matches a string
-                if (string_table) {
-                    const StringEntry *str_entry = string_table_find(string_table, full_addr);
-                    if (str_entry) {
-                        // Generate string reference instead of raw address
-                        snprintf(output, output_size, "r%d = (uintptr_t)&%s;  /* \"%s\" */",
-                                rD, str_entry->label, str_entry->content);
-                        snprintf(comment, comment_size, "%s r%d, r%d, %d (string ref)",
-                                mnemonic, rD, rA, simm);
-                        last_lis_reg = -1;  // Reset
-                        // Track as host pointer (string address)
-                        if (tracker) {
-                            register_tracker_clear(tracker, rD);  // Can't track string addresses
-                        }
-                        return true;
-                    }
-                }
-                
-                // Convert GameCube addresses to host pointers immediately
-                if (is_gamecube_address(full_addr)) {
-                    uint32_t offset = gamecube_to_offset(full_addr);
-                    if (offset != 0xFFFFFFFF) {
-                        // Generate code that directly creates host pointer: mem + offset
-                        snprintf(output, output_size, "r%d = (uintptr_t)(mem + 0x%08X);",
-                                rD, offset);
-                        snprintf(comment, comment_size, "%s r%d, r%d, %d (GC 0x%08X -> host ptr)",
-                                mnemonic, rD, rA, simm, full_addr);
-                        last_lis_reg = -1;  // Reset
-                        // Don't track - register now contains host pointer, not GameCube address
-                        if (tracker) {
-                            register_tracker_clear(tracker, rD);
-                        }
-                        return true;
-                    }
-                }
-                // Not a GameCube address - just set the value
-                // Track the full address
-                if (tracker) {
-                    register_tracker_set(tracker, rD, full_addr);
-                }
-            } else if (tracker && tracker->r_known[rA]) {
-                // rA contains a known address, add offset to it
-                uint32_t base_addr = tracker->r[rA];
-                uint32_t new_addr = base_addr + simm;
-                
-                // Check if the result is a GameCube address - generate host pointer directly
-                if (is_gamecube_address(new_addr)) {
-                    uint32_t offset = gamecube_to_offset(new_addr);
-                    if (offset != 0xFFFFFFFF) {
-                        // Generate code that directly creates host pointer: mem + offset
-                        snprintf(output, output_size, "r%d = (uintptr_t)(mem + 0x%08X);",
-                                rD, offset);
-                        snprintf(comment, comment_size, "%s r%d, r%d, %d (GC 0x%08X -> host ptr)",
-                                mnemonic, rD, rA, simm, new_addr);
-                        // Don't track - register now contains host pointer
-                        register_tracker_clear(tracker, rD);
-                        return true;
-                    }
-                }
-                // Not a GameCube address - track it
-                register_tracker_set(tracker, rD, new_addr);
-            } else {
-                // Unknown value - clear tracking
-                if (tracker) register_tracker_clear(tracker, rD);
-            }
-        }
-    }
-    
-    // Track mtlr (move to link register)
-    if (strcmp(mnemonic, "mtlr") == 0) {
-        int reg;
-        if (sscanf(operands, "r%d", &reg) == 1) {
-            if (tracker) {
-                uint32_t addr = register_tracker_get(tracker, reg);
-                if (addr != 0) {
-                    register_tracker_set_lr(tracker, addr);
-                } else {
-                    tracker->lr_known = false;
-                }
-            }
+        if ((sscanf(operands, "r%d, r%d, %i", &rD, &rA, &simm) == 3 ||
+             sscanf(operands, "r%d,r%d,%i", &rD, &rA, &simm) == 3) &&
+            rewrite_add_immediate(mnemonic, rD, rA, simm, output, output_size,
+                                  comment, comment_size, string_table, tracker)) {
+            return true;
         }
     }
     
-    // Track mtctr (move to count register)
-    if (strcmp(mnemonic, "mtctr") == 0) {
+    // Track mtlr/mtctr (move to link/count register)
+    if (strcmp(mnemonic, "mtlr") == 0 || strcmp(mnemonic, "mtctr") == 0) {
         int reg;
         if (sscanf(operands, "r%d", &reg) == 1) {
-            if (tracker) {
-                uint32_t addr = register_tracker_get(tracker, reg);
-                if (addr != 0) {
-                    register_tracker_set_ctr(tracker, addr);
-                } else {
-                    tracker->ctr_known = false;
-                }
-            }
+            track_move_to_spr(reg, mnemonic[3] == 'c', tracker);
         }
     }
     
-    // Track and transpile lwz (load word) - might load function pointers from vtables or function tables
+    // Track and transpile lwz (load word)
     if (strcmp(mnemonic, "lwz") == 0) {
         int rD, rA;
         int32_t offset;
-        if (sscanf(operands, "r%d, %i(r%d)", &rD, &offset, &rA) == 3 ||
-            sscanf(operands, "r%d,%i(r%d)", &rD, &offset, &rA) == 3) {
-            // Check if this is loading from an absolute address (rA == 0)
-            if (rA == 0) {
-                // Absolute address load: lwz rD, offset(0) means load from address = offset
-                uint32_t abs_addr = (uint32_t)offset;
-                
-                // Generate code with literal address (for transpiler resolution)
-                // Add conversion to handle GameCube addresses loaded from memory
-                snprintf(output, output_size, 
-                        "r%u = *(uint32_t*)(uintptr_t)0x%08X; "
-                        "r%u = convert_gc_address((uint32_t)r%u);", 
-                        rD, abs_addr, rD, rD);
-                snprintf(comment, comment_size, "lwz r%u, %i(0) [convert GC addr if needed]", rD, offset);
-                
-                // Check if this address contains a function pointer
-                const char *func_name = lookup_function_by_address(abs_addr);
-                if (func_name && tracker) {
-                    // The address itself is a function - track that rD contains this function address
-                    register_tracker_set(tracker, rD, abs_addr);
-                } else if (tracker) {
-                    // TODO: Parse assembly data sections to find what value is stored at abs_addr
-                    // For now, mark as unknown
-                    register_tracker_clear(tracker, rD);
-                }
-                return true;
-            } else {
-                // Register-based load: lwz rD, offset(rA)
-                // Check if rA contains a known address (from lis/addi)
-                if (tracker && tracker->r_known[rA]) {
-                    uint32_t base_addr = tracker->r[rA];
-                    uint32_t load_addr = base_addr + offset;
-                    
-                    // Generate code with literal address (for transpiler resolution)
-                    // Add conversion to handle GameCube addresses loaded from memory
-                    snprintf(output, output_size, 
-                            "r%u = *(uint32_t*)(uintptr_t)0x%08X; "
-                            "r%u = convert_gc_address((uint32_t)r%u);", 
-                            rD, load_addr, rD, rD);
-                    snprintf(comment, comment_size, "lwz r%u, %i(r%u) [resolved: 0x%08X, convert GC addr if needed]", rD, offset, rA, load_addr);
-                    
-                    // Check if the value at this address is a function pointer
-                    // TODO: Parse assembly data sections to find the actual value stored at load_addr
-                    const char *func_name = lookup_function_by_address(load_addr);
-                    if (func_name) {
-                        // The address being loaded from is a function - track it
-                        register_tracker_set(tracker, rD, load_addr);
-                    } else {
-                        // Can't determine what value is stored there at compile time
-                        register_tracker_clear(tracker, rD);
-                    }
-                    return true;
-                } else {
-                    // Base register unknown - fall through to opcode transpile function
-                    // Registers contain host pointers, so opcode will use direct cast
-                    if (tracker) register_tracker_clear(tracker, rD);
-                }
-            }
+        if ((sscanf(operands, "r%d, %i(r%d)", &rD, &offset, &rA) == 3 ||
+             sscanf(operands, "r%d,%i(r%d)", &rD, &offset, &rA) == 3) &&
+            rewrite_lwz(rD, offset, rA, output, output_size, comment, comment_size, tracker)) {
+            return true;
         }
     }
     
@@ -714,33 +1130,10 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
     if (strcmp(mnemonic, "stw") == 0) {
         int rS, rA;
         int32_t offset;
-        if (sscanf(operands, "r%d, %i(r%d)", &rS, &offset, &rA) == 3 ||
-            sscanf(operands, "r%d,%i(r%d)", &rS, &offset, &rA) == 3) {
-            // Check if this is storing to an absolute address (rA == 0)
-            if (rA == 0) {
-                // Absolute address store: stw rS, offset(0) means store to address = offset
-                uint32_t abs_addr = (uint32_t)offset;
-                
-                // Generate code with literal address (for transpiler resolution)
-                snprintf(output, output_size, "*(uint32_t*)(uintptr_t)0x%08X = r%u;", abs_addr, rS);
-                snprintf(comment, comment_size, "stw r%u, %i(0)", rS, offset);
-                return true;
-            } else {
-                // Register-based store: stw rS, offset(rA)
-                // Check if rA contains a known address (from lis/addi)
-                if (tracker && tracker->r_known[rA]) {
-                    uint32_t base_addr = tracker->r[rA];
-                    uint32_t store_addr = base_addr + offset;
-                    
-                    // Generate code with literal address (for transpiler resolution)
-                    snprintf(output, output_size, "*(uint32_t*)(uintptr_t)0x%08X = r%u;", store_addr, rS);
-                    snprintf(comment, comment_size, "stw r%u, %i(r%u) [resolved: 0x%08X]", rS, offset, rA, store_addr);
-                    return true;
-                } else {
-                    // Base register unknown - fall through to opcode transpile function
-                    // Registers contain host pointers, so opcode will use direct cast
-                }
-            }
+        if ((sscanf(operands, "r%d, %i(r%d)", &rS, &offset, &rA) == 3 ||
+             sscanf(operands, "r%d,%i(r%d)", &rS, &offset, &rA) == 3) &&
+            rewrite_stw(rS, offset, rA, output, output_size, comment, comment_size, tracker)) {
+            return true;
         }
     }
     
@@ -748,31 +1141,10 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
     if (strcmp(mnemonic, "stwu") == 0) {
         int rS, rA;
         int32_t offset;
-        if (sscanf(operands, "r%d, %i(r%d)", &rS, &offset, &rA) == 3 ||
-            sscanf(operands, "r%d,%i(r%d)", &rS, &offset, &rA) == 3) {
-            // Check if rA contains a known address (from lis/addi)
-            if (tracker && tracker->r_known[rA]) {
-                uint32_t base_addr = tracker->r[rA];
-                uint32_t store_addr = base_addr + offset;
-                
-                // Generate code with literal address (for transpiler resolution)
-                // Note: stwu updates rA, so we need to update the tracker too
-                if (offset >= 0) {
-                    snprintf(output, output_size, "r%u = r%u + 0x%x; *(uint32_t*)(uintptr_t)0x%08X = r%u;", 
-                            rA, rA, (uint16_t)offset, store_addr, rS);
-                } else {
-                    snprintf(output, output_size, "r%u = r%u - 0x%x; *(uint32_t*)(uintptr_t)0x%08X = r%u;", 
-                            rA, rA, (uint16_t)(-offset), store_addr, rS);
-                }
-                snprintf(comment, comment_size, "stwu r%u, %i(r%u) [resolved: 0x%08X]", rS, offset, rA, store_addr);
-                
-                // Update tracker with new rA value
-                register_tracker_set(tracker, rA, store_addr);
-                return true;
-            } else {
-                // Base register unknown or runtime address - use translate_address()
-                // Fall through to opcode transpile function which will use translate_address()
-            }
+        if ((sscanf(operands, "r%d, %i(r%d)", &rS, &offset, &rA) == 3 ||
+             sscanf(operands, "r%d,%i(r%d)", &rS, &offset, &rA) == 3) &&
+            rewrite_stwu(rS, offset, rA, output, output_size, comment, comment_size, tracker)) {
+            return true;
         }
     }
     
@@ -791,100 +1163,24 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
         }
     }
     
-    // Track mflr (move from link register) - copies LR to a register
-    if (strcmp(mnemonic, "mflr") == 0) {
+    // Track mflr/mfctr (move from link/count register)
+    if (strcmp(mnemonic, "mflr") == 0 || strcmp(mnemonic, "mfctr") == 0) {
         int reg;
         if (sscanf(operands, "r%d", &reg) == 1) {
-            if (tracker && tracker->lr_known) {
-                register_tracker_set(tracker, reg, tracker->lr);
-            } else if (tracker) {
-                register_tracker_clear(tracker, reg);
-            }
-        }
-    }
-    
-    // Track mfctr (move from count register) - copies CTR to a register
-    if (strcmp(mnemonic, "mfctr") == 0) {
-        int reg;
-        if (sscanf(operands, "r%d", &reg) == 1) {
-            if (tracker && tracker->ctr_known) {
-                register_tracker_set(tracker, reg, tracker->ctr);
-            } else if (tracker) {
-                register_tracker_clear(tracker, reg);
-            }
+            track_move_from_spr(reg, mnemonic[2] == 'c', tracker);
         }
     }
     
     // Handle blr (branch to link register = return)
     if (strcmp(mnemonic, "blr") == 0) {
-        if (func_context && func_context->returns_value) {
-            snprintf(output, output_size, "return r3;");
-        } else {
-            snprintf(output, output_size, "return;");
-        }
-        snprintf(comment, comment_size, "blr");
-        return true;
-    }
-    
-    // Handle blrl (branch to link register and link)
-    if (strcmp(mnemonic, "blrl") == 0) {
-        uint32_t return_addr = address + 4;
-        uint32_t func_addr = 0;
-        const char *func_name = NULL;
-        
-        // Check if LR contains a known function address
-        if (tracker) {
-            func_addr = register_tracker_get_lr(tracker);
-            if (func_addr != 0) {
-                func_name = lookup_function_by_address(func_addr);
-            }
-        }
-        
-        if (func_name) {
-            // Replace with direct function call!
-            snprintf(output, output_size,
-                    "{ lr = 0x%08X; %s(r3, r4, r5, r6, r7, r8, r9, r10, f1, f2); }",
-                    return_addr, func_name);
-            snprintf(comment, comment_size, "blrl - replaced with direct call to %s (0x%08X)", func_name, func_addr);
-        } else {
-            // Fallback to runtime resolution
-            snprintf(output, output_size, 
-                    "{ uintptr_t saved_lr = lr; lr = 0x%08X; "
-                    "call_function_by_address((uint32_t)saved_lr, r3, r4, r5, r6, r7, r8, r9, r10, f1, f2); }",
-                    return_addr);
-            snprintf(comment, comment_size, "blrl - indirect call via lr (address unknown at compile time)");
-        }
+        transpile_return(func_context, output, output_size, comment, comment_size);
         return true;
     }
     
-    // Handle bctrl (branch to count register and link)
-    if (strcmp(mnemonic, "bctrl") == 0) {
-        uint32_t return_addr = address + 4;
-        uint32_t func_addr = 0;
-        const char *func_name = NULL;
-        
-        // Check if CTR contains a known function address
-        if (tracker) {
-            func_addr = register_tracker_get_ctr(tracker);
-            if (func_addr != 0) {
-                func_name = lookup_function_by_address(func_addr);
-            }
-        }
-        
-        if (func_name) {
-            // Replace with direct function call!
-            snprintf(output, output_size,
-                    "{ lr = 0x%08X; %s(r3, r4, r5, r6, r7, r8, r9, r10, f1, f2); }",
-                    return_addr, func_name);
-            snprintf(comment, comment_size, "bctrl - replaced with direct call to %s (0x%08X)", func_name, func_addr);
-        } else {
-            // Fallback to runtime resolution
-            snprintf(output, output_size,
-                    "{ uintptr_t saved_ctr = ctr; lr = 0x%08X; "
-                    "call_function_by_address((uint32_t)saved_ctr, r3, r4, r5, r6, r7, r8, r9, r10, f1, f2); }",
-                    return_addr);
-            snprintf(comment, comment_size, "bctrl - indirect call via ctr (address unknown at compile time)");
-        }
+    // Handle blrl/bctrl (branch to link/count register and link)
+    if (strcmp(mnemonic, "blrl") == 0 || strcmp(mnemonic, "bctrl") == 0) {
+        transpile_indirect_call(mnemonic[1] == 'c', address, output, output_size,
+                                                comment, comment_size, tracker);
         return true;
     }
     
@@ -929,7 +1225,7 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
     
     // Handle bctrl (branch to count register and link)
     if (strcmp(mnemonic, "bctrl") == 0) {
-        snprintf(output, output_size, "lr = 0x%08X; ((void (*)(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double))ctr)(r3, r4, r5, r6, r7, r8, r9, r10, f1, f2);", address + 4);
+        snprintf(output, output_size, "lr = 0x%08X; ((%s)ctr)(%s);", address + 4, game_func_ptr_type(), game_call_args());
         snprintf(comment, comment_size, "bctrl - indirect call via ctr");
         return true;
     }
@@ -958,7 +1254,7 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
             uint32_t addr;
             sscanf(target, "%x", &addr);
             if (strcmp(mnemonic, "bla") == 0 || strcmp(mnemonic, "bl") == 0) {
-                snprintf(output, output_size, "lr = 0x%08X; ((void (*)(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double))0x%08X)(r3, r4, r5, r6, r7, r8, r9, r10, f1, f2);  /* call absolute */", address + 4, addr);
+                snprintf(output, output_size, "lr = 0x%08X; ((%s)0x%08X)(%s);  /* call absolute */", address + 4, game_func_ptr_type(), addr, game_call_args());
             } else {
                 snprintf(output, output_size, "pc = 0x%08X;  /* branch absolute */", addr);
             }
@@ -998,8 +1294,8 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
                 sscanf(underscore + 1, "%x", &target_addr);
                 
                 // Check if this address is in the current function's label map
-                if (label_map && func_context && target_addr != 0) {
-                    const char *mapped_func = labelmap_find_function(label_map, target_addr);
+                if (func_context && target_addr != 0) {
+                    const char *mapped_func = find_containing_function(label_map, target_addr);
                     if (mapped_func && strcmp(mapped_func, func_context->name) == 0) {
                         is_local_label = true;
                     }
@@ -1015,161 +1311,9 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
                 }
             } else {
                 // It's a function name (external or other file)
-                // Both b and bl should be function calls for external symbols
-                // IMPORTANT: We MUST sanitize reserved names when calling them too,
-                // because the function was defined with a sanitized name (e.g., main -> main_impl)
-                // This ensures calls to reserved names match the renamed definitions.
-                
-                // Sanitize the function name to get the actual C function name
-                char sanitized_target[MAX_FUNCTION_NAME];
-                static char stub_name[256];  // Static so it persists after function returns
-                const char *actual_target;
-                
-                // Special case: __va_arg -> ppc_va_arg (to avoid MSVC intrinsic conflict)
-                if (strcmp(target, "__va_arg") == 0) {
-                    actual_target = "ppc_va_arg";
-                }
-                // Handle C++ template names, @unnamed@ patterns, and extremely long mangled names
-                // These contain '<', '>', ',', '@' or are very long
-                else if (strlen(target) > 80 || strchr(target, '<') != NULL || 
-                         strchr(target, '>') != NULL || strchr(target, ',') != NULL ||
-                         strchr(target, '@') != NULL) {
-                    // Check if this is a C++ standard library call that should be ignored
-                    if (config.ignore_cstd_calls && is_cstd_call(target)) {
-                        // Generate a comment instead of a function call
-                        if (strcmp(mnemonic, "bl") == 0 || strcmp(mnemonic, "bla") == 0) {
-                            snprintf(output, output_size, "/* C++ std call ignored: %s */", target);
-                        } else {
-                            snprintf(output, output_size, "/* C++ std branch ignored: %s */", target);
-                        }
-                        snprintf(comment, comment_size, "%s %s (C++ std call - ignored)", mnemonic, target);
-                        return true;
-                    }
-                    
-                    // Create a shorter stub name based on hash
-                    unsigned int hash = 0;
-                    for (const char *p = target; *p; p++) {
-                        hash = hash * 31 + (unsigned char)*p;
-                    }
-                    snprintf(stub_name, sizeof(stub_name), "cpp_stub_func_%08x", hash);
-                    actual_target = stub_name;
-                } else {
-                    // Normal function name - check if it should be ignored first
-                    if (config.ignore_cstd_calls && is_cstd_call(target)) {
-                        // Generate a comment instead of a function call
-                        if (strcmp(mnemonic, "bl") == 0 || strcmp(mnemonic, "bla") == 0) {
-                            snprintf(output, output_size, "/* C++ std call ignored: %s */", target);
-                        } else {
-                            snprintf(output, output_size, "/* C++ std branch ignored: %s */", target);
-                        }
-                        snprintf(comment, comment_size, "%s %s (C++ std call - ignored)", mnemonic, target);
-                        return true;
-                    }
-                    // Sanitize it (handles reserved names like main -> main_impl)
-                    sanitize_function_name(target, sanitized_target, sizeof(sanitized_target));
-                    actual_target = sanitized_target;
-                }
-                
-                // Check if this is an SDK function
-                const SDK_Function_Info *sdk_info = get_sdk_function_info(actual_target);
-                
-                char params[512];
-                bool is_sdk_func = (sdk_info != NULL);
-                
-                if (is_sdk_func) {
-                    // SDK function - generate typed parameters (or empty if no params)
-                    if (sdk_info->num_params > 0) {
-                        const char *int_regs[] = {"r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10"};
-                        const char *float_regs[] = {"f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8"};
-                        
-                        char *p = params;
-                        size_t remaining = sizeof(params);
-                        int int_reg_idx = 0;
-                        int float_reg_idx = 0;
-                        
-                        for (int i = 0; i < sdk_info->num_params && i < 10; i++) {
-                            if (i > 0) {
-                                int written = snprintf(p, remaining, ", ");
-                                p += written;
-                                remaining -= written;
-                            }
-                            
-                            switch (sdk_info->param_types[i]) {
-                                case SDK_PARAM_PTR:
-                                    if (int_reg_idx < 8) {
-                                        int written = snprintf(p, remaining, "(void*)%s", int_regs[int_reg_idx++]);
-                                        p += written;
-                                        remaining -= written;
-                                    }
-                                    break;
-                                case SDK_PARAM_INT:
-                                    if (int_reg_idx < 8) {
-                                        int written = snprintf(p, remaining, "(int)%s", int_regs[int_reg_idx++]);
-                                        p += written;
-                                        remaining -= written;
-                                    }
-                                    break;
-                                case SDK_PARAM_FLOAT:
-                                    if (float_reg_idx < 8) {
-                                        int written = snprintf(p, remaining, "(float)%s", float_regs[float_reg_idx++]);
-                                        p += written;
-                                        remaining -= written;
-                                    }
-                                    break;
-                                case SDK_PARAM_DOUBLE:
-                                    if (float_reg_idx < 8) {
-                                        int written = snprintf(p, remaining, "%s", float_regs[float_reg_idx++]);
-                                        p += written;
-                                        remaining -= written;
-                                    }
-                                    break;
-                            }
-                        }
-                    } else {
-                        // SDK function with no parameters - empty parameter list
-                        params[0] = '\0';
-                    }
-                } else {
-                    // Game function - use standard 10-parameter convention
-                    snprintf(params, sizeof(params), "r3, r4, r5, r6, r7, r8, r9, r10, f1, f2");
-                }
-                
-                // Check if this SDK function returns a value (functions that return pointers or ints)
-                // For now, we'll assume SDK functions with names starting with "OSGet" return values
-                bool returns_value = false;
-                if (is_sdk_func && (strncmp(actual_target, "OSGet", 5) == 0 || 
-                                    strncmp(actual_target, "OSIs", 4) == 0 ||
-                                    strncmp(actual_target, "OSCreate", 8) == 0 ||
-                                    strncmp(actual_target, "OSAlloc", 7) == 0 ||
-                                    strncmp(actual_target, "OSGetCurrent", 12) == 0 ||
-                                    strncmp(actual_target, "OSGetThread", 11) == 0)) {
-                    returns_value = true;
-                }
-                
-                if (strcmp(mnemonic, "bl") == 0 || strcmp(mnemonic, "bla") == 0) {
-                    if (is_sdk_func && returns_value) {
-                        // SDK function that returns a value - capture return in r3
-                        if (sdk_info->num_params > 0) {
-                            snprintf(output, output_size, "r3 = (uintptr_t)%s(%s);", actual_target, params);
-                        } else {
-                            snprintf(output, output_size, "r3 = (uintptr_t)%s();", actual_target);
-                        }
-                    } else {
-                        // SDK function with no return, or game function
-                        if (is_sdk_func && sdk_info->num_params == 0) {
-                            snprintf(output, output_size, "%s();", actual_target);
-                        } else {
-                            snprintf(output, output_size, "%s(%s);", actual_target, params);
-                        }
-                    }
-                } else {
-                    // Tail call optimization (branch without link)
-                    if (is_sdk_func && sdk_info->num_params == 0) {
-                        snprintf(output, output_size, "return %s();  /* Tail call */", actual_target);
-                    } else {
-                        snprintf(output, output_size, "return %s(%s);  /* Tail call */", actual_target, params);
-                    }
-                }
+                transpile_named_call(mnemonic, target, strcmp(mnemonic, "bl") == 0 || strcmp(mnemonic, "bla") == 0,
+                                     output, output_size, comment, comment_size);
+                return true;
             }
         }
         snprintf(comment, comment_size, "%s %s", mnemonic, target);
@@ -1247,8 +1391,8 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
                 sscanf(underscore + 1, "%x", &target_addr);
                 
                 // Check if this address is in the current function's label map
-                if (label_map && func_context && target_addr != 0) {
-                    const char *mapped_func = labelmap_find_function(label_map, target_addr);
+                if (func_context && target_addr != 0) {
+                    const char *mapped_func = find_containing_function(label_map, target_addr);
                     if (mapped_func && strcmp(mapped_func, func_context->name) == 0) {
                         is_local_label = true;
                     }
@@ -1313,7 +1457,7 @@ bool transpile_from_asm(const char *mnemonic, const char *operands, uint32_t add
                     written += snprintf(output + written, output_size - written, "if (1 /* unknown condition: %s */) {\n        ", clean_mnemonic);
                 }
                 
-                written += snprintf(output + written, output_size - written, "%s(r3, r4, r5, r6, r7, r8, r9, r10, f1, f2);\n    }", target);
+                written += snprintf(output + written, output_size - written, "%s(%s);\n    }", target, game_call_args());
             }
         }
         snprintf(comment, comment_size, "%s %s", mnemonic, operands);
@@ -2756,11 +2900,14 @@ bool transpile_instruction(uint32_t instruction, uint32_t address,
 int transpile_file(const char *input_filename, SkipList *skip_list) {
     printf("Processing: %s\n", input_filename);
     
-    // Build label-to-function map for trampoline resolution
-    LabelMap *label_map = build_label_map(input_filename);
+    // Build label-to-function map for trampoline resolution (not needed with a symbol map)
+    Stats_Phase phase = stats_enter(STATS_LABEL_MAP);
+    LabelMap *label_map = symbol_index.functions.count ? NULL : build_label_map(input_filename);
     
     // Build string table for string literal tracking
+    stats_enter(STATS_STRING_TABLE);
     StringTable *string_table = build_string_table(input_filename);
+    stats_leave(phase);
     
     // Generate output filenames
     char output_c[256], output_h[256];
@@ -2855,8 +3002,8 @@ int transpile_file(const char *input_filename, SkipList *skip_list) {
             // .endfn marks end of function
             if (strstr(line, ".endfn") != NULL && in_function) {
                 // Add trampoline fix instructions if detected
-                if (current_func.is_trampoline && label_map) {
-                    const char *target_func = labelmap_find_function(label_map, current_func.trampoline_target);
+                if (current_func.is_trampoline) {
+                    const char *target_func = find_containing_function(label_map, current_func.trampoline_target);
                     fprintf(c_file, "    /* TRAMPOLINE DETECTED - Cross-function jump to 0x%08X\n", 
                            current_func.trampoline_target);
                     fprintf(c_file, "     * Auto-fix: Replace the goto above with:\n");
@@ -2921,10 +3068,12 @@ int transpile_file(const char *input_filename, SkipList *skip_list) {
             
             // All functions accept all potential parameters (r3-r10, f1-f2) for simplicity
             // This avoids the need to scan ahead in the file which can hang
+            // With the register calling convention they take none: arguments stay in the globals
             if (!current_func.skip) {
-                current_func.has_params = true;
-                current_func.num_int_params = 8;  // r3-r10
-                current_func.num_float_params = 2; // f1-f2
+                bool pass_params = !config.register_calling_convention;
+                current_func.has_params = pass_params;
+                current_func.num_int_params = pass_params ? 8 : 0;   // r3-r10
+                current_func.num_float_params = pass_params ? 2 : 0; // f1-f2
                 current_func.returns_value = false; // Default to void, will be detected later
             }
             
@@ -3125,16 +3274,556 @@ int transpile_file(const char *input_filename, SkipList *skip_list) {
     return 0;
 }
 
+/**
+ * @brief True if a function is left out of the output entirely (skip list, SDK, gap)
+ */
+static bool ir_function_skipped(const IR_Function *fn, SkipList *skip_list) {
+    const char *name = ir_text(&program_ir, fn->name);
+    return strncmp(name, "gap_", 4) == 0 || skiplist_should_skip(skip_list, name) ||
+           is_sdk_or_stdlib_function(name);
+}
+
+/**
+ * @brief Fold identical function bodies in the program IR
+ * Only functions emitted with a full body take part; a shared body must be callable
+ * from every file that forwards to it (declared in a header) or live in the same file.
+ */
+static int fold_identical_functions(SkipList *skip_list) {
+    uint8_t *candidates = (uint8_t*)calloc(program_ir.function_count + 1, 1);
+    if (!candidates) return 0;
+    bool dead_dropped = strcmp(config.dead_functions, "keep") != 0;
+    for (uint32_t f = 0; f < program_ir.function_count; f++) {
+        const IR_Function *fn = &program_ir.functions[f];
+        const char *name = ir_text(&program_ir, fn->name);
+        if (ir_function_skipped(fn, skip_list) || !binary_is_c_identifier(name) ||
+            strcmp(name, "__init_registers") == 0 ||
+            (dead_dropped && (fn->flags & IR_FUNCTION_UNREACHABLE))) {
+            continue;
+        }
+        bool exported = !(fn->flags & IR_FUNCTION_LOCAL) && !is_sdk_prefixed_name(name);
+        // A forwarder calls its shared body directly, which must not cross a reloadable module
+        candidates[f] = exported && !config.shared_modules ? IR_FOLD_GLOBAL : IR_FOLD_FILE;
+    }
+    int folded = ir_fold_identical(&program_ir, candidates);
+    free(candidates);
+    return folded;
+}
+
+/**
+ * @brief Pick the small leaf functions whose bodies are emitted at their call sites
+ * The callee keeps its own definition: it can still be reached through pointers.
+ */
+static int inline_leaf_functions(SkipList *skip_list) {
+    uint8_t *candidates = (uint8_t*)calloc(program_ir.function_count + 1, 1);
+    if (!candidates) return 0;
+    bool dead_dropped = strcmp(config.dead_functions, "keep") != 0;
+    for (uint32_t f = 0; f < program_ir.function_count; f++) {
+        const IR_Function *fn = &program_ir.functions[f];
+        if (ir_function_skipped(fn, skip_list) || fn->canonical != IR_NONE ||
+            (dead_dropped && (fn->flags & IR_FUNCTION_UNREACHABLE))) {
+            continue;
+        }
+        candidates[f] = 1;
+    }
+    int inlined = ir_mark_inline_leaves(&program_ir, candidates, config.inline_max_instructions);
+    free(candidates);
+    return inlined;
+}
+
+/**
+ * @brief Turn private stack slots into C locals (see ir_frame.h)
+ */
+static void promote_frame_slots(SkipList *skip_list) {
+    uint8_t *candidates = (uint8_t*)calloc(program_ir.function_count + 1, 1);
+    if (!candidates) return;
+    for (uint32_t f = 0; f < program_ir.function_count; f++) {
+        candidates[f] = !ir_function_skipped(&program_ir.functions[f], skip_list);
+    }
+    int accesses, elided;
+    int functions = ir_promote_frames(&program_ir, candidates, &accesses, &elided);
+    printf("Frame promotion: %d stack accesses in %d functions use C locals, %d frames removed\n",
+           accesses, functions, elided);
+    free(candidates);
+}
+
+//==============================================================================
+// PER-FILE INCLUDES
+//==============================================================================
+
+// C name of every emitted function and the file defining it, sorted by name
+typedef struct {
+    char name[256];             // As large as the sanitize buffer, so long names still match
+    uint32_t file;
+    uint32_t address;
+    bool local;
+} Emitted_Name;
+
+static Emitted_Name *emitted_names = NULL;
+static uint32_t emitted_name_count = 0;
+static const char *program_input_dir = "";
+
+// Shared modules: one per top-level input directory (shared_modules mode only)
+static uint32_t *file_modules = NULL;           // Per IR file: module index, IR_NONE for the executable
+static char **module_dirs = NULL;               // Directory of each module
+static char **module_names = NULL;              // Identifier form, as in porpoise_register_<name>
+static uint32_t module_count = 0;
+
+static int emitted_name_compare(const void *a, const void *b) {
+    const Emitted_Name *x = (const Emitted_Name*)a, *y = (const Emitted_Name*)b;
+    int c = strcmp(x->name, y->name);
+    if (c != 0) return c;
+    return x->file < y->file ? -1 : x->file > y->file;
+}
+
+/**
+ * @brief Index the C names of the functions that get a definition, so each file
+ *        can include just the headers of the files it calls into
+ */
+static void build_emitted_names(SkipList *skip_list) {
+    free(emitted_names);
+    emitted_name_count = 0;
+    emitted_names = (Emitted_Name*)malloc(sizeof(Emitted_Name) * (program_ir.function_count + 1));
+    if (!emitted_names) return;
+
+    bool omit_dead = strcmp(config.dead_functions, "omit") == 0;
+    for (uint32_t f = 0; f < program_ir.function_count; f++) {
+        const IR_Function *fn = &program_ir.functions[f];
+        if (ir_function_skipped(fn, skip_list) || fn->start_address == 0) continue;
+        if (omit_dead && (fn->flags & IR_FUNCTION_UNREACHABLE)) continue;
+
+        Emitted_Name *entry = &emitted_names[emitted_name_count++];
+        char sanitized[sizeof(entry->name)];
+        snprintf(entry->name, sizeof(entry->name), "%s",
+                 sanitize_function_name(ir_text(&program_ir, fn->name), sanitized, sizeof(sanitized)));
+        entry->file = fn->file;
+        entry->address = fn->start_address;
+        entry->local = (fn->flags & IR_FUNCTION_LOCAL) != 0;
+    }
+    qsort(emitted_names, emitted_name_count, sizeof(Emitted_Name), emitted_name_compare);
+}
+
+/**
+ * @brief Project header of an IR file (its path under the input directory, .s -> .h)
+ */
+static void ir_file_header(uint32_t file, char *output, size_t output_size) {
+    const char *path = ir_text(&program_ir, program_ir.files[file].path);
+    size_t root = strlen(program_input_dir);
+    if (strncmp(path, program_input_dir, root) == 0 && path[root] == '/') path += root + 1;
+
+    snprintf(output, output_size, "%s", path);
+    char *ext = strrchr(output, '.');
+    if (ext && strchr(ext, '/') == NULL) snprintf(ext, output_size - (size_t)(ext - output), ".h");
+}
+
+/**
+ * @brief Definition a call by name from a file binds to
+ * @return NULL when the name is defined in the file itself or is not an emitted function
+ */
+static const Emitted_Name* find_emitted_name(const char *name, size_t length, uint32_t file) {
+    Emitted_Name key;
+    if (length >= sizeof(key.name)) return NULL;
+    memcpy(key.name, name, length);
+    key.name[length] = '\0';
+    key.file = 0;
+    
+    // First entry with this name, then pick a definition (global preferred)
+    uint32_t lo = 0, hi = emitted_name_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (emitted_name_compare(&emitted_names[mid], &key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    const Emitted_Name *found = NULL;
+    for (uint32_t e = lo; e < emitted_name_count && strcmp(emitted_names[e].name, key.name) == 0; e++) {
+        if (emitted_names[e].file == file) return NULL;
+        if (!found || (found->local && !emitted_names[e].local)) found = &emitted_names[e];
+    }
+    return found;
+}
+
+/**
+ * @brief Definition an instruction calls by name, from its IR call edge
+ * Direct and conditional branches to a function, and blrl/bctrl whose target the
+ * register tracker knows (transpile_indirect_call emits those as direct calls).
+ * Must run before the instruction is transpiled, while the tracker still holds LR/CTR.
+ * @return NULL for calls within the file and for anything not called by name
+ */
+static const Emitted_Name* emitted_callee(const IR_Function *fn, const IR_Instruction *insn,
+                                          RegisterTracker *tracker, uint32_t file) {
+    const char *name = NULL;
+    char sanitized[sizeof(emitted_names[0].name)];
+    uint32_t callee = ir_call_target(&program_ir, fn, insn);
+    if (callee != IR_NONE) {
+        name = sanitize_function_name(ir_text(&program_ir, program_ir.functions[callee].name),
+                                      sanitized, sizeof(sanitized));
+    } else if ((insn->flags & IR_INSN_INDIRECT) && (insn->flags & IR_INSN_LINK)) {
+        bool via_ctr = ((insn->word >> 1) & 0x3FF) == 528;
+        name = lookup_function_by_address(via_ctr ? register_tracker_get_ctr(tracker)
+                                                  : register_tracker_get_lr(tracker));
+    }
+    return name ? find_emitted_name(name, strlen(name), file) : NULL;
+}
+
+static int module_dir_compare(const void *a, const void *b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+/**
+ * @brief Assign every IR file to the shared module of its top-level directory
+ * Files directly in the input directory stay in the executable.
+ */
+static void assign_modules(void) {
+    file_modules = (uint32_t*)malloc(sizeof(uint32_t) * (program_ir.file_count + 1));
+    module_dirs = (char**)calloc(program_ir.file_count + 1, sizeof(char*));
+    module_names = (char**)calloc(program_ir.file_count + 1, sizeof(char*));
+    if (!file_modules || !module_dirs || !module_names) {
+        free(file_modules); free(module_dirs); free(module_names);
+        file_modules = NULL;
+        return;
+    }
+    
+    // Distinct top-level directories
+    for (uint32_t i = 0; i < program_ir.file_count; i++) {
+        char header[512];
+        ir_file_header(i, header, sizeof(header));
+        char *slash = strchr(header, '/');
+        if (!slash) continue;
+        *slash = '\0';
+        
+        uint32_t m = 0;
+        while (m < module_count && strcmp(module_dirs[m], header) != 0) m++;
+        if (m == module_count && (module_dirs[m] = strdup(header)) != NULL) module_count++;
+    }
+    
+    // Number modules by name so the module table does not depend on directory read order
+    qsort(module_dirs, module_count, sizeof(char*), module_dir_compare);
+    for (uint32_t m = 0; m < module_count; m++) {
+        module_names[m] = strdup(module_dirs[m]);
+        for (char *c = module_names[m]; c && *c; c++) {
+            if (!isalnum((unsigned char)*c)) *c = '_';
+        }
+    }
+    
+    for (uint32_t i = 0; i < program_ir.file_count; i++) {
+        char header[512];
+        ir_file_header(i, header, sizeof(header));
+        char *slash = strchr(header, '/');
+        file_modules[i] = IR_NONE;
+        if (!slash) continue;
+        *slash = '\0';
+        
+        const char *key = header;
+        char **found = (char**)bsearch(&key, module_dirs, module_count, sizeof(char*), module_dir_compare);
+        if (found && module_names[found - module_dirs]) file_modules[i] = (uint32_t)(found - module_dirs);
+    }
+}
+
+/**
+ * @brief True if two files are linked into the same binary (always, without shared_modules)
+ */
+static bool same_module(uint32_t file_a, uint32_t file_b) {
+    return !file_modules || file_modules[file_a] == file_modules[file_b];
+}
+
+/**
+ * @brief Send a direct call into another module through the function address map
+ * A reloaded module re-registers its functions, so only calls made through the
+ * map reach the new code. Only the call itself (`name(`) is rewritten.
+ * @return false if the rewritten line does not fit in c_code
+ */
+static bool route_cross_module_call(char *c_code, size_t c_code_size, const Emitted_Name *callee) {
+    size_t length = strlen(callee->name);
+    for (char *p = c_code; (p = strstr(p, callee->name)) != NULL; p += length) {
+        if (p[length] != '(' || (p > c_code && (isalnum((unsigned char)p[-1]) || p[-1] == '_'))) continue;
+        
+        char call[64];
+        snprintf(call, sizeof(call), "call_function_by_address(0x%08X%s",
+                 callee->address, p[length + 1] == ')' ? "" : ", ");
+        size_t call_length = strlen(call), rest = strlen(p + length + 1);
+        if ((size_t)(p - c_code) + call_length + rest + 1 > c_code_size) return false;
+        memmove(p + call_length, p + length + 1, rest + 1);
+        memcpy(p, call, call_length);
+        return true;
+    }
+    return true;
+}
+
+//==============================================================================
+// UNITY BUILD
+//==============================================================================
+
+static int unity_compare_path(const void *a, const void *b) {
+    return strcmp(((const Unity_Source*)a)->path, ((const Unity_Source*)b)->path);
+}
+
+/**
+ * @brief Group the generated sources into unity shards (see unity_build.h)
+ * @return Number of shards (0 when unity mode is off)
+ */
+static int write_unity_shards(const char *src_dir, char **c_files, int file_count, SkipList *skip_list) {
+    int shard_count = config.unity_shards < file_count ? config.unity_shards : file_count;
+    if (shard_count > 0 && config.shared_modules) {
+        printf("Unity build: off (shared_modules builds each module on its own)\n");
+        shard_count = 0;
+    }
+    if (shard_count <= 0 || program_ir.file_count == 0) {
+        unity_write_shards(src_dir, NULL, 0, 0);
+        return 0;
+    }
+    
+    // Instruction count and static functions of each IR file, by generated source path
+    Unity_Source *by_path = (Unity_Source*)calloc(program_ir.file_count, sizeof(Unity_Source));
+    Unity_Source *sources = (Unity_Source*)calloc(file_count, sizeof(Unity_Source));
+    if (!by_path || !sources) {
+        free(by_path);
+        free(sources);
+        return 0;
+    }
+    bool omit_dead = strcmp(config.dead_functions, "omit") == 0;
+    for (uint32_t i = 0; i < program_ir.file_count; i++) {
+        const IR_File *file = &program_ir.files[i];
+        char path[512];
+        ir_file_header(i, path, sizeof(path));
+        path[strlen(path) - 1] = 'c';
+        by_path[i].path = strdup(path);
+        by_path[i].locals = (char**)malloc(sizeof(char*) * (file->function_count + 1));
+        
+        for (uint32_t f = file->first_function; f < file->first_function + file->function_count; f++) {
+            const IR_Function *fn = &program_ir.functions[f];
+            if (ir_function_skipped(fn, skip_list)) continue;
+            if (omit_dead && (fn->flags & IR_FUNCTION_UNREACHABLE)) continue;
+            by_path[i].weight += fn->instruction_count;
+            
+            const char *name = ir_text(&program_ir, fn->name);
+            if (!(fn->flags & IR_FUNCTION_LOCAL) || !by_path[i].locals ||
+                strcmp(name, "__init_registers") == 0) {
+                continue;
+            }
+            char sanitized[256];
+            by_path[i].locals[by_path[i].local_count++] = strdup(sanitize_function_name(name, sanitized, sizeof(sanitized)));
+        }
+    }
+    qsort(by_path, program_ir.file_count, sizeof(Unity_Source), unity_compare_path);
+    
+    for (int i = 0; i < file_count; i++) {
+        Unity_Source key = { .path = c_files[i] };
+        const Unity_Source *found = (const Unity_Source*)bsearch(&key, by_path, program_ir.file_count,
+                                                                 sizeof(Unity_Source), unity_compare_path);
+        sources[i] = found ? *found : key;
+        sources[i].path = c_files[i];
+    }
+    
+    char unity_dir[512];
+    snprintf(unity_dir, sizeof(unity_dir), "%s/%s", src_dir, UNITY_DIR);
+    create_directory(unity_dir);
+    unity_assign_shards(sources, file_count, shard_count);
+    int rewritten = unity_write_shards(src_dir, sources, file_count, shard_count);
+    printf("Unity build: %d sources in %d shards (%d rewritten)\n", file_count, shard_count, rewritten);
+    
+    for (uint32_t i = 0; i < program_ir.file_count; i++) {
+        for (int l = 0; l < by_path[i].local_count; l++) free(by_path[i].locals[l]);
+        free(by_path[i].locals);
+        free((char*)by_path[i].path);
+    }
+    free(by_path);
+    free(sources);
+    return shard_count;
+}
+
+//==============================================================================
+// SHARED MODULES
+//==============================================================================
+
+/**
+ * @brief Write each module's registration function and the executable's module table
+ * Adds <dir>/porpoise_module.c to the transpiled sources of each module.
+ */
+static void write_module_sources(const char *src_dir, char **c_files, int *file_count, int max_files) {
+    if (!file_modules) return;
+    
+    for (uint32_t m = 0; m < module_count; m++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s/porpoise_module.c", src_dir, module_dirs[m]);
+        FILE *f = fopen(path, "w");
+        if (!f) {
+            fprintf(stderr, "Error: Cannot create %s\n", path);
+            continue;
+        }
+        fprintf(f, "/**\n");
+        fprintf(f, " * @file porpoise_module.c\n");
+        fprintf(f, " * @brief Function registrations of module %s\n", module_dirs[m]);
+        fprintf(f, " * Called again from a freshly loaded copy on hot reload.\n");
+        fprintf(f, " */\n\n");
+        fprintf(f, "#include \"function_address_map.h\"\n");
+        fprintf(f, "#include \"all_functions.h\"\n\n");
+        fprintf(f, "void porpoise_register_%s(void) {\n", module_names[m]);
+        for (int i = 0; i < function_registry_count; i++) {
+            const FunctionRegistryEntry *entry = &function_registry[i];
+            if (entry->module == m && registry_entry_valid(entry)) {
+                fprintf(f, "    function_address_map_register(0x%08X, (TranspiledFunctionPtr)%s, \"%s\");\n",
+                        entry->gc_address, entry->name, entry->name);
+            }
+        }
+        fprintf(f, "}\n");
+        fclose(f);
+        
+        if (*file_count < max_files) {
+            snprintf(path, sizeof(path), "%s/porpoise_module.c", module_dirs[m]);
+            c_files[(*file_count)++] = strdup(path);
+        }
+    }
+    
+    char table_path[512];
+    snprintf(table_path, sizeof(table_path), "%s/porpoise_modules.c", src_dir);
+    FILE *f = fopen(table_path, "w");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot create %s\n", table_path);
+        return;
+    }
+    fprintf(f, "/**\n");
+    fprintf(f, " * @file porpoise_modules.c\n");
+    fprintf(f, " * @brief Modules linked into the executable (one per top-level input directory)\n");
+    fprintf(f, " */\n\n");
+    fprintf(f, "#include \"module_reload.h\"\n\n");
+    for (uint32_t m = 0; m < module_count; m++) {
+        fprintf(f, "void porpoise_register_%s(void);\n", module_names[m]);
+    }
+    fprintf(f, "\nconst Porpoise_Module porpoise_modules[] = {\n");
+    for (uint32_t m = 0; m < module_count; m++) {
+        fprintf(f, "    { \"%s\", porpoise_register_%s },\n", module_names[m], module_names[m]);
+    }
+    fprintf(f, "    { 0, 0 }\n");
+    fprintf(f, "};\n\n");
+    fprintf(f, "const int porpoise_module_count = %u;\n", module_count);
+    fclose(f);
+    printf("Shared modules: %u modules, registration sources written\n", module_count);
+}
+
+static const char* frame_slot_type(const IR_Frame_Access *access) {
+    if (access->kind == IR_FRAME_SINGLE) return "float";
+    if (access->kind == IR_FRAME_DOUBLE) return "double";
+    return access->width == 1 ? "uint8_t" : access->width == 2 ? "uint16_t" : "uint32_t";
+}
+
+/**
+ * @brief Declare one local per promoted slot at the top of the function body
+ */
+static void write_frame_locals(FILE *body, const IR_Frame *frame) {
+    bool any = false;
+    for (uint32_t a = 0; a < frame->access_count; a++) {
+        const IR_Frame_Access *access = &frame->accesses[a];
+        if (!access->promoted || !access->store) continue;
+        for (uint8_t k = 0; k < access->count; k++) {
+            int32_t offset = access->offset + k * access->width;
+            bool declared = false;
+            for (uint32_t b = 0; b < a && !declared; b++) {
+                const IR_Frame_Access *earlier = &frame->accesses[b];
+                if (!earlier->promoted || !earlier->store) continue;
+                declared = offset >= earlier->offset && offset < earlier->offset + earlier->width * earlier->count;
+            }
+            if (declared) continue;
+            if (!any) fprintf(body, "    // Stack slots that never escape the frame\n");
+            fprintf(body, "    %s frame_%X = 0;  // r1 + 0x%X\n", frame_slot_type(access), offset, offset);
+            any = true;
+        }
+    }
+    if (any) fprintf(body, "\n");
+}
+
+/**
+ * @brief C for a promoted load or store (one statement per register for lmw/stmw)
+ */
+static void frame_slot_code(const IR_Frame_Access *access, char *output, size_t output_size) {
+    size_t len = 0;
+    output[0] = '\0';
+    for (uint8_t k = 0; k < access->count && len < output_size; k++) {
+        int32_t offset = access->offset + k * access->width;
+        int reg = access->reg + k;
+        char reg_class = access->kind == IR_FRAME_INT ? 'r' : 'f';
+        const char *sep = k ? " " : "";
+        int n;
+        if (access->store) {
+            n = snprintf(output + len, output_size - len, "%sframe_%X = (%s)%c%d;",
+                         sep, offset, frame_slot_type(access), reg_class, reg);
+        } else if (access->sign) {
+            n = snprintf(output + len, output_size - len, "%sr%d = (uint32_t)(int32_t)(int16_t)frame_%X;",
+                         sep, reg, offset);
+        } else if (access->kind == IR_FRAME_SINGLE) {
+            n = snprintf(output + len, output_size - len, "%sf%d = (double)frame_%X;", sep, reg, offset);
+        } else {
+            n = snprintf(output + len, output_size - len, "%s%c%d = frame_%X;", sep, reg_class, reg, offset);
+        }
+        if (n < 0) break;
+        len += (size_t)n;
+    }
+}
+
+/**
+ * @brief Emit an inlined leaf in place of the `bl` that calls it
+ * Mirrors what the call would do: lr is set, and under the parameter calling
+ * convention the callee's entry marshaling of r3-r10 is replayed. The callee is
+ * in the caller's file, so its string constants are in string_table.
+ */
+static void write_inlined_call(FILE *body, const IR_Function *callee, const IR_Instruction *call,
+                               Function_Info *caller, const StringTable *string_table,
+                               RegisterTracker *tracker) {
+    fprintf(body, "    /* inline %s (0x%08X) */ lr = 0x%08X;  // 0x%08X: bl %s\n",
+           ir_text(&program_ir, callee->name), callee->start_address, call->address + 4,
+           call->address, ir_text(&program_ir, callee->name));
+    if (!config.register_calling_convention) {
+        fprintf(body, "    ");
+        for (int reg = 3; reg <= 10; reg++) {
+            fprintf(body, "r%d = convert_gc_address(r%d);%s", reg, reg, reg < 10 ? " " : "\n");
+        }
+    }
+    
+    // Everything but the final blr; a lis pending in the caller is not the callee's
+    last_lis_reg = -1;
+    uint32_t end = callee->first_instruction + callee->instruction_count - 1;
+    for (uint32_t i = callee->first_instruction; i < end; i++) {
+        const IR_Instruction *insn = &program_ir.instructions[i];
+        char c_code[512], asm_comment[128];
+        bool success = transpile_from_asm(ir_mnemonic(&program_ir, insn), ir_operands(&program_ir, insn),
+                                          insn->address, c_code, sizeof(c_code),
+                                          asm_comment, sizeof(asm_comment),
+                                          NULL, 0, caller, NULL, string_table, tracker);
+        if (!success) {
+            porpoise_stats.word_fallbacks++;
+            success = transpile_instruction(insn->word, insn->address, c_code, sizeof(c_code),
+                                            asm_comment, sizeof(asm_comment));
+        }
+        if (success) {
+            transpile_small_data(insn->word, ir_operands(&program_ir, insn), c_code, sizeof(c_code),
+                                 asm_comment, sizeof(asm_comment), tracker);
+        }
+        if (!success) {
+            porpoise_stats.unknown_opcodes++;
+            fprintf(body, "    /* 0x%08X: UNKNOWN 0x%08X - %s */\n", insn->address, insn->word, asm_comment);
+            continue;
+        }
+        fprintf(body, "    %s  // 0x%08X: %s\n", c_code, insn->address, asm_comment);
+    }
+    last_lis_reg = -1;
+}
+
 /**
  * @brief Transpile a single .s file directly to project folders
+ * Emission pass over the program IR: the file must have been decoded by ir_load_file().
  */
 int transpile_file_to_project(const char *input_filename, const char *src_dir, 
                                const char *inc_dir, const char *rel_path, SkipList *skip_list) {
-    // Build label-to-function map for trampoline resolution
-    LabelMap *label_map = build_label_map(input_filename);
+    uint32_t file_index = ir_find_file(&program_ir, input_filename);
+    if (file_index == IR_NONE) {
+        fprintf(stderr, "  Error: Cannot open %s\n", input_filename);
+        return -1;
+    }
+    const IR_File *ir_file = &program_ir.files[file_index];
+    registry_module = file_modules ? file_modules[file_index] : IR_NONE;
     
     // Build string table for string literal tracking
+    Stats_Phase phase = stats_enter(STATS_STRING_TABLE);
     StringTable *string_table = build_string_table(input_filename);
+    stats_leave(phase);
     
     // Extract base name
     const char *base = strrchr(input_filename, '/');
@@ -3143,6 +3832,7 @@ int transpile_file_to_project(const char *input_filename, const char *src_dir,
     
     char base_name[256];
     strncpy(base_name, base, sizeof(base_name) - 1);
+    base_name[sizeof(base_name) - 1] = '\0';
     char *ext = strrchr(base_name, '.');
     if (ext) *ext = '\0';
     
@@ -3151,32 +3841,30 @@ int transpile_file_to_project(const char *input_filename, const char *src_dir,
     snprintf(output_c, sizeof(output_c), "%s/%s.c", src_dir, base_name);
     snprintf(output_h, sizeof(output_h), "%s/%s.h", inc_dir, base_name);
     
-    // Open input file
-    FILE *input = fopen(input_filename, "r");
-    if (!input) {
-        fprintf(stderr, "  Error: Cannot open %s\n", input_filename);
-        if (label_map) labelmap_free(label_map);
-        if (string_table) string_table_free(string_table);
-        return -1;
-    }
-    
-    // Open output files
+    // Function bodies go to a temporary file so the includes can be decided afterwards
     FILE *c_file = fopen(output_c, "w");
     FILE *h_file = fopen(output_h, "w");
+    FILE *body = tmpfile();
     
-    if (!c_file || !h_file) {
+    if (!c_file || !h_file || !body) {
         fprintf(stderr, "  Error: Cannot create output files\n");
-        if (input) fclose(input);
         if (c_file) fclose(c_file);
         if (h_file) fclose(h_file);
+        if (body) fclose(body);
+        if (string_table) string_table_free(string_table);
         return -1;
     }
     
     // Generate header guard
-    char guard_name[128];
-    snprintf(guard_name, sizeof(guard_name), "%s_H", base_name);
+    char guard_name[512];
+    // The directory is part of the guard: a unity shard can hold a/util.c and b/util.c
+    if (rel_path && rel_path[0]) {
+        snprintf(guard_name, sizeof(guard_name), "%s_%s_H", rel_path, base_name);
+    } else {
+        snprintf(guard_name, sizeof(guard_name), "%s_H", base_name);
+    }
     for (char *p = guard_name; *p; p++) {
-        if (*p == '-' || *p == ' ' || *p == '.' || *p == '(' || *p == ')') {
+        if (*p == '-' || *p == ' ' || *p == '.' || *p == '(' || *p == ')' || *p == '/' || *p == '\\') {
             *p = '_';
         } else if (*p >= 'a' && *p <= 'z') {
             *p = *p - 32;  // Convert to uppercase
@@ -3186,426 +3874,691 @@ int transpile_file_to_project(const char *input_filename, const char *src_dir,
     // Write header file boilerplate
     fprintf(h_file, "#ifndef %s\n", guard_name);
     fprintf(h_file, "#define %s\n\n", guard_name);
-    
-    // Write C file boilerplate
-    if (rel_path && rel_path[0]) {
-        fprintf(c_file, "#include \"%s/%s.h\"\n", rel_path, base_name);
-    } else {
-        fprintf(c_file, "#include \"%s.h\"\n", base_name);
+    for (uint32_t i = 0; i < ir_file->include_count; i++) {
+        char include_line[256];
+        convert_include(ir_text(&program_ir, program_ir.includes[ir_file->first_include + i]),
+                        include_line, sizeof(include_line));
+        fprintf(h_file, "%s\n", include_line);
+    }
+    
+    // Forward declarations for local (static) functions
+    fprintf(body, "// Forward declarations for local (static) functions\n");
+    const char *local_params = config.register_calling_convention
+        ? "void"
+        : "uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double";
+    for (uint32_t f = ir_file->first_function; f < ir_file->first_function + ir_file->function_count; f++) {
+        const IR_Function *fn = &program_ir.functions[f];
+        if (!(fn->flags & IR_FUNCTION_LOCAL)) continue;
+        if ((fn->flags & IR_FUNCTION_UNREACHABLE) && strcmp(config.dead_functions, "omit") == 0) continue;
+        
+        // Strip quotes and handle special characters in function names
+        char clean_name[512];
+        strncpy(clean_name, ir_text(&program_ir, fn->name), sizeof(clean_name) - 1);
+        clean_name[sizeof(clean_name) - 1] = '\0';
+        if (clean_name[0] == '"') {
+            size_t len = strlen(clean_name);
+            memmove(clean_name, clean_name + 1, len);
+            len = strlen(clean_name);
+            if (len > 0 && clean_name[len - 1] == '"') {
+                clean_name[len - 1] = '\0';
+            }
+        }
+        
+        // Skip __init_registers and SDK functions even if they're marked as local
+        if (strcmp(clean_name, "__init_registers") == 0 || is_sdk_or_stdlib_function(clean_name)) {
+            continue;
+        }
+        
+        // Check if it needs to be stubbed (contains invalid C identifier chars)
+        if (strlen(clean_name) > 80 || strchr(clean_name, '<') != NULL || 
+            strchr(clean_name, '>') != NULL || strchr(clean_name, ',') != NULL ||
+            strchr(clean_name, '@') != NULL) {
+            unsigned int hash = 0;
+            for (const char *p = clean_name; *p; p++) {
+                hash = hash * 31 + (unsigned char)*p;
+            }
+            fprintf(body, "static void cpp_stub_func_%08x(%s);\n", hash, local_params);
+        } else {
+            fprintf(body, "static void %s(%s);\n", clean_name, local_params);
+        }
     }
-    fprintf(c_file, "#include \"powerpc_state.h\"\n");
-    fprintf(c_file, "#include \"all_functions.h\"  // For cross-file function calls\n");
-    // PLACEHOLDER_FUNCTION_ADDRESS_MAP_INCLUDE - will be replaced if indirect calls are used
+    fprintf(body, "\n");
     
     // Track if this file uses indirect calls (will add function_address_map.h if needed)
     bool needs_address_map_header = false;
     
-    // Generate string constants if any were found
-    if (string_table && string_table->count > 0) {
-        fprintf(c_file, "//==============================================================================\n");
-        fprintf(c_file, "// String Constants (from .rodata/.data sections)\n");
-        fprintf(c_file, "//==============================================================================\n\n");
-        
-        for (int i = 0; i < string_table->count; i++) {
-            const StringEntry *entry = &string_table->entries[i];
-            // Escape string content for C
-            fprintf(c_file, "const char %s[] = \"%s\";  // @ 0x%08X\n", 
-                   entry->label, entry->content, entry->address);
-        }
-        fprintf(c_file, "\n");
-    }
-    
-    // First pass: collect all local (static) functions for forward declarations
-    fprintf(c_file, "// Forward declarations for local (static) functions\n");
-    FILE *scan_file = fopen(input_filename, "r");
-    if (scan_file) {
-        char scan_line[MAX_LINE_LENGTH];
-        while (fgets(scan_line, sizeof(scan_line), scan_file)) {
-            // Stop scanning at non-code sections (data sections, etc.)
-            if (strstr(scan_line, ".section") != NULL && 
-                strstr(scan_line, ".text") == NULL &&
-                strstr(scan_line, ".init") == NULL) {
-                break;  // Stop at data sections
-            }
-            
-            ASM_Line parsed;
-            if (parse_asm_line(scan_line, &parsed) && parsed.is_function && parsed.is_local_function) {
-                // Strip quotes and handle special characters in function names
-                char clean_name[512];
-                strncpy(clean_name, parsed.function_name, sizeof(clean_name) - 1);
-                clean_name[sizeof(clean_name) - 1] = '\0';
-                
-                // Strip quotes
-                if (clean_name[0] == '"') {
-                    size_t len = strlen(clean_name);
-                    memmove(clean_name, clean_name + 1, len);
-                    len = strlen(clean_name);
-                    if (len > 0 && clean_name[len - 1] == '"') {
-                        clean_name[len - 1] = '\0';
-                    }
-                }
-                
-                // Skip __init_registers even if it's marked as local
-                if (strcmp(clean_name, "__init_registers") == 0) {
-                    continue;
-                }
-                
-                // Skip SDK functions even if they're marked as local
-                if (is_sdk_or_stdlib_function(clean_name)) {
-                    continue;
-                }
-                
-                // Check if it needs to be stubbed (contains invalid C identifier chars)
-                if (strlen(clean_name) > 80 || strchr(clean_name, '<') != NULL || 
-                    strchr(clean_name, '>') != NULL || strchr(clean_name, ',') != NULL ||
-                    strchr(clean_name, '@') != NULL) {
-                    // Create stub name based on hash
-                    unsigned int hash = 0;
-                    for (const char *p = clean_name; *p; p++) {
-                        hash = hash * 31 + (unsigned char)*p;
-                    }
-                    fprintf(c_file, "static void cpp_stub_func_%08x(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double);\n", hash);
-                } else {
-                    fprintf(c_file, "static void %s(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double, double);\n", 
-                           clean_name);
-                }
-            }
-        }
-        fclose(scan_file);
-    }
-    fprintf(c_file, "\n");
-    
-    // Process file line by line
-    char line[MAX_LINE_LENGTH];
-    bool in_function = false;
-    bool in_data_section = false;
-    bool seen_text_section = false;  // Track if we've entered the code section
-    Function_Info current_func = {0};
+    // Files whose functions this one calls (their headers replace all_functions.h)
+    uint8_t *callee_files = emitted_names ? (uint8_t*)calloc(program_ir.file_count + 1, 1) : NULL;
+    int routing_errors = 0;  // Cross-module calls that could not be routed: the file fails
     
     // Register tracker for compile-time function pointer resolution
     RegisterTracker register_tracker;
     register_tracker_init(&register_tracker);
     
-    // Buffer to track previous lines for parameter detection
-    char line_buffer[MAX_LOOKBACK_LINES][MAX_LINE_LENGTH];
-    const char *prev_lines[MAX_LOOKBACK_LINES];
-    int line_index = 0;
-    int lines_buffered = 0;
-    
-    // Initialize pointers
-    for (int i = 0; i < MAX_LOOKBACK_LINES; i++) {
-        prev_lines[i] = line_buffer[i];
-        line_buffer[i][0] = '\0';
-    }
-    
-    while (fgets(line, sizeof(line), input)) {
-        ASM_Line parsed;
+    for (uint32_t f = ir_file->first_function; f < ir_file->first_function + ir_file->function_count; f++) {
+        const IR_Function *fn = &program_ir.functions[f];
+        Function_Info current_func = {0};
+        snprintf(current_func.name, sizeof(current_func.name), "%s", ir_text(&program_ir, fn->name));
+        current_func.start_address = fn->start_address;
+        current_func.end_address = fn->end_address;
+        current_func.is_local = (fn->flags & IR_FUNCTION_LOCAL) != 0;
         
-        if (!parse_asm_line(line, &parsed)) {
-            fprintf(c_file, "    // %s", line);
+        // Gap functions (usually data misidentified as code), skip list and SDK functions
+        current_func.skip = ir_function_skipped(fn, skip_list);
+        
+        if (current_func.skip) {
+            fprintf(body, "// Function %s skipped (gap or in skip list)\n\n", current_func.name);
             continue;
         }
+        if (fn->start_address == 0) continue;  // No instructions
         
-        if (parsed.is_comment) continue;
-        
-        if (parsed.is_directive) {
-            // Track when we enter the .text section
-            if (strstr(line, ".text") != NULL || strstr(line, ".init") != NULL) {
-                seen_text_section = true;
-            }
-            
-            // Only stop at data sections AFTER we've seen the code section
-            // This handles files where data sections appear before .text
-            if (seen_text_section && strstr(line, ".section") != NULL && 
-                strstr(line, ".text") == NULL && 
-                strstr(line, ".init") == NULL) {
-                fprintf(c_file, "\n// End of code section - data sections follow\n");
-                break;  // Stop processing this file
-            }
-            
-            if (strstr(line, ".include") != NULL) {
-                char include_line[256];
-                convert_include(line, include_line, sizeof(include_line));
-                fprintf(h_file, "%s\n", include_line);
-            }
-            if (strstr(line, ".endfn") != NULL) {
-                if (in_data_section && current_func.is_data_only) {
-                    // Close data array
-                    fprintf(c_file, "};\n\n");
-                    in_data_section = false;
-                } else if (in_function) {
-                    // Add trampoline fix instructions if detected
-                    if (current_func.is_trampoline) {
-                        fprintf(c_file, "    /* TRAMPOLINE DETECTED - Cross-function jump to 0x%08X\n", 
-                               current_func.trampoline_target);
-                        fprintf(c_file, "     * Auto-fix: Replace the goto above with:\n");
-                        fprintf(c_file, "     *   pc = 0x%08X;\n", current_func.trampoline_target);
-                        fprintf(c_file, "     *   TARGET_FUNCTION();  // Function containing L_%08X\n", 
-                               current_func.trampoline_target);
-                        fprintf(c_file, "     * Then add to target function start:\n");
-                        fprintf(c_file, "     *   if (pc == 0x%08X) goto L_%08X;\n", 
-                               current_func.trampoline_target, current_func.trampoline_target);
-                        fprintf(c_file, "     */\n");
-                    }
-                    write_function_end(c_file);
-                    in_function = false;
-                }
-            }
+        bool unreachable = (fn->flags & IR_FUNCTION_UNREACHABLE) != 0;
+        if (unreachable && strcmp(config.dead_functions, "omit") == 0) {
+            fprintf(body, "// Function %s omitted (unreachable from %s)\n\n", current_func.name, IR_ENTRY_POINT);
             continue;
         }
         
-        if (parsed.is_data) {
-            in_data_section = true;
-            fprintf(c_file, "\n// === DATA SECTION ===\n");
-            fprintf(c_file, "// (Data sections preserved as byte arrays)\n\n");
+        // All functions accept all potential parameters (r3-r10, f1-f2) for simplicity
+        // With the register calling convention they take none: arguments stay in the globals
+        bool pass_params = !config.register_calling_convention;
+        current_func.has_params = pass_params;
+        current_func.num_int_params = pass_params ? 8 : 0;   // r3-r10
+        current_func.num_float_params = pass_params ? 2 : 0; // f1-f2
+        current_func.returns_value = false;
+        
+        write_function_declaration(h_file, &current_func);
+        if (fn->canonical != IR_NONE) {
+            // Identical to another function: forward to the shared body
+            const IR_Function *shared = &program_ir.functions[fn->canonical];
+            const char *shared_name = ir_text(&program_ir, shared->name);
+            write_function_forwarder(body, &current_func, shared_name, shared->start_address);
+            if (callee_files && shared->file != file_index) callee_files[shared->file] = 1;
+            bool shared_exported = !(shared->flags & IR_FUNCTION_LOCAL);
+            register_transpiled_function(shared_exported ? shared_name : current_func.name,
+                                         current_func.start_address, shared_exported ? false : current_func.is_local);
             continue;
         }
+        if (unreachable) {
+            fprintf(body, "// Unreachable from %s (no calls, not address-taken)\n", IR_ENTRY_POINT);
+        }
+        write_function_start(body, &current_func);
+        if (unreachable && strcmp(config.dead_functions, "stub") == 0) {
+            fprintf(body, "    /* Body not emitted: unreachable */\n");
+            write_function_end(body);
+            continue;
+        }
+        register_transpiled_function(current_func.name, current_func.start_address, current_func.is_local);
+        register_tracker_init(&register_tracker);
         
-        if (parsed.is_function) {
-            strcpy(current_func.name, parsed.function_name);
-            current_func.start_address = 0;
-            current_func.instruction_count = 0;
-            current_func.is_trampoline = false;
-            current_func.trampoline_target = 0;
-            current_func.is_local = parsed.is_local_function;  // Track if static
-            current_func.is_data_only = false;  // TODO: Implement efficient data detection
+        IR_Frame frame;
+        ir_frame_collect(&program_ir, fn, &frame);
+        for (uint32_t a = 0; a < frame.access_count; a++) {
+            frame.accesses[a].promoted = (program_ir.instructions[frame.accesses[a].instruction].flags &
+                                          IR_INSN_FRAME_SLOT) != 0;
+        }
+        write_frame_locals(body, &frame);
+        
+        uint32_t next_label = fn->first_label;
+        uint32_t trampoline_target = 0;
+        
+        for (uint32_t i = fn->first_instruction; i < fn->first_instruction + fn->instruction_count; i++) {
+            const IR_Instruction *insn = &program_ir.instructions[i];
             
-            // Auto-skip gap functions (usually data misidentified as code)
-            if (strncmp(current_func.name, "gap_", 4) == 0) {
-                current_func.skip = true;
-            } else {
-                // Check skip list first
-                current_func.skip = skiplist_should_skip(skip_list, current_func.name);
-                // Also skip SDK functions (even if not in skip list)
-                if (!current_func.skip && is_sdk_or_stdlib_function(current_func.name)) {
-                    current_func.skip = true;
+            if (insn->flags & IR_INSN_UNPARSED) {
+                porpoise_stats.unparsed_lines++;
+                fprintf(body, "    // %s", ir_text(&program_ir, insn->text));
+                continue;
+            }
+            porpoise_stats.instructions_emitted++;
+            
+            while (next_label < fn->first_label + fn->label_count && program_ir.labels[next_label].instruction == i) {
+                char c_label[MAX_LABEL_NAME + 2];
+                convert_label(ir_text(&program_ir, program_ir.labels[next_label].name), c_label, sizeof(c_label));
+                fprintf(body, "\n%s\n", c_label);
+                next_label++;
+            }
+            
+            // Small leaf callee: its body replaces the call
+            if ((insn->flags & IR_INSN_LINK) && !(insn->flags & IR_INSN_CONDITIONAL)) {
+                uint32_t callee = ir_call_target(&program_ir, fn, insn);
+                if (callee != IR_NONE && (program_ir.functions[callee].flags & IR_FUNCTION_INLINE) &&
+                    program_ir.functions[callee].file == file_index) {
+                    write_inlined_call(body, &program_ir.functions[callee], insn, &current_func,
+                                       string_table, &register_tracker);
+                    continue;
                 }
             }
             
-            // All functions accept all potential parameters (r3-r10, f1-f2) for simplicity
-            // This avoids the need to scan ahead in the file which can hang
-            if (!current_func.skip) {
-                current_func.has_params = true;
-                current_func.num_int_params = 8;  // r3-r10
-                current_func.num_float_params = 2; // f1-f2
-                current_func.returns_value = false; // Default to void, will be detected later
+            char c_code[512], asm_comment[128];
+            const Emitted_Name *callee = emitted_names ? emitted_callee(fn, insn, &register_tracker, file_index) : NULL;
+            
+            // Try parsing from assembly text first (for branches, etc.)
+            bool success = transpile_from_asm(ir_mnemonic(&program_ir, insn), ir_operands(&program_ir, insn),
+                                              insn->address, c_code, sizeof(c_code),
+                                              asm_comment, sizeof(asm_comment),
+                                              NULL, 0, &current_func, NULL, string_table, &register_tracker);
+            
+            // Fall back to byte-based decoding if text-based failed
+            if (!success) {
+                porpoise_stats.word_fallbacks++;
+                success = transpile_instruction(insn->word, insn->address,
+                                                c_code, sizeof(c_code),
+                                                asm_comment, sizeof(asm_comment));
+            }
+            
+            // Small-data globals and constants live at fixed addresses
+            if (!success) {
+                snprintf(asm_comment, sizeof(asm_comment), "%s %s", ir_mnemonic(&program_ir, insn),
+                         ir_operands(&program_ir, insn));
+            }
+            if (transpile_small_data(insn->word, ir_operands(&program_ir, insn), c_code, sizeof(c_code),
+                                     asm_comment, sizeof(asm_comment), &register_tracker)) {
+                success = true;
             }
             
-            // For data-only functions, write as byte array instead of function
-            if (current_func.is_data_only) {
-                fprintf(c_file, "// Data section: %s (detected as %s)\n",
-                       current_func.name, current_func.is_local ? "static" : "global");
-                fprintf(c_file, "%sconst uint8_t %s[] __attribute__((aligned(4))) = {\n",
-                       current_func.is_local ? "static " : "", current_func.name);
-                in_function = false;  // Don't treat as function
-                in_data_section = true;  // Flag to output as data
+            if (!success) {
+                porpoise_stats.unknown_opcodes++;
+                fprintf(body, "    /* 0x%08X: UNKNOWN 0x%08X - %s */\n",
+                       insn->address, insn->word, asm_comment);
                 continue;
             }
             
-            if (!current_func.skip) {
-                // Write function declaration to header (with detected parameters)
-                write_function_declaration(h_file, &current_func);
-                
-                in_function = true;
-            } else {
-                // For skipped functions, don't set in_function to prevent closing brace
-                in_function = false;
-                fprintf(c_file, "// Function %s skipped (gap or in skip list)\n\n", current_func.name);
+            // Private stack traffic (the text pass above still ran to keep the tracker in step)
+            if (insn->flags & (IR_INSN_FRAME_SLOT | IR_INSN_FRAME_ADJUST)) {
+                snprintf(asm_comment, sizeof(asm_comment), "%s %s", ir_mnemonic(&program_ir, insn),
+                         ir_operands(&program_ir, insn));
+                if (insn->flags & IR_INSN_FRAME_ADJUST) {
+                    snprintf(c_code, sizeof(c_code), "/* frame removed */");
+                } else {
+                    for (uint32_t a = 0; a < frame.access_count; a++) {
+                        if (frame.accesses[a].instruction == i) {
+                            frame_slot_code(&frame.accesses[a], c_code, sizeof(c_code));
+                            break;
+                        }
+                    }
+                }
             }
             
-            in_data_section = false;
-            continue;
+            // Headers to include, and calls into other modules, come from the IR call edge
+            if (callee && file_modules && !callee->local && !same_module(callee->file, file_index)) {
+                if (!route_cross_module_call(c_code, sizeof(c_code), callee)) {
+                    fprintf(stderr, "  Error: 0x%08X: call to %s is too long once routed through the "
+                            "function address map\n", insn->address, callee->name);
+                    routing_errors++;
+                }
+            } else if (callee && callee_files) {
+                callee_files[callee->file] = 1;
+            }
+            if (strstr(c_code, "call_function_by_address") != NULL) {
+                needs_address_map_header = true;
+            }
+            
+            // Jumps into another function's body (not its entry point)
+            if (insn->flags & IR_INSN_LEAVES_FUNCTION) {
+                if (insn->target < fn->start_address) {
+                    fprintf(stderr, "\n");
+                    fprintf(stderr, "WARNING: Backward jump detected across function boundary!\n");
+                    fprintf(stderr, "  Function: %s (starts at 0x%08X)\n", 
+                           current_func.name, current_func.start_address);
+                    fprintf(stderr, "  Jump from: 0x%08X\n", insn->address);
+                    fprintf(stderr, "  Jump to: L_%08X (before function start)\n", insn->target);
+                    fprintf(stderr, "  This usually means the function boundaries are wrong.\n");
+                    fprintf(stderr, "  The function at 0x%08X may need to be merged with the previous function.\n",
+                           current_func.start_address);
+                    fprintf(stderr, "\n");
+                }
+                if ((fn->flags & IR_FUNCTION_TRAMPOLINE) && insn->address == fn->start_address) {
+                    trampoline_target = insn->target;
+                    snprintf(c_code, sizeof(c_code),
+                            "/* TRAMPOLINE to 0x%08X - Target function needed */ "
+                            "pc = 0x%08X; return;",
+                            trampoline_target, trampoline_target);
+                } else if (!(insn->flags & IR_INSN_CONDITIONAL)) {
+                    // The label lives in another function, so a goto would not compile
+                    snprintf(c_code, sizeof(c_code), "pc = 0x%08X; return;  /* cross-function */", insn->target);
+                }
+            }
+            
+            fprintf(body, "    %s  // 0x%08X: %s\n", c_code, insn->address, asm_comment);
         }
         
-        if (parsed.is_label) {
-            // Only output labels when inside a function AND after the function signature has been written
-            if (in_function && !in_data_section && current_func.start_address != 0) {
-                char c_label[MAX_LABEL_NAME + 2];
-                convert_label(parsed.label_name, c_label, sizeof(c_label));
-                fprintf(c_file, "\n%s\n", c_label);
-            }
-            // If label appears before first instruction, it will be lost but that's okay
-            // because it would be at the function entry point anyway
-            continue;
+        if (trampoline_target) {
+            const IR_Function *target_fn = ir_function_containing(&program_ir, trampoline_target);
+            fprintf(body, "    /* TRAMPOLINE DETECTED - Cross-function jump to 0x%08X\n", trampoline_target);
+            fprintf(body, "     * Auto-fix: Replace the goto above with:\n");
+            fprintf(body, "     *   pc = 0x%08X;\n", trampoline_target);
+            fprintf(body, "     *   %s();  // Function containing L_%08X\n",
+                   target_fn ? ir_text(&program_ir, target_fn->name) : "TARGET_FUNCTION", trampoline_target);
+            fprintf(body, "     * Then add to target function start:\n");
+            fprintf(body, "     *   if (pc == 0x%08X) goto L_%08X;\n", trampoline_target, trampoline_target);
+            fprintf(body, "     */\n");
         }
+        write_function_end(body);
+        ir_frame_free(&frame);
+    }
+    
+    fprintf(h_file, "\n#endif // %s\n", guard_name);
+    
+    // Write C file boilerplate, then the function bodies
+    if (rel_path && rel_path[0]) {
+        fprintf(c_file, "#include \"%s/%s.h\"\n", rel_path, base_name);
+    } else {
+        fprintf(c_file, "#include \"%s.h\"\n", base_name);
+    }
+    fprintf(c_file, "#include \"powerpc_state.h\"\n");
+    if (callee_files) {
+        // Only the files called from here: editing one header no longer rebuilds every file
+        for (uint32_t i = 0; i < program_ir.file_count; i++) {
+            if (!callee_files[i] || i == file_index) continue;
+            char header[512];
+            ir_file_header(i, header, sizeof(header));
+            fprintf(c_file, "#include \"%s\"  // Cross-file calls\n", header);
+        }
+        free(callee_files);
+    } else {
+        fprintf(c_file, "#include \"all_functions.h\"  // For cross-file function calls\n");
+    }
+    if (needs_address_map_header) {
+        fprintf(c_file, "#include \"function_address_map.h\"  // For indirect calls (vtables, callbacks)\n");
+    }
+    
+    // Generate string constants if any were found
+    if (string_table && string_table->count > 0) {
+        fprintf(c_file, "//==============================================================================\n");
+        fprintf(c_file, "// String Constants (from .rodata/.data sections)\n");
+        fprintf(c_file, "//==============================================================================\n\n");
         
-        if (parsed.instruction != 0) {
-            if (in_data_section) {
-                fprintf(c_file, "    0x%02X, 0x%02X, 0x%02X, 0x%02X,  // 0x%08X\n",
-                       (parsed.instruction >> 24) & 0xFF,
-                       (parsed.instruction >> 16) & 0xFF,
-                       (parsed.instruction >> 8) & 0xFF,
-                       parsed.instruction & 0xFF,
-                       parsed.address);
-            } else if (in_function) {
-                if (current_func.start_address == 0) {
-                    current_func.start_address = parsed.address;
-                    
-                    if (current_func.skip) {
-                        fprintf(c_file, "// Function %s skipped (in skip list)\n\n",
-                               current_func.name);
-                        in_function = false;
-                        continue;
-                    }
-                    
-                    // Parameters already detected earlier, just write function start
-                    write_function_start(c_file, &current_func);
-                    
-                    // Register function for indirect call resolution
-                    register_transpiled_function(current_func.name, current_func.start_address, current_func.is_local);
-                    
-                    // Reset register tracker for new function
-                    register_tracker_init(&register_tracker);
-                }
-                
-                char c_code[512], asm_comment[128];
-                
-                // Try parsing from assembly text first (for branches, etc.)
-                bool success = transpile_from_asm(parsed.mnemonic, parsed.operands, parsed.address,
-                                                  c_code, sizeof(c_code),
-                                                  asm_comment, sizeof(asm_comment),
-                                                  prev_lines, lines_buffered,
-                                                  &current_func, label_map, string_table, &register_tracker);
-                
-                // Fall back to byte-based decoding if text-based failed
-                if (!success) {
-                    success = transpile_instruction(parsed.instruction, parsed.address,
-                                                    c_code, sizeof(c_code),
-                                                    asm_comment, sizeof(asm_comment));
-                }
-                
-                if (success) {
-                    // Check if this instruction generates an indirect call that needs function_address_map.h
-                    if (strstr(c_code, "call_function_by_address") != NULL) {
-                        needs_address_map_header = true;
-                    }
-                    
-                    // Check for backward jumps to labels (potential loop or misidentified function boundary)
-                    if (strstr(c_code, "goto L_") != NULL || strstr(c_code, "goto lbl_") != NULL) {
-                        char *goto_pos = strstr(c_code, "goto ");
-                        if (goto_pos) {
-                            char *addr_start = goto_pos + 5; // Skip "goto "
-                            while (*addr_start == ' ') addr_start++;
-                            uint32_t target_addr = 0;
-                            if (strncmp(addr_start, "L_", 2) == 0) {
-                                sscanf(addr_start + 2, "%x", &target_addr);
-                            } else if (strncmp(addr_start, "lbl_", 4) == 0) {
-                                sscanf(addr_start + 4, "%x", &target_addr);
-                            }
-                            
-                            // Check if this is a backward jump (target address < current address)
-                            if (target_addr != 0 && target_addr < parsed.address) {
-                                // Check if target is before this function started (cross-function backward jump)
-                                if (target_addr < current_func.start_address) {
-                                    fprintf(stderr, "\n");
-                                    fprintf(stderr, "WARNING: Backward jump detected across function boundary!\n");
-                                    fprintf(stderr, "  Function: %s (starts at 0x%08X)\n", 
-                                           current_func.name, current_func.start_address);
-                                    fprintf(stderr, "  Jump from: 0x%08X\n", parsed.address);
-                                    fprintf(stderr, "  Jump to: L_%08X (before function start)\n", target_addr);
-                                    fprintf(stderr, "  This usually means the function boundaries are wrong.\n");
-                                    fprintf(stderr, "  The function at 0x%08X may need to be merged with the previous function.\n",
-                                           current_func.start_address);
-                                    fprintf(stderr, "\n");
-                                }
-                            }
-                        }
-                    }
-                    
-                    // Detect trampoline: single branch instruction to a label
-                    bool is_trampoline_branch = false;
-                    uint32_t trampoline_target = 0;
-                    
-                    if (current_func.instruction_count == 0 && 
-                        (strncmp(parsed.mnemonic, "b", 1) == 0) &&
-                        (strstr(c_code, "goto L_") != NULL || strstr(c_code, "goto lbl_") != NULL)) {
-                        // Extract target address from the goto statement
-                        char *goto_pos = strstr(c_code, "goto ");
-                        if (goto_pos) {
-                            char *addr_start = goto_pos + 5; // Skip "goto "
-                            while (*addr_start == ' ') addr_start++;
-                            if (strncmp(addr_start, "L_", 2) == 0) {
-                                sscanf(addr_start + 2, "%x", &trampoline_target);
-                            } else if (strncmp(addr_start, "lbl_", 4) == 0) {
-                                sscanf(addr_start + 4, "%x", &trampoline_target);
-                            }
-                            
-                            if (trampoline_target != 0) {
-                                is_trampoline_branch = true;
-                                current_func.is_trampoline = true;
-                                current_func.trampoline_target = trampoline_target;
-                                
-                                // Replace goto with valid C code that compiles
-                                // Use a function call stub instead of goto
-                                snprintf(c_code, sizeof(c_code), 
-                                        "/* TRAMPOLINE to 0x%08X - Target function needed */ "
-                                        "pc = 0x%08X; return;", 
-                                        trampoline_target, trampoline_target);
-                            }
-                        }
-                    }
-                    
-                    fprintf(c_file, "    %s  // 0x%08X: %s\n",
-                           c_code, parsed.address, asm_comment);
-                    current_func.instruction_count++;
-                } else {
-                    fprintf(c_file, "    /* 0x%08X: UNKNOWN 0x%08X - %s */\n",
-                           parsed.address, parsed.instruction, asm_comment);
-                    current_func.instruction_count++;
-                }
+        for (int i = 0; i < string_table->count; i++) {
+            const StringEntry *entry = &string_table->entries[i];
+            fprintf(c_file, "const char %s[] = \"%s\";  // @ 0x%08X\n", 
+                   entry->label, entry->content, entry->address);
+        }
+        fprintf(c_file, "\n");
+    }
+    
+    rewind(body);
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), body)) > 0) {
+        fwrite(chunk, 1, n, c_file);
+    }
+    fclose(body);
+    fclose(c_file);
+    fclose(h_file);
+    
+    if (string_table) string_table_free(string_table);
+    
+    // A call left unrouted would keep running the old code after a reload
+    if (routing_errors > 0) return -1;
+    
+    if (LOG_ENABLED(LOG_NORMAL)) {
+        printf("  → %s/%s.c\n", src_dir, base_name);
+        printf("  → %s/%s.h\n", inc_dir, base_name);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief Find the discovered function starting exactly at an address
+ */
+static const Function_Info* binary_find_function(const Function_Info *funcs, int count, uint32_t address) {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (funcs[mid].start_address == address) return &funcs[mid];
+        if (funcs[mid].start_address < address) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Discover and name the functions of a DOL/ELF image
+ * Seeds are the loaded symbols, the start of each code section and the entry
+ * point; discover_functions() adds bl targets and prologue matches. A function
+ * takes the name of the symbol at its address when that is a valid C identifier,
+ * __start for an unnamed entry point, and fn_XXXXXXXX otherwise.
+ * @return Number of functions (sorted by address), or -1 on failure
+ */
+static int binary_collect_functions(Binary_Image *img, Function_Info **funcs) {
+    binary_sort_symbols(img);
+
+    uint32_t *seeds = (uint32_t*)malloc(sizeof(uint32_t) * (img->symbol_count + img->section_count + 1));
+    if (!seeds) return -1;
+    int seed_count = 0;
+    for (int i = 0; i < img->symbol_count; i++) seeds[seed_count++] = img->symbols[i].address;
+    for (int s = 0; s < img->section_count; s++) {
+        if (img->sections[s].is_code) seeds[seed_count++] = img->sections[s].address;
+    }
+    if (img->entry_point != 0) seeds[seed_count++] = img->entry_point;
+
+    int count = discover_functions(img, seeds, seed_count, funcs);
+    free(seeds);
+
+    for (int i = 0; i < count; i++) {
+        Function_Info *func = &(*funcs)[i];
+        const Binary_Symbol *sym = binary_find_symbol(img, func->start_address);
+        if (sym && binary_is_c_identifier(sym->name)) {
+            snprintf(func->name, sizeof(func->name), "%s", sym->name);
+        } else if (func->start_address == img->entry_point) {
+            snprintf(func->name, sizeof(func->name), "__start");
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Tracker and lr/ctr rewrites straight from an instruction word
+ * DOL/ELF counterpart of the text checks in transpile_from_asm(): the register
+ * fields come from the word, so the decoder's comment is never parsed back.
+ * @return true if output was generated; false keeps the decoder's output
+ */
+static bool binary_rewrite_word(uint32_t word, uint32_t address, const Function_Info *func,
+                                char *output, size_t output_size,
+                                char *comment, size_t comment_size, RegisterTracker *tracker) {
+    int rD = (word >> 21) & 0x1F;
+    int rA = (word >> 16) & 0x1F;
+    int rB = (word >> 11) & 0x1F;
+    int32_t simm = (int16_t)(word & 0xFFFF);
+    uint32_t uimm = word & 0xFFFF;
+    uint32_t xo = (word >> 1) & 0x3FF;
+
+    switch (word >> 26) {
+        case 14:  // addi (li when rA == 0)
+            if (rA == 0) {
+                register_tracker_clear(tracker, rD);
+                return false;
+            }
+            return rewrite_add_immediate("addi", rD, rA, simm, output, output_size,
+                                         comment, comment_size, NULL, tracker);
+        case 15:  // addis (lis when rA == 0)
+            if (rA == 0) return rewrite_lis(rD, uimm, output, output_size, comment, comment_size, tracker);
+            register_tracker_clear(tracker, rD);
+            return false;
+        case 24:  // ori rA, rS, UIMM
+            return rewrite_add_immediate("ori", rA, rD, (int32_t)uimm, output, output_size,
+                                         comment, comment_size, NULL, tracker);
+        case 32:
+            return rewrite_lwz(rD, simm, rA, output, output_size, comment, comment_size, tracker);
+        case 36:
+            return rewrite_stw(rD, simm, rA, output, output_size, comment, comment_size, tracker);
+        case 37:
+            return rewrite_stwu(rD, simm, rA, output, output_size, comment, comment_size, tracker);
+        case 19:
+            // Only unconditional bclr/bcctr (BO = 1z1zz); conditional forms stay with the decoder
+            if ((rD & 0x14) != 0x14) return false;
+            if (xo == 16 && !(word & 1)) {
+                transpile_return(func, output, output_size, comment, comment_size);
+                return true;
+            }
+            if (xo == 16 || (xo == 528 && (word & 1))) {
+                transpile_indirect_call(xo == 528, address, output, output_size,
+                                        comment, comment_size, tracker);
+                return true;
+            }
+            return false;
+        case 31: {
+            uint32_t spr = (uint32_t)(rA | (rB << 5));
+            switch (xo) {
+                case 467:  // mtspr
+                    if (spr == 8 || spr == 9) track_move_to_spr(rD, spr == 9, tracker);
+                    break;
+                case 339:  // mfspr
+                    if (spr == 8 || spr == 9) track_move_from_spr(rD, spr == 9, tracker);
+                    break;
+                case 266: case 40:  // add, subf
+                    register_tracker_clear(tracker, rD);
+                    break;
+                case 28: case 444: case 316: case 24: case 536: case 792:  // and, or, xor, slw, srw, sraw
+                    register_tracker_clear(tracker, rA);
+                    break;
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Transpile one function [start, end) of a code section
+ */
+static void binary_transpile_function(const Binary_Image *img, const Binary_Section *sec,
+                                      const Function_Info *func, const Function_Info *funcs, int func_count,
+                                      FILE *c_file, bool *needs_address_map_header) {
+    uint32_t count = func->size / 4;
+    uint8_t *is_label = (uint8_t*)calloc(count ? count : 1, 1);
+
+    // First pass: branch targets inside this function become C labels
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t addr = func->start_address + i * 4;
+        uint32_t word = binary_section_word(img, sec, addr);
+        uint32_t target;
+        if (!(word & 1) && binary_branch_target(word, addr, &target) &&
+            target - func->start_address < count * 4 && is_label) {
+            is_label[(target - func->start_address) / 4] = 1;
+        }
+    }
+
+    RegisterTracker register_tracker;
+    register_tracker_init(&register_tracker);
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t addr = func->start_address + i * 4;
+        uint32_t word = binary_section_word(img, sec, addr);
+        char c_code[512], asm_comment[128];
+
+        if (is_label && is_label[i]) {
+            fprintf(c_file, "\nL_%08X:\n", addr);
+        }
+
+        bool success = transpile_instruction(word, addr, c_code, sizeof(c_code),
+                                             asm_comment, sizeof(asm_comment));
+        porpoise_stats.instructions_emitted++;
+
+        uint32_t target;
+        bool direct_branch = binary_branch_target(word, addr, &target);
+        if (direct_branch && (word >> 26) == 18 &&
+            ((word & 1) || target - func->start_address >= count * 4)) {
+            // Calls and tail branches to another function
+            const Function_Info *callee = binary_find_function(funcs, func_count, target);
+            if (callee) {
+                transpile_named_call((word & 1) ? "bl" : "b", callee->name, word & 1,
+                                     c_code, sizeof(c_code), asm_comment, sizeof(asm_comment));
+                success = true;
             }
+        } else if (success && !direct_branch) {
+            // Tracker and indirect calls, decoder output as fallback
+            binary_rewrite_word(word, addr, func, c_code, sizeof(c_code),
+                                asm_comment, sizeof(asm_comment), &register_tracker);
         }
-        
-        // Update line buffer (circular buffer for context)
-        strncpy(line_buffer[line_index], line, MAX_LINE_LENGTH - 1);
-        line_buffer[line_index][MAX_LINE_LENGTH - 1] = '\0';
-        line_index = (line_index + 1) % MAX_LOOKBACK_LINES;
-        if (lines_buffered < MAX_LOOKBACK_LINES) {
-            lines_buffered++;
+
+        if (success) {
+            transpile_small_data(word, NULL, c_code, sizeof(c_code),
+                                 asm_comment, sizeof(asm_comment), &register_tracker);
+        }
+
+        // A goto that leaves the function cannot be expressed in C: hand off through pc
+        char *goto_pos = success ? strstr(c_code, "goto L_") : NULL;
+        uint32_t goto_target;
+        if (goto_pos && sscanf(goto_pos + 7, "%8X", &goto_target) == 1 &&
+            goto_target - func->start_address >= count * 4) {
+            char tail[512];
+            snprintf(tail, sizeof(tail), "%s", goto_pos + 7 + 8 + 1);  // after "goto L_XXXXXXXX;"
+            snprintf(goto_pos, sizeof(c_code) - (size_t)(goto_pos - c_code),
+                     "{ pc = 0x%08X; return; }  /* cross-function */%s", goto_target, tail);
+        }
+
+        if (success) {
+            if (strstr(c_code, "call_function_by_address") != NULL) {
+                *needs_address_map_header = true;
+            }
+            fprintf(c_file, "    %s  // 0x%08X: %s\n", c_code, addr, asm_comment);
+        } else {
+            porpoise_stats.unknown_opcodes++;
+            fprintf(c_file, "    /* 0x%08X: UNKNOWN 0x%08X - %s */\n", addr, word, asm_comment);
         }
     }
-    
-    fprintf(h_file, "\n#endif // %s\n", guard_name);
-    
-    // If indirect calls were used, add the include header
-    if (needs_address_map_header) {
-        // Read the C file, replace placeholder with include
-        fclose(c_file);
-        FILE *temp_file = fopen(output_c, "r");
-        if (temp_file) {
-            char temp_path[512];
-            snprintf(temp_path, sizeof(temp_path), "%s.tmp", output_c);
-            FILE *new_file = fopen(temp_path, "w");
-            if (new_file) {
-                char line[1024];
-                while (fgets(line, sizeof(line), temp_file)) {
-                    if (strstr(line, "PLACEHOLDER_FUNCTION_ADDRESS_MAP_INCLUDE") != NULL) {
-                        fprintf(new_file, "#include \"function_address_map.h\"  // For indirect calls (vtables, callbacks)\n");
-                    } else {
-                        fputs(line, new_file);
-                    }
-                }
-                fclose(new_file);
-                fclose(temp_file);
-                remove(output_c);
-                rename(temp_path, output_c);
-            } else {
-                fclose(temp_file);
+
+    free(is_label);
+}
+
+/**
+ * @brief Transpile a DOL/ELF executable straight from its instruction words
+ * Each code section becomes one .c/.h pair in the project. Function boundaries
+ * come from discover_functions() (see function_discovery.h).
+ * @return Number of files generated, or -1 if the executable cannot be loaded
+ */
+int transpile_binary_to_project(const char *input_filename,
+                                const char *src_dir, const char *inc_dir, SkipList *skip_list,
+                                char **c_files, char **h_files, int *file_count, int max_files) {
+    Stats_Phase phase = stats_enter(STATS_DECODE);
+    Binary_Image img;
+    if (binary_image_open(&img, input_filename) != 0) {
+        fprintf(stderr, "Error: %s is not a readable DOL or ELF executable\n", input_filename);
+        return -1;
+    }
+
+    // Function names from the imported symbol map (ELF .symtab entries are already loaded)
+    for (int i = 0; i < symbol_index.functions.count; i++) {
+        const Symbol_Entry *entry = &symbol_index.functions.entries[i];
+        binary_add_symbol(&img, symbol_map_name(&symbol_index, entry), entry->address, entry->size);
+    }
+
+    Function_Info *funcs = NULL;
+    int func_count = binary_collect_functions(&img, &funcs);
+    if (func_count < 0) {
+        fprintf(stderr, "Error: Out of memory during function discovery\n");
+        binary_image_close(&img);
+        return -1;
+    }
+    printf("%s: %d sections, %d functions, entry 0x%08X\n\n",
+           img.is_elf ? "ELF" : "DOL", img.section_count, func_count, img.entry_point);
+    for (int s = 0; s < img.section_count; s++) {
+        if (img.sections[s].is_code) porpoise_stats.instructions_decoded += img.sections[s].size / 4;
+    }
+    stats_enter(STATS_EMIT);
+
+    // Register every entry point up front so blrl/bctrl can resolve forward references
+    for (int i = 0; i < func_count; i++) {
+        register_transpiled_function(funcs[i].name, funcs[i].start_address, false);
+    }
+
+    int generated = 0;
+    for (int s = 0; s < img.section_count; s++) {
+        const Binary_Section *sec = &img.sections[s];
+        if (!sec->is_code) continue;
+        if (*file_count >= max_files) {
+            fprintf(stderr, "Warning: Too many files (max %d)\n", max_files);
+            break;
+        }
+
+        // ".text0" -> text0
+        char base_name[64];
+        int n = 0;
+        for (const char *p = sec->name; *p && n < (int)sizeof(base_name) - 1; p++) {
+            if (isalnum((unsigned char)*p)) base_name[n++] = *p;
+            else if (n > 0) base_name[n++] = '_';
+        }
+        base_name[n] = '\0';
+        if (n == 0) snprintf(base_name, sizeof(base_name), "section%d", s);
+
+        char output_c[512], output_h[512];
+        snprintf(output_c, sizeof(output_c), "%s/%s.c", src_dir, base_name);
+        snprintf(output_h, sizeof(output_h), "%s/%s.h", inc_dir, base_name);
+        if (LOG_ENABLED(LOG_NORMAL)) {
+            printf("Processing %s (0x%08X, %u bytes)\n", sec->name, sec->address, sec->size);
+        }
+        double section_start = stats_now();
+        uint64_t emitted_before = porpoise_stats.instructions_emitted;
+
+        FILE *c_file = fopen(output_c, "w");
+        FILE *h_file = fopen(output_h, "w");
+        FILE *body = tmpfile();
+        if (!c_file || !h_file || !body) {
+            fprintf(stderr, "  Error: Cannot create output files\n");
+            if (c_file) fclose(c_file);
+            if (h_file) fclose(h_file);
+            if (body) fclose(body);
+            continue;
+        }
+
+        char guard_name[128];
+        snprintf(guard_name, sizeof(guard_name), "%s_H", base_name);
+        for (char *p = guard_name; *p; p++) *p = (char)toupper((unsigned char)*p);
+        fprintf(h_file, "#ifndef %s\n", guard_name);
+        fprintf(h_file, "#define %s\n\n", guard_name);
+
+        bool needs_address_map_header = false;
+        uint32_t covered = sec->address;
+
+        for (int i = 0; i < func_count; i++) {
+            if (funcs[i].start_address - sec->address >= sec->size) continue;
+
+            Function_Info func = funcs[i];
+            if (func.start_address > covered) {
+                fprintf(body, "// 0x%08X-0x%08X: not reached by function discovery (data or padding)\n\n",
+                        covered, func.start_address);
+            }
+            covered = func.end_address;
+            func.skip = skiplist_should_skip(skip_list, func.name) || is_sdk_or_stdlib_function(func.name);
+
+            if (func.skip) {
+                fprintf(body, "// Function %s skipped (in skip list)\n\n", func.name);
+                continue;
             }
+
+            bool pass_params = !config.register_calling_convention;
+            func.has_params = pass_params;
+            func.num_int_params = pass_params ? 8 : 0;   // r3-r10
+            func.num_float_params = pass_params ? 2 : 0; // f1-f2
+
+            write_function_declaration(h_file, &func);
+            write_function_start(body, &func);
+            binary_transpile_function(&img, sec, &func, funcs, func_count, body, &needs_address_map_header);
+            write_function_end(body);
         }
-    } else {
+
+        fprintf(h_file, "\n#endif // %s\n", guard_name);
+        fclose(h_file);
+
+        fprintf(c_file, "#include \"%s.h\"\n", base_name);
+        fprintf(c_file, "#include \"powerpc_state.h\"\n");
+        fprintf(c_file, "#include \"all_functions.h\"  // For cross-file function calls\n");
+        if (needs_address_map_header) {
+            fprintf(c_file, "#include \"function_address_map.h\"  // For indirect calls (vtables, callbacks)\n");
+        }
+        fprintf(c_file, "\n");
+
+        char buffer[8192];
+        size_t got;
+        rewind(body);
+        while ((got = fread(buffer, 1, sizeof(buffer), body)) > 0) {
+            fwrite(buffer, 1, got, c_file);
+        }
+        fclose(body);
         fclose(c_file);
+
+        char c_rel[128], h_rel[128];
+        snprintf(c_rel, sizeof(c_rel), "%s.c", base_name);
+        snprintf(h_rel, sizeof(h_rel), "%s.h", base_name);
+        c_files[*file_count] = strdup(c_rel);
+        h_files[*file_count] = strdup(h_rel);
+        (*file_count)++;
+        generated++;
+        stats_add_file(sec->name, (uint32_t)(porpoise_stats.instructions_emitted - emitted_before),
+                       stats_now() - section_start);
+
+        if (LOG_ENABLED(LOG_NORMAL)) {
+            printf("  → %s\n", output_c);
+            printf("  → %s\n", output_h);
+        }
     }
-    fclose(h_file);
-    
-    // Cleanup label map
-    if (label_map) labelmap_free(label_map);
-    if (string_table) string_table_free(string_table);
-    
-    printf("  → %s/%s.c\n", src_dir, base_name);
-    printf("  → %s/%s.h\n", inc_dir, base_name);
-    
-    return 0;
+
+    free(funcs);
+    binary_image_close(&img);
+    stats_leave(phase);
+    return generated;
 }
 
 /**
@@ -3725,12 +4678,15 @@ int generate_project(const char *output_dir, const char *dir_path) {
     // Generate project files
     printf("Generating CMakeLists.txt...\n");
     generate_cmake(output_dir, proj_name, c_file_count, (const char**)c_files, 
-                   h_file_count, (const char**)h_files);
+                   h_file_count, (const char**)h_files, NULL);
+    generate_build_manifest(output_dir, proj_name, c_file_count, (const char**)c_files, NULL);
     
     printf("Generating runtime files...\n");
-    generate_runtime_h(output_dir);
+    generate_runtime_h(output_dir, config.register_calling_convention,
+                       small_data.sda_base ? small_data.sda_base : SDA_DEFAULT_BASE,
+                       small_data.sda2_base ? small_data.sda2_base : SDA2_DEFAULT_BASE);
     generate_runtime_c(output_dir);
-    generate_main_c(output_dir);
+    generate_main_c(output_dir, config.register_calling_convention);
     
     printf("Copying core headers...\n");
     // Generate stdlib_headers.h with config settings
@@ -3791,6 +4747,21 @@ int generate_project(const char *output_dir, const char *dir_path) {
         fclose(gecko_dst_file);
     }
     
+    // Copy address_map.h (included by gecko_memory.h)
+    snprintf(gecko_src, sizeof(gecko_src), "include/address_map.h");
+    snprintf(gecko_dst, sizeof(gecko_dst), "%s/include/address_map.h", output_dir);
+    gecko_src_file = fopen(gecko_src, "r");
+    gecko_dst_file = fopen(gecko_dst, "w");
+    if (gecko_src_file && gecko_dst_file) {
+        char buffer[4096];
+        size_t bytes;
+        while ((bytes = fread(buffer, 1, sizeof(buffer), gecko_src_file)) > 0) {
+            fwrite(buffer, 1, bytes, gecko_dst_file);
+        }
+        fclose(gecko_src_file);
+        fclose(gecko_dst_file);
+    }
+    
     // Copy function_address_map.h and function_address_map.c
     char fam_src[512], fam_dst[512];
     
@@ -3903,7 +4874,9 @@ int generate_project(const char *output_dir, const char *dir_path) {
     printf("  cd %s\n", output_dir);
     printf("  mkdir build && cd build\n");
     printf("  cmake ..\n");
-    printf("  cmake --build .\n\n");
+    printf("  cmake --build .\n");
+    printf("Or with the built-in driver and object cache:\n");
+    printf("  porpoise_tool build %s\n\n", output_dir);
     
     return 0;
 }
@@ -3969,10 +4942,12 @@ static int process_directory_recursive(const char *input_dir, const char *output
         else {
             size_t name_len = strlen(entry->d_name);
             if (name_len >= 3 && strcmp(entry->d_name + name_len - 2, ".s") == 0) {
-                printf("Processing [%d]: %s%s\n", *files_processed + 1,
-                       rel_path[0] ? rel_path : "", rel_path[0] ? "/" : "");
-                printf("%s\n", entry->d_name);
-                fflush(stdout);
+                if (LOG_ENABLED(LOG_NORMAL)) {
+                    printf("Processing [%d]: %s%s\n", *files_processed + 1,
+                           rel_path[0] ? rel_path : "", rel_path[0] ? "/" : "");
+                    printf("%s\n", entry->d_name);
+                    fflush(stdout);
+                }
                 
                 if (*file_count >= max_files) {
                     fprintf(stderr, "Warning: Too many files (max %d)\n", max_files);
@@ -3980,7 +4955,13 @@ static int process_directory_recursive(const char *input_dir, const char *output
                 }
                 
                 // Transpile to project structure
+                double file_start = stats_now();
+                uint64_t emitted_before = porpoise_stats.instructions_emitted;
                 int result = transpile_file_to_project(full_path, output_src, output_inc, rel_path, skip_list);
+                char stats_path[512];
+                snprintf(stats_path, sizeof(stats_path), "%s%s%s", rel_path, rel_path[0] ? "/" : "", entry->d_name);
+                stats_add_file(stats_path, (uint32_t)(porpoise_stats.instructions_emitted - emitted_before),
+                               stats_now() - file_start);
                 if (result == 0) {
                     // Track filenames with relative paths
                     char base_name[256];
@@ -4001,7 +4982,7 @@ static int process_directory_recursive(const char *input_dir, const char *output
                     (*file_count)++;
                     (*files_processed)++;
                     
-                    printf("  ✓ Success\n");
+                    if (LOG_ENABLED(LOG_NORMAL)) printf("  ✓ Success\n");
                 } else {
                     fprintf(stderr, "  ✗ Failed\n");
                 }
@@ -4167,6 +5148,16 @@ static void load_config(void) {
         }
     }
     
+    // register_calling_convention
+    value = json_get_value(json_content, "register_calling_convention");
+    if (value) {
+        if (strcmp(value, "true") == 0 || strcmp(value, "1") == 0) {
+            config.register_calling_convention = true;
+        } else {
+            config.register_calling_convention = false;
+        }
+    }
+    
     // sdk_functions_file
     value = json_get_value(json_content, "sdk_functions_file");
     if (value && strlen(value) > 0) {
@@ -4181,14 +5172,291 @@ static void load_config(void) {
         config.skip_list_file[sizeof(config.skip_list_file) - 1] = '\0';
     }
     
+    // symbol_map_file
+    value = json_get_value(json_content, "symbol_map_file");
+    if (value && strlen(value) > 0) {
+        strncpy(config.symbol_map_file, value, sizeof(config.symbol_map_file) - 1);
+        config.symbol_map_file[sizeof(config.symbol_map_file) - 1] = '\0';
+    }
+    
+    // splits_file
+    value = json_get_value(json_content, "splits_file");
+    if (value && strlen(value) > 0) {
+        strncpy(config.splits_file, value, sizeof(config.splits_file) - 1);
+        config.splits_file[sizeof(config.splits_file) - 1] = '\0';
+    }
+    
+    // sda_base / sda2_base
+    value = json_get_value(json_content, "sda_base");
+    if (value && strlen(value) > 0) {
+        config.sda_base = (uint32_t)strtoul(value, NULL, 0);
+    }
+    value = json_get_value(json_content, "sda2_base");
+    if (value && strlen(value) > 0) {
+        config.sda2_base = (uint32_t)strtoul(value, NULL, 0);
+    }
+    
+    // fold_identical_functions
+    value = json_get_value(json_content, "fold_identical_functions");
+    if (value) {
+        config.fold_identical_functions = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+    }
+    
+    // promote_frame_slots
+    value = json_get_value(json_content, "promote_frame_slots");
+    if (value) {
+        config.promote_frame_slots = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+    }
+    
+    // inline_max_instructions
+    value = json_get_value(json_content, "inline_max_instructions");
+    if (value) {
+        int max_instructions = atoi(value);
+        config.inline_max_instructions = max_instructions > 0 ? max_instructions : 0;
+    }
+    
+    // unity_shards
+    value = json_get_value(json_content, "unity_shards");
+    if (value) {
+        int shards = atoi(value);
+        config.unity_shards = shards < 0 ? 0 : (shards > UNITY_MAX_SHARDS ? UNITY_MAX_SHARDS : shards);
+    }
+    
+    // shared_modules
+    value = json_get_value(json_content, "shared_modules");
+    if (value) {
+        config.shared_modules = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+    }
+    
+    // cmake_precompiled_headers
+    value = json_get_value(json_content, "cmake_precompiled_headers");
+    if (value) {
+        config.cmake_precompiled_headers = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+    }
+    
+    // cmake_lto
+    value = json_get_value(json_content, "cmake_lto");
+    if (value) {
+        config.cmake_lto = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+    }
+    
+    // cmake_gc_sections
+    value = json_get_value(json_content, "cmake_gc_sections");
+    if (value) {
+        config.cmake_gc_sections = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+    }
+    
+    // log_level
+    value = json_get_value(json_content, "log_level");
+    if (value) {
+        if (strcmp(value, "quiet") == 0) porpoise_log_level = LOG_QUIET;
+        else if (strcmp(value, "normal") == 0) porpoise_log_level = LOG_NORMAL;
+        else if (strcmp(value, "verbose") == 0) porpoise_log_level = LOG_VERBOSE;
+    }
+    
+    // dead_functions
+    value = json_get_value(json_content, "dead_functions");
+    if (value && (strcmp(value, "keep") == 0 || strcmp(value, "stub") == 0 || strcmp(value, "omit") == 0)) {
+        snprintf(config.dead_functions, sizeof(config.dead_functions), "%s", value);
+    }
+    
     free(json_content);
     printf("Loaded configuration from: %s\n", config_path);
 }
 
+//==============================================================================
+// PROGRAM DATABASE COMMANDS
+//==============================================================================
+
+/**
+ * @brief porpoise_tool index <asm_dir> [db]
+ */
+static int run_index_command(const char *input_dir, const char *db_path) {
+    Program_DB db;
+    int scanned = pdb_update(&db, db_path, input_dir);
+    if (scanned < 0) {
+        fprintf(stderr, "Error: Could not write program database %s\n", db_path);
+        pdb_free(&db);
+        return 1;
+    }
+    printf("Program database %s: %u files (%d re-scanned), %u functions, %u labels, %u strings, "
+           "%u data objects, %u calls, %u data references\n",
+           db_path, db.file_count, scanned, db.function_count, db.label_count, db.string_count,
+           db.data_count, db.call_count, db.xref_count);
+    pdb_free(&db);
+    return 0;
+}
+
+/**
+ * @brief Describe an address as "name+0xoff" using the functions, then the data objects
+ */
+static void pdb_describe_address(const Program_DB *db, uint32_t address, char *out, size_t out_size) {
+    const PDB_Function *fn = pdb_function_at(db, address);
+    if (fn) {
+        if (address == fn->address) snprintf(out, out_size, "%s", pdb_name(db, fn->name));
+        else snprintf(out, out_size, "%s+0x%X", pdb_name(db, fn->name), address - fn->address);
+        return;
+    }
+    for (uint32_t i = 0; i < db->data_count; i++) {
+        const PDB_Data *d = &db->data[i];
+        if (address >= d->address && address < d->address + (d->size ? d->size : 1)) {
+            snprintf(out, out_size, "%s+0x%X", pdb_name(db, d->name), address - d->address);
+            return;
+        }
+    }
+    snprintf(out, out_size, "0x%08X", address);
+}
+
+/**
+ * @brief porpoise_tool query <db> <callers-of|callees-of|refs-to|info> [name|0xADDR]
+ */
+static int run_query_command(const char *db_path, const char *kind, const char *subject) {
+    Program_DB db;
+    if (!pdb_open(&db, db_path)) {
+        fprintf(stderr, "Error: Could not open program database %s (run 'index' first)\n", db_path);
+        return 1;
+    }
+
+    if (strcmp(kind, "info") == 0) {
+        printf("%u files, %u functions, %u labels, %u strings, %u data objects, %u calls, %u data references\n",
+               db.file_count, db.function_count, db.label_count, db.string_count,
+               db.data_count, db.call_count, db.xref_count);
+        pdb_free(&db);
+        return 0;
+    }
+    if (!subject) {
+        fprintf(stderr, "Error: '%s' needs a function name, symbol or 0xADDR\n", kind);
+        pdb_free(&db);
+        return 1;
+    }
+
+    uint32_t address = strncmp(subject, "0x", 2) == 0 ? (uint32_t)strtoul(subject, NULL, 16)
+                                                       : pdb_resolve_name(&db, subject);
+    if (address == 0 && strcmp(kind, "refs-to") == 0) {
+        // Symbols defined outside the indexed sources are matched by name
+        for (uint32_t i = 0; i < db.xref_count; i++) {
+            const PDB_Xref *x = &db.xrefs[i];
+            if (x->target != 0 || strcmp(pdb_name(&db, x->target_name), subject) != 0) continue;
+            char where[256];
+            pdb_describe_address(&db, x->site, where, sizeof(where));
+            printf("0x%08X  %-40s %s\n", x->site, where, pdb_name(&db, db.files[x->file].path));
+        }
+        pdb_free(&db);
+        return 0;
+    }
+    if (address == 0) {
+        fprintf(stderr, "Error: Unknown symbol %s\n", subject);
+        pdb_free(&db);
+        return 1;
+    }
+
+    char where[256];
+    uint32_t first, last;
+    if (strcmp(kind, "callers-of") == 0) {
+        pdb_calls_to(&db, address, &first, &last);
+        for (uint32_t i = first; i < last; i++) {
+            const PDB_Call *c = &db.calls[i];
+            pdb_describe_address(&db, c->site, where, sizeof(where));
+            printf("0x%08X  %-40s %s%s\n", c->site, where, pdb_name(&db, db.files[c->file].path),
+                   (c->flags & PDB_CALL_TAIL) ? "  (tail call)" : "");
+        }
+    } else if (strcmp(kind, "callees-of") == 0) {
+        const PDB_Function *fn = pdb_function_at(&db, address);
+        pdb_calls_from(&db, fn ? fn->address : address, &first, &last);
+        for (uint32_t i = first; i < last; i++) {
+            const PDB_Call *c = &db.calls[db.call_by_caller[i]];
+            if (c->callee) pdb_describe_address(&db, c->callee, where, sizeof(where));
+            else snprintf(where, sizeof(where), "%s (external)", pdb_name(&db, c->callee_name));
+            printf("0x%08X  %s%s\n", c->site, where, (c->flags & PDB_CALL_TAIL) ? "  (tail call)" : "");
+        }
+    } else if (strcmp(kind, "refs-to") == 0) {
+        pdb_refs_to(&db, address, &first, &last);
+        for (uint32_t i = first; i < last; i++) {
+            const PDB_Xref *x = &db.xrefs[i];
+            pdb_describe_address(&db, x->site, where, sizeof(where));
+            printf("0x%08X  %-40s %s\n", x->site, where, pdb_name(&db, db.files[x->file].path));
+        }
+    } else {
+        fprintf(stderr, "Error: Unknown query '%s' (callers-of, callees-of, refs-to, info)\n", kind);
+        pdb_free(&db);
+        return 1;
+    }
+
+    pdb_free(&db);
+    return 0;
+}
+
+/**
+ * @brief `build <project> [-j N]`: compile and link a generated project (see build_driver.h)
+ */
+static int run_build_command(const char *project_dir, int argc, char *argv[]) {
+    int jobs = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "-j", 2) == 0) {
+            jobs = atoi(argv[i] + 2);
+        } else {
+            fprintf(stderr, "Error: Unknown build option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // The manifest and the cache key use project-relative paths
+    char previous_dir[1024];
+#ifdef _WIN32
+    if (!_getcwd(previous_dir, sizeof(previous_dir)) || _chdir(project_dir) != 0) {
+#else
+    if (!getcwd(previous_dir, sizeof(previous_dir)) || chdir(project_dir) != 0) {
+#endif
+        fprintf(stderr, "Error: Cannot enter project directory %s\n", project_dir);
+        return 1;
+    }
+    int result = build_project(jobs);
+#ifdef _WIN32
+    if (_chdir(previous_dir) != 0) result = 1;
+#else
+    if (chdir(previous_dir) != 0) result = 1;
+#endif
+    return result;
+}
+
+/**
+ * @brief `sweep [-j N] [--step N] [--range FIRST-LAST] [--verbose]`: cross-check
+ * transpile_instruction() against every decoder (see decoder_sweep.h)
+ */
+static int run_sweep_command(int argc, char *argv[]) {
+    Sweep_Options options = { 0, 0xFFFFFFFFu, 1, 0, false };
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options.jobs = atoi(argv[++i]);
+        } else if (strncmp(argv[i], "-j", 2) == 0 && argv[i][2]) {
+            options.jobs = atoi(argv[i] + 2);
+        } else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            options.step = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--range") == 0 && i + 1 < argc) {
+            char *end;
+            options.first = (uint32_t)strtoul(argv[++i], &end, 16);
+            options.last = *end == '-' ? (uint32_t)strtoul(end + 1, NULL, 16) : options.first;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            options.verbose = true;
+        } else {
+            fprintf(stderr, "Error: Unknown sweep option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (options.step == 0 || options.last < options.first) {
+        fprintf(stderr, "Error: --step must be positive and --range FIRST-LAST ascending\n");
+        return 1;
+    }
+    return run_decoder_sweep(transpile_instruction, &options);
+}
+
 /**
  * @brief Main entry point
  */
 int main(int argc, char *argv[]) {
+    stats_start();
     printf("===========================================\n");
     printf("   Porpoise Tool - PowerPC to C Transpiler\n");
     printf("   For GameCube/Wii Decompilation Projects\n");
@@ -4204,7 +5472,21 @@ int main(int argc, char *argv[]) {
     
     // Load SDK functions configuration (use path from config if specified)
     load_sdk_functions(config.sdk_functions_file);
-    
+
+    // Program database subcommands
+    if (argc >= 3 && strcmp(argv[1], "index") == 0) {
+        return run_index_command(argv[2], argc >= 4 ? argv[3] : PDB_DEFAULT_NAME);
+    }
+    if (argc >= 4 && strcmp(argv[1], "query") == 0) {
+        return run_query_command(argv[2], argv[3], argc >= 5 ? argv[4] : NULL);
+    }
+    if (argc >= 3 && strcmp(argv[1], "build") == 0) {
+        return run_build_command(argv[2], argc - 3, argv + 3);
+    }
+    if (argc >= 2 && strcmp(argv[1], "sweep") == 0) {
+        return run_sweep_command(argc - 2, argv + 2);
+    }
+
     // Check for help flag
     bool show_help = (argc < 2);
     if (argc >= 2) {
@@ -4219,12 +5501,27 @@ int main(int argc, char *argv[]) {
         
         printf("USAGE:\n");
         printf("  %s <input_dir> [output_project] [skip_list.txt]\n", argv[0]);
+        printf("  %s <game.dol|game.elf> [output_project] [skip_list.txt] [--symbols symbols.txt]\n", argv[0]);
+        printf("  %s <input> [output_project] [--stats[=json]] [--quiet | --verbose]\n", argv[0]);
+        printf("  %s index <input_dir> [program.pdb]\n", argv[0]);
+        printf("  %s query <program.pdb> callers-of|callees-of|refs-to <name|0xADDR>\n", argv[0]);
+        printf("  %s query <program.pdb> info\n", argv[0]);
+        printf("  %s build <output_project> [-j N]\n", argv[0]);
+        printf("  %s sweep [-j N] [--step N] [--range FIRST-LAST] [--verbose]\n", argv[0]);
         printf("  %s --help | -h | -? | /?     Show this help message\n\n", argv[0]);
         
         printf("ARGUMENTS:\n");
         printf("  <input_dir>         Directory containing .s assembly files to transpile\n");
+        printf("  <game.dol|elf>      Executable to decode directly (no disassembly step)\n");
         printf("  [output_project]    Output project directory (default: GameCube_Project)\n");
-        printf("  [skip_list.txt]     Optional text file with function names to skip (one per line)\n\n");
+        printf("  [skip_list.txt]     Optional text file with function names to skip (one per line)\n");
+        printf("  --symbols <file>    Symbol map: CodeWarrior .map, dtk symbols.txt or \"0xADDR name\" lines\n");
+        printf("  --stats[=json]      Phase and per-file timings, throughput, peak RSS and fallback counts\n");
+        printf("                      (json: written to <output_project>/porpoise_stats.json)\n");
+        printf("  --quiet | --verbose No per-file output | per-file diagnostics (config: log_level)\n");
+        printf("  -j N                build, sweep: parallel jobs (default: one per CPU)\n");
+        printf("  sweep               Decode every instruction word: throughput, words no decoder\n");
+        printf("                      handles and words more than one decoder accepts\n\n");
         
         printf("FEATURES:\n");
         printf("  • Transpiles 248 PowerPC + Gekko opcodes (100%% coverage!)\n");
@@ -4244,6 +5541,9 @@ int main(int argc, char *argv[]) {
         printf("  Skip specific functions during transpilation:\n");
         printf("    %s \"Test Asm\" MyGame skip_functions.txt\n\n", argv[0]);
         
+        printf("  Transpile a DOL directly with names from a symbol file:\n");
+        printf("    %s main.dol MyGame --symbols symbols.txt\n\n", argv[0]);
+        
         printf("SKIP LIST FORMAT:\n");
         printf("  Create a text file with one function name per line:\n");
         printf("    fn_80003100\n");
@@ -4254,6 +5554,7 @@ int main(int argc, char *argv[]) {
         printf("  • <project>/src/       - Transpiled C source files\n");
         printf("  • <project>/include/   - Header files and declarations\n");
         printf("  • <project>/CMakeLists.txt - Build configuration\n");
+        printf("  • <project>/program.pdb    - Symbol/cross-reference database (for 'query')\n");
         printf("  • <project>/<project>.sln - Visual Studio solution (on Windows)\n\n");
         
         printf("BUILDING THE OUTPUT:\n");
@@ -4265,9 +5566,57 @@ int main(int argc, char *argv[]) {
         return (argc < 2) ? 1 : 0;  // Error if no args, success if --help
     }
     
-    const char *input_dir = argv[1];
-    const char *output_project = (argc >= 3) ? argv[2] : "GameCube_Project";
-    const char *skip_file = (argc >= 4) ? argv[3] : NULL;
+    // Split off --symbols <file> and the output options; everything else is positional
+    const char *symbol_file = NULL;
+    const char *positional[3] = {NULL, NULL, NULL};
+    int positional_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+            symbol_file = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) {
+            porpoise_stats.report = true;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            porpoise_stats.report = porpoise_stats.json = true;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            porpoise_log_level = LOG_QUIET;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            porpoise_log_level = LOG_VERBOSE;
+        } else if (positional_count < 3) {
+            positional[positional_count++] = argv[i];
+        }
+    }
+    if (!positional[0]) {
+        fprintf(stderr, "Error: No input directory or executable given\n");
+        return 1;
+    }
+    
+    const char *input_dir = positional[0];
+    const char *output_project = positional[1] ? positional[1] : "GameCube_Project";
+    const char *skip_file = positional[2];
+    bool binary_input = binary_is_executable_path(input_dir);
+    
+    // Symbol map shared by every file (parsed once, then reused from its .idx cache)
+    if (!symbol_file && config.symbol_map_file[0] != '\0') {
+        symbol_file = config.symbol_map_file;
+    }
+    const char *symbol_sources[2] = { symbol_file, config.splits_file[0] ? config.splits_file : NULL };
+    for (int i = 0; i < 2; i++) {
+        if (!symbol_sources[i]) continue;
+        if (symbol_map_load(&symbol_index, symbol_sources[i]) < 0) {
+            printf("Warning: Could not load symbol map %s\n", symbol_sources[i]);
+        }
+    }
+    if (symbol_map_count(&symbol_index) > 0) {
+        printf("Symbol map: %d functions, %d objects, %d units\n\n",
+               symbol_index.functions.count, symbol_index.objects.count, symbol_index.units.count);
+    }
+    
+    // Small-data bases: configuration first, then linker symbols (the IR adds __init_registers)
+    small_data.sda_base = config.sda_base;
+    small_data.sda2_base = config.sda2_base;
+    if (config.sda_base || config.sda2_base) small_data.source = "config";
+    small_data_from_symbols(&symbol_index, &small_data);
+    if (binary_input) report_small_data();
     
     // Use skip_list_file from config if not provided via command line
     if (!skip_file && config.skip_list_file[0] != '\0') {
@@ -4301,8 +5650,6 @@ int main(int argc, char *argv[]) {
     create_directory(src_dir);
     create_directory(inc_dir);
     
-    printf("Processing assembly files from: %s (recursive)\n\n", input_dir);
-    
     // Process all .s files recursively and output directly to project
     int files_processed = 0;
     int max_files = 5000;  // Support large games with thousands of files
@@ -4315,10 +5662,86 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
-    // Process recursively starting from root
-    process_directory_recursive(input_dir, src_dir, inc_dir, "",
-                               &skip_list, &files_processed,
-                               c_files, h_files, &file_count, max_files);
+    if (binary_input) {
+        // Decode instruction words straight from the executable
+        printf("Processing executable: %s\n\n", input_dir);
+        int generated = transpile_binary_to_project(input_dir, src_dir, inc_dir, &skip_list,
+                                                    c_files, h_files, &file_count, max_files);
+        if (generated < 0) {
+            return 1;
+        }
+        files_processed = generated;
+    } else {
+        // Decode the whole program once, then emit file by file
+        stats_enter(STATS_DECODE);
+        ir_init(&program_ir);
+        int ir_files = ir_load_directory(&program_ir, input_dir);
+        if (ir_files < 0 || !ir_finalize(&program_ir)) {
+            fprintf(stderr, "Error: Cannot read assembly from %s\n", input_dir);
+            return 1;
+        }
+        porpoise_stats.instructions_decoded = program_ir.instruction_count;
+        stats_enter(STATS_ANALYZE);
+        printf("Program IR: %d files, %u functions, %u blocks, %u instructions\n",
+               ir_files, program_ir.function_count, program_ir.block_count, program_ir.instruction_count);
+        program_input_dir = input_dir;
+        if (config.shared_modules) {
+            assign_modules();
+            printf("Shared modules: %u top-level directories, cross-module calls use the address map\n",
+                   module_count);
+        }
+        
+        small_data_from_ir(&program_ir, &small_data);
+        report_small_data();
+        
+        int unreachable = ir_mark_unreachable(&program_ir, NULL, 0);
+        if (unreachable < 0) {
+            printf("Reachability: no %s in the input, every function is kept\n", IR_ENTRY_POINT);
+        } else {
+            printf("Reachability: %d of %u functions unreachable from %s (%s)\n",
+                   unreachable, program_ir.function_count, IR_ENTRY_POINT, config.dead_functions);
+        }
+        if (config.fold_identical_functions) {
+            printf("Identical-code folding: %d functions share another function's body\n",
+                   fold_identical_functions(&skip_list));
+        }
+        if (config.promote_frame_slots) {
+            promote_frame_slots(&skip_list);
+        }
+        if (config.inline_max_instructions > 0) {
+            printf("Inlining: %d leaf functions inlined at their call sites (max %d instructions)\n",
+                   inline_leaf_functions(&skip_list), config.inline_max_instructions);
+        }
+        build_emitted_names(&skip_list);
+        printf("\n");
+        
+        // Process recursively starting from root
+        stats_enter(STATS_EMIT);
+        printf("Processing assembly files from: %s (recursive)\n\n", input_dir);
+        process_directory_recursive(input_dir, src_dir, inc_dir, "",
+                                   &skip_list, &files_processed,
+                                   c_files, h_files, &file_count, max_files);
+        
+        // Keep the project's cross-reference database in step with the sources
+        stats_enter(STATS_SCAN);
+        char db_path[512];
+        snprintf(db_path, sizeof(db_path), "%s/%s", output_project, PDB_DEFAULT_NAME);
+        Program_DB program_db;
+        int rescanned = pdb_update(&program_db, db_path, input_dir);
+        if (rescanned >= 0) {
+            printf("\nProgram database: %u functions, %u calls, %u data references (%d files re-scanned)\n",
+                   program_db.function_count, program_db.call_count, program_db.xref_count, rescanned);
+        } else {
+            printf("\nWarning: Could not update program database %s\n", db_path);
+        }
+        pdb_free(&program_db);
+    }
+    
+    // Sharding needs the IR (instruction counts, static names); otherwise old shards are removed
+    stats_enter(STATS_WRITE);
+    int unity_shards = write_unity_shards(src_dir, c_files, file_count, &skip_list);
+    int transpiled_c_count = file_count;  // Plus the module registration sources
+    write_module_sources(src_dir, c_files, &transpiled_c_count, max_files);
     
     printf("\n===========================================\n");
     printf("   Transpilation Complete!\n");
@@ -4333,15 +5756,22 @@ int main(int argc, char *argv[]) {
     if (!proj_name) proj_name = strrchr(output_project, '\\');
     proj_name = proj_name ? (proj_name + 1) : output_project;
     
-    // Add powerpc_state.c, compiler_runtime.c, and main.c to sources
-    int total_c_count = file_count + 3;
+    // Transpiled sources first, then the runtime files written or copied below
+    int total_c_count = transpiled_c_count + (file_modules ? 8 : 6);
     char **all_c_files = malloc(sizeof(char*) * total_c_count);
-    for (int i = 0; i < file_count; i++) {
+    for (int i = 0; i < transpiled_c_count; i++) {
         all_c_files[i] = c_files[i];
     }
-    all_c_files[file_count] = strdup("powerpc_state.c");
-    all_c_files[file_count + 1] = strdup("compiler_runtime.c");
-    all_c_files[file_count + 2] = strdup("main.c");
+    all_c_files[transpiled_c_count] = strdup("powerpc_state.c");
+    all_c_files[transpiled_c_count + 1] = strdup("compiler_runtime.c");
+    all_c_files[transpiled_c_count + 2] = strdup("ppc_runtime.c");
+    all_c_files[transpiled_c_count + 3] = strdup("function_address_map.c");
+    all_c_files[transpiled_c_count + 4] = strdup("function_registry.c");
+    all_c_files[transpiled_c_count + 5] = strdup("main.c");
+    if (file_modules) {
+        all_c_files[transpiled_c_count + 6] = strdup("module_reload.c");
+        all_c_files[transpiled_c_count + 7] = strdup("porpoise_modules.c");
+    }
     
     // Add powerpc_state.h, all_functions.h, and macros.h to headers
     int total_h_count = file_count + 3;
@@ -4353,13 +5783,24 @@ int main(int argc, char *argv[]) {
     all_h_files[file_count + 1] = strdup("all_functions.h");
     all_h_files[file_count + 2] = strdup("macros.h");
     
+    CMake_Options cmake_options = {
+        .transpiled_count = transpiled_c_count,
+        .unity_shards = unity_shards,
+        .precompiled_headers = config.cmake_precompiled_headers,
+        .lto = config.cmake_lto,
+        .gc_sections = config.cmake_gc_sections,
+        .shared_modules = file_modules != NULL
+    };
     generate_cmake(output_project, proj_name, total_c_count, (const char**)all_c_files, 
-                   total_h_count, (const char**)all_h_files);
+                   total_h_count, (const char**)all_h_files, &cmake_options);
+    generate_build_manifest(output_project, proj_name, total_c_count, (const char**)all_c_files, &cmake_options);
     generate_all_functions_h(output_project, file_count, (const char**)h_files);
-    generate_runtime_h(output_project);
+    generate_runtime_h(output_project, config.register_calling_convention,
+                       small_data.sda_base ? small_data.sda_base : SDA_DEFAULT_BASE,
+                       small_data.sda2_base ? small_data.sda2_base : SDA2_DEFAULT_BASE);
     generate_runtime_c(output_project);
     generate_compiler_runtime_c(output_project);
-    generate_main_c(output_project);
+    generate_main_c(output_project, config.register_calling_convention);
     generate_macros_h(output_project);
     
     // Copy core headers to project
@@ -4411,6 +5852,7 @@ int main(int argc, char *argv[]) {
     const char *headers_to_copy[] = {
         "stdlib_stubs.h",
         "gecko_memory.h",
+        "address_map.h",
         "function_address_map.h",
         NULL
     };
@@ -4472,6 +5914,32 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Warning: Could not copy ppc_runtime.c (tried: %s)\n", src_c_path);
     }
     
+    // Hot reload runtime for shared modules
+    if (file_modules) {
+        const char *module_runtime[][2] = {
+            { "src/module_reload.c", "src/module_reload.c" },
+            { "include/module_reload.h", "include/module_reload.h" }
+        };
+        for (int i = 0; i < 2; i++) {
+            snprintf(src_c_path, sizeof(src_c_path), "%s", module_runtime[i][0]);
+            snprintf(dst_c_path, sizeof(dst_c_path), "%s/%s", output_project, module_runtime[i][1]);
+            src_c = fopen(src_c_path, "r");
+            dst_c = src_c ? fopen(dst_c_path, "w") : NULL;
+            if (src_c && dst_c) {
+                char buffer[4096];
+                size_t bytes;
+                while ((bytes = fread(buffer, 1, sizeof(buffer), src_c)) > 0) {
+                    fwrite(buffer, 1, bytes, dst_c);
+                }
+                printf("  Copied %s\n", module_runtime[i][0]);
+            } else {
+                fprintf(stderr, "Warning: Could not copy %s\n", module_runtime[i][0]);
+            }
+            if (src_c) fclose(src_c);
+            if (dst_c) fclose(dst_c);
+        }
+    }
+    
     // Copy ppc_runtime.h header file (if not already in headers_to_copy list)
     char ppc_runtime_h_src[512], ppc_runtime_h_dst[512];
     snprintf(ppc_runtime_h_src, sizeof(ppc_runtime_h_src), "include/ppc_runtime.h");
@@ -4553,11 +6021,14 @@ int main(int argc, char *argv[]) {
         free(c_files[i]);
         free(h_files[i]);
     }
+    for (int i = file_count; i < transpiled_c_count; i++) {
+        free(c_files[i]);
+    }
     free(c_files);
     free(h_files);
     
     // Free the combined arrays
-    for (int i = file_count; i < total_c_count; i++) {
+    for (int i = transpiled_c_count; i < total_c_count; i++) {
         free(all_c_files[i]);
     }
     free(all_c_files);
@@ -4576,8 +6047,13 @@ int main(int argc, char *argv[]) {
     printf("  cd %s\n", output_project);
     printf("  mkdir build && cd build\n");
     printf("  cmake ..\n");
-    printf("  cmake --build .\n\n");
+    printf("  cmake --build .\n");
+    printf("Or with the built-in driver and object cache:\n");
+    printf("  porpoise_tool build %s\n\n", output_project);
     
+    if (porpoise_stats.report) {
+        stats_report(output_project);
+    }
     return 0;
 }
 
@@ -20,9 +20,7 @@
  * @brief Exit the process (transpiled from GameCube exit function)
  * This is called when the game exits. On Windows, we call ExitProcess.
  */
-void _ExitProcess(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6,
-                  uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10,
-                  double f1, double f2) {
+void _ExitProcess(PPC_FUNC_PARAMS) {
     (void)r4; (void)r5; (void)r6; (void)r7; (void)r8; (void)r9; (void)r10;
     (void)f1; (void)f2;
     
@@ -44,9 +42,7 @@ void _ExitProcess(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6,
  * @param type Type of argument to extract (passed in r4)
  * @return The extracted argument value
  */
-void* ppc_va_arg(uint32_t r3, uint32_t r4, uint32_t r5, uint32_t r6,
-                 uint32_t r7, uint32_t r8, uint32_t r9, uint32_t r10,
-                 double f1, double f2) {
+void* ppc_va_arg(PPC_FUNC_PARAMS) {
     (void)r5; (void)r6; (void)r7; (void)r8; (void)r9; (void)r10;
     (void)f1; (void)f2;
     
@@ -145,11 +141,16 @@ int strcasecmp(const char *s1, const char *s2) {
  * 
  * The game's __init_registers() sets:
  * - r1 = 0x8002F0D8 (stack pointer)
- * - r2 = 0x800270A0 (small data area pointer)
- * - r13 = 0x80026E00 (small data area pointer)
+ * - r2 = _SDA2_BASE_ (small data area pointer)
+ * - r13 = _SDA_BASE_ (small data area pointer)
  * 
- * This function converts these GameCube addresses to host pointers.
+ * This function converts these GameCube addresses to host pointers. The
+ * small-data bases come from powerpc_state.h (found by the transpiler).
  */
+#ifdef PPC_REGISTER_ABI
+void __init_registers(void) {
+    // Register convention: arguments are already in the globals
+#else
 void __init_registers(uint32_t param_r3, uint32_t param_r4, uint32_t param_r5, uint32_t param_r6,
                       uint32_t param_r7, uint32_t param_r8, uint32_t param_r9, uint32_t param_r10,
                       double param_f1, double param_f2) {
@@ -164,16 +165,13 @@ void __init_registers(uint32_t param_r3, uint32_t param_r4, uint32_t param_r5, u
     r10 = param_r10;
     f1 = param_f1;
     f2 = param_f2;
+#endif
     
     // Initialize r1 (stack pointer) to host pointer
     // GameCube address: 0x8002F0D8 -> mem + 0x2F0D8
     r1 = (uintptr_t)(mem + 0x2F0D8);
     
-    // Initialize r2 (small data area pointer) to host pointer
-    // GameCube address: 0x800270A0 -> mem + 0x270A0
-    r2 = (uintptr_t)(mem + 0x270A0);
-    
-    // Initialize r13 (small data area pointer) to host pointer
-    // GameCube address: 0x80026E00 -> mem + 0x26E00
-    r13 = (uintptr_t)(mem + 0x26E00);
+    // Initialize r2 and r13 (small data area pointers) to host pointers
+    r2 = convert_gc_address(PPC_SDA2_BASE);
+    r13 = convert_gc_address(PPC_SDA_BASE);
 }